@@ -0,0 +1,104 @@
+#include "animationscheduler.h"
+#include "powermetrics.h"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+
+namespace {
+AnimationScheduler *sharedScheduler = nullptr;
+}
+
+// Hủy cùng app (QTimer cần event dispatcher còn sống), không phải sau main()
+AnimationScheduler &AnimationScheduler::shared()
+{
+    if (!sharedScheduler) {
+        sharedScheduler = new AnimationScheduler;
+        qAddPostRoutine([] {
+            delete sharedScheduler;
+            sharedScheduler = nullptr;
+        });
+    }
+    return *sharedScheduler;
+}
+
+AnimationScheduler::AnimationScheduler(QObject *parent) : QObject(parent)
+{
+    m_timer.setInterval(FrameMs);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &AnimationScheduler::onTimeout);
+}
+
+int AnimationScheduler::add(QObject *context, Tick tick)
+{
+    const int id = m_nextId++;
+    Entry entry{id, std::move(tick), QMetaObject::Connection(), false};
+    entry.contextDestroyed = connect(context, &QObject::destroyed, this, [this, id]() { remove(id); });
+    // đang tick thì m_entries có thể đang được duyệt -> để dành
+    if (m_ticking) m_pending.append(std::move(entry));
+    else m_entries.append(std::move(entry));
+
+    if (!m_timer.isActive()) {
+        m_clock.start();
+        m_timer.start();
+    }
+    return id;
+}
+
+// Chỉ đánh dấu; sweep() xóa khi không có tick nào đang chạy
+void AnimationScheduler::remove(int id)
+{
+    for (QVector<Entry> *list : {&m_entries, &m_pending}) {
+        for (Entry &entry : *list) {
+            if (entry.id == id) entry.removed = true;
+        }
+    }
+    if (!m_ticking) sweep();
+}
+
+bool AnimationScheduler::contains(int id) const
+{
+    for (const QVector<Entry> *list : {&m_entries, &m_pending}) {
+        for (const Entry &entry : *list) {
+            if (entry.id == id && !entry.removed) return true;
+        }
+    }
+    return false;
+}
+
+int AnimationScheduler::activeCount() const
+{
+    int count = 0;
+    for (const QVector<Entry> *list : {&m_entries, &m_pending}) {
+        for (const Entry &entry : *list) count += !entry.removed;
+    }
+    return count;
+}
+
+void AnimationScheduler::sweep()
+{
+    for (Entry &entry : m_entries) {
+        if (entry.removed) disconnect(entry.contextDestroyed);
+    }
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [](const Entry &e) { return e.removed; }),
+                    m_entries.end());
+    for (Entry &entry : m_pending) {
+        if (entry.removed) disconnect(entry.contextDestroyed);
+        else m_entries.append(std::move(entry));
+    }
+    m_pending.clear();
+    if (m_entries.isEmpty()) m_timer.stop();
+}
+
+void AnimationScheduler::onTimeout()
+{
+    PowerMetrics::recordWakeup();
+    const float dt = qMin(0.05f, m_clock.restart() / 1000.0f);   // frame bị trễ: không nhảy cóc
+
+    m_ticking = true;
+    for (Entry &entry : m_entries) {
+        if (!entry.removed && !entry.tick(dt)) entry.removed = true;
+    }
+    m_ticking = false;
+    sweep();
+}
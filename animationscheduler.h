@@ -0,0 +1,53 @@
+#ifndef ANIMATIONSCHEDULER_H
+#define ANIMATIONSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include <functional>
+
+// One animation tick for every board in the process (bounce, particles,
+// demo bots). A single QTimer runs only while at least one animation is
+// registered, so an idle process has no periodic wake-ups and the 16th
+// board adds a callback, not another thread or timer.
+class AnimationScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FrameMs = 16;
+
+    // tick(dt giây) trả về false khi animation xong -> tự gỡ
+    using Tick = std::function<bool(float dt)>;
+
+    static AnimationScheduler &shared();
+
+    // Đăng ký animation; gỡ tự động khi context bị hủy. Trả về id để remove().
+    int add(QObject *context, Tick tick);
+    void remove(int id);
+    bool contains(int id) const;
+    int activeCount() const;
+
+private:
+    explicit AnimationScheduler(QObject *parent = nullptr);
+    void onTimeout();
+
+    struct Entry {
+        int id;
+        Tick tick;
+        QMetaObject::Connection contextDestroyed;
+        bool removed;
+    };
+    void sweep();
+
+    QVector<Entry> m_entries;
+    QVector<Entry> m_pending;          // add() trong lúc tick: nhập vào sau vòng lặp
+    int m_nextId = 1;
+    bool m_ticking = false;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+};
+
+#endif // ANIMATIONSCHEDULER_H
@@ -0,0 +1,52 @@
+#include "ballgym.h"
+#include "gymbatch.h"
+
+#include <new>
+
+struct BallGym {
+    BallGym(int numEnvs, const GameRules &rules, uint64_t seed, int threads)
+        : batch(numEnvs, rules, seed, threads)
+    {
+    }
+    GymBatch batch;
+};
+
+BallGym *ballgym_create(int num_envs, int rows, int cols, int colors, uint64_t seed, int threads)
+{
+    if (num_envs <= 0 || !GymBatch::fitsActions(rows, cols) || colors <= 0 || colors > 255) return nullptr;
+    GameRules rules;
+    rules.rows = rows;
+    rules.cols = cols;
+    rules.colorCount = colors;
+    return new (std::nothrow) BallGym(num_envs, rules, seed, threads);
+}
+
+void ballgym_destroy(BallGym *gym)
+{
+    delete gym;
+}
+
+int ballgym_num_envs(const BallGym *gym)
+{
+    return gym->batch.envCount();
+}
+
+int ballgym_cell_count(const BallGym *gym)
+{
+    return gym->batch.cellCount();
+}
+
+void ballgym_reset(BallGym *gym, uint8_t *observations)
+{
+    gym->batch.reset(observations);
+}
+
+void ballgym_step(BallGym *gym, const int32_t *actions, uint8_t *observations, float *rewards, uint8_t *dones)
+{
+    gym->batch.step(actions, observations, rewards, dones);
+}
+
+void ballgym_sample_actions(BallGym *gym, int32_t *actions)
+{
+    gym->batch.sampleActions(actions);
+}
@@ -0,0 +1,49 @@
+#ifndef BALLGYM_H
+#define BALLGYM_H
+
+/* C API over GymBatch for training agents (ctypes / cffi friendly).
+ *
+ * Layout per call, N = number of environments, C = rows * cols:
+ *   actions       int32[N]   from * C + to
+ *   observations  uint8[N*C] palette index per cell (0 = empty)
+ *   rewards       float[N]   balls cleared, -1 for an illegal action
+ *   dones         uint8[N]   1 = game over; that environment was reset
+ * No memory is allocated per step.
+ * Every action must fit an int32, so C may be at most 46340 cells
+ * (e.g. 215 x 215); ballgym_create returns NULL for larger boards. */
+
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(BALLGYM_BUILD)
+#define BALLGYM_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define BALLGYM_API __declspec(dllimport)
+#else
+#define BALLGYM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BallGym BallGym;
+
+/* colors: number of base colours (3 in the game); threads: -1 = one per core.
+ * NULL if a size is out of range (see above) or allocation fails. */
+BALLGYM_API BallGym *ballgym_create(int num_envs, int rows, int cols, int colors, uint64_t seed, int threads);
+BALLGYM_API void ballgym_destroy(BallGym *gym);
+
+BALLGYM_API int ballgym_num_envs(const BallGym *gym);
+BALLGYM_API int ballgym_cell_count(const BallGym *gym);
+
+BALLGYM_API void ballgym_reset(BallGym *gym, uint8_t *observations);
+BALLGYM_API void ballgym_step(BallGym *gym, const int32_t *actions, uint8_t *observations, float *rewards,
+                              uint8_t *dones);
+/* one random legal action per environment */
+BALLGYM_API void ballgym_sample_actions(BallGym *gym, int32_t *actions);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BALLGYM_H */
@@ -0,0 +1,34 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <chrono>
+
+// Các benchmark của lõi game, chạy bằng: ballgame_bench <tên> [tham số]
+int runLineScanBench(int argc, char **argv);
+int runBoardBench(int argc, char **argv);
+int runPathBench(int argc, char **argv);
+int runHintBench(int argc, char **argv);
+int runGymBench(int argc, char **argv);
+int runHistoryBench(int argc, char **argv);
+int runParticlesBench(int argc, char **argv);
+int runSaveBench(int argc, char **argv);
+int runPuzzleBench(int argc, char **argv);
+int runStreamBench(int argc, char **argv);
+int runShmBench(int argc, char **argv);
+int runTelemetryBench(int argc, char **argv);
+
+// Wall-clock stopwatch in microseconds
+class BenchTimer
+{
+public:
+    BenchTimer() : m_start(std::chrono::steady_clock::now()) {}
+    double elapsedUs() const
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // BENCH_H
@@ -0,0 +1,173 @@
+#include "bench.h"
+#include "../board.h"
+#include "../gameengine.h"
+#include "../linescan.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+template <class Geometry>
+int markAll(const Geometry &geo, const std::vector<uint8_t> &cells, std::vector<uint8_t> &mask)
+{
+    mask.assign(cells.size(), 0);
+    int marked = 0;
+    for (int cell = 0; cell < geo.cellCount(); ++cell)
+        marked += geo.markLinesThrough(cells.data(), cell, mask.data());
+    return marked;
+}
+
+template <class Geometry>
+double timeMarkAll(const Geometry &geo, const std::vector<std::vector<uint8_t>> &boards, int reps)
+{
+    std::vector<uint8_t> mask;
+    volatile unsigned sink = 0;
+    BenchTimer timer;
+    for (int rep = 0; rep < reps; ++rep)
+        for (const auto &cells : boards) sink = sink + markAll(geo, cells, mask);
+    return timer.elapsedUs() * 1000.0 / (double(reps) * boards.size() * geo.cellCount());
+}
+
+template <class Geometry>
+double timeNeighbours(const Geometry &geo, int reps)
+{
+    volatile unsigned sink = 0;
+    BenchTimer timer;
+    for (int rep = 0; rep < reps; ++rep) {
+        unsigned sum = 0;
+        for (int cell = 0; cell < geo.cellCount(); ++cell)
+            geo.forEachNeighbour(cell, [&](int n) { sum += unsigned(n); });
+        sink = sink + sum;
+    }
+    return timer.elapsedUs() * 1000.0 / (double(reps) * geo.cellCount());
+}
+
+// Board<> (bảng dựng sẵn) == DynamicBoard == LineScanner với cùng hướng
+template <class Geometry>
+bool verifyVariant(const char *name, const Geometry &fixed, int boardCount, std::mt19937 &rng)
+{
+    const int rows = fixed.rows(), cols = fixed.cols(), n = fixed.cellCount();
+    const unsigned dirs = fixed.lineDirections();
+    const DynamicBoard dynamic(rows, cols, fixed.lineLength(), dirs);
+    std::uniform_int_distribution<int> color(0, 3);
+    LineScanner scanner;
+    std::vector<uint8_t> cells(n), a, b, full(n);
+    for (int i = 0; i < boardCount; ++i) {
+        for (uint8_t &cell : cells) cell = static_cast<uint8_t>(color(rng));
+        const int fixedCount = markAll(fixed, cells, a);
+        const int dynamicCount = markAll(dynamic, cells, b);
+        const int fullCount = scanner.scan(cells.data(), rows, cols, fixed.lineLength(), full.data(), dirs);
+        if (a != b || a != full || fixedCount != dynamicCount || fixedCount != fullCount) {
+            std::fprintf(stderr, "MISMATCH between %s, DynamicBoard and LineScanner\n", name);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Bước engine / giây với một bộ luật (nước ngẫu nhiên, ván mới khi hết nước)
+double engineStepsPerSecond(const GameRules &rules, int steps)
+{
+    GameEngine engine(rules);
+    engine.reset(1);
+    Rng rng;
+    rng.setState(2);
+    BenchTimer timer;
+    for (int i = 0, games = 0; i < steps; ++i) {
+        int from, to;
+        if (!engine.randomMove(rng, from, to)) {
+            engine.reset(++games);
+            continue;
+        }
+        engine.step(from, to);
+    }
+    return steps / (timer.elapsedUs() / 1e6);
+}
+
+bool checkRulesParser()
+{
+    GameRules rules;
+    const bool ok = rules.parse("{\"lineLength\": 4, \"directions\": [\"horizontal\", \"vertical\"],"
+                                " \"movement\": \"jump\", \"spawnPerTurn\": 2, \"colorCount\": 7}");
+    if (!ok || rules.lineLength != 4 || rules.lineDirections != BoardDirections::Orthogonal
+        || rules.movement != GameRules::Movement::Jump || rules.spawnPerTurn != 2 || rules.colorCount != 7
+        || rules.rows != 10) {
+        std::fprintf(stderr, "FAIL: rules parser\n");
+        return false;
+    }
+    const char *bad[] = { "{\"lineLenght\": 4}", "{\"lineLength\": 1}", "{\"directions\": []}",
+                          "{\"movement\": \"fly\"}", "{\"colorCount\": 2.5}", "[1]", "{\"rows\": 10" };
+    for (const char *text : bad) {
+        GameRules copy;
+        std::string error;
+        if (copy.parse(text, &error) || error.empty() || copy.lineLength != 5) {
+            std::fprintf(stderr, "FAIL: rules parser accepted %s\n", text);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int runBoardBench(int, char **)
+{
+    const StandardBoard fixed;
+    const DynamicBoard dynamic(10, 10, 5);
+
+    // Union of the per-cell line checks must equal the full-board scan
+    std::mt19937 rng(777);
+    std::uniform_int_distribution<int> color(0, 3);
+    std::vector<std::vector<uint8_t>> boards(2000, std::vector<uint8_t>(100));
+    for (auto &cells : boards)
+        for (uint8_t &cell : cells) cell = static_cast<uint8_t>(color(rng));
+
+    LineScanner scanner;
+    std::vector<uint8_t> a, b, full(100);
+    for (const auto &cells : boards) {
+        const int fixedCount = markAll(fixed, cells, a);
+        const int dynamicCount = markAll(dynamic, cells, b);
+        const int fullCount = scanner.scan(cells.data(), 10, 10, 5, full.data());
+        if (a != b || a != full || fixedCount != dynamicCount || fixedCount != fullCount) {
+            std::fprintf(stderr, "MISMATCH between Board<10,10,5>, DynamicBoard and LineScanner\n");
+            return 1;
+        }
+    }
+    if (!verifyVariant("OrthogonalBoard", OrthogonalBoard(), 2000, rng) || !verifyVariant("ClassicBoard", ClassicBoard(), 2000, rng)
+        || !checkRulesParser())
+        return 1;
+    std::printf("verify: Board<10,10,5> == DynamicBoard == LineScanner on %zu boards "
+                "(also orthogonal-only and 9x9 tables, rules parser)\n\n", boards.size());
+
+    std::printf("%-22s %14s %14s\n", "10x10, line 5", "Board<> ns", "Dynamic ns");
+    std::printf("%-22s %14.2f %14.2f\n", "markLinesThrough/cell",
+                timeMarkAll(fixed, boards, 50), timeMarkAll(dynamic, boards, 50));
+    std::printf("%-22s %14.2f %14.2f\n", "forEachNeighbour/cell",
+                timeNeighbours(fixed, 200000), timeNeighbours(dynamic, 200000));
+
+    // Luật hay gặp chạy trên bảng dựng sẵn, luật khác trên DynamicBoard
+    struct Variant {
+        const char *name;
+        GameRules rules;
+    };
+    Variant variants[5];
+    variants[0].name = "standard 10x10";
+    variants[1].name = "orthogonal only";
+    variants[1].rules.lineDirections = BoardDirections::Orthogonal;
+    variants[2].name = "classic 9x9, 7 colours";
+    variants[2].rules.rows = variants[2].rules.cols = 9;
+    variants[2].rules.colorCount = 7;
+    variants[3].name = "free jump";
+    variants[3].rules.movement = GameRules::Movement::Jump;
+    variants[4].name = "11x11, line 4";
+    variants[4].rules.rows = variants[4].rules.cols = 11;
+    variants[4].rules.lineLength = 4;
+    std::printf("\n%-24s %12s %14s\n", "GameEngine rules", "tables", "steps/s");
+    for (const Variant &v : variants) {
+        std::printf("%-24s %12s %14.0f\n", v.name, v.rules.isSpecialised() ? "compiled" : "dynamic",
+                    engineStepsPerSecond(v.rules, 200000));
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "bench.h"
+#include "../ballgym.h"
+#include "../gymbatch.h"
+#include "../linescan.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct Buffers {
+    explicit Buffers(int envs, int cells)
+        : actions(envs), observations(static_cast<size_t>(envs) * cells), rewards(envs), dones(envs)
+    {
+    }
+    std::vector<int32_t> actions;
+    std::vector<uint8_t> observations;
+    std::vector<float> rewards;
+    std::vector<uint8_t> dones;
+};
+
+} // namespace
+
+int runGymBench(int, char **)
+{
+    GameRules rules;
+    LineScanner scanner;
+
+    // 1) same seed + same actions -> same trajectory, with or without threads;
+    //    no run of >= 5 is ever left on a board; sampled actions are legal
+    {
+        const int envs = 256, steps = 400;
+        GymBatch serial(envs, rules, 42, 0);
+        GymBatch threaded(envs, rules, 42, -1);
+        Buffers a(envs, serial.cellCount()), b(envs, serial.cellCount());
+        serial.reset(a.observations.data());
+        threaded.reset(b.observations.data());
+        long long games = 0;
+        for (int s = 0; s < steps; ++s) {
+            serial.sampleActions(a.actions.data());
+            threaded.step(a.actions.data(), b.observations.data(), b.rewards.data(), b.dones.data());
+            serial.step(a.actions.data(), a.observations.data(), a.rewards.data(), a.dones.data());
+            if (a.observations != b.observations || a.rewards != b.rewards || a.dones != b.dones) {
+                std::fprintf(stderr, "MISMATCH serial vs threaded batch at step %d\n", s);
+                return 1;
+            }
+            for (int i = 0; i < envs; ++i) {
+                games += a.dones[i];
+                if (a.rewards[i] < 0) {
+                    std::fprintf(stderr, "MISMATCH sampled action was illegal\n");
+                    return 1;
+                }
+                if (scanner.scan(serial.env(i).board(), rules.lineLength) != 0) {
+                    std::fprintf(stderr, "MISMATCH a complete line was left on the board\n");
+                    return 1;
+                }
+            }
+        }
+        std::printf("checked %d envs x %d steps (%lld games finished)\n", envs, steps, games);
+    }
+
+    // 2) the C API rejects boards whose actions would overflow int32
+    {
+        BallGym *largest = ballgym_create(1, 215, 215, 3, 1, 0);
+        if (!largest || ballgym_create(1, 216, 216, 3, 1, 0) || ballgym_create(1, 1, 50000, 3, 1, 0)
+            || ballgym_create(1, 0, 10, 3, 1, 0)) {
+            std::fprintf(stderr, "FAIL: ballgym_create size limits\n");
+            return 1;
+        }
+        ballgym_destroy(largest);
+    }
+
+    // 3) throughput through the C API
+    const int envCounts[] = { 1024, 4096, 16384 };
+    for (int envs : envCounts) {
+        BallGym *gym = ballgym_create(envs, rules.rows, rules.cols, rules.colorCount, 7, -1);
+        Buffers buf(envs, ballgym_cell_count(gym));
+        ballgym_reset(gym, buf.observations.data());
+        const int steps = 200;
+        double stepUs = 0;
+        long long cleared = 0, games = 0;
+        for (int s = 0; s < steps; ++s) {
+            ballgym_sample_actions(gym, buf.actions.data());
+            BenchTimer timer;
+            ballgym_step(gym, buf.actions.data(), buf.observations.data(), buf.rewards.data(), buf.dones.data());
+            stepUs += timer.elapsedUs();
+            for (int i = 0; i < envs; ++i) {
+                cleared += static_cast<long long>(buf.rewards[i]);
+                games += buf.dones[i];
+            }
+        }
+        std::printf("%6d envs: %6.2f M steps/s  (%lld balls cleared, %lld games)\n", envs,
+                    double(envs) * steps / stepUs, cleared, games);
+        ballgym_destroy(gym);
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "bench.h"
+#include "../emptyregions.h"
+#include "../gameboard.h"
+#include "../hintengine.h"
+#include "../linescan.h"
+#include "../pathfinder.h"
+#include "../workerpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+bool sameMoves(const std::vector<HintMove> &a, const std::vector<HintMove> &b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].from != b[i].from || a[i].to != b[i].to || a[i].score != b[i].score) return false;
+    }
+    return true;
+}
+
+// Random board with no complete line left on it (like a board between turns)
+GameBoard randomBoard(int size, double density, std::mt19937 &rng, LineScanner &scanner)
+{
+    GameBoard board(size, size);
+    std::uniform_real_distribution<double> fill(0.0, 1.0);
+    std::uniform_int_distribution<int> color(1, 7);
+    for (int cell = 0; cell < board.cellCount(); ++cell)
+        board.data()[cell] = fill(rng) < density ? static_cast<uint8_t>(color(rng)) : 0;
+    while (scanner.scan(board, 5) > 0) {
+        const std::vector<uint8_t> &mask = scanner.mask();
+        for (int cell = 0; cell < board.cellCount(); ++cell)
+            if (mask[cell]) board.data()[cell] = 0;
+    }
+    return board;
+}
+
+// parallelFor inside a chunk of the same pool (e.g. a hint search that calls
+// into other parallel code) must run inline instead of deadlocking
+bool checkNestedParallelFor()
+{
+    WorkerPool pool(3);
+    std::atomic<long long> sum{0};
+    pool.parallelFor(64, 4, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            pool.parallelFor(100, 10, [&](int b, int e) {
+                for (int j = b; j < e; ++j) sum.fetch_add(i * 100 + j, std::memory_order_relaxed);
+            });
+        }
+    });
+    const long long n = 64 * 100;
+    return sum.load() == n * (n - 1) / 2;
+}
+
+} // namespace
+
+int runHintBench(int, char **)
+{
+    if (!checkNestedParallelFor()) {
+        std::fprintf(stderr, "MISMATCH nested parallelFor sum\n");
+        return 1;
+    }
+    std::mt19937 rng(31);
+    LineScanner scanner;
+    WorkerPool serialPool(0);
+    HintEngine serial(serialPool);
+    HintEngine parallel(WorkerPool::shared());
+
+    // 1) same hints with and without threads; cleared / reachability agree
+    //    with LineScanner / PathFinder
+    std::vector<GameBoard> boards;
+    for (int i = 0; i < 300; ++i) boards.push_back(randomBoard(10, 0.25 + 0.5 * (i % 10) / 10.0, rng, scanner));
+    std::vector<int> path;
+    for (GameBoard &board : boards) {
+        const EmptyRegions regions(board);
+        const std::vector<HintMove> a = serial.bestMoves(board, regions, 5);
+        const std::vector<HintMove> &b = parallel.bestMoves(board, regions, 5);
+        if (!sameMoves(a, b)) {
+            std::fprintf(stderr, "MISMATCH serial vs parallel hints\n");
+            return 1;
+        }
+        PathFinder finder(board);
+        for (const HintMove &move : a) {
+            if (!finder.findPath(move.from, move.to, path)) {
+                std::fprintf(stderr, "MISMATCH hint move %d -> %d has no path\n", move.from, move.to);
+                return 1;
+            }
+            GameBoard after = board;
+            after.data()[move.to] = after.data()[move.from];
+            after.data()[move.from] = 0;
+            if (scanner.scan(after, 5) != move.cleared) {
+                std::fprintf(stderr, "MISMATCH hint cleared %d vs scan %d\n", move.cleared, scanner.scan(after, 5));
+                return 1;
+            }
+        }
+    }
+
+    // 2) time per hint (top 3)
+    std::printf("%-14s %10s %12s %12s %8s\n", "board", "moves", "serial us", "parallel us", "threads");
+    const struct { int size; double density; int reps; } cases[] = {
+        { 10, 0.3, 2000 }, { 10, 0.5, 2000 }, { 10, 0.7, 2000 }, { 20, 0.5, 200 }, { 40, 0.5, 20 },
+    };
+    for (const auto &c : cases) {
+        const GameBoard board = randomBoard(c.size, c.density, rng, scanner);
+        const EmptyRegions regions(board);
+        BenchTimer serialTimer;
+        for (int i = 0; i < c.reps; ++i) serial.bestMoves(board, regions, 3);
+        const double serialUs = serialTimer.elapsedUs() / c.reps;
+        BenchTimer parallelTimer;
+        for (int i = 0; i < c.reps; ++i) parallel.bestMoves(board, regions, 3);
+        const double parallelUs = parallelTimer.elapsedUs() / c.reps;
+
+        char label[32];
+        std::snprintf(label, sizeof(label), "%dx%d @%.0f%%", c.size, c.size, c.density * 100);
+        std::printf("%-14s %10d %12.1f %12.1f %8d\n", label, parallel.lastMoveCount(), serialUs, parallelUs,
+                    WorkerPool::shared().concurrency());
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "bench.h"
+#include "../gameengine.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct Snapshot {
+    std::vector<uint8_t> cells;
+    uint64_t rng;
+    int score;
+    int emptyCount;
+    int regionCount;
+};
+
+Snapshot snapshot(GameEngine &engine)
+{
+    const GameBoard &board = engine.board();
+    return Snapshot{std::vector<uint8_t>(board.data(), board.data() + board.cellCount()), engine.rng().state(),
+                    engine.score(), engine.regions().emptyCount(), engine.regions().regionCount()};
+}
+
+bool same(const Snapshot &a, const Snapshot &b)
+{
+    return a.cells == b.cells && a.rng == b.rng && a.score == b.score && a.emptyCount == b.emptyCount
+           && a.regionCount == b.regionCount;
+}
+
+} // namespace
+
+int runHistoryBench(int, char **)
+{
+    // 1) every turn undone and redone restores board, regions, RNG and score
+    Rng policy(99);
+    long long turns = 0;
+    size_t bytes = 0;
+    for (int game = 0; game < 300; ++game) {
+        GameEngine engine;
+        engine.setHistoryEnabled(true);
+        engine.reset(1000 + game);
+        std::vector<Snapshot> states{snapshot(engine)};
+        int from = 0, to = 0;
+        while (engine.randomMove(policy, from, to)) {
+            engine.step(from, to);
+            states.push_back(snapshot(engine));
+        }
+        for (int i = static_cast<int>(states.size()) - 2; i >= 0; --i) {
+            if (!engine.undo() || !same(snapshot(engine), states[i])) {
+                std::fprintf(stderr, "MISMATCH undo to turn %d of game %d\n", i, game);
+                return 1;
+            }
+        }
+        for (size_t i = 1; i < states.size(); ++i) {
+            if (!engine.redo() || !same(snapshot(engine), states[i])) {
+                std::fprintf(stderr, "MISMATCH redo to turn %zu of game %d\n", i, game);
+                return 1;
+            }
+        }
+        // a new turn after undo drops the redo branch and continues deterministically
+        engine.undo();
+        const Snapshot before = snapshot(engine);
+        engine.randomMove(policy, from, to);
+        engine.step(from, to);
+        if (engine.history().canRedo() || engine.history().turnCount() != engine.turns()) {
+            std::fprintf(stderr, "MISMATCH redo branch not truncated\n");
+            return 1;
+        }
+        engine.undo();
+        if (!same(snapshot(engine), before)) {
+            std::fprintf(stderr, "MISMATCH undo after branch\n");
+            return 1;
+        }
+        turns += static_cast<long long>(states.size()) - 1;
+        bytes += engine.history().memoryBytes();
+    }
+    std::printf("checked %lld turns in 300 games, history %.1f bytes/turn (board copy: %d bytes)\n", turns,
+                double(bytes) / turns, 100);
+
+    // 2) bot "try move, then revert": step + undo vs copying the engine state
+    GameEngine engine;
+    engine.setHistoryEnabled(true);
+    engine.reset(5);
+    for (int i = 0; i < 10; ++i) {
+        int from = 0, to = 0;
+        engine.randomMove(policy, from, to);
+        engine.step(from, to);
+    }
+    std::vector<std::pair<int, int>> moves;
+    for (int i = 0; i < 20000; ++i) {
+        int from = 0, to = 0;
+        engine.randomMove(policy, from, to);
+        moves.emplace_back(from, to);
+    }
+    BenchTimer tryTimer;
+    long long cleared = 0;
+    for (const auto &move : moves) {
+        cleared += engine.step(move.first, move.second).cleared;
+        engine.undo();
+    }
+    const double tryUs = tryTimer.elapsedUs() / moves.size();
+
+    BenchTimer cloneTimer;
+    for (const auto &move : moves) {
+        auto copy = std::make_unique<GameEngine>(engine.rules());
+        copy->reset(1);     // stands in for restoring a full copy of the state
+        cleared += copy->step(move.first, move.second).cleared;
+    }
+    const double cloneUs = cloneTimer.elapsedUs() / moves.size();
+    std::printf("try+revert: %.2f us/move via undo, %.2f us/move via a fresh engine (%lld)\n", tryUs, cloneUs,
+                cleared);
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "bench.h"
+#include "../linescan.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Random board with runs long enough to actually trigger removals
+void fillBoard(std::vector<uint8_t> &cells, int rows, int cols, int colors, double density, std::mt19937 &rng)
+{
+    std::uniform_real_distribution<double> fill(0.0, 1.0);
+    std::uniform_int_distribution<int> color(1, colors);
+    cells.assign(static_cast<size_t>(rows) * cols, 0);
+    for (uint8_t &cell : cells) {
+        if (fill(rng) < density) cell = static_cast<uint8_t>(color(rng));
+    }
+}
+
+const LineScanner::Kernel kKernels[] = {
+    LineScanner::Kernel::Scalar, LineScanner::Kernel::Sse2, LineScanner::Kernel::Avx2
+};
+
+// Every supported kernel must give exactly the scalar mask
+bool verify(std::mt19937 &rng)
+{
+    LineScanner reference(LineScanner::Kernel::Scalar);
+    std::vector<uint8_t> cells, expected, actual;
+    std::uniform_int_distribution<int> dim(1, 70);
+    std::uniform_int_distribution<int> len(1, 9);
+    std::uniform_int_distribution<int> colors(1, 4);
+    std::uniform_real_distribution<double> density(0.2, 1.0);
+
+    for (int iter = 0; iter < 3000; ++iter) {
+        const int rows = dim(rng), cols = dim(rng), minLen = len(rng);
+        fillBoard(cells, rows, cols, colors(rng), density(rng), rng);
+        expected.assign(cells.size(), 0);
+        const int expectedCount = reference.scan(cells.data(), rows, cols, minLen, expected.data());
+
+        for (LineScanner::Kernel kernel : kKernels) {
+            if (!LineScanner::isSupported(kernel)) continue;
+            LineScanner scanner(kernel);
+            actual.assign(cells.size(), 0xAA);
+            const int count = scanner.scan(cells.data(), rows, cols, minLen, actual.data());
+            if (count != expectedCount || actual != expected) {
+                std::fprintf(stderr, "MISMATCH kernel=%s rows=%d cols=%d minLen=%d\n",
+                             LineScanner::kernelName(kernel), rows, cols, minLen);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int runLineScanBench(int argc, char **argv)
+{
+    int minLen = 5;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--min-len") == 0) minLen = std::atoi(argv[++i]);
+    }
+
+    std::mt19937 rng(12345);
+    if (!verify(rng)) return 1;
+    std::printf("verify: all kernels match scalar bit for bit\n");
+    std::printf("best kernel: %s\n\n", LineScanner::kernelName(LineScanner::bestKernel()));
+
+    const int sizes[] = { 10, 30, 100, 300, 1000 };
+    std::printf("%-10s %-8s %12s %12s %8s\n", "board", "kernel", "us/scan", "Mcells/s", "marked");
+    std::vector<uint8_t> cells, mask;
+    for (int size : sizes) {
+        fillBoard(cells, size, size, 3, 0.7, rng);
+        mask.assign(cells.size(), 0);
+        // khoảng 20M ô mỗi phép đo, tối thiểu 5 lần quét
+        const int reps = std::max(5, 20000000 / (size * size));
+
+        for (LineScanner::Kernel kernel : kKernels) {
+            if (!LineScanner::isSupported(kernel)) continue;
+            LineScanner scanner(kernel);
+            int marked = scanner.scan(cells.data(), size, size, minLen, mask.data()); // warm-up
+            BenchTimer timer;
+            for (int rep = 0; rep < reps; ++rep)
+                marked = scanner.scan(cells.data(), size, size, minLen, mask.data());
+            const double us = timer.elapsedUs() / reps;
+            char board[32];
+            std::snprintf(board, sizeof(board), "%dx%d", size, size);
+            std::printf("%-10s %-8s %12.2f %12.1f %8d\n", board, LineScanner::kernelName(kernel),
+                        us, size * size / us, marked);
+        }
+    }
+    return 0;
+}
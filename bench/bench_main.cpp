@@ -0,0 +1,51 @@
+#include "bench.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+struct BenchEntry {
+    const char *name;
+    int (*run)(int argc, char **argv);
+    const char *help;
+};
+
+const BenchEntry kBenches[] = {
+    { "lines", runLineScanBench, "SIMD line scan vs scalar, 10x10 .. 1000x1000" },
+    { "board", runBoardBench,    "Board<10,10,5> tables vs DynamicBoard" },
+    { "path",  runPathBench,     "legacy A* vs A*, JPS and HPA* (length parity and speed)" },
+    { "hint",  runHintBench,     "best-move hint: serial vs worker pool, checked against scan/path" },
+    { "gym",   runGymBench,      "batched environments: determinism and steps per second" },
+    { "history", runHistoryBench, "undo/redo deltas: exact restore, bytes per turn, try+revert" },
+    { "particles", runParticlesBench, "line-clear particle pool: capped frame cost under huge chain clears" },
+    { "save", runSaveBench,      "streaming save reader: validation, MB/s and peak RSS on a huge save [side]" },
+    { "puzzle", runPuzzleBench,  "puzzle generator: verified K-move puzzles per second [count] [K]" },
+    { "stream", runStreamBench,  "spectator stream: turn deltas vs snapshots, chunked decode check [games]" },
+    { "shm", runShmBench,        "shared-memory board export: seqlock consistency under a live writer [side] [writes]" },
+    { "telemetry", runTelemetryBench, "telemetry ring file: wrap-around, reuse across sessions, ns per record" },
+};
+
+void printUsage(const char *program)
+{
+    std::printf("Usage: %s <benchmark> [options]\n\nBenchmarks:\n", program);
+    for (const BenchEntry &entry : kBenches)
+        std::printf("  %-10s %s\n", entry.name, entry.help);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    for (const BenchEntry &entry : kBenches) {
+        if (std::strcmp(argv[1], entry.name) == 0)
+            return entry.run(argc - 1, argv + 1);
+    }
+    std::fprintf(stderr, "Unknown benchmark: %s\n", argv[1]);
+    printUsage(argv[0]);
+    return 2;
+}
@@ -0,0 +1,49 @@
+#include "bench.h"
+#include "../particlesystem.h"
+
+#include <algorithm>
+#include <cstdio>
+
+// Chain clear on a 1000x1000 board: every frame tries to burst far more
+// balls than the pool holds. Frame cost must stay flat at the capacity.
+int runParticlesBench(int, char **)
+{
+    ParticleSystem particles;
+    const int frames = 2000;
+    const int burstsPerFrame = 20000;
+    const float dt = 1.0f / 60.0f;
+
+    long long emitted = 0;
+    int peak = 0;
+    double worstUs = 0;
+    BenchTimer total;
+    for (int frame = 0; frame < frames; ++frame) {
+        BenchTimer timer;
+        for (int b = 0; b < burstsPerFrame && particles.freeSlots() > 0; ++b) {
+            emitted += particles.burst((b * 7919) % 1000 + 0.5f, (b * 104729) % 1000 + 0.5f, static_cast<uint8_t>(1 + b % 12));
+        }
+        particles.update(dt);
+        worstUs = std::max(worstUs, timer.elapsedUs());
+        if (particles.size() > peak) peak = particles.size();
+        if (particles.size() > particles.capacity()) {
+            std::fprintf(stderr, "FAIL: %d particles > capacity %d\n", particles.size(), particles.capacity());
+            return 1;
+        }
+    }
+    const double avgUs = total.elapsedUs() / frames;
+
+    // pool drains completely once bursts stop
+    int drainFrames = 0;
+    while (!particles.empty() && drainFrames < 600) {
+        particles.update(dt);
+        ++drainFrames;
+    }
+    if (!particles.empty()) {
+        std::fprintf(stderr, "FAIL: %d particles still alive after 10 s\n", particles.size());
+        return 1;
+    }
+
+    std::printf("capacity %d, peak %d live, %lld emitted over %d frames\n", particles.capacity(), peak, emitted, frames);
+    std::printf("emit+update: %.1f us/frame avg, %.1f us worst; drained in %d frames\n", avgUs, worstUs, drainFrames);
+    return 0;
+}
@@ -0,0 +1,330 @@
+#include "bench.h"
+#include "../emptyregions.h"
+#include "../gameboard.h"
+#include "../pathfinder.h"
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Replica of the original MainWindow::findPath: three fresh grids per call
+// and an O(balls) occupancy test for every neighbour.
+struct LegacyAStar {
+    const GameBoard &board;
+    std::vector<int> balls;     // cell of every ball
+
+    bool occupiedExcept(int r, int c, int excludeCell) const
+    {
+        for (int cell : balls) {
+            if (cell == excludeCell) continue;
+            if (cell / board.cols() == r && cell % board.cols() == c) return true;
+        }
+        return false;
+    }
+
+    int pathLength(int start, int target) const
+    {
+        const int R = board.rows(), C = board.cols();
+        const int sr = start / C, sc = start % C, tr = target / C, tc = target % C;
+        struct Node {
+            int r, c, f, g;
+            bool operator<(const Node &o) const { return f > o.f; }
+        };
+        std::vector<std::vector<int>> gscore(R, std::vector<int>(C, INT_MAX));
+        std::vector<std::vector<int>> parent(R, std::vector<int>(C, -1));
+        std::vector<std::vector<bool>> closed(R, std::vector<bool>(C, false));
+        auto heuristic = [&](int r, int c) { return std::abs(r - tr) + std::abs(c - tc); };
+        std::priority_queue<Node> open;
+        gscore[sr][sc] = 0;
+        open.push(Node{sr, sc, heuristic(sr, sc), 0});
+        const int dr[4] = {-1, 1, 0, 0};
+        const int dc[4] = {0, 0, -1, 1};
+        while (!open.empty()) {
+            Node cur = open.top();
+            open.pop();
+            if (closed[cur.r][cur.c]) continue;
+            closed[cur.r][cur.c] = true;
+            if (cur.r == tr && cur.c == tc) break;
+            for (int k = 0; k < 4; ++k) {
+                const int nr = cur.r + dr[k], nc = cur.c + dc[k];
+                if (nr < 0 || nr >= R || nc < 0 || nc >= C) continue;
+                if (occupiedExcept(nr, nc, start)) continue;
+                const int g = gscore[cur.r][cur.c] + 1;
+                if (g < gscore[nr][nc]) {
+                    gscore[nr][nc] = g;
+                    parent[nr][nc] = cur.r * C + cur.c;
+                    open.push(Node{nr, nc, g + heuristic(nr, nc), g});
+                }
+            }
+        }
+        return gscore[tr][tc] == INT_MAX ? -1 : gscore[tr][tc] + 1;
+    }
+};
+
+struct Query {
+    int start;
+    int target;
+};
+
+// A path must start/end right, move one step at a time and only cross empty cells
+bool validPath(const GameBoard &board, const std::vector<int> &path, const Query &q)
+{
+    if (path.empty() || path.front() != q.start || path.back() != q.target) return false;
+    for (size_t i = 1; i < path.size(); ++i) {
+        const int a = path[i - 1], b = path[i], C = board.cols();
+        if (std::abs(a / C - b / C) + std::abs(a % C - b % C) != 1) return false;
+        if (board.data()[b] != GameBoard::Empty) return false;
+    }
+    return true;
+}
+
+// HPA* of a finder updated through cellChanged() against a fresh one on the same
+// board: same reachability and same path length for a sample of queries
+bool sameAsFresh(const GameBoard &board, PathFinder &incremental, const std::vector<Query> &qs, std::mt19937 &rng)
+{
+    PathFinder fresh(board);
+    fresh.boardReset();
+    std::uniform_int_distribution<size_t> pickQuery(0, qs.size() - 1);
+    std::vector<int> a, b;
+    for (int i = 0; i < 32; ++i) {
+        const Query &q = qs[pickQuery(rng)];
+        if (board.data()[q.start] == GameBoard::Empty || board.data()[q.target] != GameBoard::Empty) continue;
+        const bool foundA = incremental.findPath(q.start, q.target, a, PathFinder::Algorithm::Hierarchical);
+        const bool foundB = fresh.findPath(q.start, q.target, b, PathFinder::Algorithm::Hierarchical);
+        if (foundA != foundB || (foundA && (!validPath(board, a, q) || a.size() != b.size()))) return false;
+    }
+    return true;
+}
+
+// Incrementally updated regions against EmptyRegions built from scratch: same
+// counts, the empty-cell list matches the board, and the labels of empty
+// cells map one-to-one with the same sizes
+bool sameRegions(const GameBoard &board, const EmptyRegions &incremental)
+{
+    const EmptyRegions fresh(board);
+    if (incremental.emptyCount() != fresh.emptyCount() || incremental.regionCount() != fresh.regionCount())
+        return false;
+    // emptyCell() lists each empty cell exactly once
+    std::vector<uint8_t> listed(board.cellCount(), 0);
+    for (int i = 0; i < incremental.emptyCount(); ++i) {
+        const int cell = incremental.emptyCell(i);
+        if (board.data()[cell] != GameBoard::Empty || listed[cell]++) return false;
+    }
+    std::vector<int> toFresh(incremental.idCapacity(), -1), toIncremental(fresh.idCapacity(), -1);
+    for (int cell = 0; cell < board.cellCount(); ++cell) {
+        const int a = incremental.regionOf(cell), b = fresh.regionOf(cell);
+        if ((a < 0) != (b < 0) || (a < 0) != (board.data()[cell] != GameBoard::Empty)) return false;
+        if (a < 0) continue;
+        if (toFresh[a] < 0 && toIncremental[b] < 0) {
+            if (incremental.regionSize(a) != fresh.regionSize(b)) return false;
+            toFresh[a] = b;
+            toIncremental[b] = a;
+        } else if (toFresh[a] != b || toIncremental[b] != a) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Random fills and clears on small boards, compared after every change
+bool checkRegions(std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> dim(1, 24);
+    std::uniform_real_distribution<double> fill(0.0, 1.0);
+    for (int iter = 0; iter < 200; ++iter) {
+        GameBoard board(dim(rng), dim(rng));
+        const double density = fill(rng);
+        for (int cell = 0; cell < board.cellCount(); ++cell) board.data()[cell] = fill(rng) < density ? 1 : 0;
+        EmptyRegions regions(board);
+        std::uniform_int_distribution<int> pickCell(0, board.cellCount() - 1);
+        for (int step = 0; step < 200; ++step) {
+            const int cell = pickCell(rng);
+            board.data()[cell] = board.data()[cell] == GameBoard::Empty ? 1 : GameBoard::Empty;
+            regions.cellChanged(cell);
+            if (!sameRegions(board, regions)) {
+                std::fprintf(stderr, "MISMATCH incremental regions vs fresh on %dx%d at step %d\n",
+                             board.rows(), board.cols(), step);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+struct Result {
+    double us = 0;
+    long long length = 0;
+    int found = 0;
+};
+
+int runCase(int size, double density, int queries, std::mt19937 &rng, bool withLegacy)
+{
+    GameBoard board(size, size);
+    std::uniform_real_distribution<double> fill(0.0, 1.0);
+    std::vector<int> ballCells, emptyCells;
+    for (int cell = 0; cell < board.cellCount(); ++cell) {
+        if (fill(rng) < density) {
+            board.data()[cell] = 1;
+            ballCells.push_back(cell);
+        } else {
+            emptyCells.push_back(cell);
+        }
+    }
+
+    std::vector<Query> qs;
+    std::uniform_int_distribution<size_t> pickBall(0, ballCells.size() - 1);
+    std::uniform_int_distribution<size_t> pickEmpty(0, emptyCells.size() - 1);
+    for (int i = 0; i < queries; ++i) qs.push_back(Query{ballCells[pickBall(rng)], emptyCells[pickEmpty(rng)]});
+
+    PathFinder finder(board);
+    const PathFinder::Algorithm algorithms[] = {
+        PathFinder::Algorithm::AStar, PathFinder::Algorithm::JumpPoint, PathFinder::Algorithm::Hierarchical
+    };
+    Result results[3];
+    std::vector<int> expected(qs.size());
+    std::vector<int> path;
+
+    // reference lengths from the new A* (checked against the replica below)
+    for (size_t i = 0; i < qs.size(); ++i)
+        expected[i] = finder.findPath(qs[i].start, qs[i].target, path, PathFinder::Algorithm::AStar)
+                          ? static_cast<int>(path.size()) : -1;
+
+    double legacyUs = -1;
+    if (withLegacy) {
+        LegacyAStar legacy{board, ballCells};
+        BenchTimer timer;
+        for (size_t i = 0; i < qs.size(); ++i) {
+            if (legacy.pathLength(qs[i].start, qs[i].target) != expected[i]) {
+                std::fprintf(stderr, "MISMATCH legacy A* vs A* on %dx%d\n", size, size);
+                return 1;
+            }
+        }
+        legacyUs = timer.elapsedUs() / qs.size();
+    }
+
+    for (int a = 0; a < 3; ++a) {
+        finder.boardReset();
+        finder.findPath(qs[0].start, qs[0].target, path, algorithms[a]);    // build HPA* clusters once
+        BenchTimer timer;
+        for (const Query &q : qs) {
+            if (finder.findPath(q.start, q.target, path, algorithms[a])) {
+                results[a].found++;
+                results[a].length += static_cast<long long>(path.size());
+            }
+        }
+        results[a].us = timer.elapsedUs() / qs.size();
+
+        // correctness pass (outside the timing)
+        for (size_t i = 0; i < qs.size(); ++i) {
+            const bool found = finder.findPath(qs[i].start, qs[i].target, path, algorithms[a]);
+            if (found != (expected[i] >= 0) || (found && !validPath(board, path, qs[i]))) {
+                std::fprintf(stderr, "MISMATCH %s reachability/validity on %dx%d\n",
+                             PathFinder::algorithmName(algorithms[a]), size, size);
+                return 1;
+            }
+            if (algorithms[a] != PathFinder::Algorithm::Hierarchical && found
+                && static_cast<int>(path.size()) != expected[i]) {
+                std::fprintf(stderr, "MISMATCH %s length on %dx%d\n", PathFinder::algorithmName(algorithms[a]), size, size);
+                return 1;
+            }
+        }
+    }
+
+    char label[48];
+    std::snprintf(label, sizeof(label), "%dx%d @%.0f%%", size, size, density * 100);
+    if (legacyUs < 0) std::printf("%-18s %10s", label, "-");
+    else std::printf("%-18s %10.1f", label, legacyUs);
+    for (const Result &r : results) std::printf(" %10.1f", r.us);
+    const double ratio = results[0].length ? double(results[2].length) / results[0].length : 1.0;
+    std::printf(" %10.3f %7d/%d\n", ratio, results[0].found, queries);
+
+    // incremental HPA*: move balls between queries so clusters get rebuilt
+    std::uniform_int_distribution<size_t> pickQuery(0, qs.size() - 1);
+    int moves = 0;
+    double incrementalUs = 0;
+    EmptyRegions regions(board);
+    for (int i = 0; i < queries; ++i) {
+        BenchTimer timer;
+        const Query &q = qs[pickQuery(rng)];
+        if (board.data()[q.start] == GameBoard::Empty || board.data()[q.target] != GameBoard::Empty) continue;
+        if (!finder.findPath(q.start, q.target, path, PathFinder::Algorithm::Hierarchical)) continue;
+        std::swap(board.data()[q.start], board.data()[q.target]);
+        finder.cellChanged(q.start);
+        finder.cellChanged(q.target);
+        ++moves;
+        incrementalUs += timer.elapsedUs();
+        regions.cellChanged(q.start);
+        regions.cellChanged(q.target);
+        // sau mỗi lô nước đi (ngoài phần đo): cluster cập nhật dần phải cho cùng
+        // kết quả với một PathFinder dựng lại từ đầu
+        if (moves % 64 == 0 || i == queries - 1) {
+            if (!sameAsFresh(board, finder, qs, rng)) {
+                std::fprintf(stderr, "MISMATCH incremental hpa vs fresh boardReset on %dx%d after %d moves\n",
+                             size, size, moves);
+                return 1;
+            }
+            if (!sameRegions(board, regions)) {
+                std::fprintf(stderr, "MISMATCH incremental regions vs fresh on %dx%d after %d moves\n",
+                             size, size, moves);
+                return 1;
+            }
+        }
+    }
+    std::printf("%-18s hpa with incremental cluster updates: %.1f us per query+move (%d moves, checked)\n",
+                "", incrementalUs / std::max(1, moves), moves);
+    return 0;
+}
+
+} // namespace
+
+int runPathBench(int, char **)
+{
+    // bàn đổi kích thước (--board, setBoardSize): boardReset chọn lại thuật toán,
+    // trừ khi setAlgorithm đã chọn cố định
+    {
+        GameBoard board(10, 10);
+        PathFinder finder(board);
+        board.reset(1000, 1000);
+        finder.boardReset();
+        if (finder.algorithm() != PathFinder::Algorithm::Hierarchical) {
+            std::fprintf(stderr, "FAIL: boardReset kept %s on 1000x1000\n", PathFinder::algorithmName(finder.algorithm()));
+            return 1;
+        }
+        finder.setAlgorithm(PathFinder::Algorithm::AStar);
+        board.reset(10, 10);
+        finder.boardReset();
+        if (finder.algorithm() != PathFinder::Algorithm::AStar) {
+            std::fprintf(stderr, "FAIL: boardReset overrode setAlgorithm\n");
+            return 1;
+        }
+    }
+
+    std::mt19937 rng(2024);
+    if (!checkRegions(rng)) return 1;
+    std::printf("verify: incremental empty regions match a fresh labelling\n");
+    std::printf("%-18s %10s %10s %10s %10s %10s %10s\n", "board", "legacy us", "astar us", "jps us", "hpa us",
+                "hpa/opt", "found");
+    struct Case {
+        int size;
+        double density;
+        int queries;
+        bool legacy;
+    };
+    const Case cases[] = {
+        { 10, 0.5, 20000, true },
+        { 10, 0.2, 20000, true },
+        { 100, 0.3, 1000, true },
+        { 300, 0.2, 200, false },
+        { 1000, 0.1, 50, false },
+        { 1000, 0.3, 50, false },
+    };
+    for (const Case &c : cases) {
+        if (runCase(c.size, c.density, c.queries, rng, c.legacy) != 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "bench.h"
+#include "../puzzle.h"
+#include "../workerpool.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+uint64_t digest(const std::vector<Puzzle> &puzzles)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const Puzzle &p : puzzles) {
+        for (uint8_t cell : p.cells) hash = (hash ^ cell) * 1099511628211ull;
+        for (const PuzzleMove &m : p.solution) hash = (hash ^ uint64_t(m.from) << 16 ^ uint64_t(m.to)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+// Sinh N puzzle "xóa hết trong K nước" song song, chạy lại từng lời giải và
+// so kết quả với bản chạy 1 luồng (phải giống hệt, theo seed từng puzzle).
+int runPuzzleBench(int argc, char **argv)
+{
+    const int count = argc > 1 ? std::atoi(argv[1]) : 1000;
+    const int moves = argc > 2 ? std::atoi(argv[2]) : 3;
+    if (count < 1 || moves < 1 || moves > 12) {
+        std::fprintf(stderr, "usage: puzzle [count] [moves 1..12]\n");
+        return 2;
+    }
+
+    PuzzleGenerator::Options options;
+    options.moves = moves;
+    WorkerPool &pool = WorkerPool::shared();
+
+    PuzzleGenerator::Stats stats;
+    BenchTimer timer;
+    const std::vector<Puzzle> puzzles = PuzzleGenerator::generate(count, 42, options, pool, &stats);
+    const double seconds = timer.elapsedUs() / 1e6;
+
+    int solutionMoves = 0;
+    for (const Puzzle &puzzle : puzzles) {
+        if (!puzzle.verify()) {
+            std::fprintf(stderr, "FAIL: puzzle seed %llu: solution does not clear the board\n",
+                         static_cast<unsigned long long>(puzzle.seed));
+            return 1;
+        }
+        solutionMoves += static_cast<int>(puzzle.solution.size());
+    }
+
+    const int checkCount = count < 64 ? count : 64;
+    WorkerPool single(0);
+    BenchTimer serialTimer;
+    const std::vector<Puzzle> serial = PuzzleGenerator::generate(checkCount, 42, options, single);
+    const double serialSeconds = serialTimer.elapsedUs() / 1e6;
+    const std::vector<Puzzle> head = PuzzleGenerator::generate(checkCount, 42, options, pool);
+    if (digest(serial) != digest(head)) {
+        std::fprintf(stderr, "FAIL: puzzles differ between 1 and %d threads\n", pool.concurrency());
+        return 1;
+    }
+
+    const GameRules &rules = options.rules;
+    std::printf("%dx%d, line %d, %d colours, K = %d\n", rules.rows, rules.cols, rules.lineLength, rules.colorCount,
+                moves);
+    std::printf("%zu/%d puzzles in %.3f s (%.0f puzzles/s, %d threads), all solutions verified\n", puzzles.size(),
+                count, seconds, puzzles.size() / seconds, pool.concurrency());
+    std::printf("attempts %.2f per puzzle, %.0f search nodes per puzzle, memo hits %lld, mean solution %.2f moves\n",
+                double(stats.attempts) / count, double(stats.nodes) / count, static_cast<long long>(stats.memoHits),
+                puzzles.empty() ? 0.0 : double(solutionMoves) / puzzles.size());
+    std::printf("dead-end first moves %.2f per puzzle, %.2f lines per puzzle wait for another line\n",
+                puzzles.empty() ? 0.0 : double(stats.deadEnds) / puzzles.size(),
+                puzzles.empty() ? 0.0 : double(stats.ordered) / puzzles.size());
+    std::printf("1 thread: %d puzzles in %.3f s (%.0f puzzles/s), identical output\n", checkCount, serialSeconds,
+                checkCount / serialSeconds);
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include "bench.h"
+#include "../powermetrics.h"
+#include "../rng.h"
+#include "../savestream.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Digest {
+    int balls = 0;
+    uint64_t sum = 0;
+
+    void add(int row, int col, uint32_t color)
+    {
+        ++balls;
+        sum = sum * 1099511628211ull + (uint64_t(row) << 40 ^ uint64_t(col) << 16 ^ color);
+    }
+};
+
+// Như QJsonDocument::toJson(Indented): key theo thứ tự chữ cái, balls trước palette
+Digest writeSave(std::FILE *out, int side, uint64_t seed)
+{
+    Rng rng;
+    rng.setState(seed);
+    Digest digest;
+    std::fputs("{\n    \"balls\": [\n", out);
+    bool first = true;
+    int id = 0;
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            if (rng.below(2) == 0) continue;
+            const uint32_t color = rng.range(1, 12);
+            std::fprintf(out,
+                         "%s        {\n            \"bounceOffset\": 0,\n            \"col\": %d,\n"
+                         "            \"color\": %u,\n            \"id\": %d,\n            \"row\": %d\n        }",
+                         first ? "" : ",\n", c, color, id++, r);
+            digest.add(r, c, color);
+            first = false;
+        }
+    }
+    std::fprintf(out, "\n    ],\n    \"gameName\": \"Ball Game\",\n    \"movingBallIndex\": -1,\n"
+                      "    \"nextBallId\": %d,\n    \"palette\": [\n", id);
+    for (int i = 0; i < 12; ++i) std::fprintf(out, "        \"#%02x%02x%02x\"%s\n", i * 20, 255 - i * 20, 128, i < 11 ? "," : "");
+    std::fputs("    ],\n    \"saveTime\": \"2024-01-01T00:00:00\",\n    \"saveVersion\": \"1.1\",\n"
+               "    \"selectedBallIndex\": -1\n}\n", out);
+    return digest;
+}
+
+struct ReadResult {
+    bool ok = false;
+    std::string error;
+    Digest digest;
+    int nextBallId = 0;
+    size_t paletteSize = 0;
+};
+
+ReadResult readSave(const std::string &text, size_t chunk, int rows, int cols)
+{
+    ReadResult result;
+    SaveStreamReader reader(rows, cols, [&](const SaveStreamReader::Ball &b) {
+        result.digest.add(b.row, b.col, b.colorKind == SaveStreamReader::Ball::Index ? uint32_t(b.colorIndex) : b.rgba);
+    });
+    bool ok = true;
+    for (size_t i = 0; ok && i < text.size(); i += chunk) ok = reader.feed(text.data() + i, std::min(chunk, text.size() - i));
+    result.ok = ok && reader.finish();
+    result.error = reader.error();
+    result.nextBallId = reader.nextBallId();
+    result.paletteSize = reader.palette().size();
+    return result;
+}
+
+bool expectError(const char *name, const std::string &text, const char *needle)
+{
+    // mọi kích thước chunk phải cho cùng kết quả
+    for (size_t chunk : { size_t(1), size_t(7), size_t(4096) }) {
+        const ReadResult r = readSave(text, chunk, 10, 10);
+        if (r.ok || r.error.find(needle) == std::string::npos) {
+            std::fprintf(stderr, "FAIL: %s (chunk %zu): got '%s'\n", name, chunk, r.ok ? "ok" : r.error.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// Các định dạng màu cũ, escape và token bị cắt ở mọi vị trí
+bool checkFormats()
+{
+    const std::string legacy =
+        "{\"balls\":[{\"id\":4,\"row\":1,\"col\":2,\"color\":\"#00ff00\"},"
+        "{\"id\":9,\"row\":3,\"col\":3,\"color\":{\"r\":1,\"g\":2,\"b\":3},\"extra\":[1,{\"x\":null}]},"
+        "{\"id\":2,\"row\":0,\"col\":0,\"color\":\"\\u0023f00\",\"bounceOffset\":-3}],"
+        "\"nextBallId\":1,\"saveVersion\":\"1.0\"}";
+    const ReadResult whole = readSave(legacy, legacy.size(), 10, 10);
+    if (!whole.ok || whole.digest.balls != 3 || whole.nextBallId != 10) {
+        std::fprintf(stderr, "FAIL: legacy save: %s, %d balls, next id %d\n", whole.error.c_str(), whole.digest.balls,
+                     whole.nextBallId);
+        return false;
+    }
+    for (size_t chunk = 1; chunk < 16; ++chunk) {
+        const ReadResult r = readSave(legacy, chunk, 10, 10);
+        if (!r.ok || r.digest.sum != whole.digest.sum) {
+            std::fprintf(stderr, "FAIL: legacy save differs with chunk %zu\n", chunk);
+            return false;
+        }
+    }
+
+    // puzzle (v1.2): lời giải đọc được ở mọi kích thước chunk
+    const std::string puzzle = "{\"balls\":[{\"row\":1,\"col\":1,\"color\":1}],"
+                               "\"puzzle\":{\"moves\":2,\"solution\":[[1,1,2,2],[0,9,9,0]]}}";
+    for (size_t chunk = 1; chunk < 16; ++chunk) {
+        SaveStreamReader reader(10, 10, nullptr);
+        bool ok = true;
+        for (size_t i = 0; ok && i < puzzle.size(); i += chunk) ok = reader.feed(puzzle.data() + i, std::min(chunk, puzzle.size() - i));
+        const auto &solution = reader.puzzleSolution();
+        if (!ok || !reader.finish() || reader.puzzleMoves() != 2 || solution.size() != 2 || solution[1].fromCol != 9
+            || solution[1].toRow != 9) {
+            std::fprintf(stderr, "FAIL: puzzle save (chunk %zu): %s\n", chunk, reader.error().c_str());
+            return false;
+        }
+    }
+
+    // kích thước bàn ghi sau balls (khóa xếp theo ABC như QJsonDocument)
+    {
+        const std::string sized = "{\"balls\":[{\"row\":1,\"col\":1}],\"cols\":7,\"rows\":12}";
+        SaveStreamReader reader(10, 10, nullptr);
+        if (!reader.feed(sized.data(), sized.size()) || !reader.finish() || reader.declaredRows() != 12
+            || reader.declaredCols() != 7) {
+            std::fprintf(stderr, "FAIL: rows/cols not parsed: %s\n", reader.error().c_str());
+            return false;
+        }
+        SaveStreamReader legacyReader(10, 10, nullptr);
+        const std::string unsized = "{\"balls\":[{\"row\":1,\"col\":1}]}";
+        if (!legacyReader.feed(unsized.data(), unsized.size()) || !legacyReader.finish()
+            || legacyReader.declaredRows() != 0 || legacyReader.declaredCols() != 0) {
+            std::fprintf(stderr, "FAIL: size reported for a save without rows/cols\n");
+            return false;
+        }
+    }
+
+    const std::string head = "{\"balls\":[";
+    return expectError("duplicate", head + "{\"row\":1,\"col\":1},{\"row\":1,\"col\":1}]}", "cùng vị trí")
+           && expectError("out of bounds", head + "{\"row\":10,\"col\":1}]}", "không hợp lệ")
+           && expectError("truncated", head + "{\"row\":1,\"col\":1}", "hỏng")
+           && expectError("no balls", head + "]}", "không chứa bóng")
+           && expectError("balls not array", "{\"balls\":5}", "không chứa dữ liệu")
+           && expectError("garbage", "{\"balls\":[}", "hỏng")
+           && expectError("number in balls", head + "{\"row\":1,\"col\":1},7]}", "không chứa dữ liệu")
+           && expectError("null in balls", head + "null,{\"row\":1,\"col\":1}]}", "không chứa dữ liệu")
+           && expectError("array in balls", head + "[1,1]]}", "không chứa dữ liệu")
+           && expectError("zero rows", head + "{\"row\":1,\"col\":1}],\"rows\":0}", "hỏng")
+           && expectError("fractional cols", head + "{\"row\":1,\"col\":1}],\"cols\":2.5}", "hỏng")
+           && expectError("leading zero", head + "{\"row\":01,\"col\":1}]}", "hỏng")
+           && expectError("bare fraction", head + "{\"row\":1.,\"col\":1}]}", "hỏng")
+           && expectError("no integer part", head + "{\"row\":.5,\"col\":1}]}", "hỏng")
+           && expectError("short move", head + "{\"row\":1,\"col\":1}],\"puzzle\":{\"solution\":[[1,1,2]]}}", "Lời giải")
+           && expectError("move out of bounds", head + "{\"row\":1,\"col\":1}],\"puzzle\":{\"solution\":[[1,1,2,10]]}}",
+                          "Lời giải");
+}
+
+} // namespace
+
+// Save lớn (mặc định bàn 1000x1000, ~50% ô có bóng) đọc theo từng khúc
+// 256 KB: kiểm tra kết quả và đo MB/s, RSS tăng thêm phải nhỏ so với file.
+int runSaveBench(int argc, char **argv)
+{
+    const int side = argc > 1 ? std::atoi(argv[1]) : 1000;
+    if (side < 10 || side > 4096) {
+        std::fprintf(stderr, "side must be 10..4096\n");
+        return 2;
+    }
+    if (!checkFormats()) return 1;
+
+    std::FILE *file = std::tmpfile();
+    if (!file) {
+        std::fprintf(stderr, "cannot create temp file\n");
+        return 1;
+    }
+    const Digest expected = writeSave(file, side, 42);
+    const long bytes = std::ftell(file);
+    std::rewind(file);
+
+    const uint64_t rssBefore = PowerMetrics::peakRssBytes();
+    Digest digest;
+    SaveStreamReader reader(side, side, [&](const SaveStreamReader::Ball &b) {
+        digest.add(b.row, b.col, uint32_t(b.colorIndex));
+    });
+    std::vector<char> chunk(256 * 1024);
+    BenchTimer timer;
+    bool ok = true;
+    size_t n;
+    while (ok && (n = std::fread(chunk.data(), 1, chunk.size(), file)) > 0) ok = reader.feed(chunk.data(), n);
+    ok = ok && reader.finish();
+    const double seconds = timer.elapsedUs() / 1e6;
+    const uint64_t rssAfter = PowerMetrics::peakRssBytes();
+    std::fclose(file);
+
+    if (!ok) {
+        std::fprintf(stderr, "FAIL: %s\n", reader.error().c_str());
+        return 1;
+    }
+    if (digest.balls != expected.balls || digest.sum != expected.sum || reader.palette().size() != 12) {
+        std::fprintf(stderr, "FAIL: read %d balls (expected %d), digest %s\n", digest.balls, expected.balls,
+                     digest.sum == expected.sum ? "ok" : "differs");
+        return 1;
+    }
+
+    std::printf("%dx%d board, %d balls, %.1f MB save\n", side, side, expected.balls, bytes / 1e6);
+    std::printf("stream read: %.3f s, %.1f MB/s, %.0f ns/ball\n", seconds, bytes / 1e6 / seconds,
+                seconds * 1e9 / expected.balls);
+    std::printf("peak RSS %.1f MB -> %.1f MB (+%.2f MB; occupancy bitmap %.2f MB)\n", rssBefore / 1e6, rssAfter / 1e6,
+                (rssAfter - rssBefore) / 1e6, (double(side) * side / 8) / 1e6);
+    return 0;
+}
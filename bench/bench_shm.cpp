@@ -0,0 +1,149 @@
+#include "bench.h"
+#include "../boardshm.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Lượt k đổi ô k % n sang màu k % 250 + 1: từ turn suy ra được cả bàn
+uint8_t colorOf(uint64_t turn)
+{
+    return static_cast<uint8_t>(turn % 250 + 1);
+}
+
+bool matchesModel(const BoardShm::Snapshot &s, int n)
+{
+    const uint64_t turn = s.status.turn;
+    if (s.status.selectedCell != int(turn % n) || s.status.ballCount != int(turn)) return false;
+    for (int i = 0; i < n; ++i) {
+        // lượt gần nhất <= turn đã ghi vào ô i
+        const uint64_t back = (turn + n - uint64_t(i) % n) % n;
+        const uint8_t expected = turn >= back && turn - back >= 1 ? colorOf(turn - back) : 0;
+        if (s.cells[i] != expected) return false;
+    }
+    return true;
+}
+
+std::string segmentName()
+{
+#ifdef _WIN32
+    return "ballgame-bench-shm";
+#else
+    return "ballgame-bench-shm-" + std::to_string(getpid());
+#endif
+}
+
+} // namespace
+
+// Writer đổi từng ô và ghi qua seqlock, reader (luồng khác, cùng segment
+// như một tiến trình ngoài) đọc liên tục: mọi snapshot phải khớp đúng một
+// lượt, không bao giờ lẫn hai lượt. In ns/ghi, snapshot/s và số lần đọc lại.
+int runShmBench(int argc, char **argv)
+{
+    const int side = argc > 1 ? std::atoi(argv[1]) : 64;
+    const int writes = argc > 2 ? std::atoi(argv[2]) : 2000000;
+    if (side < 2 || side > 4096 || writes < 1) {
+        std::fprintf(stderr, "usage: shm [side 2..4096] [writes]\n");
+        return 2;
+    }
+    const int n = side * side;
+    const std::string name = segmentName();
+
+    BoardShm::Reader missing;
+    std::string error;
+    if (missing.open(name, &error) || error.empty()) {
+        std::fprintf(stderr, "FAIL: opened a segment that does not exist\n");
+        return 1;
+    }
+
+    BoardShm::Writer writer;
+    if (!writer.open(name, size_t(n), &error)) {
+        std::fprintf(stderr, "cannot create segment: %s\n", error.c_str());
+        return 1;
+    }
+    GameBoard board(side, side);
+    const std::vector<uint32_t> palette = { 0xffff0000u, 0xff00ff00u, 0xff0000ffu };
+    writer.publish(board, palette, BoardShm::Status{ 0, 0, 0 });
+    if (GameBoard big(side + 1, side); writer.publish(big, palette, BoardShm::Status())) {
+        std::fprintf(stderr, "FAIL: published a board larger than the segment\n");
+        return 1;
+    }
+
+    BoardShm::Reader reader;
+    BoardShm::Snapshot first;
+    if (!reader.open(name, &error) || !reader.read(first) || first.palette != palette || first.rows != side
+        || !matchesModel(first, n)) {
+        std::fprintf(stderr, "FAIL: reader open / first snapshot: %s\n", error.c_str());
+        return 1;
+    }
+
+    // 1) chi phí ghi, không có reader
+    uint64_t turn = 0;
+    auto write = [&]() {
+        ++turn;
+        const int cell = int(turn % n);
+        board.data()[cell] = colorOf(turn);
+        const BoardShm::Status status{ cell, turn, int(turn) };
+        // thỉnh thoảng chép cả bàn (như rebuildBoard)
+        if (turn % 4096 == 0) writer.publish(board, palette, status);
+        else writer.update(board, &cell, 1, status);
+    };
+    BenchTimer timer;
+    for (int i = 0; i < writes; ++i) write();
+    const double us = timer.elapsedUs();
+
+    // 2) reader chạy song song ~1 s; writer nhường CPU định kỳ để máy một
+    // nhân cũng có lúc bị cắt ngang giữa chừng
+    std::atomic<bool> done{false};
+    long long snapshots = 0, unchanged = 0, mismatches = 0, gaveUp = 0;
+    std::thread readerThread([&]() {
+        BoardShm::Snapshot s;
+        uint64_t lastSeq = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            if (reader.seq() == lastSeq) {
+                ++unchanged;
+                std::this_thread::yield();
+                continue;
+            }
+            if (!reader.read(s)) {
+                ++gaveUp;
+                continue;
+            }
+            lastSeq = s.seq;
+            ++snapshots;
+            if (!matchesModel(s, n)) ++mismatches;
+        }
+    });
+    BenchTimer concurrent;
+    long long concurrentWrites = 0;
+    while (concurrent.elapsedUs() < 1e6) {
+        for (int i = 0; i < 1024; ++i) write();
+        concurrentWrites += 1024;
+        std::this_thread::yield();
+    }
+    done = true;
+    readerThread.join();
+
+    BoardShm::Snapshot last;
+    if (!reader.read(last) || last.status.turn != turn || !matchesModel(last, n)) {
+        std::fprintf(stderr, "FAIL: final snapshot differs from the writer\n");
+        return 1;
+    }
+    if (mismatches > 0) {
+        std::fprintf(stderr, "FAIL: %lld of %lld snapshots mixed two writes\n", mismatches, snapshots);
+        return 1;
+    }
+    std::printf("%dx%d board, %d writes: %.1f ns/write (writer never waits)\n", side, side, writes, us * 1e3 / writes);
+    std::printf("concurrent: %lld writes, reader took %lld consistent snapshots, %llu retries on torn reads, "
+                "%lld gave up, %lld idle polls\n",
+                concurrentWrites, snapshots, static_cast<unsigned long long>(reader.retries()), gaveUp, unchanged);
+    return 0;
+}
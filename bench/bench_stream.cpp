@@ -0,0 +1,150 @@
+#include "bench.h"
+#include "../gameengine.h"
+#include "../gamestream.h"
+#include "../rng.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::vector<uint32_t> kPalette = { 0xffff0000u, 0xff00ff00u, 0xff0000ffu };
+
+// Đưa luồng vào Reader theo khúc ngẫu nhiên 1..maxChunk byte (như socket)
+bool feedChunked(GameStream::Reader &reader, const std::string &bytes, Rng &rng, int maxChunk)
+{
+    for (size_t i = 0; i < bytes.size();) {
+        const size_t n = std::min<size_t>(static_cast<size_t>(rng.range(1, maxChunk)), bytes.size() - i);
+        if (!reader.feed(bytes.data() + i, n)) return false;
+        i += n;
+    }
+    return true;
+}
+
+bool sameBoard(const GameStream::Reader &reader, const GameBoard &board)
+{
+    return reader.rows() == board.rows() && reader.cols() == board.cols()
+           && std::equal(reader.cells().begin(), reader.cells().end(), board.data());
+}
+
+bool expectError(const char *name, const std::string &bytes, const char *needle)
+{
+    GameStream::Reader reader;
+    if (reader.feed(bytes.data(), bytes.size()) || reader.error().find(needle) == std::string::npos) {
+        std::fprintf(stderr, "FAIL: %s: got '%s'\n", name, reader.error().c_str());
+        return false;
+    }
+    return true;
+}
+
+// Frame hỏng / sai thứ tự phải bị từ chối, không làm hỏng bàn của client
+bool checkErrors()
+{
+    const uint8_t cells[4] = { 1, 0, 0, 2 };
+    std::string snapshot;
+    GameStream::appendSnapshot(snapshot, 7, 2, 2, cells, kPalette);
+
+    std::string badVersion = snapshot;
+    badVersion[5] = 9;
+    std::string tooLarge = snapshot;
+    tooLarge[3] = 0x7f;
+    std::string unknown = snapshot;
+    unknown[4] = 42;
+
+    // lượt giả: seq 9 (nhảy cóc), rồi đi từ ô trống
+    auto turnFrame = [](std::initializer_list<uint8_t> payload) {
+        std::string out;
+        const uint32_t n = static_cast<uint32_t>(payload.size());
+        for (int i = 0; i < 4; ++i) out += static_cast<char>(n >> (8 * i));
+        out += static_cast<char>(GameStream::FrameType::Turn);
+        for (uint8_t b : payload) out += static_cast<char>(b);
+        return out;
+    };
+    return expectError("version", badVersion, "version")
+           && expectError("frame size", tooLarge, "too large")
+           && expectError("frame type", unknown, "unknown")
+           && expectError("turn first", turnFrame({ 1, 0, 1, 0, 0 }), "before snapshot")
+           && expectError("sequence gap", snapshot + turnFrame({ 9, 0, 1, 0, 0 }), "sequence")
+           && expectError("empty source", snapshot + turnFrame({ 8, 1, 2, 0, 0 }), "illegal move")
+           && expectError("bad removal", snapshot + turnFrame({ 8, 0, 1, 0, 1, 0 }), "removal")
+           && expectError("trailing", snapshot + turnFrame({ 8, 0, 1, 0, 0, 0 }), "trailing");
+}
+
+} // namespace
+
+// Ván engine ghi thành luồng (snapshot + mỗi lượt một frame), client đọc
+// theo khúc ngẫu nhiên phải khớp bàn của engine sau từng lượt; khách vào
+// giữa ván nhận snapshot dựng từ bản sao của server. In byte/lượt so với
+// snapshot và ns mã hóa / giải mã.
+int runStreamBench(int argc, char **argv)
+{
+    const int games = argc > 1 ? std::atoi(argv[1]) : 200;
+    if (games < 1) {
+        std::fprintf(stderr, "games must be >= 1\n");
+        return 2;
+    }
+    if (!checkErrors()) return 1;
+
+    Rng policy(17), chunks(3);
+    long long turns = 0;
+    size_t turnBytes = 0, snapshotBytes = 0;
+    double encodeUs = 0, decodeUs = 0;
+    for (int game = 0; game < games; ++game) {
+        GameEngine engine;
+        engine.setHistoryEnabled(true);
+        engine.reset(500 + game);
+        const GameBoard &board = engine.board();
+
+        uint64_t seq = 1;
+        std::string stream;
+        GameStream::appendSnapshot(stream, seq, board.rows(), board.cols(), board.data(), kPalette);
+        snapshotBytes += stream.size();
+        GameStream::Reader client;
+        GameStream::Reader mirror;      // như server: giữ bàn để phục vụ khách đến muộn
+        if (!feedChunked(client, stream, chunks, 64) || !mirror.feed(stream.data(), stream.size())) {
+            std::fprintf(stderr, "FAIL: snapshot: %s\n", client.error().c_str());
+            return 1;
+        }
+
+        int from = 0, to = 0;
+        while (engine.randomMove(policy, from, to)) {
+            engine.step(from, to);
+            stream.clear();
+            BenchTimer encode;
+            GameStream::appendTurn(stream, ++seq, engine.history().last());
+            encodeUs += encode.elapsedUs();
+            turnBytes += stream.size();
+            ++turns;
+
+            BenchTimer decode;
+            const bool ok = mirror.feed(stream.data(), stream.size());
+            decodeUs += decode.elapsedUs();
+            if (!ok || !feedChunked(client, stream, chunks, 8) || !sameBoard(client, board)
+                || !sameBoard(mirror, board)) {
+                std::fprintf(stderr, "FAIL: game %d turn %lld: %s%s\n", game, turns, client.error().c_str(),
+                             mirror.error().c_str());
+                return 1;
+            }
+        }
+
+        // khách đến muộn
+        std::string late;
+        GameStream::appendSnapshot(late, mirror.seq(), mirror.rows(), mirror.cols(), mirror.cells().data(),
+                                   mirror.palette());
+        GameStream::Reader joiner;
+        if (!feedChunked(joiner, late, chunks, 16) || !sameBoard(joiner, board) || joiner.seq() != seq
+            || joiner.palette() != kPalette || joiner.ballCount() != client.ballCount()) {
+            std::fprintf(stderr, "FAIL: late joiner in game %d: %s\n", game, joiner.error().c_str());
+            return 1;
+        }
+    }
+
+    std::printf("checked %lld turns in %d games (random chunking, late joiners)\n", turns, games);
+    std::printf("turn frame %.1f bytes avg, snapshot %.1f bytes avg (10x10, 3 colours)\n", double(turnBytes) / turns,
+                double(snapshotBytes) / games);
+    std::printf("encode %.0f ns/turn, decode+apply %.0f ns/turn\n", encodeUs * 1e3 / turns, decodeUs * 1e3 / turns);
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include "bench.h"
+#include "../telemetry.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Type = TelemetryRing::Type;
+
+bool fail(const char *what, const std::string &detail = std::string())
+{
+    std::fprintf(stderr, "FAIL: %s %s\n", what, detail.c_str());
+    return false;
+}
+
+// Vòng ghi đè đúng thứ tự, file được dùng lại qua các phiên, gộp theo giây
+bool checkRing(const std::string &path)
+{
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+    std::string error;
+    {
+        TelemetryRing ring;
+        if (!ring.open(path, 1000, &error)) return fail("open", error);
+        for (uint32_t i = 1; i <= 2500; ++i) ring.record(Type::PathSearch, TelemetryRing::nowNs(), i);
+        for (int i = 0; i < 1000; ++i) ring.fold(Type::Layout, 2000);
+        if (ring.recordsWritten() != 2501) return fail("fold wrote before its window closed");
+    }   // close ghi bản ghi gộp
+
+    std::vector<TelemetryRing::Record> records;
+    if (!TelemetryRing::readFile(path, records, &error)) return fail("read", error);
+    if (records.size() != 1000) return fail("ring size");
+    for (size_t i = 0; i + 1 < records.size(); ++i) {
+        if (records[i].type() != Type::PathSearch || records[i].value != 1502 + i) return fail("ring order");
+    }
+    const TelemetryRing::Record &folded = records.back();
+    if (folded.type() != Type::Layout || folded.value != 1000 || folded.durationUs != 2000.0f)
+        return fail("folded record");
+
+    // phiên sau ghi tiếp vào cùng file
+    {
+        TelemetryRing ring;
+        if (!ring.open(path, 1000, &error)) return fail("reopen", error);
+        if (ring.recordsWritten() != 2503) return fail("reopen did not keep the ring");
+    }
+    // capacity khác: báo lỗi, file cũ còn nguyên
+    {
+        TelemetryRing ring;
+        if (ring.open(path, 64, &error)) return fail("opened a ring of another capacity");
+    }
+    if (!TelemetryRing::readFile(path, records, &error) || records.size() != 1000)
+        return fail("other capacity touched the file", error);
+
+    std::FILE *junk = std::fopen(path.c_str(), "wb");
+    std::fputs("not telemetry", junk);
+    std::fclose(junk);
+    if (TelemetryRing::readFile(path, records, &error)) return fail("accepted a junk file");
+    {
+        TelemetryRing ring;
+        if (ring.open(path, 1000, &error)) return fail("opened a junk file");
+    }
+    if (std::filesystem::file_size(path) != 13) return fail("open touched a junk file");
+
+    // đúng cỡ nhưng header toàn 0 (tiến trình tạo file chết giữa chừng): đợi rồi báo lỗi
+    std::filesystem::resize_file(path, 0);
+    std::filesystem::resize_file(path, 64 + 1000 * sizeof(TelemetryRing::Record));
+    {
+        TelemetryRing ring;
+        if (ring.open(path, 1000, &error)) return fail("opened a file without header");
+    }
+    if (TelemetryRing::readFile(path, records, &error)) return fail("open initialised a file it did not create");
+    return true;
+}
+
+// Hai writer (như hai cửa sổ game) cùng một file: không bản ghi nào bị ghi đè
+bool checkSharedFile(const std::string &path)
+{
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+    const uint32_t perWriter = 200000;
+    std::string error;
+    TelemetryRing rings[2];
+    // cùng tạo file: một bên tạo, bên kia đợi header rồi dùng chung
+    bool opened[2] = {};
+    std::thread openers[2];
+    for (int w = 0; w < 2; ++w) openers[w] = std::thread([&, w]() { opened[w] = rings[w].open(path, 1u << 20); });
+    for (std::thread &opener : openers) opener.join();
+    if (!opened[0] || !opened[1]) return fail("open shared");
+    std::thread writers[2];
+    for (uint32_t w = 0; w < 2; ++w) {
+        writers[w] = std::thread([&, w]() {
+            for (uint32_t i = 0; i < perWriter; ++i) {
+                rings[w].record(Type::PathSearch, 0, w * perWriter + i);
+                if (i % 1024 == 0) std::this_thread::yield();   // máy một nhân: xen kẽ hai writer
+            }
+        });
+    }
+    for (std::thread &writer : writers) writer.join();
+    for (TelemetryRing &ring : rings) ring.close();
+
+    std::vector<TelemetryRing::Record> records;
+    if (!TelemetryRing::readFile(path, records, &error)) return fail("read shared", error);
+    std::vector<char> seen(2 * perWriter, 0);
+    size_t sessions = 0;
+    for (const TelemetryRing::Record &record : records) {
+        if (record.type() == Type::Session) {
+            ++sessions;
+        } else if (record.type() != Type::PathSearch || record.value >= seen.size() || seen[record.value]++) {
+            return fail("shared file: bad or duplicated record");
+        }
+    }
+    if (sessions != 2 || records.size() != 2 + 2 * size_t(perWriter))
+        return fail("shared file lost records", std::to_string(records.size()));
+    return true;
+}
+
+} // namespace
+
+// Kiểm tra vòng / phiên / gộp, rồi đo chi phí ghi trên đường nóng:
+// record (1 bản ghi) và fold (cộng dồn, 1 bản ghi / giây).
+int runTelemetryBench(int, char **)
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "ballgame-bench.telemetry").string();
+    if (!checkRing(path) || !checkSharedFile(path)) return 1;
+
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);     // checkSharedFile để lại ring 1M bản ghi
+    TelemetryRing ring;
+    std::string error;
+    if (!ring.open(path, TelemetryRing::DefaultCapacity, &error)) {
+        std::fprintf(stderr, "cannot open %s\n", error.c_str());
+        return 1;
+    }
+    const int n = 2000000;
+    BenchTimer recordTimer;
+    for (int i = 0; i < n; ++i) ring.record(Type::PathSearch, 0, uint32_t(i));
+    const double recordNs = recordTimer.elapsedUs() * 1e3 / n;
+
+    BenchTimer foldTimer;
+    for (int i = 0; i < n; ++i) ring.fold(Type::Frames, 1000);
+    const double foldNs = foldTimer.elapsedUs() * 1e3 / n;
+    ring.close();
+
+    std::vector<TelemetryRing::Record> records;
+    TelemetryRing::readFile(path, records);
+    std::printf("record %.1f ns, fold %.1f ns (%d calls each); ring %zu records, %.1f MB on disk\n", recordNs, foldNs, n,
+                records.size(), (64 + records.size() * sizeof(TelemetryRing::Record)) / 1e6);
+    std::filesystem::remove(path, ignored);
+    return 0;
+}
@@ -0,0 +1,273 @@
+// Offscreen render benchmark for MainWindow.
+//
+//   ballgame_renderbench [--frames N] [--board RxC] [--output results.json]
+//                        [--baseline old.json] [--tolerance 0.15]
+//                        [--min-fps X] [--max-allocs-per-frame Y]
+//
+// Runs with QT_QPA_PLATFORM=offscreen unless a platform is already set.
+// Exit code: 0 ok, 1 a threshold regressed, 2 bad arguments / files.
+//
+// No baseline or threshold is checked in: fps and allocs/frame depend on
+// the machine and the Qt build, so record one with --output on the machine
+// that runs the comparison and pass it back with --baseline.
+
+#include "../mainwindow.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+
+// ---- allocation counter (whole process) ----
+namespace {
+std::atomic<unsigned long long> g_allocs{0};
+std::atomic<unsigned long long> g_allocBytes{0};
+}
+
+void *operator new(std::size_t size)
+{
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+struct FrameStats {
+    QString scenario;
+    double density = 0;
+    int frames = 0;
+    double fps = 0;
+    double cpuMsPerFrame = 0;
+    double allocsPerFrame = 0;
+    double bytesPerFrame = 0;
+
+    QJsonObject toJson() const
+    {
+        return QJsonObject{
+            {"scenario", scenario}, {"density", density}, {"frames", frames}, {"fps", fps},
+            {"cpuMsPerFrame", cpuMsPerFrame}, {"allocsPerFrame", allocsPerFrame}, {"bytesPerFrame", bytesPerFrame},
+        };
+    }
+};
+
+// Drives MainWindow frames directly (friend of MainWindow)
+class RenderBench
+{
+public:
+    explicit RenderBench(MainWindow &window) : w(window) {}
+
+    // Bàn ngẫu nhiên với mật độ cho trước, không còn hàng đủ 5
+    void loadBoard(double density, quint32 seed)
+    {
+        GameSave::GameState state;
+        state.palette = Palette();
+        Rng rng(seed);
+        const int rows = w.board.rows(), cols = w.board.cols();
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                if (rng.below(1000) >= density * 1000) continue;
+                const quint8 color = static_cast<quint8>(rng.range(1, 7));
+                state.balls.append(GameSave::BallData(state.nextBallId++, r, c, color, 0));
+            }
+        }
+        w.applyGameState(state);
+        w.removeBallsAt(w.findLinesToRemove());
+        w.updateBallPositions();
+    }
+
+    // Một bóng (đang chọn) nảy: mỗi frame là một onBounceUpdated như tick nảy gửi
+    void bounceFrame(int frame)
+    {
+        if (w.balls.isEmpty()) return;
+        if (w.selectedBallIndex != 0) {
+            w.selectedBallIndex = 0;
+            w.updateBallPositions();
+        }
+        const int phase = frame % 20;                       // sóng tam giác -5..5
+        const int offset = phase < 10 ? phase - 5 : 15 - phase;
+        w.onBounceUpdated(w.balls[0].id, offset);
+    }
+
+    // Một bước đi như playTurn: bóng sang ô trống kề bên
+    void moveFrame(int frame)
+    {
+        const int n = w.balls.size();
+        for (int k = 0; k < n; ++k) {
+            MainWindow::Ball &ball = w.balls[(frame + k) % n];
+            static const int dr[4] = { -1, 1, 0, 0 };
+            static const int dc[4] = { 0, 0, -1, 1 };
+            for (int d = 0; d < 4; ++d) {
+                const int r = ball.row + dr[(frame + d) % 4], c = ball.col + dc[(frame + d) % 4];
+                if (!w.board.inBounds(r, c) || !w.board.isEmpty(r, c)) continue;
+                w.setCell(ball.row, ball.col, Palette::Empty);
+                ball.row = r;
+                ball.col = c;
+                w.setCell(r, c, ball.colorIndex);
+                w.updateBallPositions();
+                return;
+            }
+        }
+        w.updateBallPositions();
+    }
+
+    FrameStats run(const QString &scenario, double density, int frames)
+    {
+        loadBoard(density, 1234);
+        for (int i = 0; i < 10; ++i) frame(scenario, i);   // warm up caches / pixmaps
+
+        const unsigned long long allocs0 = g_allocs.load(), bytes0 = g_allocBytes.load();
+        const std::clock_t cpu0 = std::clock();
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < frames; ++i) frame(scenario, i);
+        const double wallMs = timer.nsecsElapsed() / 1e6;
+        const double cpuMs = 1000.0 * (std::clock() - cpu0) / CLOCKS_PER_SEC;
+
+        FrameStats stats;
+        stats.scenario = scenario;
+        stats.density = density;
+        stats.frames = frames;
+        stats.fps = frames / (wallMs / 1000.0);
+        stats.cpuMsPerFrame = cpuMs / frames;
+        stats.allocsPerFrame = double(g_allocs.load() - allocs0) / frames;
+        stats.bytesPerFrame = double(g_allocBytes.load() - bytes0) / frames;
+        return stats;
+    }
+
+private:
+    void frame(const QString &scenario, int i)
+    {
+        if (scenario == "bounce") bounceFrame(i);
+        else moveFrame(i);
+        w.repaint();                            // vẽ đồng bộ vào backing store offscreen
+        QCoreApplication::processEvents();      // deleteLater, layout requests
+    }
+
+    MainWindow &w;
+};
+
+namespace {
+
+QString key(const QJsonObject &o)
+{
+    return o["scenario"].toString() + "@" + QString::number(o["density"].toDouble());
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Offscreen render benchmark for the ball game");
+    parser.addHelpOption();
+    QCommandLineOption framesOpt("frames", "Frames per scenario.", "N", "300");
+    QCommandLineOption boardOpt("board", "Board size.", "RxC", "10x10");
+    QCommandLineOption outputOpt("output", "Write results as JSON.", "file");
+    QCommandLineOption baselineOpt("baseline", "Compare with an earlier JSON result.", "file");
+    QCommandLineOption toleranceOpt("tolerance", "Allowed relative regression vs baseline.", "ratio", "0.15");
+    QCommandLineOption minFpsOpt("min-fps", "Fail if any scenario is slower.", "fps");
+    QCommandLineOption maxAllocsOpt("max-allocs-per-frame", "Fail if any scenario allocates more.", "count");
+    parser.addOptions({framesOpt, boardOpt, outputOpt, baselineOpt, toleranceOpt, minFpsOpt, maxAllocsOpt});
+    parser.process(app);
+
+    const int frames = qMax(1, parser.value(framesOpt).toInt());
+    const double tolerance = parser.value(toleranceOpt).toDouble();
+    int rows = 10, cols = 10;
+    if (!MainWindow::parseBoardSize(parser.value(boardOpt), rows, cols)) {
+        std::fprintf(stderr, "invalid --board %s\n", qPrintable(parser.value(boardOpt)));
+        return 2;
+    }
+    const QString boardName = QString("%1x%2").arg(rows).arg(cols);
+
+    GameRules rules;
+    rules.rows = rows;
+    rules.cols = cols;
+    MainWindow window(rules);
+    window.resize(1000, 800);
+    window.show();
+    QCoreApplication::processEvents();
+
+    RenderBench bench(window);
+    QJsonArray results;
+    QList<FrameStats> all;
+    for (const QString scenario : {QStringLiteral("bounce"), QStringLiteral("move")}) {
+        for (double density : {0.1, 0.5, 0.9}) {
+            const FrameStats stats = bench.run(scenario, density, frames);
+            all.append(stats);
+            results.append(stats.toJson());
+            std::printf("%-7s density %.1f: %8.1f fps  %6.3f ms cpu/frame  %8.1f allocs/frame  %10.0f bytes/frame\n",
+                        qPrintable(scenario), density, stats.fps, stats.cpuMsPerFrame, stats.allocsPerFrame,
+                        stats.bytesPerFrame);
+        }
+    }
+
+    QJsonObject doc{{"benchmark", "render"}, {"qt", QString(qVersion())}, {"board", boardName},
+                    {"frames", frames}, {"results", results}};
+    if (parser.isSet(outputOpt)) {
+        QFile file(parser.value(outputOpt));
+        if (!file.open(QIODevice::WriteOnly)) {
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(parser.value(outputOpt)));
+            return 2;
+        }
+        file.write(QJsonDocument(doc).toJson());
+    }
+
+    // ---- regression checks ----
+    int failures = 0;
+    auto fail = [&](const FrameStats &s, const QString &why) {
+        std::fprintf(stderr, "REGRESSION %s density %.1f: %s\n", qPrintable(s.scenario), s.density, qPrintable(why));
+        ++failures;
+    };
+    for (const FrameStats &s : all) {
+        if (parser.isSet(minFpsOpt) && s.fps < parser.value(minFpsOpt).toDouble())
+            fail(s, QString("%1 fps < %2").arg(s.fps).arg(parser.value(minFpsOpt)));
+        if (parser.isSet(maxAllocsOpt) && s.allocsPerFrame > parser.value(maxAllocsOpt).toDouble())
+            fail(s, QString("%1 allocs/frame > %2").arg(s.allocsPerFrame).arg(parser.value(maxAllocsOpt)));
+    }
+    if (parser.isSet(baselineOpt)) {
+        QFile file(parser.value(baselineOpt));
+        if (!file.open(QIODevice::ReadOnly)) {
+            std::fprintf(stderr, "cannot read baseline %s\n", qPrintable(parser.value(baselineOpt)));
+            return 2;
+        }
+        const QJsonObject baseDoc = QJsonDocument::fromJson(file.readAll()).object();
+        if (baseDoc["board"].toString("10x10") != boardName) {
+            std::fprintf(stderr, "baseline was measured on a %s board, not %s\n",
+                         qPrintable(baseDoc["board"].toString("10x10")), qPrintable(boardName));
+            return 2;
+        }
+        const QJsonArray base = baseDoc["results"].toArray();
+        for (const FrameStats &s : all) {
+            const QJsonObject now = s.toJson();
+            for (const QJsonValue &v : base) {
+                const QJsonObject old = v.toObject();
+                if (key(old) != key(now)) continue;
+                const double oldFps = old["fps"].toDouble(), oldAllocs = old["allocsPerFrame"].toDouble();
+                if (s.fps < oldFps * (1.0 - tolerance))
+                    fail(s, QString("fps %1 vs baseline %2").arg(s.fps).arg(oldFps));
+                // vài allocation lệch là nhiễu; tăng theo tỉ lệ mới là hồi quy
+                if (s.allocsPerFrame > oldAllocs * (1.0 + tolerance) + 2.0)
+                    fail(s, QString("allocs/frame %1 vs baseline %2").arg(s.allocsPerFrame).arg(oldAllocs));
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
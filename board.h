@@ -0,0 +1,244 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+// Board geometry: neighbours of a cell and the line segments through it.
+//
+// Board<Rows, Cols, LineLen, Dirs> builds both tables at compile time, so the
+// hot loops have no bounds checks or direction arithmetic and unroll fully;
+// directions outside Dirs are dropped at compile time. DynamicBoard offers
+// the same interface for any other rule set; pick one at run time with
+// withBoardGeometry().
+//
+// Cells are flat indices (row * cols + col) into a palette-index board
+// (0 = empty), the layout of GameBoard.
+
+namespace BoardDirections {
+// 4 bước đi của bóng: lên, xuống, trái, phải (như dr/dc cũ của findPath)
+constexpr int StepRow[4] = { -1, 1, 0, 0 };
+constexpr int StepCol[4] = { 0, 0, -1, 1 };
+// 4 hướng của hàng: ngang, dọc, chéo phải, chéo trái
+constexpr int LineRow[4] = { 0, 1, 1, 1 };
+constexpr int LineCol[4] = { 1, 0, 1, -1 };
+// Tập hướng được tính là hàng (GameRules::lineDirections): bit d = LineRow/LineCol[d]
+enum LineMask : unsigned {
+    Horizontal = 1u << 0,
+    Vertical = 1u << 1,
+    Diagonal = 1u << 2,
+    AntiDiagonal = 1u << 3,
+    Orthogonal = Horizontal | Vertical,
+    AllLines = Horizontal | Vertical | Diagonal | AntiDiagonal,
+};
+}
+
+namespace BoardDetail {
+
+// Calls f(std::integral_constant<int, I>) for I = 0..N-1, fully unrolled
+template <class F, int... I>
+inline void unrollImpl(F &&f, std::integer_sequence<int, I...>)
+{
+    (f(std::integral_constant<int, I>()), ...);
+}
+
+template <int N, class F>
+inline void unroll(F &&f)
+{
+    unrollImpl(std::forward<F>(f), std::make_integer_sequence<int, N>());
+}
+
+} // namespace BoardDetail
+
+template <int Rows, int Cols, int LineLen, unsigned Dirs = BoardDirections::AllLines>
+class Board
+{
+    static_assert(Rows > 0 && Cols > 0, "empty board");
+    static_assert(Dirs != 0 && Dirs <= BoardDirections::AllLines, "bad direction mask");
+    static_assert(LineLen >= 2, "a line needs at least two balls");
+    static_assert(Rows * Cols <= 32767, "cell indices are stored as int16_t");
+
+public:
+    static constexpr int CellCount = Rows * Cols;
+    static constexpr int Span = 2 * LineLen - 1;   // ô trung tâm +- (LineLen - 1)
+    static constexpr int16_t NoCell = -1;
+
+    using Neighbours = std::array<int16_t, 4>;
+    using Segment = std::array<int16_t, Span>;
+
+    int rows() const { return Rows; }
+    int cols() const { return Cols; }
+    int lineLength() const { return LineLen; }
+    unsigned lineDirections() const { return Dirs; }
+    int cellCount() const { return CellCount; }
+
+    // f(neighbourCell) for each in-bounds neighbour (up, down, left, right)
+    template <class F>
+    void forEachNeighbour(int cell, F &&f) const
+    {
+        const Neighbours &n = neighbourTable[cell];
+        BoardDetail::unroll<4>([&](auto k) {
+            if (n[k] != NoCell) f(int(n[k]));
+        });
+    }
+
+    // Sets mask[] = 1 for every cell of a >= LineLen run through `cell`.
+    // Runs are seen up to LineLen - 1 cells each side, which covers every run
+    // a single new ball can create when no long run was left on the board.
+    // Returns the number of cells newly marked.
+    int markLinesThrough(const uint8_t *cells, int cell, uint8_t *mask) const
+    {
+        const uint8_t color = cells[cell];
+        if (color == 0) return 0;
+
+        int marked = 0;
+        BoardDetail::unroll<4>([&](auto dir) {
+            if constexpr (!(Dirs >> dir & 1u)) return;
+            const Segment &seg = lineTable[cell][dir];
+            // branchless: count consecutive matches outward from the centre
+            int back = 0, fwd = 0;
+            bool backAlive = true, fwdAlive = true;
+            BoardDetail::unroll<LineLen - 1>([&](auto k) {
+                const int16_t b = seg[LineLen - 2 - k];
+                const int16_t f = seg[LineLen + k];
+                backAlive = backAlive && b != NoCell && cells[b] == color;
+                fwdAlive = fwdAlive && f != NoCell && cells[f] == color;
+                back += backAlive;
+                fwd += fwdAlive;
+            });
+            if (back + 1 + fwd < LineLen) return;
+            for (int i = LineLen - 1 - back; i <= LineLen - 1 + fwd; ++i) {
+                marked += !mask[seg[i]];
+                mask[seg[i]] = 1;
+            }
+        });
+        return marked;
+    }
+
+private:
+    static constexpr std::array<Neighbours, CellCount> makeNeighbourTable()
+    {
+        std::array<Neighbours, CellCount> table{};
+        for (int r = 0; r < Rows; ++r) {
+            for (int c = 0; c < Cols; ++c) {
+                for (int k = 0; k < 4; ++k) {
+                    const int nr = r + BoardDirections::StepRow[k];
+                    const int nc = c + BoardDirections::StepCol[k];
+                    const bool inside = nr >= 0 && nr < Rows && nc >= 0 && nc < Cols;
+                    table[r * Cols + c][k] = inside ? int16_t(nr * Cols + nc) : NoCell;
+                }
+            }
+        }
+        return table;
+    }
+
+    static constexpr std::array<std::array<Segment, 4>, CellCount> makeLineTable()
+    {
+        std::array<std::array<Segment, 4>, CellCount> table{};
+        for (int r = 0; r < Rows; ++r) {
+            for (int c = 0; c < Cols; ++c) {
+                for (int d = 0; d < 4; ++d) {
+                    for (int i = 0; i < Span; ++i) {
+                        const int step = i - (LineLen - 1);
+                        const int nr = r + step * BoardDirections::LineRow[d];
+                        const int nc = c + step * BoardDirections::LineCol[d];
+                        const bool inside = nr >= 0 && nr < Rows && nc >= 0 && nc < Cols;
+                        table[r * Cols + c][d][i] = inside ? int16_t(nr * Cols + nc) : NoCell;
+                    }
+                }
+            }
+        }
+        return table;
+    }
+
+    static constexpr std::array<Neighbours, CellCount> neighbourTable = makeNeighbourTable();
+    static constexpr std::array<std::array<Segment, 4>, CellCount> lineTable = makeLineTable();
+};
+
+// Same interface as Board<>, geometry known only at run time
+class DynamicBoard
+{
+public:
+    DynamicBoard(int rows, int cols, int lineLen, unsigned dirs = BoardDirections::AllLines)
+        : m_rows(rows), m_cols(cols), m_lineLen(lineLen), m_dirs(dirs)
+    {
+    }
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    int lineLength() const { return m_lineLen; }
+    unsigned lineDirections() const { return m_dirs; }
+    int cellCount() const { return m_rows * m_cols; }
+
+    template <class F>
+    void forEachNeighbour(int cell, F &&f) const
+    {
+        const int r = cell / m_cols, c = cell % m_cols;
+        if (r > 0) f(cell - m_cols);
+        if (r + 1 < m_rows) f(cell + m_cols);
+        if (c > 0) f(cell - 1);
+        if (c + 1 < m_cols) f(cell + 1);
+    }
+
+    int markLinesThrough(const uint8_t *cells, int cell, uint8_t *mask) const
+    {
+        const uint8_t color = cells[cell];
+        if (color == 0) return 0;
+
+        const int r = cell / m_cols, c = cell % m_cols;
+        auto matches = [&](int rr, int cc) {
+            return rr >= 0 && rr < m_rows && cc >= 0 && cc < m_cols && cells[rr * m_cols + cc] == color;
+        };
+
+        int marked = 0;
+        for (int d = 0; d < 4; ++d) {
+            if (!(m_dirs >> d & 1u)) continue;
+            const int dr = BoardDirections::LineRow[d], dc = BoardDirections::LineCol[d];
+            int back = 0, fwd = 0;
+            while (back < m_lineLen - 1 && matches(r - (back + 1) * dr, c - (back + 1) * dc)) ++back;
+            while (fwd < m_lineLen - 1 && matches(r + (fwd + 1) * dr, c + (fwd + 1) * dc)) ++fwd;
+            if (back + 1 + fwd < m_lineLen) continue;
+            for (int i = -back; i <= fwd; ++i) {
+                const int idx = (r + i * dr) * m_cols + (c + i * dc);
+                marked += !mask[idx];
+                mask[idx] = 1;
+            }
+        }
+        return marked;
+    }
+
+private:
+    int m_rows;
+    int m_cols;
+    int m_lineLen;
+    unsigned m_dirs;
+};
+
+// Bàn chuẩn của game: 10x10, hàng 5
+using StandardBoard = Board<10, 10, 5>;
+// Các bộ luật hay gặp khác: chỉ ngang/dọc trên bàn chuẩn, Color Lines cổ điển 9x9
+using OrthogonalBoard = Board<10, 10, 5, BoardDirections::Orthogonal>;
+using ClassicBoard = Board<9, 9, 5>;
+
+// Runs f(geometry) with a compile-time board when the rule set is one of the
+// common ones above, otherwise with a DynamicBoard. f is usually a generic
+// lambda.
+template <class F>
+decltype(auto) withBoardGeometry(int rows, int cols, int lineLen, unsigned dirs, F &&f)
+{
+    if (lineLen == 5) {
+        if (rows == 10 && cols == 10 && dirs == BoardDirections::AllLines) return f(StandardBoard());
+        if (rows == 10 && cols == 10 && dirs == BoardDirections::Orthogonal) return f(OrthogonalBoard());
+        if (rows == 9 && cols == 9 && dirs == BoardDirections::AllLines) return f(ClassicBoard());
+    }
+    return f(DynamicBoard(rows, cols, lineLen, dirs));
+}
+
+template <class F>
+decltype(auto) withBoardGeometry(int rows, int cols, int lineLen, F &&f)
+{
+    return withBoardGeometry(rows, cols, lineLen, BoardDirections::AllLines, std::forward<F>(f));
+}
+
+#endif // BOARD_H
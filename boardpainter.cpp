@@ -0,0 +1,160 @@
+#include "boardpainter.h"
+#include "gameboard.h"
+#include "palette.h"
+#include "spritecache.h"
+
+#include <QPaintDevice>
+#include <QPainter>
+#include <QtMath>
+
+namespace {
+
+const QColor EmptyCellColor(240, 240, 240);
+const QColor GridColor(213, 219, 219);
+const QColor SelectedColor(220, 240, 255);
+const QColor HintFromColor(255, 236, 153);
+const QColor HintToColor(171, 235, 198);
+// ở chế độ LOD ô quá nhỏ để tô nền -> viền đậm hơn
+const QColor SelectedOutline(52, 152, 219);
+const QColor HintFromOutline(243, 156, 18);
+const QColor HintToOutline(39, 174, 96);
+
+} // namespace
+
+QRectF BoardPainter::cellRect(int row, int col) const
+{
+    return QRectF(m_origin.x() + col * m_cellSize, m_origin.y() + row * m_cellSize, m_cellSize, m_cellSize);
+}
+
+void BoardPainter::paint(QPainter &painter, const GameBoard &board, const Palette &palette, const QPointF &origin,
+                         double cellSize, int r0, int c0, int r1, int c1, const Marks &marks)
+{
+    if (r0 >= r1 || c0 >= c1) return;
+    m_origin = origin;
+    m_cellSize = cellSize;
+    if (isLevelOfDetail(cellSize)) paintFlat(painter, board, palette, r0, c0, r1, c1, marks);
+    else paintBalls(painter, board, palette, r0, c0, r1, c1, marks);
+}
+
+// LOD: mỗi ô 1 pixel trong m_flatImage, phóng to kiểu nearest-neighbour
+void BoardPainter::paintFlat(QPainter &painter, const GameBoard &board, const Palette &palette, int r0, int c0, int r1,
+                             int c1, const Marks &marks)
+{
+    const int w = c1 - c0, h = r1 - r0;
+    if (m_flatImage.width() != w || m_flatImage.height() != h) {
+        m_flatImage = QImage(w, h, QImage::Format_RGB32);
+    }
+
+    m_colorTable[0] = EmptyCellColor.rgb();
+    for (int i = 1; i < 256; ++i) {
+        m_colorTable[i] = palette.isValidIndex(i) ? palette.color(static_cast<quint8>(i)).rgb() : EmptyCellColor.rgb();
+    }
+
+    const uint8_t *cells = board.data();
+    const int cols = board.cols();
+    for (int r = r0; r < r1; ++r) {
+        const uint8_t *src = cells + static_cast<size_t>(r) * cols + c0;
+        QRgb *dst = reinterpret_cast<QRgb *>(m_flatImage.scanLine(r - r0));
+        for (int c = 0; c < w; ++c) dst[c] = m_colorTable[src[c]];
+    }
+    painter.drawImage(QRectF(m_origin.x() + c0 * m_cellSize, m_origin.y() + r0 * m_cellSize, w * m_cellSize, h * m_cellSize),
+                      m_flatImage);
+
+    paintMarker(painter, board, marks.selectedCell, SelectedOutline);
+    paintMarker(painter, board, marks.hintFrom, HintFromOutline);
+    paintMarker(painter, board, marks.hintTo, HintToOutline);
+}
+
+// Viền quanh ô, tối thiểu 5px để còn thấy khi zoom xa
+void BoardPainter::paintMarker(QPainter &painter, const GameBoard &board, int cell, const QColor &color)
+{
+    if (cell < 0 || cell >= board.cellCount()) return;
+    QRectF rect = cellRect(cell / board.cols(), cell % board.cols());
+    if (rect.width() < 5) rect = QRectF(rect.center() - QPointF(2.5, 2.5), QSizeF(5, 5));
+    painter.setPen(QPen(color, 2));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(rect);
+}
+
+void BoardPainter::paintBalls(QPainter &painter, const GameBoard &board, const Palette &palette, int r0, int c0, int r1,
+                              int c1, const Marks &marks)
+{
+    const double cs = m_cellSize;
+    const QRectF area(m_origin.x() + c0 * cs, m_origin.y() + r0 * cs, (c1 - c0) * cs, (r1 - r0) * cs);
+    painter.fillRect(area, EmptyCellColor);
+
+    // nền ô chọn / gợi ý (vẽ thừa ngoài vùng cũng không sao, painter đã clip)
+    auto fillCell = [&](int cell, const QColor &color) {
+        if (cell < 0 || cell >= board.cellCount()) return;
+        painter.fillRect(cellRect(cell / board.cols(), cell % board.cols()), color);
+    };
+    fillCell(marks.selectedCell, SelectedColor);
+    if (marks.hintFrom >= 0 && marks.hintTo >= 0) {
+        fillCell(marks.hintFrom, HintFromColor);
+        fillCell(marks.hintTo, HintToColor);
+    }
+
+    painter.setPen(GridColor);
+    for (int c = c0; c <= c1; ++c) {
+        const double x = m_origin.x() + c * cs;
+        painter.drawLine(QLineF(x, area.top(), x, area.bottom()));
+    }
+    for (int r = r0; r <= r1; ++r) {
+        const double y = m_origin.y() + r * cs;
+        painter.drawLine(QLineF(area.left(), y, area.right(), y));
+    }
+
+    // bóng: 60% ô như trước, sprite dựng sẵn, chỉ tra lại khi đổi màu
+    const int diameter = qMax(4, qRound(cs * 0.6));
+    const double radius = diameter / 2.0;
+    const qreal dpr = painter.device() ? painter.device()->devicePixelRatioF() : 1.0;
+    const bool widget = m_target == Target::Widget;
+    const uint8_t *cells = board.data();
+    const int cols = board.cols();
+    uint8_t spriteColor = Palette::Empty;
+    QPixmap pixmap;
+    QImage image;
+    for (int r = r0; r < r1; ++r) {
+        for (int c = c0; c < c1; ++c) {
+            const int cell = r * cols + c;
+            const uint8_t color = cells[cell];
+            if (color == Palette::Empty) continue;
+            if (color != spriteColor) {
+                if (widget) pixmap = SpriteCache::shared().ball(palette.color(color), diameter, dpr);
+                else image = spriteImage(palette.color(color), diameter, dpr);
+                spriteColor = color;
+            }
+            QPointF center(m_origin.x() + (c + 0.5) * cs, m_origin.y() + (r + 0.5) * cs);
+            if (cell == marks.selectedCell) center.ry() += marks.bounceOffset * cs / BounceCellSize;
+            const QPointF topLeft(center.x() - radius, center.y() - radius);
+            if (widget) painter.drawPixmap(topLeft, pixmap);
+            else painter.drawImage(topLeft, image);
+        }
+    }
+}
+
+// Như SpriteCache nhưng QImage và riêng từng BoardPainter (QPixmap không
+// dùng được ngoài luồng GUI)
+QImage BoardPainter::spriteImage(const QColor &color, int diameter, qreal dpr)
+{
+    const quint64 key = quint64(color.rgba()) | quint64(diameter & 0xffff) << 32
+                        | quint64(qRound(dpr * 100) & 0xffff) << 48;
+    auto it = m_sprites.constFind(key);
+    if (it != m_sprites.constEnd()) return it.value();
+
+    if (m_sprites.size() >= MaxSprites) m_sprites.clear();
+    const int pixels = qMax(1, qCeil(diameter * dpr));
+    QImage image(pixels, pixels, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(dpr);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(color);
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(QRectF(0, 0, diameter, diameter));
+    painter.end();
+
+    m_sprites.insert(key, image);
+    return image;
+}
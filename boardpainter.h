@@ -0,0 +1,61 @@
+#ifndef BOARDPAINTER_H
+#define BOARDPAINTER_H
+
+#include <QHash>
+#include <QImage>
+#include <QPointF>
+#include <QRectF>
+
+class GameBoard;
+class Palette;
+class QPainter;
+
+// Phần vẽ bàn dùng chung cho BoardView (widget) và ThumbnailRenderer
+// (QImage trên luồng worker): cùng màu, lưới, bóng, viền chọn / gợi ý.
+//  - Ô nhỏ hơn LodCellSize px: mỗi ô 1 pixel, phóng to không làm mịn.
+//  - Lớn hơn: nền ô, lưới, bóng tròn 60% ô từ sprite dựng sẵn.
+// Target::Widget lấy sprite QPixmap từ SpriteCache (chỉ luồng GUI);
+// Target::Image giữ sprite QImage riêng của từng BoardPainter, nên mỗi luồng
+// dùng một BoardPainter riêng là an toàn.
+class BoardPainter
+{
+public:
+    enum class Target { Widget, Image };
+    static constexpr double LodCellSize = 12.0;
+    static constexpr double BounceCellSize = 55.0;   // độ nảy -5..5 px tính theo ô này
+    static constexpr int MaxSprites = 256;
+
+    struct Marks {
+        int selectedCell = -1;
+        int bounceOffset = 0;
+        int hintFrom = -1;
+        int hintTo = -1;
+    };
+
+    explicit BoardPainter(Target target = Target::Widget) : m_target(target) {}
+
+    static bool isLevelOfDetail(double cellSize) { return cellSize < LodCellSize; }
+
+    // Ô [r0, r1) x [c0, c1) của bàn có góc trên trái tại origin, ô cellSize px
+    void paint(QPainter &painter, const GameBoard &board, const Palette &palette, const QPointF &origin,
+               double cellSize, int r0, int c0, int r1, int c1, const Marks &marks);
+
+private:
+    void paintFlat(QPainter &painter, const GameBoard &board, const Palette &palette, int r0, int c0, int r1, int c1,
+                   const Marks &marks);
+    void paintBalls(QPainter &painter, const GameBoard &board, const Palette &palette, int r0, int c0, int r1, int c1,
+                    const Marks &marks);
+    void paintMarker(QPainter &painter, const GameBoard &board, int cell, const QColor &color);
+    QImage spriteImage(const QColor &color, int diameter, qreal dpr);
+    QRectF cellRect(int row, int col) const;
+
+    Target m_target;
+    QPointF m_origin;
+    double m_cellSize = BounceCellSize;
+
+    QImage m_flatImage;                // ảnh 1 pixel / ô cho chế độ LOD, dùng lại giữa các lần vẽ
+    QRgb m_colorTable[256];
+    QHash<quint64, QImage> m_sprites;  // Target::Image
+};
+
+#endif // BOARDPAINTER_H
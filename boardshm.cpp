@@ -0,0 +1,274 @@
+#include "boardshm.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BoardShm {
+
+namespace {
+
+constexpr uint32_t CellsOffset = (sizeof(Header) + 63) / 64 * 64;
+
+#ifdef _WIN32
+std::string objectName(const std::string &name)
+{
+    return "Local\\" + name;
+}
+#else
+// POSIX: tên bắt đầu bằng '/', không có '/' nào khác
+std::string objectName(const std::string &name)
+{
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+bool fail(std::string *error, const std::string &what)
+{
+    if (error) *error = what + ": " + std::strerror(errno);
+    return false;
+}
+#endif
+
+} // namespace
+
+Segment::~Segment()
+{
+    unmap();
+}
+
+bool Segment::map(const std::string &name, size_t bytes, bool create, std::string *error)
+{
+    unmap();
+    const std::string object = objectName(name);
+#ifdef _WIN32
+    HANDLE handle;
+    if (create) {
+        handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, DWORD(uint64_t(bytes) >> 32),
+                                    DWORD(bytes), object.c_str());
+    } else {
+        handle = OpenFileMappingA(FILE_MAP_READ, FALSE, object.c_str());
+    }
+    if (!handle) {
+        if (error) *error = object + ": error " + std::to_string(GetLastError());
+        return false;
+    }
+    void *base = MapViewOfFile(handle, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, create ? bytes : 0);
+    if (!base) {
+        if (error) *error = object + ": error " + std::to_string(GetLastError());
+        CloseHandle(handle);
+        return false;
+    }
+    if (!create) {
+        MEMORY_BASIC_INFORMATION info{};
+        VirtualQuery(base, &info, sizeof info);
+        bytes = info.RegionSize;
+    }
+    m_handle = handle;
+#else
+    int fd;
+    if (create) {
+        // segment cũ còn sót lại sau khi crash
+        shm_unlink(object.c_str());
+        fd = shm_open(object.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) return fail(error, object);
+        if (ftruncate(fd, off_t(bytes)) != 0) {
+            const bool result = fail(error, object);
+            close(fd);
+            shm_unlink(object.c_str());
+            return result;
+        }
+    } else {
+        fd = shm_open(object.c_str(), O_RDONLY, 0);
+        if (fd < 0) return fail(error, object);
+        struct stat st {};
+        if (fstat(fd, &st) != 0) {
+            const bool result = fail(error, object);
+            close(fd);
+            return result;
+        }
+        bytes = size_t(st.st_size);
+    }
+    void *base = bytes > 0 ? mmap(nullptr, bytes, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0)
+                           : MAP_FAILED;
+    const bool mapped = base != MAP_FAILED;
+    const bool result = mapped || fail(error, object);
+    close(fd);      // mapping giữ segment
+    if (!mapped) {
+        if (create) shm_unlink(object.c_str());
+        return result;
+    }
+#endif
+    m_name = object;
+    m_base = base;
+    m_bytes = bytes;
+    m_owner = create;
+    return true;
+}
+
+void Segment::unmap()
+{
+    if (!m_base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_base);
+    CloseHandle(m_handle);
+    m_handle = nullptr;
+#else
+    munmap(m_base, m_bytes);
+    // reader đang mở vẫn đọc được tới khi tự đóng
+    if (m_owner) shm_unlink(m_name.c_str());
+#endif
+    m_base = nullptr;
+    m_bytes = 0;
+    m_owner = false;
+}
+
+bool Writer::open(const std::string &name, size_t capacity, std::string *error)
+{
+    if (capacity == 0 || capacity > UINT32_MAX - CellsOffset) {
+        if (error) *error = "bad capacity";
+        return false;
+    }
+    if (!map(name, CellsOffset + capacity, true, error)) return false;
+
+    Header *h = new (m_base) Header{};
+    h->version = Version;
+    h->capacity = uint32_t(capacity);
+    h->cellsOffset = CellsOffset;
+    h->selectedCell = -1;
+    // magic cuối cùng: reader mở sớm thấy segment chưa sẵn sàng
+    std::atomic_thread_fence(std::memory_order_release);
+    h->magic = Magic;
+    return true;
+}
+
+size_t Writer::capacity() const
+{
+    return m_base ? header()->capacity : 0;
+}
+
+uint8_t *Writer::cells() const
+{
+    return static_cast<uint8_t *>(m_base) + CellsOffset;
+}
+
+uint64_t Writer::beginWrite()
+{
+    const uint64_t seq = header()->seq.load(std::memory_order_relaxed);
+    header()->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return seq + 2;
+}
+
+void Writer::endWrite(uint64_t seq)
+{
+    header()->seq.store(seq, std::memory_order_release);
+}
+
+bool Writer::publish(const GameBoard &board, const std::vector<uint32_t> &palette, const Status &status)
+{
+    if (!m_base || size_t(board.cellCount()) > capacity()) return false;
+    Header *h = header();
+    const uint64_t seq = beginWrite();
+    h->rows = board.rows();
+    h->cols = board.cols();
+    h->selectedCell = status.selectedCell;
+    h->ballCount = status.ballCount;
+    h->turn = status.turn;
+    h->paletteSize = uint32_t(std::min<size_t>(palette.size(), MaxPalette));
+    std::copy_n(palette.begin(), h->paletteSize, h->palette);
+    std::memcpy(cells(), board.data(), size_t(board.cellCount()));
+    endWrite(seq);
+    return true;
+}
+
+bool Writer::update(const GameBoard &board, const int *changed, size_t count, const Status &status)
+{
+    if (!m_base || size_t(board.cellCount()) > capacity()) return false;
+    Header *h = header();
+    const size_t n = size_t(board.cellCount());
+    const uint64_t seq = beginWrite();
+    if (h->rows != board.rows() || h->cols != board.cols() || count * 4 > n) {
+        h->rows = board.rows();
+        h->cols = board.cols();
+        std::memcpy(cells(), board.data(), n);
+    } else {
+        uint8_t *out = cells();
+        const uint8_t *in = board.data();
+        for (size_t i = 0; i < count; ++i) out[changed[i]] = in[changed[i]];
+    }
+    h->selectedCell = status.selectedCell;
+    h->ballCount = status.ballCount;
+    h->turn = status.turn;
+    endWrite(seq);
+    return true;
+}
+
+bool Reader::open(const std::string &name, std::string *error)
+{
+    if (!map(name, 0, false, error)) return false;
+    const Header *h = header();
+    const char *problem = nullptr;
+    if (m_bytes < sizeof(Header) || h->magic != Magic) problem = "not a board segment (or not ready yet)";
+    else if (h->version != Version) problem = "unsupported segment version";
+    else if (size_t(h->cellsOffset) + h->capacity > m_bytes || h->cellsOffset < sizeof(Header)) problem = "bad segment size";
+    if (problem) {
+        if (error) *error = m_name + ": " + problem;
+        unmap();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+uint64_t Reader::seq() const
+{
+    return m_base ? header()->seq.load(std::memory_order_acquire) : 0;
+}
+
+bool Reader::read(Snapshot &out, int maxAttempts)
+{
+    if (!m_base) return false;
+    const Header *h = header();
+    const uint8_t *cells = static_cast<const uint8_t *>(m_base) + h->cellsOffset;
+    for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+        if (attempt > 0) {
+            ++m_retries;
+            if (attempt % 64 == 0) std::this_thread::yield();
+        }
+        const uint64_t seq = h->seq.load(std::memory_order_acquire);
+        if (seq & 1) continue;
+
+        // giá trị có thể bị ghi đè giữa chừng: kiểm tra trước khi dùng làm kích thước
+        const int rows = h->rows, cols = h->cols;
+        const uint32_t paletteSize = h->paletteSize;
+        if (rows < 0 || cols < 0 || uint64_t(rows) * uint64_t(cols) > h->capacity || paletteSize > MaxPalette)
+            continue;
+        out.rows = rows;
+        out.cols = cols;
+        out.status.selectedCell = h->selectedCell;
+        out.status.ballCount = h->ballCount;
+        out.status.turn = h->turn;
+        out.palette.assign(h->palette, h->palette + paletteSize);
+        out.cells.assign(cells, cells + size_t(rows) * size_t(cols));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (h->seq.load(std::memory_order_relaxed) == seq) {
+            out.seq = seq;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace BoardShm
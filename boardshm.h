@@ -0,0 +1,123 @@
+#ifndef BOARDSHM_H
+#define BOARDSHM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gameboard.h"
+
+// Board exported into a named shared-memory segment so external tools and
+// bots can read it without any serialisation, Qt-free (POSIX shm_open on
+// Linux / macOS, a named file mapping on Windows).
+//
+// Layout (same machine, so native byte order):
+//   Header | cells[capacity] u8, row major, 0 = empty, else palette index
+// A seqlock guards everything after `seq`: the writer makes seq odd, writes,
+// then makes it even again; a reader copies, then checks seq did not move
+// and retries otherwise. The writer never waits for readers, and a reader
+// that polls seq() alone costs one load.
+namespace BoardShm {
+
+constexpr uint32_t Magic = 0x4d534742u;     // "BGSM"
+constexpr uint32_t Version = 1;
+constexpr int MaxPalette = 255;
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;          // số ô tối đa của segment
+    uint32_t cellsOffset;       // byte từ đầu segment tới cells
+    alignas(64) std::atomic<uint64_t> seq;
+    int32_t rows;
+    int32_t cols;
+    int32_t selectedCell;       // ô của bóng đang chọn, -1 nếu không có
+    int32_t ballCount;
+    uint64_t turn;              // số lượt tính từ đầu ván (lùi khi undo)
+    uint32_t paletteSize;
+    uint32_t palette[MaxPalette];   // 0xAARRGGBB, palette[i] là màu của chỉ số i + 1
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs a lock-free 64-bit atomic across processes");
+
+// Phần không thuộc ô của trạng thái
+struct Status {
+    int selectedCell = -1;
+    uint64_t turn = 0;
+    int ballCount = 0;
+    bool operator==(const Status &) const = default;
+};
+
+struct Snapshot {
+    uint64_t seq = 0;
+    int rows = 0;
+    int cols = 0;
+    Status status;
+    std::vector<uint32_t> palette;
+    std::vector<uint8_t> cells;
+};
+
+class Segment
+{
+public:
+    Segment() = default;
+    ~Segment();
+    Segment(const Segment &) = delete;
+    Segment &operator=(const Segment &) = delete;
+
+protected:
+    bool map(const std::string &name, size_t bytes, bool create, std::string *error);
+    void unmap();
+
+    std::string m_name;
+    void *m_base = nullptr;
+    size_t m_bytes = 0;
+    bool m_owner = false;
+#ifdef _WIN32
+    void *m_handle = nullptr;
+#endif
+};
+
+// Phía game: tạo segment, ghi cả bàn hoặc chỉ các ô vừa đổi
+class Writer : public Segment
+{
+public:
+    // Segment đủ cho capacity ô (trang chưa chạm tới không tốn RAM)
+    bool open(const std::string &name, size_t capacity, std::string *error = nullptr);
+    bool isOpen() const { return m_base != nullptr; }
+    size_t capacity() const;
+
+    // Cả bàn + palette (ván mới, load, đổi kích thước); false nếu bàn lớn hơn capacity
+    bool publish(const GameBoard &board, const std::vector<uint32_t> &palette, const Status &status);
+    // Các ô trong changed (có thể trùng) đã đổi từ lần ghi trước; nhiều quá thì chép cả bàn
+    bool update(const GameBoard &board, const int *changed, size_t count, const Status &status);
+
+private:
+    Header *header() const { return static_cast<Header *>(m_base); }
+    uint8_t *cells() const;
+    uint64_t beginWrite();
+    void endWrite(uint64_t seq);
+};
+
+// Phía tool: mở segment đã có, chép ra snapshot nhất quán
+class Reader : public Segment
+{
+public:
+    bool open(const std::string &name, std::string *error = nullptr);
+    bool isOpen() const { return m_base != nullptr; }
+
+    // Đổi mỗi lần writer ghi; lẻ = đang ghi
+    uint64_t seq() const;
+    // false nếu sau maxAttempts lần writer vẫn đang ghi đè (rất hiếm)
+    bool read(Snapshot &out, int maxAttempts = 1000);
+    uint64_t retries() const { return m_retries; }
+
+private:
+    const Header *header() const { return static_cast<const Header *>(m_base); }
+    uint64_t m_retries = 0;
+};
+
+} // namespace BoardShm
+
+#endif // BOARDSHM_H
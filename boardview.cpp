@@ -0,0 +1,303 @@
+#include "boardview.h"
+#include "gameboard.h"
+#include "palette.h"
+#include "latencytracker.h"
+#include "animationscheduler.h"
+
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWheelEvent>
+
+#include <cmath>
+
+namespace {
+
+const QColor BackgroundColor(236, 240, 241);   // #ecf0f1 như rightContent
+QPointF mousePos(const QMouseEvent *event)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return event->position();
+#else
+    return event->localPos();
+#endif
+}
+QPointF mousePos(const QWheelEvent *event)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    return event->position();
+#else
+    return event->posF();
+#endif
+}
+
+} // namespace
+
+BoardView::BoardView(const GameBoard &board, const Palette &palette, QWidget *parent)
+    : QWidget(parent), m_board(board), m_palette(palette)
+{
+    setMinimumSize(200, 200);
+    setFocusPolicy(Qt::NoFocus);
+    setAttribute(Qt::WA_OpaquePaintEvent);     // paintEvent tô kín vùng cần vẽ
+    syncLayout();
+}
+
+void BoardView::syncLayout()
+{
+    if (m_layoutRows == m_board.rows() && m_layoutCols == m_board.cols()) return;
+    m_layoutRows = m_board.rows();
+    m_layoutCols = m_board.cols();
+    m_autoFit = true;
+    m_cellSize = fitCellSize();
+    clampOrigin();
+}
+
+double BoardView::fitCellSize() const
+{
+    if (m_board.rows() <= 0 || m_board.cols() <= 0) return MaxFitCellSize;
+    const double fit = qMin((width() - 4.0) / m_board.cols(), (height() - 4.0) / m_board.rows());
+    return qBound(0.05, fit, MaxFitCellSize);
+}
+
+void BoardView::fitToView()
+{
+    m_autoFit = true;
+    m_cellSize = fitCellSize();
+    clampOrigin();
+    update();
+}
+
+// Bàn nhỏ hơn widget thì nằm giữa, lớn hơn thì không kéo ra khỏi mép
+void BoardView::clampOrigin()
+{
+    const double boardW = m_board.cols() * m_cellSize;
+    const double boardH = m_board.rows() * m_cellSize;
+    if (boardW <= width()) m_origin.setX((width() - boardW) / 2);
+    else m_origin.setX(qBound(width() - boardW, m_origin.x(), 0.0));
+    if (boardH <= height()) m_origin.setY((height() - boardH) / 2);
+    else m_origin.setY(qBound(height() - boardH, m_origin.y(), 0.0));
+}
+
+bool BoardView::cellAt(const QPointF &pos, int &row, int &col) const
+{
+    const double x = (pos.x() - m_origin.x()) / m_cellSize;
+    const double y = (pos.y() - m_origin.y()) / m_cellSize;
+    if (x < 0 || y < 0) return false;
+    row = static_cast<int>(y);
+    col = static_cast<int>(x);
+    return row < m_board.rows() && col < m_board.cols();
+}
+
+QRectF BoardView::cellRect(int row, int col) const
+{
+    return QRectF(m_origin.x() + col * m_cellSize, m_origin.y() + row * m_cellSize, m_cellSize, m_cellSize);
+}
+
+void BoardView::updateCell(int cell)
+{
+    if (cell < 0 || cell >= m_board.cellCount()) return;
+    // +3px: viền LOD có cỡ tối thiểu lớn hơn ô
+    update(cellRect(cell / m_board.cols(), cell % m_board.cols()).toAlignedRect().adjusted(-3, -3, 3, 3));
+}
+
+void BoardView::setSelectedCell(int cell, int bounceOffset)
+{
+    if (cell == m_selectedCell && bounceOffset == m_bounceOffset) return;
+    updateCell(m_selectedCell);
+    m_selectedCell = cell;
+    m_bounceOffset = bounceOffset;
+    updateCell(m_selectedCell);
+}
+
+void BoardView::setHintCells(int from, int to)
+{
+    if (from == m_hintFrom && to == m_hintTo) return;
+    updateCell(m_hintFrom);
+    updateCell(m_hintTo);
+    m_hintFrom = from;
+    m_hintTo = to;
+    updateCell(m_hintFrom);
+    updateCell(m_hintTo);
+}
+
+void BoardView::visibleRange(const QRectF &rect, int &r0, int &c0, int &r1, int &c1) const
+{
+    c0 = qBound(0, static_cast<int>(std::floor((rect.left() - m_origin.x()) / m_cellSize)), m_board.cols());
+    c1 = qBound(0, static_cast<int>(std::ceil((rect.right() - m_origin.x()) / m_cellSize)), m_board.cols());
+    r0 = qBound(0, static_cast<int>(std::floor((rect.top() - m_origin.y()) / m_cellSize)), m_board.rows());
+    r1 = qBound(0, static_cast<int>(std::ceil((rect.bottom() - m_origin.y()) / m_cellSize)), m_board.rows());
+}
+
+void BoardView::paintEvent(QPaintEvent *event)
+{
+    const qint64 start = LatencyTracker::nowNs();
+    syncLayout();
+
+    QPainter painter(this);
+    painter.fillRect(event->rect(), BackgroundColor);
+
+    int r0, c0, r1, c1;
+    visibleRange(QRectF(event->rect()), r0, c0, r1, c1);
+    if (r0 >= r1 || c0 >= c1) {
+        painter.end();
+        m_lastPaintNs = LatencyTracker::nowNs() - start;
+        emit framePainted();
+        return;
+    }
+
+    BoardPainter::Marks marks;
+    marks.selectedCell = m_selectedCell;
+    marks.bounceOffset = m_bounceOffset;
+    marks.hintFrom = m_hintFrom;
+    marks.hintTo = m_hintTo;
+    m_painter.paint(painter, m_board, m_palette, m_origin, m_cellSize, r0, c0, r1, c1, marks);
+    paintParticles(painter, QRectF(event->rect()));
+    painter.end();
+    m_lastPaintNs = LatencyTracker::nowNs() - start;
+    emit framePainted();
+}
+
+void BoardView::addClearEffect(const QVector<QPoint> &cells)
+{
+    const int n = cells.size();
+    if (n == 0) return;
+    if (!m_particles) m_particles = std::make_unique<ParticleSystem>();
+    const int free = m_particles->freeSlots();
+    if (free == 0) return;
+
+    // mỗi bóng `per` hạt; ngân sách không đủ 1 hạt / bóng thì bỏ qua bớt bóng
+    const int per = qBound(1, free / n, ParticleSystem::FragmentsPerBurst + 1);
+    const int stride = per * n > free ? (n + free - 1) / free : 1;
+    for (int i = 0; i < n; i += stride) {
+        const QPoint &p = cells[i];
+        if (!m_board.inBounds(p.x(), p.y()) || m_board.isEmpty(p.x(), p.y())) continue;
+        if (m_particles->burst(p.y() + 0.5f, p.x() + 0.5f, m_board.at(p.x(), p.y()), per) == 0) break;
+    }
+
+    if (!m_particles->empty() && !AnimationScheduler::shared().contains(m_particleAnimation))
+        m_particleAnimation = AnimationScheduler::shared().add(this, [this](float dt) { return particleTick(dt); });
+    update(particleBounds());
+}
+
+// Vùng widget phủ mọi hạt (+ lề cho antialias)
+QRect BoardView::particleBounds() const
+{
+    float x0, y0, x1, y1;
+    if (!m_particles || !m_particles->bounds(x0, y0, x1, y1)) return QRect();
+    return QRectF(m_origin.x() + x0 * m_cellSize, m_origin.y() + y0 * m_cellSize,
+                  (x1 - x0) * m_cellSize, (y1 - y0) * m_cellSize)
+        .toAlignedRect()
+        .adjusted(-2, -2, 2, 2);
+}
+
+// Chỉ đăng ký với scheduler khi còn hạt, tự gỡ ngay khi hạt cuối biến mất
+bool BoardView::particleTick(float dt)
+{
+    const QRect before = particleBounds();
+    m_particles->update(dt);
+    update(before.united(particleBounds()));
+    return !m_particles->empty();
+}
+
+// Hạt trong vùng cần vẽ: tròn mờ dần khi zoom gần, ô vuông khi ở chế độ LOD
+void BoardView::paintParticles(QPainter &painter, const QRectF &dirty)
+{
+    if (!m_particles || m_particles->empty()) return;
+    const ParticleSystem &particles = *m_particles;
+
+    const bool flat = isLevelOfDetail();
+    painter.setRenderHint(QPainter::Antialiasing, !flat);
+    painter.setPen(Qt::NoPen);
+    for (int i = 0; i < particles.size(); ++i) {
+        const double d = qMax(1.0, particles.size(i) * m_cellSize);
+        const QRectF rect(m_origin.x() + particles.x(i) * m_cellSize - d / 2,
+                          m_origin.y() + particles.y(i) * m_cellSize - d / 2, d, d);
+        if (!rect.intersects(dirty)) continue;
+
+        QColor color = m_palette.color(particles.color(i));
+        color.setAlphaF(particles.alpha(i));
+        if (flat) {
+            painter.fillRect(rect, color);
+        } else {
+            painter.setBrush(color);
+            painter.drawEllipse(rect);
+        }
+    }
+}
+
+void BoardView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    const double fit = fitCellSize();
+    if (m_autoFit || m_cellSize < fit) m_cellSize = fit;
+    clampOrigin();
+}
+
+// Zoom quanh con trỏ; nhỏ nhất là vừa khít cả bàn
+void BoardView::wheelEvent(QWheelEvent *event)
+{
+    const double steps = event->angleDelta().y() / 120.0;
+    if (steps == 0) return;
+
+    const double fit = fitCellSize();
+    const double size = qBound(fit, m_cellSize * std::pow(1.25, steps), qMax(fit, MaxCellSize));
+    const QPointF pos = mousePos(event);
+    m_origin = pos - (pos - m_origin) * (size / m_cellSize);
+    m_cellSize = size;
+    m_autoFit = size <= fit;
+    clampOrigin();
+    update();
+    event->accept();
+}
+
+void BoardView::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) return;
+    m_pressed = true;
+    m_dragging = false;
+    m_pressPos = mousePos(event);
+    m_pressOrigin = m_origin;
+}
+
+void BoardView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_pressed) return;
+    const QPointF delta = mousePos(event) - m_pressPos;
+    if (!m_dragging && delta.manhattanLength() < QApplication::startDragDistance()) return;
+    if (!m_dragging) {
+        m_dragging = true;
+        setCursor(Qt::ClosedHandCursor);
+    }
+    m_origin = m_pressOrigin + delta;
+    m_autoFit = false;
+    clampOrigin();
+    update();
+}
+
+// Nhấn rồi thả không kéo = click vào ô.
+// timestamp() của sự kiện theo đồng hồ ms của hệ thống cửa sổ: độ lệch nhỏ
+// nhất giữa lúc nhận và timestamp ứng với lúc không phải chờ, phần lệch vượt
+// hơn là thời gian sự kiện nằm trong hàng đợi (sau bounceUpdated, vẽ lại...)
+void BoardView::mouseReleaseEvent(QMouseEvent *event)
+{
+    const qint64 now = LatencyTracker::nowNs();
+    m_clickArrivalNs = now;
+    if (event->timestamp() != 0) {
+        const qint64 offsetMs = now / 1000000 - static_cast<qint64>(event->timestamp());
+        // > 10 s: đồng hồ sự kiện quay vòng / nhảy -> lấy mốc mới
+        if (!m_haveEventOffset || offsetMs < m_minEventOffsetMs || offsetMs - m_minEventOffsetMs > 10000) {
+            m_minEventOffsetMs = offsetMs;
+            m_haveEventOffset = true;
+        }
+        m_clickArrivalNs = now - (offsetMs - m_minEventOffsetMs) * 1000000;
+    }
+
+    if (event->button() != Qt::LeftButton || !m_pressed) return;
+    const bool clicked = !m_dragging;
+    m_pressed = m_dragging = false;
+    unsetCursor();
+
+    int row, col;
+    if (clicked && cellAt(mousePos(event), row, col)) emit cellClicked(row, col);
+}
@@ -0,0 +1,118 @@
+#ifndef BOARDVIEW_H
+#define BOARDVIEW_H
+
+#include <QWidget>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+#include <QPoint>
+#include <memory>
+
+#include "boardpainter.h"
+#include "particlesystem.h"
+
+class GameBoard;
+class Palette;
+
+// Vẽ trực tiếp GameBoard, không có widget/item cho từng ô.
+//  - Cuộn chuột để zoom quanh con trỏ, kéo chuột để di chuyển bàn.
+//  - paintEvent chỉ duyệt các ô nằm trong vùng cần vẽ.
+//  - Vẽ ô qua BoardPainter (dùng chung với ThumbnailRenderer): ô nhỏ hơn
+//    LodCellSize px là 1 pixel / ô phóng to không làm mịn, lớn hơn là bóng tròn.
+//  - Hiệu ứng vỡ bóng: ParticleSystem vẽ trong cùng paintEvent, tick qua
+//    AnimationScheduler dùng chung, chỉ đăng ký khi còn hạt.
+//  - Sprite bóng lấy từ SpriteCache dùng chung, nhiều BoardView không vẽ lại.
+// Board và palette thuộc về MainWindow; gọi update() sau khi chúng đổi.
+class BoardView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr double LodCellSize = BoardPainter::LodCellSize;
+    static constexpr double MaxCellSize = 96.0;
+    static constexpr double MaxFitCellSize = 55.0;   // cỡ ô cũ của QTableWidget
+
+    BoardView(const GameBoard &board, const Palette &palette, QWidget *parent = nullptr);
+
+    double cellSize() const { return m_cellSize; }
+    bool isLevelOfDetail() const { return BoardPainter::isLevelOfDetail(m_cellSize); }
+
+    // Cả bàn vừa khít widget (bỏ zoom / pan của người dùng)
+    void fitToView();
+
+    // Ô đang chọn (nền xanh nhạt) và độ nảy của bóng trong ô đó, -1 nếu không có
+    void setSelectedCell(int cell, int bounceOffset);
+    // Ô nguồn / đích của gợi ý, -1 nếu không có
+    void setHintCells(int from, int to);
+
+    // Bóng tại các ô (row, col) sắp bị xóa vỡ ra; gọi trước khi xóa khỏi board.
+    // Số hạt chia đều trong ngân sách của pool, hết ngân sách thì chỉ còn
+    // một phần các bóng có hiệu ứng.
+    void addClearEffect(const QVector<QPoint> &cells);
+    int particleCount() const { return m_particles ? m_particles->size() : 0; }
+
+    // (row, col) dưới điểm pos của widget; false nếu ngoài bàn
+    bool cellAt(const QPointF &pos, int &row, int &col) const;
+    QRectF cellRect(int row, int col) const;
+
+    // Lúc click cuối cùng tới process (LatencyTracker::nowNs), đã trừ thời
+    // gian ước tính nằm trong hàng đợi sự kiện
+    qint64 lastClickArrivalNs() const { return m_clickArrivalNs; }
+    // Thời gian của paintEvent vừa xong (đọc trong framePainted)
+    qint64 lastPaintNs() const { return m_lastPaintNs; }
+
+signals:
+    void cellClicked(int row, int column);
+    void framePainted();               // sau mỗi paintEvent (đo độ trễ click -> hình)
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    void syncLayout();                 // board đổi kích thước -> vừa khít lại
+    double fitCellSize() const;
+    void clampOrigin();
+    void updateCell(int cell);
+    // Khoảng ô [r0, r1) x [c0, c1) giao với rect của widget
+    void visibleRange(const QRectF &rect, int &r0, int &c0, int &r1, int &c1) const;
+    void paintParticles(QPainter &painter, const QRectF &dirty);
+    bool particleTick(float dt);
+    QRect particleBounds() const;
+
+    const GameBoard &m_board;
+    const Palette &m_palette;
+    int m_layoutRows = -1;
+    int m_layoutCols = -1;
+
+    double m_cellSize = MaxFitCellSize;
+    QPointF m_origin;                  // vị trí góc trên trái của bàn trong widget
+    bool m_autoFit = true;             // chưa zoom / kéo -> resize thì vừa khít lại
+
+    int m_selectedCell = -1;
+    int m_bounceOffset = 0;
+    int m_hintFrom = -1;
+    int m_hintTo = -1;
+
+    // kéo chuột
+    QPointF m_pressPos;
+    QPointF m_pressOrigin;
+    bool m_pressed = false;
+    bool m_dragging = false;
+
+    qint64 m_clickArrivalNs = 0;
+    qint64 m_minEventOffsetMs = 0;     // nhỏ nhất của (lúc nhận - timestamp sự kiện)
+    bool m_haveEventOffset = false;
+    qint64 m_lastPaintNs = 0;
+
+    std::unique_ptr<ParticleSystem> m_particles;   // ~116 KB, tạo ở hiệu ứng đầu tiên (bàn của BoardWall không dùng)
+    int m_particleAnimation = 0;       // id trong AnimationScheduler
+
+    BoardPainter m_painter{BoardPainter::Target::Widget};
+};
+
+#endif // BOARDVIEW_H
@@ -0,0 +1,139 @@
+#include "boardwall.h"
+#include "animationscheduler.h"
+#include "spritecache.h"
+#include "workerpool.h"
+
+#include <QElapsedTimer>
+#include <QGridLayout>
+#include <QRandomGenerator>
+#include <QVBoxLayout>
+#include <QtMath>
+
+BoardWall::BoardWall(int boardCount, const GameRules &rules, QWidget *parent)
+    : QWidget(parent), m_hints(WorkerPool::shared())
+{
+    m_rng.setState(QRandomGenerator::global()->generate64());
+    m_hints.setRules(rules);
+
+    const int count = qBound(1, boardCount, MaxBoards);
+    const int columns = qCeil(qSqrt(count));
+    auto *grid = new QGridLayout(this);
+    grid->setSpacing(6);
+
+    m_slots.resize(count);
+    for (int i = 0; i < count; ++i) {
+        Slot &slot = m_slots[i];
+        slot.engine = std::make_unique<GameEngine>(rules);
+        slot.engine->reset(m_rng.next());
+        slot.greedy = i % 2 == 1;
+
+        // chỉ xem: cellClicked không nối vào đâu
+        auto *cell = new QWidget(this);
+        auto *layout = new QVBoxLayout(cell);
+        layout->setContentsMargins(0, 0, 0, 0);
+        slot.view = new BoardView(slot.engine->board(), m_palette, cell);
+        slot.view->setMinimumSize(120, 120);
+        slot.label = new QLabel(cell);
+        layout->addWidget(slot.view, 1);
+        layout->addWidget(slot.label);
+        grid->addWidget(cell, i / columns, i % columns);
+        updateLabel(slot, i);
+    }
+
+    m_animation = AnimationScheduler::shared().add(this, [this](float dt) { return tick(dt); });
+    updateTitle();
+}
+
+// Gỡ tick trước khi các engine bị hủy (destroyed() chỉ phát sau đó)
+BoardWall::~BoardWall()
+{
+    AnimationScheduler::shared().remove(m_animation);
+}
+
+size_t BoardWall::boardBytes() const
+{
+    size_t bytes = 0;
+    for (const Slot &slot : m_slots) bytes += slot.engine->memoryBytes();
+    return bytes;
+}
+
+// Một entry trong scheduler cho cả tường; mỗi StepSeconds mọi bàn đi một nước.
+// HintEngine chạy trên luồng GUI trong tick chung, nên mỗi tick chỉ đi các bàn
+// còn nước cho tới hết HintBudgetMs (ít nhất một bàn); tick sau tiếp tục từ bàn
+// kế tiếp, để 64 bàn gợi ý không dồn vào một frame.
+bool BoardWall::tick(float dt)
+{
+    m_elapsed += dt;
+    if (m_elapsed >= StepSeconds) {
+        m_elapsed = 0;
+        for (Slot &slot : m_slots) slot.pending = true;
+    }
+
+    QElapsedTimer budget;
+    budget.start();
+    const int count = boardCount();
+    int stepped = 0;
+    for (int n = 0; n < count; ++n) {
+        const int i = (m_cursor + n) % count;
+        Slot &slot = m_slots[i];
+        if (!slot.pending) continue;
+        if (stepped > 0 && budget.nsecsElapsed() >= HintBudgetMs * 1000000LL) {
+            m_cursor = i;
+            break;
+        }
+        slot.pending = false;
+        stepBoard(slot);
+        updateLabel(slot, i);
+        ++stepped;
+    }
+    if (stepped > 0) updateTitle();
+    return true;
+}
+
+void BoardWall::stepBoard(Slot &slot)
+{
+    GameEngine &engine = *slot.engine;
+    if (engine.isOver()) {
+        // hết nước: ván mới với seed mới, bàn giữ nguyên bộ nhớ đã cấp
+        engine.reset(m_rng.next());
+        ++slot.games;
+        slot.view->update();
+        return;
+    }
+
+    int from = -1, to = -1;
+    if (slot.greedy) {
+        const std::vector<HintMove> &best = m_hints.bestMoves(engine.board(), engine.regions(), 1);
+        if (!best.empty()) {
+            from = best.front().from;
+            to = best.front().to;
+        }
+    } else {
+        engine.randomMove(m_rng, from, to);
+    }
+    if (from < 0) return;
+
+    engine.step(from, to);
+    slot.view->update();
+}
+
+void BoardWall::updateLabel(const Slot &slot, int index)
+{
+    const GameEngine &engine = *slot.engine;
+    slot.label->setText(QString("#%1 %2 · ván %3 · lượt %4 · điểm %5 · %6 B")
+                            .arg(index + 1)
+                            .arg(slot.greedy ? "gợi ý" : "ngẫu nhiên")
+                            .arg(slot.games + 1)
+                            .arg(engine.turns())
+                            .arg(engine.score())
+                            .arg(engine.memoryBytes()));
+}
+
+void BoardWall::updateTitle()
+{
+    setWindowTitle(QString("Ball Game - %1 bàn, %2 KB dữ liệu bàn, %3 sprite, %4 animation")
+                       .arg(boardCount())
+                       .arg(boardBytes() / 1024.0, 0, 'f', 1)
+                       .arg(SpriteCache::shared().size())
+                       .arg(AnimationScheduler::shared().activeCount()));
+}
@@ -0,0 +1,65 @@
+#ifndef BOARDWALL_H
+#define BOARDWALL_H
+
+#include <QLabel>
+#include <QWidget>
+
+#include <memory>
+#include <vector>
+
+#include "boardview.h"
+#include "gameengine.h"
+#include "hintengine.h"
+#include "palette.h"
+#include "rng.h"
+
+// Nhiều bàn chơi cùng lúc trong một cửa sổ (--boards N), mỗi bàn do bot tự
+// chơi. Mỗi bàn chỉ có dữ liệu của riêng nó: một GameEngine (~4 KB cho 10x10),
+// một BoardView (không có pool hạt: chỉ tạo khi có hiệu ứng vỡ bóng) và một
+// nhãn. Mọi thứ còn lại dùng chung:
+//  - AnimationScheduler::shared(): một tick cho tất cả bàn (không thread/timer riêng)
+//  - SpriteCache::shared(): sprite bóng vẽ một lần cho mọi bàn
+//  - WorkerPool::shared() + một HintEngine: bot "gợi ý" chấm nước đi, tối đa
+//    HintBudgetMs mỗi tick; bàn chưa kịp đi thì đi ở tick sau
+//  - một Palette
+class BoardWall : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxBoards = 64;
+    static constexpr float StepSeconds = 0.25f;   // mỗi bàn đi một nước sau mỗi khoảng này
+    static constexpr int HintBudgetMs = 4;        // thời gian tối đa cho các nước đi trong một tick
+
+    BoardWall(int boardCount, const GameRules &rules, QWidget *parent = nullptr);
+    ~BoardWall() override;
+
+    int boardCount() const { return static_cast<int>(m_slots.size()); }
+    // Tổng dữ liệu riêng của các bàn (engine), không tính phần dùng chung
+    size_t boardBytes() const;
+
+private:
+    struct Slot {
+        std::unique_ptr<GameEngine> engine;
+        BoardView *view = nullptr;
+        QLabel *label = nullptr;
+        bool greedy = false;            // bàn chẵn chơi ngẫu nhiên, bàn lẻ theo HintEngine
+        bool pending = false;           // còn một nước chưa đi trong đợt StepSeconds này
+        int games = 0;
+    };
+
+    bool tick(float dt);
+    void stepBoard(Slot &slot);
+    void updateLabel(const Slot &slot, int index);
+    void updateTitle();
+
+    Palette m_palette;
+    HintEngine m_hints;
+    Rng m_rng;
+    std::vector<Slot> m_slots;          // Slot chỉ move được (unique_ptr), QVector cần copy
+    float m_elapsed = 0;
+    int m_cursor = 0;                  // bàn đầu tiên được đi ở tick sau
+    int m_animation = 0;               // id trong AnimationScheduler
+};
+
+#endif // BOARDWALL_H
@@ -0,0 +1,289 @@
+#include "emptyregions.h"
+#include "gameboard.h"
+
+#include <algorithm>
+
+EmptyRegions::EmptyRegions(const GameBoard &board)
+    : m_board(board)
+{
+    reset();
+}
+
+int EmptyRegions::neighbours(int cell, int *out) const
+{
+    const int rows = m_board.rows(), cols = m_board.cols();
+    const int r = cell / cols, c = cell % cols;
+    int count = 0;
+    if (r > 0) out[count++] = cell - cols;
+    if (r + 1 < rows) out[count++] = cell + cols;
+    if (c > 0) out[count++] = cell - 1;
+    if (c + 1 < cols) out[count++] = cell + 1;
+    return count;
+}
+
+int EmptyRegions::newId()
+{
+    ++m_regionCount;
+    if (!m_freeIds.empty()) {
+        const int id = m_freeIds.back();
+        m_freeIds.pop_back();
+        return id;
+    }
+    m_size.push_back(0);
+    return static_cast<int>(m_size.size()) - 1;
+}
+
+void EmptyRegions::releaseId(int id)
+{
+    --m_regionCount;
+    m_size[id] = 0;
+    m_freeIds.push_back(id);
+}
+
+// Đổi nhãn cả vùng chứa `seed` từ `from` sang `to`
+void EmptyRegions::relabel(int seed, int from, int to)
+{
+    m_queue.clear();
+    m_queue.push_back(seed);
+    m_label[seed] = to;
+    int next[4];
+    for (size_t head = 0; head < m_queue.size(); ++head) {
+        const int count = neighbours(m_queue[head], next);
+        for (int i = 0; i < count; ++i) {
+            if (m_label[next[i]] == from) {
+                m_label[next[i]] = to;
+                m_queue.push_back(next[i]);
+            }
+        }
+    }
+}
+
+void EmptyRegions::reset()
+{
+    const int n = m_board.cellCount();
+    const uint8_t *cells = m_board.data();
+    m_label.assign(n, -1);
+    m_size.clear();
+    m_freeIds.clear();
+    m_regionCount = 0;
+    m_emptyCells.clear();
+    m_emptyPos.assign(n, -1);
+    m_stamp.assign(n, 0);
+    m_owner.assign(n, 0);
+    m_generation = 0;
+
+    const int Unlabelled = -2;
+    for (int cell = 0; cell < n; ++cell) {
+        if (cells[cell] == GameBoard::Empty) {
+            m_label[cell] = Unlabelled;
+            m_emptyPos[cell] = static_cast<int>(m_emptyCells.size());
+            m_emptyCells.push_back(cell);
+        }
+    }
+    for (int cell = 0; cell < n; ++cell) {
+        if (m_label[cell] != Unlabelled) continue;
+        const int id = newId();
+        relabel(cell, Unlabelled, id);
+        m_size[id] = static_cast<int>(m_queue.size());
+    }
+}
+
+void EmptyRegions::cellChanged(int cell)
+{
+    if (static_cast<int>(m_label.size()) != m_board.cellCount()) {
+        reset();
+        return;
+    }
+    const bool empty = m_board.data()[cell] == GameBoard::Empty;
+    const bool wasEmpty = m_label[cell] >= 0;
+    if (empty == wasEmpty) return;       // chỉ đổi màu
+    if (empty) cellEmptied(cell);
+    else cellFilled(cell);
+}
+
+void EmptyRegions::cellEmptied(int cell)
+{
+    m_emptyPos[cell] = static_cast<int>(m_emptyCells.size());
+    m_emptyCells.push_back(cell);
+    int next[4];
+    const int count = neighbours(cell, next);
+
+    // vùng lớn nhất giữ nhãn, các vùng khác gộp vào
+    int keep = -1;
+    for (int i = 0; i < count; ++i) {
+        const int id = m_label[next[i]];
+        if (id >= 0 && (keep < 0 || m_size[id] > m_size[keep])) keep = id;
+    }
+    if (keep < 0) keep = newId();
+    m_label[cell] = keep;
+    ++m_size[keep];
+
+    for (int i = 0; i < count; ++i) {
+        const int id = m_label[next[i]];
+        if (id < 0 || id == keep) continue;
+        m_size[keep] += m_size[id];
+        relabel(next[i], id, keep);
+        releaseId(id);
+    }
+}
+
+void EmptyRegions::cellFilled(int cell)
+{
+    const int id = m_label[cell];
+    m_label[cell] = -1;
+    // swap-remove
+    const int pos = m_emptyPos[cell];
+    const int last = m_emptyCells.back();
+    m_emptyCells[pos] = last;
+    m_emptyPos[last] = pos;
+    m_emptyCells.pop_back();
+    m_emptyPos[cell] = -1;
+    if (--m_size[id] == 0) {
+        releaseId(id);
+        return;
+    }
+
+    // Ô trống liền nhau trên vòng 8 ô quanh `cell` chắc chắn cùng một mảnh,
+    // nên mỗi cung trống chỉ cần một fill (từ hàng xóm thẳng đầu tiên của cung)
+    static constexpr int RingRow[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+    static constexpr int RingCol[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+    const int rows = m_board.rows(), cols = m_board.cols();
+    const int r = cell / cols, c = cell % cols;
+    bool open[8];
+    int firstBlocked = -1;
+    for (int k = 0; k < 8; ++k) {
+        const int rr = r + RingRow[k], cc = c + RingCol[k];
+        open[k] = rr >= 0 && rr < rows && cc >= 0 && cc < cols && m_label[rr * cols + cc] >= 0;
+        if (!open[k] && firstBlocked < 0) firstBlocked = k;
+    }
+    if (firstBlocked < 0) return;        // cả vòng trống: không thể tách vùng
+
+    int seeds[4];
+    int next[4];
+    int count = 0;
+    bool arcHasSeed = false;
+    for (int i = 1; i <= 8; ++i) {
+        const int k = (firstBlocked + i) % 8;
+        if (!open[k]) {
+            arcHasSeed = false;
+        } else if (k % 2 == 0 && !arcHasSeed) {
+            seeds[count++] = (r + RingRow[k]) * cols + (c + RingCol[k]);
+            arcHasSeed = true;
+        }
+    }
+    if (count <= 1) return;
+
+    if (++m_generation == 0) {
+        std::fill(m_stamp.begin(), m_stamp.end(), 0);
+        m_generation = 1;
+    }
+    int group[4] = { 0, 1, 2, 3 };       // union-find over the fills
+    auto find = [&](int s) {
+        while (group[s] != s) s = group[s] = group[group[s]];
+        return s;
+    };
+    size_t head[4] = { 0, 0, 0, 0 };
+    for (int s = 0; s < count; ++s) {
+        m_fill[s].clear();
+        if (m_stamp[seeds[s]] == m_generation) {
+            group[find(s)] = find(m_owner[seeds[s]]);
+            continue;
+        }
+        m_stamp[seeds[s]] = m_generation;
+        m_owner[seeds[s]] = static_cast<uint8_t>(s);
+        m_fill[s].push_back(seeds[s]);
+    }
+
+    // Mỗi vòng: mỗi fill còn chạy mở rộng 1 ô. Dừng khi mọi fill đã gặp nhau
+    // (không tách) hoặc chỉ còn <= 1 nhóm chưa xong (các nhóm xong là vùng mới).
+    // Trạng thái nhóm chỉ cần tính lại khi có hai fill gặp nhau hoặc một fill chạy hết.
+    bool changed = true;
+    for (;;) {
+        if (changed) {
+            bool running[4] = { false, false, false, false };
+            int groups = 0, unfinished = 0;
+            for (int s = 0; s < count; ++s) {
+                if (find(s) == s) ++groups;
+                if (head[s] < m_fill[s].size()) running[find(s)] = true;
+            }
+            for (int s = 0; s < count; ++s) unfinished += find(s) == s && running[s];
+            if (groups == 1) return;
+            if (unfinished <= 1) break;
+            changed = false;
+        }
+
+        for (int s = 0; s < count; ++s) {
+            if (head[s] >= m_fill[s].size()) continue;
+            const int at = m_fill[s][head[s]++];
+            const int k = neighbours(at, next);
+            for (int i = 0; i < k; ++i) {
+                const int n = next[i];
+                if (m_label[n] != id) continue;
+                if (m_stamp[n] == m_generation) {
+                    const int a = find(s), b = find(m_owner[n]);
+                    if (a != b) {
+                        group[a] = b;
+                        changed = true;
+                    }
+                    continue;
+                }
+                m_stamp[n] = m_generation;
+                m_owner[n] = static_cast<uint8_t>(s);
+                m_fill[s].push_back(n);
+            }
+            changed = changed || head[s] == m_fill[s].size();
+        }
+    }
+
+    // Finished groups are whole regions. The one still growing (or, if all
+    // finished, the largest) keeps the old id; the rest get new ids.
+    int groupSize[4] = { 0, 0, 0, 0 };
+    bool groupRunning[4] = { false, false, false, false };
+    for (int s = 0; s < count; ++s) {
+        groupSize[find(s)] += static_cast<int>(m_fill[s].size());
+        if (head[s] < m_fill[s].size()) groupRunning[find(s)] = true;
+    }
+    int keep = -1;
+    for (int s = 0; s < count; ++s) {
+        if (find(s) != s) continue;
+        if (groupRunning[s]) {
+            keep = s;
+            break;
+        }
+        if (keep < 0 || groupSize[s] > groupSize[keep]) keep = s;
+    }
+    for (int g = 0; g < count; ++g) {
+        if (find(g) != g || g == keep) continue;
+        const int newRegion = newId();
+        for (int s = 0; s < count; ++s) {
+            if (find(s) != g) continue;
+            for (int visited : m_fill[s]) m_label[visited] = newRegion;
+        }
+        m_size[newRegion] = groupSize[g];
+        m_size[id] -= groupSize[g];
+    }
+}
+
+bool EmptyRegions::canReach(int from, int to) const
+{
+    const int n = static_cast<int>(m_label.size());
+    if (from < 0 || from >= n || to < 0 || to >= n) return false;
+    if (from == to) return true;
+    const int id = m_label[to];
+    if (id < 0) return false;
+    int next[4];
+    const int count = neighbours(from, next);
+    for (int i = 0; i < count; ++i) {
+        if (m_label[next[i]] == id) return true;
+    }
+    return false;
+}
+
+size_t EmptyRegions::heapBytes() const
+{
+    size_t bytes = (m_label.capacity() + m_size.capacity() + m_freeIds.capacity() + m_queue.capacity()
+                    + m_emptyCells.capacity() + m_emptyPos.capacity()) * sizeof(int)
+                   + m_stamp.capacity() * sizeof(uint32_t) + m_owner.capacity();
+    for (const std::vector<int> &fill : m_fill) bytes += fill.capacity() * sizeof(int);
+    return bytes;
+}
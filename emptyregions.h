@@ -0,0 +1,75 @@
+#ifndef EMPTYREGIONS_H
+#define EMPTYREGIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GameBoard;
+
+// Connected regions (4-connected) of empty cells, kept up to date one cell
+// at a time. A ball can move to a cell iff that cell's region touches the
+// ball, so reachability and "is any move left" are O(1) queries.
+//
+// Updates after cellChanged():
+//  - a cell emptied merges the regions around it (smaller ones are relabelled
+//    into the largest);
+//  - a cell filled may split its region: flood fills from its empty
+//    neighbours run in lockstep and stop as soon as at most one piece is
+//    still growing, so the cost is bounded by the smaller pieces.
+class EmptyRegions
+{
+public:
+    explicit EmptyRegions(const GameBoard &board);
+
+    // Gán nhãn lại toàn bộ (load, random, đổi kích thước)
+    void reset();
+    // Ô vừa đổi giữa trống <-> có bóng; gọi sau khi board đã đổi
+    void cellChanged(int cell);
+
+    int emptyCount() const { return static_cast<int>(m_emptyCells.size()); }
+    int ballCount() const { return static_cast<int>(m_label.size()) - emptyCount(); }
+    // Ô trống thứ index, 0 <= index < emptyCount(); thứ tự đổi khi cellChanged
+    // (dùng để chọn ô trống ngẫu nhiên mà không quét bàn)
+    int emptyCell(int index) const { return m_emptyCells[index]; }
+    int regionCount() const { return m_regionCount; }
+
+    // Region id of an empty cell, -1 for a ball. Ids are < idCapacity().
+    int regionOf(int cell) const { return m_label[cell]; }
+    int regionSize(int id) const { return m_size[id]; }
+    int idCapacity() const { return static_cast<int>(m_size.size()); }
+
+    // On a connected grid some ball touches some empty cell whenever both
+    // exist, and that ball can move.
+    bool anyMoveLegal() const { return emptyCount() > 0 && ballCount() > 0; }
+
+    // Bóng ở ô `from` đi tới ô `to` được không
+    bool canReach(int from, int to) const;
+
+    size_t heapBytes() const;       // bộ nhớ các buffer đang giữ (capacity)
+
+private:
+    int newId();
+    void releaseId(int id);
+    void relabel(int seed, int from, int to);
+    void cellEmptied(int cell);
+    void cellFilled(int cell);
+    int neighbours(int cell, int *out) const;
+
+    const GameBoard &m_board;
+    std::vector<int> m_label;       // region id per cell, -1 = ball
+    std::vector<int> m_size;        // cells per region id (0 = id is free)
+    std::vector<int> m_freeIds;
+    std::vector<int> m_emptyCells;  // every empty cell, unordered
+    std::vector<int> m_emptyPos;    // index in m_emptyCells, -1 = ball
+    int m_regionCount = 0;
+
+    // lockstep flood fill scratch
+    uint32_t m_generation = 0;
+    std::vector<uint32_t> m_stamp;
+    std::vector<uint8_t> m_owner;   // which fill reached the cell first
+    std::vector<int> m_fill[4];     // cells visited by each fill (also its queue)
+    std::vector<int> m_queue;
+};
+
+#endif // EMPTYREGIONS_H
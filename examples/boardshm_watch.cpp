@@ -0,0 +1,72 @@
+// Ví dụ đọc bàn từ shared memory (chạy game với --shm NAME):
+//   boardshm_watch NAME          in lại mỗi khi bàn đổi
+//   boardshm_watch NAME --once   in một lần rồi thoát
+// Chỉ cần boardshm.h / boardshm.cpp, không cần Qt.
+#include "../boardshm.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// '.' ô trống, 1-9 rồi a-z theo chỉ số palette; '*' là bóng đang chọn
+char cellChar(uint8_t color, bool selected)
+{
+    if (selected) return '*';
+    if (color == 0) return '.';
+    if (color < 10) return char('0' + color);
+    return color < 36 ? char('a' + color - 10) : '#';
+}
+
+void print(const BoardShm::Snapshot &s)
+{
+    std::printf("seq %llu turn %llu: %dx%d, %d balls, selected %d, %zu colours\n",
+                static_cast<unsigned long long>(s.seq), static_cast<unsigned long long>(s.status.turn), s.rows, s.cols,
+                s.status.ballCount, s.status.selectedCell, s.palette.size());
+    if (s.rows > 40 || s.cols > 80) return;     // bàn lớn: chỉ in tóm tắt
+    for (int r = 0; r < s.rows; ++r) {
+        for (int c = 0; c < s.cols; ++c) {
+            const int cell = r * s.cols + c;
+            std::putchar(cellChar(s.cells[cell], cell == s.status.selectedCell));
+        }
+        std::putchar('\n');
+    }
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s NAME [--once]\n", argv[0]);
+        return 2;
+    }
+    const bool once = argc > 2 && std::strcmp(argv[2], "--once") == 0;
+
+    BoardShm::Reader reader;
+    std::string error;
+    if (!reader.open(argv[1], &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    BoardShm::Snapshot snapshot;
+    uint64_t lastSeq = 0;
+    for (;;) {
+        // chỉ đọc seq khi không có gì mới: một load, không làm phiền writer
+        if (reader.seq() != lastSeq) {
+            if (!reader.read(snapshot)) {
+                // writer ghi liên tục: read() đã quay maxAttempts lần, nghỉ chút
+                // rồi mới thử lại, không giữ một lõi ở 100%
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            lastSeq = snapshot.seq;
+            print(snapshot);
+            if (once) return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef GAMEBOARD_H
+#define GAMEBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Bàn cờ dạng mảng phẳng, 1 byte mỗi ô: chỉ số màu trong Palette (0 = trống).
+// Không phụ thuộc Qt để dùng lại được cho các bộ mô phỏng chạy headless.
+class GameBoard
+{
+public:
+    static constexpr uint8_t Empty = 0;
+
+    explicit GameBoard(int rows = 10, int cols = 10) { reset(rows, cols); }
+
+    void reset(int rows, int cols)
+    {
+        m_rows = rows;
+        m_cols = cols;
+        m_cells.assign(static_cast<size_t>(rows) * cols, Empty);
+    }
+    void clear() { m_cells.assign(m_cells.size(), Empty); }
+
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    int cellCount() const { return static_cast<int>(m_cells.size()); }
+    bool inBounds(int r, int c) const { return r >= 0 && r < m_rows && c >= 0 && c < m_cols; }
+
+    uint8_t at(int r, int c) const { return m_cells[static_cast<size_t>(r) * m_cols + c]; }
+    void set(int r, int c, uint8_t color) { m_cells[static_cast<size_t>(r) * m_cols + c] = color; }
+    bool isEmpty(int r, int c) const { return at(r, c) == Empty; }
+
+    const uint8_t *data() const { return m_cells.data(); }
+    uint8_t *data() { return m_cells.data(); }
+
+private:
+    int m_rows = 0;
+    int m_cols = 0;
+    std::vector<uint8_t> m_cells;
+};
+
+#endif // GAMEBOARD_H
@@ -0,0 +1,208 @@
+#include "gameengine.h"
+#include "board.h"
+
+#include <algorithm>
+
+GameEngine::GameEngine(const GameRules &rules)
+    : m_rules(rules),
+    m_board(rules.rows, rules.cols)
+{
+    reset(0);
+}
+
+void GameEngine::setCell(int cell, uint8_t color)
+{
+    const bool wasEmpty = m_board.data()[cell] == GameBoard::Empty;
+    m_board.data()[cell] = color;
+    const bool empty = color == GameBoard::Empty;
+    if (wasEmpty != empty) m_regions.cellChanged(cell);
+}
+
+void GameEngine::reset(uint64_t seed)
+{
+    m_rng.setState(seed);
+    m_score = 0;
+    m_turns = 0;
+    m_history.clear();
+    m_board.reset(m_rules.rows, m_rules.cols);
+    const int n = m_board.cellCount();
+    m_mask.assign(n, 0);
+    m_regions.reset();
+
+    // (2,2), (5,5), (8,8) trên bàn 10x10, co giãn theo kích thước
+    const int start[3] = { 2, 5, 8 };
+    for (int i = 0; i < std::min(3, m_rules.initialBalls); ++i) {
+        const int cell = start[i] * m_rules.rows / 10 * m_rules.cols + start[i] * m_rules.cols / 10;
+        if (m_board.data()[cell] == GameBoard::Empty) setCell(cell, static_cast<uint8_t>(1 + i % m_rules.colorCount));
+    }
+    // luật có nhiều bóng ban đầu hơn: thêm ở ô ngẫu nhiên (không ghi lịch sử)
+    int placed = m_regions.ballCount();
+    for (; placed < m_rules.initialBalls && m_regions.emptyCount() > 0; ++placed) {
+        const int cell = randomEmptyCell(m_rng);
+        setCell(cell, static_cast<uint8_t>(m_rng.range(1, m_rules.colorCount)));
+    }
+}
+
+void GameEngine::load(const uint8_t *cells, uint64_t seed)
+{
+    reset(seed);
+    const int n = m_board.cellCount();
+    for (int cell = 0; cell < n; ++cell) setCell(cell, cells[cell]);
+}
+
+bool GameEngine::canMove(int from, int to) const
+{
+    const int n = m_board.cellCount();
+    if (from < 0 || from >= n || to < 0 || to >= n || from == to) return false;
+    if (m_board.data()[from] == GameBoard::Empty) return false;
+    if (m_rules.movement == GameRules::Movement::Jump) return m_board.data()[to] == GameBoard::Empty;
+    return m_regions.canReach(from, to);
+}
+
+// Như addRandomBalls: ô trống ngẫu nhiên, màu ngẫu nhiên trong màu gốc
+int GameEngine::spawn(int count, int *cells)
+{
+    int spawned = 0;
+    for (; spawned < count && m_regions.emptyCount() > 0; ++spawned) {
+        const int cell = randomEmptyCell(m_rng);
+        const uint8_t color = static_cast<uint8_t>(m_rng.range(1, m_rules.colorCount));
+        setCell(cell, color);
+        if (m_historyEnabled) m_history.recordSpawn(cell, color);
+        cells[spawned] = cell;
+    }
+    return spawned;
+}
+
+// Như findLinesThrough + removeBallsAt: đánh dấu các hàng qua những ô vừa
+// đổi, rồi xóa. Chỉ duyệt cửa sổ quanh các ô đó, không quét cả bàn.
+int GameEngine::clearLinesThrough(const int *cells, int count)
+{
+    const int L = m_rules.lineLength, cols = m_rules.cols, rows = m_rules.rows;
+    const unsigned dirs = m_rules.lineDirections;
+    int marked = 0;
+    withBoardGeometry(rows, cols, L, dirs, [&](const auto &geo) {
+        for (int i = 0; i < count; ++i) marked += geo.markLinesThrough(m_board.data(), cells[i], m_mask.data());
+    });
+    if (marked == 0) return 0;
+
+    for (int i = 0; i < count; ++i) {
+        const int r = cells[i] / cols, c = cells[i] % cols;
+        for (int d = 0; d < 4; ++d) {
+            if (!(dirs >> d & 1u)) continue;
+            for (int k = -(L - 1); k <= L - 1; ++k) {
+                const int rr = r + k * BoardDirections::LineRow[d], cc = c + k * BoardDirections::LineCol[d];
+                if (rr < 0 || rr >= rows || cc < 0 || cc >= cols) continue;
+                const int cell = rr * cols + cc;
+                if (!m_mask[cell]) continue;
+                m_mask[cell] = 0;
+                if (m_historyEnabled) m_history.recordRemove(cell, m_board.data()[cell]);
+                setCell(cell, GameBoard::Empty);
+            }
+        }
+    }
+    return marked;
+}
+
+GameEngine::StepResult GameEngine::step(int from, int to)
+{
+    StepResult result;
+    if (!canMove(from, to)) return result;
+    result.legal = true;
+
+    if (m_historyEnabled) m_history.beginTurn(from, to, m_rng.state());
+    moveBall(from, to);
+
+    // ô vừa đến + các ô vừa thêm bóng (tối đa spawnPerTurn)
+    int changed[1 + GameRules::MaxSpawnPerTurn];
+    changed[0] = to;
+    const int spawned = spawn(std::min(m_rules.spawnPerTurn, GameRules::MaxSpawnPerTurn), changed + 1);
+    result.cleared = clearLinesThrough(changed, 1 + spawned);
+
+    m_score += result.cleared;
+    ++m_turns;
+    if (m_historyEnabled) m_history.endTurn(m_rng.state());
+    result.done = isOver();
+    return result;
+}
+
+int GameEngine::spawnBalls(int count, int *cleared)
+{
+    // bàn đổi ngoài lượt -> lịch sử cũ không undo đúng được nữa
+    m_history.clear();
+    const bool historyEnabled = m_historyEnabled;
+    m_historyEnabled = false;
+
+    int changed[16];
+    int total = 0, removed = 0;
+    while (total < count) {
+        const int spawned = spawn(std::min(count - total, 16), changed);
+        if (spawned == 0) break;
+        removed += clearLinesThrough(changed, spawned);
+        total += spawned;
+    }
+    m_historyEnabled = historyEnabled;
+    m_score += removed;
+    if (cleared) *cleared = removed;
+    return total;
+}
+
+void GameEngine::moveBall(int from, int to)
+{
+    const uint8_t color = m_board.data()[from];
+    setCell(from, GameBoard::Empty);
+    setCell(to, color);
+}
+
+// Ngược thứ tự của step: trả bóng đã xóa, bỏ bóng vừa thêm, đưa bóng về chỗ cũ
+bool GameEngine::undo()
+{
+    if (!m_history.canUndo()) return false;
+    const TurnHistory::Turn turn = m_history.undo();
+    for (int i = 0; i < turn.removedCount(); ++i) setCell(turn.removed(i).cell, turn.removed(i).color);
+    for (int i = 0; i < turn.spawnedCount(); ++i) setCell(turn.spawned(i).cell, GameBoard::Empty);
+    moveBall(turn.to, turn.from);
+    m_rng.setState(turn.rngBefore);
+    m_score -= turn.removedCount();
+    --m_turns;
+    return true;
+}
+
+bool GameEngine::redo()
+{
+    if (!m_history.canRedo()) return false;
+    const TurnHistory::Turn turn = m_history.redo();
+    moveBall(turn.from, turn.to);
+    for (int i = 0; i < turn.spawnedCount(); ++i) setCell(turn.spawned(i).cell, turn.spawned(i).color);
+    for (int i = 0; i < turn.removedCount(); ++i) setCell(turn.removed(i).cell, GameBoard::Empty);
+    m_rng.setState(turn.rngAfter);
+    m_score += turn.removedCount();
+    ++m_turns;
+    return true;
+}
+
+bool GameEngine::randomMove(Rng &rng, int &from, int &to) const
+{
+    if (isOver()) return false;
+    const int n = m_board.cellCount();
+    const uint8_t *cells = m_board.data();
+
+    // Ô đích ngẫu nhiên, rồi một bóng kề vùng của nó (quét từ vị trí ngẫu nhiên).
+    // Vùng nào cũng giáp ít nhất một bóng khi bàn còn bóng.
+    to = randomEmptyCell(rng);
+    const bool jump = m_rules.movement == GameRules::Movement::Jump;
+    const int offset = static_cast<int>(rng.below(static_cast<uint32_t>(n)));
+    for (int i = 0; i < n; ++i) {
+        const int cell = (offset + i) % n;
+        if (cells[cell] != GameBoard::Empty && (jump || m_regions.canReach(cell, to))) {
+            from = cell;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t GameEngine::memoryBytes() const
+{
+    return sizeof(*this) + static_cast<size_t>(m_board.cellCount()) + m_regions.heapBytes() + m_history.memoryBytes()
+           + m_mask.capacity();
+}
@@ -0,0 +1,87 @@
+#ifndef GAMEENGINE_H
+#define GAMEENGINE_H
+
+#include "emptyregions.h"
+#include "gameboard.h"
+#include "gamerules.h"
+#include "rng.h"
+#include "turnhistory.h"
+
+#include <cstdint>
+#include <vector>
+
+// Headless version of the MainWindow turn: move a ball to a reachable empty
+// cell (any empty cell with Movement::Jump), spawn balls on random empty
+// cells, clear every run of >= lineLength along the rule's directions
+// through the moved and spawned cells. No Qt, no path search (reachability
+// comes from EmptyRegions), no allocation per step once warmed up.
+//
+// Holds references into itself (EmptyRegions -> GameBoard): not copyable.
+class GameEngine
+{
+public:
+    struct StepResult {
+        bool legal = false;
+        int cleared = 0;    // bóng bị xóa trong lượt
+        bool done = false;  // hết nước đi sau lượt này
+    };
+
+    explicit GameEngine(const GameRules &rules = GameRules());
+    GameEngine(const GameEngine &) = delete;
+    GameEngine &operator=(const GameEngine &) = delete;
+
+    // Bàn ban đầu như initializeBalls: initialBalls bóng màu gốc, 3 bóng đầu
+    // trên đường chéo, còn lại ở ô ngẫu nhiên
+    void reset(uint64_t seed);
+    // Bàn cho sẵn (rows * cols byte, 0 = trống), ví dụ từ file save. Không
+    // xóa hàng có sẵn; điểm và số lượt về 0.
+    void load(const uint8_t *cells, uint64_t seed);
+
+    bool canMove(int from, int to) const;
+    StepResult step(int from, int to);
+    // Như addRandomBalls + checkAndRemoveLines, ngoài lượt. Trả về số bóng thêm được.
+    int spawnBalls(int count, int *cleared = nullptr);
+
+    bool isOver() const { return !m_regions.anyMoveLegal(); }
+
+    // Ghi lịch sử để undo/redo (tắt mặc định: gym không cần)
+    void setHistoryEnabled(bool enabled) { m_historyEnabled = enabled; }
+    const TurnHistory &history() const { return m_history; }
+    // O(delta): no board copy. Also the way a bot tries a move and reverts it.
+    bool undo();
+    bool redo();
+    // Nước đi hợp lệ ngẫu nhiên (đều theo ô đích). False nếu hết nước.
+    bool randomMove(Rng &rng, int &from, int &to) const;
+
+    const GameRules &rules() const { return m_rules; }
+    const GameBoard &board() const { return m_board; }
+    const EmptyRegions &regions() const { return m_regions; }
+    Rng &rng() { return m_rng; }
+    int score() const { return m_score; }
+    int turns() const { return m_turns; }
+    // Cả engine: object + board + EmptyRegions + history + buffers (~4 KB cho 10x10)
+    size_t memoryBytes() const;
+
+private:
+    void setCell(int cell, uint8_t color);
+    int spawn(int count, int *cells);
+    int randomEmptyCell(Rng &rng) const     // cần emptyCount() > 0
+    {
+        return m_regions.emptyCell(static_cast<int>(rng.below(static_cast<uint32_t>(m_regions.emptyCount()))));
+    }
+    void moveBall(int from, int to);
+    int clearLinesThrough(const int *cells, int count);
+
+    GameRules m_rules;
+    GameBoard m_board;
+    EmptyRegions m_regions{m_board};    // khai báo sau m_board
+    Rng m_rng;
+    int m_score = 0;
+    int m_turns = 0;
+    bool m_historyEnabled = false;
+    TurnHistory m_history;
+
+    std::vector<uint8_t> m_mask;
+};
+
+#endif // GAMEENGINE_H
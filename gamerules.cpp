@@ -0,0 +1,143 @@
+#include "gamerules.h"
+#include "jsonstream.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// Một object phẳng: số nguyên, chuỗi, mảng chuỗi "directions"
+class RulesHandler : public JsonStream::Handler
+{
+public:
+    explicit RulesHandler(GameRules &rules) : m_rules(rules) {}
+
+    bool startObject() override
+    {
+        if (m_depth++ == 0) return true;
+        return fail("Luật chơi: \"" + m_key + "\" không được là object");
+    }
+    bool endObject() override
+    {
+        --m_depth;
+        return true;
+    }
+    bool startArray() override
+    {
+        if (m_depth == 0) return fail("Luật chơi phải là một object JSON");
+        if (m_key != "directions" || m_inArray) return fail("Luật chơi: \"" + m_key + "\" không được là mảng");
+        m_inArray = true;
+        m_rules.lineDirections = 0;
+        return true;
+    }
+    bool endArray() override
+    {
+        m_inArray = false;
+        return true;
+    }
+    bool key(std::string_view name) override
+    {
+        m_key.assign(name);
+        return true;
+    }
+    bool string(std::string_view value) override
+    {
+        if (m_depth == 0) return fail("Luật chơi phải là một object JSON");
+        if (m_inArray) {
+            if (value == "horizontal") m_rules.lineDirections |= BoardDirections::Horizontal;
+            else if (value == "vertical") m_rules.lineDirections |= BoardDirections::Vertical;
+            else if (value == "diagonal") m_rules.lineDirections |= BoardDirections::Diagonal;
+            else if (value == "antidiagonal") m_rules.lineDirections |= BoardDirections::AntiDiagonal;
+            else return fail("Luật chơi: hướng \"" + std::string(value) + "\" không hợp lệ");
+            return true;
+        }
+        if (m_key == "movement") {
+            if (value == "path") m_rules.movement = GameRules::Movement::Path;
+            else if (value == "jump") m_rules.movement = GameRules::Movement::Jump;
+            else return fail("Luật chơi: movement phải là \"path\" hoặc \"jump\"");
+            return true;
+        }
+        return unknownKey();
+    }
+    bool number(double value) override
+    {
+        if (m_depth == 0 || m_inArray) return fail("Luật chơi: giá trị của \"" + m_key + "\" không hợp lệ");
+        int *field = nullptr;
+        if (m_key == "rows") field = &m_rules.rows;
+        else if (m_key == "cols") field = &m_rules.cols;
+        else if (m_key == "lineLength") field = &m_rules.lineLength;
+        else if (m_key == "spawnPerTurn") field = &m_rules.spawnPerTurn;
+        else if (m_key == "colorCount") field = &m_rules.colorCount;
+        else if (m_key == "initialBalls") field = &m_rules.initialBalls;
+        if (!field) return unknownKey();
+        if (std::floor(value) != value || value < -1e9 || value > 1e9)
+            return fail("Luật chơi: \"" + m_key + "\" phải là số nguyên");
+        *field = static_cast<int>(value);
+        return true;
+    }
+    bool boolean(bool) override { return fail("Luật chơi: giá trị của \"" + m_key + "\" không hợp lệ"); }
+    bool null() override { return fail("Luật chơi: giá trị của \"" + m_key + "\" không hợp lệ"); }
+
+    const std::string &error() const { return m_error; }
+
+private:
+    bool unknownKey() { return fail("Luật chơi: khóa \"" + m_key + "\" không hợp lệ"); }
+    bool fail(std::string message)
+    {
+        if (m_error.empty()) m_error = std::move(message);
+        return false;
+    }
+
+    GameRules &m_rules;
+    std::string m_key;
+    std::string m_error;
+    int m_depth = 0;
+    bool m_inArray = false;
+};
+
+} // namespace
+
+bool GameRules::validate(std::string *error) const
+{
+    auto fail = [error](const char *message) {
+        if (error) *error = message;
+        return false;
+    };
+    if (rows < 1 || cols < 1 || rows > MaxSide || cols > MaxSide) return fail("Luật chơi: kích thước bàn không hợp lệ");
+    if (lineLength < MinLineLength || lineLength > MaxLineLength) return fail("Luật chơi: lineLength phải trong 2..16");
+    if (lineLength > rows && lineLength > cols) return fail("Luật chơi: hàng dài hơn cả bàn");
+    if (spawnPerTurn < 0 || spawnPerTurn > MaxSpawnPerTurn) return fail("Luật chơi: spawnPerTurn phải trong 0..16");
+    if (colorCount < 1 || colorCount > MaxColorCount) return fail("Luật chơi: colorCount phải trong 1..12");
+    if (initialBalls < 0 || initialBalls > rows * cols) return fail("Luật chơi: initialBalls không hợp lệ");
+    if (lineDirections == 0 || lineDirections > BoardDirections::AllLines) return fail("Luật chơi: cần ít nhất một hướng");
+    return true;
+}
+
+bool GameRules::parse(std::string_view json, std::string *error)
+{
+    GameRules parsed = *this;
+    RulesHandler handler(parsed);
+    JsonStream stream(handler);
+    if (!stream.feed(json.data(), json.size()) || !stream.finish()) {
+        if (error) *error = handler.error().empty() ? "Luật chơi: JSON hỏng (" + stream.error() + ")" : handler.error();
+        return false;
+    }
+    if (!parsed.validate(error)) return false;
+    *this = parsed;
+    return true;
+}
+
+bool GameRules::loadFile(const std::string &path, std::string *error)
+{
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        if (error) *error = "Không thể mở file luật chơi: " + path;
+        return false;
+    }
+    std::string text;
+    char buffer[4096];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof buffer, file)) > 0 && text.size() < 1024 * 1024) text.append(buffer, n);
+    std::fclose(file);
+    return parse(text, error);
+}
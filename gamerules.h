@@ -0,0 +1,58 @@
+#ifndef GAMERULES_H
+#define GAMERULES_H
+
+#include "board.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Luật chơi (mặc định giống MainWindow). Qt-free, dùng chung cho GameEngine,
+// HintEngine, MainWindow và headless.
+//
+// Bộ luật hay gặp (bàn 10x10 hoặc 9x9, hàng 5, đủ 4 hướng hoặc chỉ ngang/dọc)
+// chạy trên bảng tra dựng lúc biên dịch (withBoardGeometry); bộ luật khác
+// dùng DynamicBoard, cùng kết quả.
+struct GameRules {
+    enum class Movement : uint8_t {
+        Path,   // bóng phải có đường đi qua ô trống (findPath)
+        Jump,   // bóng nhảy thẳng tới ô trống bất kỳ
+    };
+
+    int rows = 10;
+    int cols = 10;
+    int lineLength = 5;     // số bóng cùng màu tối thiểu để xóa
+    int spawnPerTurn = 3;   // bóng mới sau mỗi nước đi
+    int colorCount = 3;     // màu gốc 1..colorCount (đỏ, xanh lá, xanh dương)
+    int initialBalls = 3;   // bóng lúc bắt đầu ván
+    unsigned lineDirections = BoardDirections::AllLines;
+    Movement movement = Movement::Path;
+
+    static constexpr int MinLineLength = 2;
+    static constexpr int MaxLineLength = 16;
+    static constexpr int MaxSpawnPerTurn = 16;
+    static constexpr int MaxColorCount = 12;    // số màu chuẩn của Palette
+    static constexpr int MaxSide = 4096;
+
+    // Dùng bảng tra dựng sẵn (không có chi phí của luật tùy biến)
+    bool isSpecialised() const
+    {
+        return withBoardGeometry(rows, cols, lineLength, lineDirections,
+                                 [](const auto &geo) { return !std::is_same_v<std::decay_t<decltype(geo)>, DynamicBoard>; });
+    }
+
+    // false + *error (tiếng Việt) nếu một giá trị nằm ngoài giới hạn
+    bool validate(std::string *error = nullptr) const;
+
+    // JSON, mọi khóa đều tùy chọn (thiếu thì giữ giá trị hiện tại):
+    //   {"rows": 10, "cols": 10, "lineLength": 5, "spawnPerTurn": 3,
+    //    "colorCount": 3, "initialBalls": 3,
+    //    "directions": ["horizontal", "vertical", "diagonal", "antidiagonal"],
+    //    "movement": "path" | "jump"}
+    // Khóa lạ là lỗi: gõ sai tên khóa không được âm thầm bỏ qua.
+    bool parse(std::string_view json, std::string *error = nullptr);
+    bool loadFile(const std::string &path, std::string *error = nullptr);
+};
+
+#endif // GAMERULES_H
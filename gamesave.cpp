@@ -4,31 +4,169 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QInputDialog>
+#include <QBuffer>
+#include <QSaveFile>
+#include <QtEndian>
+#include "savebrowser.h"
+#include "saveindex.h"
+#include "savestream.h"
+#include "thumbnailrenderer.h"
+#include "powermetrics.h"
+#include "puzzle.h"
+
+namespace {
+
+const QByteArray SaveMagic("BGSZ");
+constexpr int CompressBlockBytes = 1 << 20;        // JSON mỗi khối nén
+constexpr quint32 MaxHeaderBytes = 1 << 20;
+constexpr quint32 MaxThumbnailBytes = 4 << 20;
+constexpr quint32 MaxBlockBytes = 64 << 20;
+
+bool writeU32(QIODevice &device, quint32 value)
+{
+    const quint32 be = qToBigEndian(value);
+    return device.write(reinterpret_cast<const char *>(&be), 4) == 4;
+}
+
+bool writeBlock(QIODevice &device, const QByteArray &data)
+{
+    return writeU32(device, quint32(data.size())) && device.write(data) == data.size();
+}
+
+// Khối u32 độ dài + dữ liệu; false nếu thiếu hoặc dài quá maxBytes (file hỏng)
+bool readBlock(QIODevice &device, quint32 maxBytes, QByteArray &data)
+{
+    quint32 be = 0;
+    if (device.read(reinterpret_cast<char *>(&be), 4) != 4) return false;
+    const quint32 size = qFromBigEndian(be);
+    if (size > maxBytes) return false;
+    data.resize(int(size));
+    return device.read(data.data(), size) == qint64(size);
+}
+
+// Sau magic: header JSON và thumbnail (bỏ qua ảnh nếu không cần)
+bool readHeader(QIODevice &device, GameSave::SaveInfo &info, bool wantThumbnail)
+{
+    if (device.read(4) != SaveMagic) return false;
+    QByteArray header, png;
+    if (!readBlock(device, MaxHeaderBytes, header)) return false;
+    const QJsonObject obj = QJsonDocument::fromJson(header).object();
+    info.ballCount = obj.value("balls").toInt(0);
+    info.rows = obj.value("rows").toInt(0);
+    info.cols = obj.value("cols").toInt(0);
+    info.saveTime = obj.value("saveTime").toString();
+    if (info.rows <= 0 || info.cols <= 0 || info.rows > GameSave::MaxSide || info.cols > GameSave::MaxSide) return false;
+
+    if (!wantThumbnail) {
+        quint32 be = 0;
+        if (device.read(reinterpret_cast<char *>(&be), 4) != 4) return false;
+        const quint32 size = qFromBigEndian(be);
+        return size <= MaxThumbnailBytes && device.skip(size) == qint64(size);
+    }
+    if (!readBlock(device, MaxThumbnailBytes, png)) return false;
+    info.thumbnail = png.isEmpty() ? QImage() : QImage::fromData(png, "PNG");
+    return true;
+}
+
+} // namespace
 
 GameSave::GameSave(QObject *parent) : QObject(parent)
 {
 }
 
-bool GameSave::saveGame(const GameState &gameState, QWidget *parent)
+GameSave::~GameSave() = default;
+
+SaveIndex &GameSave::saveIndex()
 {
-    // Ask user for save location
-    QString filename = QFileDialog::getSaveFileName(
-        parent,
-        "Lưu Game",
-        QDir::homePath() + "/ball_game_save.bgsave",
-        getSaveFileFilter()
-        );
+    if (!m_index) m_index = std::make_unique<SaveIndex>();
+    return *m_index;
+}
 
-    if (filename.isEmpty()) {
+bool GameSave::saveGame(const GameState &gameState, QWidget *parent)
+{
+    // Ask user for a slot name
+    bool ok = false;
+    QString name = QInputDialog::getText(parent, "Lưu Game", "Tên save:", QLineEdit::Normal,
+                                         QDateTime::currentDateTime().toString("'save-'yyyyMMdd-HHmmss"), &ok)
+                       .trimmed();
+    if (!ok || name.isEmpty()) {
         return false; // User canceled
     }
+    if (name.contains('/') || name.contains('\\') || name.startsWith('.')) {
+        QMessageBox::warning(parent, "Lỗi Lưu Game", "Tên save không hợp lệ!");
+        return false;
+    }
 
     // Ensure file has proper extension
-    if (!filename.endsWith(".bgsave", Qt::CaseInsensitive) &&
-        !filename.endsWith(".json", Qt::CaseInsensitive)) {
-        filename += ".bgsave";
+    if (!name.endsWith(".bgsave", Qt::CaseInsensitive) &&
+        !name.endsWith(".json", Qt::CaseInsensitive)) {
+        name += ".bgsave";
+    }
+
+    SaveIndex &index = saveIndex();
+    QDir().mkpath(index.directory());
+    const QString filename = index.filePath(name);
+    if (QFileInfo::exists(filename)
+        && QMessageBox::question(parent, "Lưu Game", QString("Save \"%1\" đã có. Ghi đè?").arg(name))
+               != QMessageBox::Yes) {
+        return false;
     }
 
+    QString error;
+    QElapsedTimer io;
+    io.start();
+    const bool written = writeFile(filename, gameState, &error);
+    m_lastIoNs = io.nsecsElapsed();
+    if (!written) {
+        QMessageBox::warning(parent, "Lỗi Lưu Game", error);
+        return false;
+    }
+
+    // Giữ index mới: chỉ đọc lại header vừa ghi
+    SaveInfo info;
+    if (readInfo(filename, info)) index.updateFile(name, info);
+
+    // Show success message
+    QMessageBox::information(parent, "Thành Công",
+                             QString("Game đã được lưu thành công!\n\nSave: %1\nSố lượng bóng: %2")
+                                 .arg(name)
+                                 .arg(gameState.balls.size()));
+
+    return true;
+}
+
+bool GameSave::loadGame(GameState &gameState, QWidget *parent, int rows, int cols)
+{
+    // Ask user for a slot (or any file)
+    SaveBrowser browser(saveIndex(), parent);
+    if (browser.exec() != QDialog::Accepted || browser.selectedFile().isEmpty()) {
+        return false; // User canceled
+    }
+    const QString filename = browser.selectedFile();
+
+    QString error;
+    QElapsedTimer io;
+    io.start();
+    const bool read = readFile(filename, gameState, &error, rows, cols);
+    m_lastIoNs = io.nsecsElapsed();
+    if (!read) {
+        QMessageBox::warning(parent, "Lỗi Mở Game", error);
+        return false;
+    }
+
+    // Show success message
+    QMessageBox::information(parent, "Thành Công",
+                             QString("Game đã được tải thành công!\n\nFile: %1\nSố lượng bóng: %2")
+                                 .arg(QFileInfo(filename).fileName())
+                                 .arg(gameState.balls.size()));
+
+    return true;
+}
+
+bool GameSave::writeFile(const QString &filename, const GameState &gameState, QString *error)
+{
     // Create JSON object for game state
     QJsonObject gameStateObj;
 
@@ -38,163 +176,286 @@ bool GameSave::saveGame(const GameState &gameState, QWidget *parent)
         ballsArray.append(ballToJson(ball));
     }
     gameStateObj["balls"] = ballsArray;
+    gameStateObj["palette"] = paletteToJson(gameState.palette);
 
     // Save game metadata
     gameStateObj["nextBallId"] = gameState.nextBallId;
     gameStateObj["selectedBallIndex"] = gameState.selectedBallIndex;
     gameStateObj["movingBallIndex"] = gameState.movingBallIndex;
+    gameStateObj["rows"] = gameState.rows;
+    gameStateObj["cols"] = gameState.cols;
+    if (gameState.puzzleMoves > 0) {
+        QJsonArray solution;
+        for (const MoveData &move : gameState.puzzleSolution)
+            solution.append(QJsonArray{ move.fromRow, move.fromCol, move.toRow, move.toCol });
+        gameStateObj["puzzle"] = QJsonObject{ { "moves", gameState.puzzleMoves }, { "solution", solution } };
+    }
 
     // Save timestamp and version for compatibility
-    gameStateObj["saveVersion"] = "1.0";
-    gameStateObj["saveTime"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    const QString saveTime = QDateTime::currentDateTime().toString(Qt::ISODate);
+    gameStateObj["saveVersion"] = "1.2";
+    gameStateObj["saveTime"] = saveTime;
     gameStateObj["gameName"] = "Ball Game";
 
     // Create JSON document
     QJsonDocument doc(gameStateObj);
 
-    // Write to file
-    QFile file(filename);
+    // Ghi file tạm rồi đổi tên: lỗi giữa chừng không làm hỏng save cũ
+    QSaveFile file(filename);
     if (!file.open(QIODevice::WriteOnly)) {
-        QMessageBox::warning(parent, "Lỗi Lưu Game",
-                             QString("Không thể tạo file:\n%1\n\nLỗi: %2")
-                                 .arg(filename).arg(file.errorString()));
+        if (error) *error = QString("Không thể tạo file:\n%1\n\nLỗi: %2").arg(filename).arg(file.errorString());
         return false;
     }
 
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
-
-    // Show success message
-    QMessageBox::information(parent, "Thành Công",
-                             QString("Game đã được lưu thành công!\n\nFile: %1\nSố lượng bóng: %2")
-                                 .arg(QFileInfo(filename).fileName())
-                                 .arg(gameState.balls.size()));
+    if (filename.endsWith(".json", Qt::CaseInsensitive)) {
+        file.write(doc.toJson(QJsonDocument::Indented));
+    } else {
+        const QJsonObject header{
+            { "balls", int(gameState.balls.size()) },
+            { "rows", gameState.rows },
+            { "cols", gameState.cols },
+            { "saveTime", saveTime },
+            { "saveVersion", "1.2" },
+        };
+        QByteArray png;
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        thumbnail(gameState).save(&buffer, "PNG");
+
+        bool ok = file.write(SaveMagic) == SaveMagic.size()
+                  && writeBlock(file, QJsonDocument(header).toJson(QJsonDocument::Compact))
+                  && writeBlock(file, png);
+        // khối độc lập: đọc lại chỉ cần giữ một khối đã giải nén
+        const QByteArray json = doc.toJson(QJsonDocument::Compact);
+        for (int i = 0; ok && i < json.size(); i += CompressBlockBytes) {
+            const int n = qMin(CompressBlockBytes, int(json.size()) - i);
+            ok = writeBlock(file, qCompress(reinterpret_cast<const uchar *>(json.constData()) + i, n));
+        }
+        ok = ok && writeU32(file, 0);
+        if (!ok) file.cancelWriting();
+    }
 
+    if (!file.commit()) {
+        if (error) *error = QString("Không thể ghi file:\n%1\n\nLỗi: %2").arg(filename).arg(file.errorString());
+        return false;
+    }
     return true;
 }
 
-bool GameSave::loadGame(GameState &gameState, QWidget *parent)
+// Đọc từng khúc qua SaveStreamReader: không giữ cả file, không dựng DOM.
+// Kiểm tra vị trí / trùng ô ngay khi đọc xong mỗi bóng.
+bool GameSave::readFile(const QString &filename, GameState &gameState, QString *error, int rows, int cols,
+                        ReadStats *stats)
 {
-    // Ask user for file to load
-    QString filename = QFileDialog::getOpenFileName(
-        parent,
-        "Mở Game",
-        QDir::homePath(),
-        getLoadFileFilter()
-        );
+    auto fail = [error](const QString &message) {
+        if (error) *error = message;
+        return false;
+    };
 
-    if (filename.isEmpty()) {
-        return false; // User canceled
-    }
+    QElapsedTimer timer;
+    timer.start();
 
-    // Read file
     QFile file(filename);
     if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::warning(parent, "Lỗi Mở Game",
-                             QString("Không thể mở file:\n%1\n\nLỗi: %2")
-                                 .arg(filename).arg(file.errorString()));
-        return false;
+        return fail(QString("Không thể mở file:\n%1\n\nLỗi: %2").arg(filename).arg(file.errorString()));
     }
 
-    QByteArray data = file.readAll();
-    file.close();
-
-    // Parse JSON
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull() || !doc.isObject()) {
-        QMessageBox::warning(parent, "Lỗi File",
-                             "File không hợp lệ hoặc đã bị hỏng!");
-        return false;
+    // File nén: kích thước bàn lấy từ header. File .json ghi "rows"/"cols" sau
+    // balls, nên đọc với giới hạn MaxSide rồi kiểm tra lại khi đã biết kích thước
+    const bool compressed = file.peek(SaveMagic.size()) == SaveMagic;
+    int boundRows = MaxSide, boundCols = MaxSide;
+    if (compressed) {
+        SaveInfo info;
+        if (!readHeader(file, info, false)) return fail("File không hợp lệ hoặc đã bị hỏng!");
+        boundRows = rows = info.rows;
+        boundCols = cols = info.cols;
     }
 
-    QJsonObject gameStateObj = doc.object();
-
-    // Validate basic structure
-    if (!gameStateObj.contains("balls") || !gameStateObj["balls"].isArray()) {
-        QMessageBox::warning(parent, "Lỗi File",
-                             "File không chứa dữ liệu game hợp lệ!");
-        return false;
+    // Màu dạng tên / RGB (v1.0) thêm vào bảng màu chuẩn ngay; chỉ số (v1.1)
+    // giữ nguyên và kiểm tra khi đã đọc xong palette (có thể nằm sau balls)
+    Palette legacyPalette;
+    QVector<int> rgbaBalls;          // bóng mang màu v1.0, hiếm gặp
+    int missingColors = 0;
+    QVector<BallData> balls;
+    if (!compressed && file.size() > 0) balls.reserve(int(qMin<qint64>(file.size() / 128, 1 << 24)));   // ~140 byte / bóng (Indented)
+
+    SaveStreamReader reader(
+        boundRows, boundCols,
+        [&](const SaveStreamReader::Ball &b) {
+            BallData ball(b.id, b.row, b.col, Palette::Empty, b.bounceOffset);
+            if (b.colorKind == SaveStreamReader::Ball::Index) {
+                ball.colorIndex = static_cast<quint8>(b.colorIndex);
+            } else if (b.colorKind == SaveStreamReader::Ball::Rgba) {
+                ball.colorIndex = legacyPalette.indexOf(QColor::fromRgba(b.rgba));
+                rgbaBalls.append(int(balls.size()));
+            } else {
+                ++missingColors;
+            }
+            balls.append(ball);
+        },
+        [](std::string_view name, uint32_t &rgba) {
+            const QColor color(QString::fromUtf8(name.data(), int(name.size())));
+            if (!color.isValid()) return false;
+            rgba = color.rgba();
+            return true;
+        });
+
+    if (compressed) {
+        // từng khối nén độc lập, khối rỗng là kết thúc
+        QByteArray block;
+        for (;;) {
+            if (!readBlock(file, MaxBlockBytes, block)) return fail("File không hợp lệ hoặc đã bị hỏng!");
+            if (block.isEmpty()) break;
+            const QByteArray json = qUncompress(block);
+            if (json.isEmpty()) return fail("File không hợp lệ hoặc đã bị hỏng!");
+            if (!reader.feed(json.constData(), size_t(json.size()))) return fail(QString::fromStdString(reader.error()));
+        }
+    } else {
+        static constexpr qint64 ChunkBytes = 256 * 1024;
+        QByteArray chunk(int(ChunkBytes), Qt::Uninitialized);
+        for (;;) {
+            const qint64 n = file.read(chunk.data(), ChunkBytes);
+            if (n < 0) return fail(QString("Lỗi đọc file:\n%1\n\nLỗi: %2").arg(filename).arg(file.errorString()));
+            if (n == 0) break;
+            if (!reader.feed(chunk.constData(), size_t(n))) return fail(QString::fromStdString(reader.error()));
+        }
     }
-
-    // Clear current game state
-    gameState.balls.clear();
-
-    // Load balls
-    QJsonArray ballsArray = gameStateObj["balls"].toArray();
-    for (const QJsonValue &value : ballsArray) {
-        if (value.isObject()) {
-            BallData ball = jsonToBall(value.toObject());
-            gameState.balls.append(ball);
+    if (!reader.finish()) return fail(QString::fromStdString(reader.error()));
+
+    if (!compressed) {
+        if (reader.declaredRows() > 0 || reader.declaredCols() > 0) {
+            // kích thước file tự ghi (v1.2+)
+            rows = reader.declaredRows();
+            cols = reader.declaredCols();
+            if (rows <= 0 || cols <= 0 || rows > MaxSide || cols > MaxSide)
+                return fail("File không hợp lệ hoặc đã bị hỏng!");
+        } else if (rows <= 0 || cols <= 0) {
+            // save cũ không ghi kích thước: bàn nhỏ nhất (tối thiểu 10x10) chứa mọi bóng
+            rows = cols = 10;
+            for (const BallData &ball : balls) {
+                rows = qMax(rows, ball.row + 1);
+                cols = qMax(cols, ball.col + 1);
+            }
+        }
+        for (const BallData &ball : balls) {
+            if (ball.row >= rows || ball.col >= cols) {
+                return fail(QString("Bóng có vị trí không hợp lệ:\nBóng ID %1 tại (%2,%3)")
+                                .arg(ball.id).arg(ball.row).arg(ball.col));
+            }
+        }
+        for (const SaveStreamReader::SolutionMove &m : reader.puzzleSolution()) {
+            if (m.fromRow >= rows || m.fromCol >= cols || m.toRow >= rows || m.toCol >= cols)
+                return fail("Lời giải puzzle không hợp lệ!");
         }
     }
 
-    // Load metadata with fallback values
-    gameState.nextBallId = gameStateObj.value("nextBallId").toInt(0);
-    gameState.selectedBallIndex = gameStateObj.value("selectedBallIndex").toInt(-1);
-    gameState.movingBallIndex = gameStateObj.value("movingBallIndex").toInt(-1);
-
-    // Validate loaded data
-    if (gameState.balls.isEmpty()) {
-        QMessageBox::warning(parent, "Lỗi Dữ Liệu",
-                             "File không chứa bóng nào!");
-        return false;
+    // Palette (v1.1+); v1.0 saves start from the standard colours
+    if (reader.hasPalette()) {
+        QVector<QColor> colors;
+        colors.reserve(int(reader.palette().size()));
+        for (uint32_t rgba : reader.palette()) colors.append(QColor::fromRgba(rgba));
+        gameState.palette = colors.isEmpty() ? Palette() : Palette(colors);
+    } else {
+        gameState.palette = legacyPalette;
     }
 
-    // Update nextBallId if necessary (find maximum ID)
-    int maxId = 0;
-    for (const BallData &ball : gameState.balls) {
-        if (ball.id > maxId) {
-            maxId = ball.id;
-        }
+    // Màu v1.0 trong file có palette riêng: đổi sang chỉ số của palette đó
+    if (reader.hasPalette()) {
+        for (int i : rgbaBalls) balls[i].colorIndex = gameState.palette.indexOf(legacyPalette.color(balls[i].colorIndex));
     }
-    if (maxId >= gameState.nextBallId) {
-        gameState.nextBallId = maxId + 1;
-    }
-
-    // Validate ball positions
-    for (const BallData &ball : gameState.balls) {
-        if (ball.row < 0 || ball.row >= 10 || ball.col < 0 || ball.col >= 10) {
-            QMessageBox::warning(parent, "Lỗi Dữ Liệu",
-                                 QString("Bóng có vị trí không hợp lệ:\nBóng ID %1 tại (%2,%3)")
-                                     .arg(ball.id).arg(ball.row).arg(ball.col));  // ĐÃ SỬA: bỏ dấu ) thừa
-            return false;
+    // Màu hỏng / chỉ số ngoài bảng màu -> đỏ mặc định như jsonToBall. Chỉ duyệt
+    // lại khi thật sự có bóng như vậy.
+    if (missingColors > 0 || reader.maxColorIndex() > gameState.palette.size()) {
+        const quint8 red = gameState.palette.indexOf(QColor(255, 0, 0));
+        for (BallData &ball : balls) {
+            if (!gameState.palette.isValidIndex(ball.colorIndex)) ball.colorIndex = red;
         }
     }
 
-    // Check for duplicate positions
-    QVector<QPoint> positions;
-    for (const BallData &ball : gameState.balls) {
-        QPoint pos(ball.row, ball.col);
-        if (positions.contains(pos)) {
-            QMessageBox::warning(parent, "Lỗi Dữ Liệu",
-                                 QString("Nhiều bóng ở cùng vị trí:\nHàng %1, Cột %2")
-                                     .arg(ball.row).arg(ball.col));  // ĐÃ SỬA: bỏ dấu ) thừa
-            return false;
-        }
-        positions.append(pos);
+    gameState.balls = std::move(balls);
+    gameState.nextBallId = reader.nextBallId();
+    gameState.selectedBallIndex = reader.selectedBallIndex();
+    gameState.movingBallIndex = reader.movingBallIndex();
+    gameState.rows = rows;
+    gameState.cols = cols;
+    gameState.puzzleMoves = reader.puzzleMoves();
+    gameState.puzzleSolution.clear();
+    for (const SaveStreamReader::SolutionMove &m : reader.puzzleSolution())
+        gameState.puzzleSolution.append(MoveData{ m.fromRow, m.fromCol, m.toRow, m.toCol });
+
+    if (stats) {
+        stats->bytes = file.pos();
+        stats->jsonBytes = qint64(reader.bytesRead());
+        stats->seconds = timer.nsecsElapsed() / 1e9;
+        stats->peakRssBytes = qint64(PowerMetrics::peakRssBytes());
     }
+    return true;
+}
 
-    // Show success message
-    QMessageBox::information(parent, "Thành Công",
-                             QString("Game đã được tải thành công!\n\nFile: %1\nSố lượng bóng: %2")
-                                 .arg(QFileInfo(filename).fileName())
-                                 .arg(gameState.balls.size()));
+bool GameSave::readInfo(const QString &filename, SaveInfo &info, QString *error)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) *error = QString("Không thể mở file:\n%1\n\nLỗi: %2").arg(filename).arg(file.errorString());
+        return false;
+    }
+    if (file.peek(SaveMagic.size()) == SaveMagic) {
+        if (readHeader(file, info, true)) return true;
+        if (error) *error = "File không hợp lệ hoặc đã bị hỏng!";
+        return false;
+    }
+    file.close();
 
+    // .json / save cũ: không có header -> đọc cả file một lần
+    GameState state;
+    if (!readFileAnySize(filename, state, error)) return false;
+    info.ballCount = int(state.balls.size());
+    info.rows = state.rows;
+    info.cols = state.cols;
+    info.saveTime = QFileInfo(filename).lastModified().toString(Qt::ISODate);
+    info.thumbnail = thumbnail(state);
     return true;
 }
 
+bool GameSave::readFileAnySize(const QString &filename, GameState &gameState, QString *error)
+{
+    // file nén: header; .json: "rows"/"cols" nếu có, không thì suy ra từ bóng xa nhất
+    return readFile(filename, gameState, error, 0, 0);
+}
+
+GameSave::GameState GameSave::fromPuzzle(const Puzzle &puzzle)
+{
+    GameState state;
+    state.rows = puzzle.rules.rows;
+    state.cols = puzzle.rules.cols;
+    const int C = state.cols;
+    for (int cell = 0; cell < int(puzzle.cells.size()); ++cell) {
+        if (puzzle.cells[cell] == Palette::Empty) continue;
+        state.balls.append(BallData(state.nextBallId++, cell / C, cell % C, puzzle.cells[cell], 0));
+    }
+    state.puzzleMoves = puzzle.moveLimit;
+    for (const PuzzleMove &move : puzzle.solution)
+        state.puzzleSolution.append(MoveData{ move.from / C, move.from % C, move.to / C, move.to % C });
+    return state;
+}
+
+QImage GameSave::thumbnail(const GameState &gameState, int maxSide)
+{
+    return ThumbnailRenderer::render(gameState, maxSide);
+}
+
 QJsonObject GameSave::ballToJson(const BallData &ball)
 {
     QJsonObject obj;
     obj["id"] = ball.id;
     obj["row"] = ball.row;
     obj["col"] = ball.col;
-    obj["color"] = ball.color.name();
+    obj["color"] = ball.colorIndex;
     obj["bounceOffset"] = ball.bounceOffset;
     return obj;
 }
 
-GameSave::BallData GameSave::jsonToBall(const QJsonObject &json)
+GameSave::BallData GameSave::jsonToBall(const QJsonObject &json, Palette &palette)
 {
     BallData ball;
 
@@ -203,24 +464,52 @@ GameSave::BallData GameSave::jsonToBall(const QJsonObject &json)
     ball.col = json.value("col").toInt(0);
     ball.bounceOffset = json.value("bounceOffset").toInt(0);
 
-    // Handle color - support both name and RGB values
+    // Handle color - palette index (v1.1), or name / RGB values (v1.0)
+    QColor color;
     if (json.contains("color")) {
-        if (json["color"].isString()) {
-            ball.color = QColor(json["color"].toString());
+        if (json["color"].isDouble()) {
+            int index = json["color"].toInt(Palette::Empty);
+            if (palette.isValidIndex(index)) {
+                ball.colorIndex = static_cast<quint8>(index);
+            }
+        } else if (json["color"].isString()) {
+            color = QColor(json["color"].toString());
         } else if (json["color"].isObject()) {
             QJsonObject colorObj = json["color"].toObject();
-            ball.color = QColor(
+            color = QColor(
                 colorObj.value("r").toInt(0),
                 colorObj.value("g").toInt(0),
                 colorObj.value("b").toInt(0)
                 );
         }
     }
+    if (color.isValid()) {
+        ball.colorIndex = palette.indexOf(color);
+    }
 
     // If color is invalid, use default red
-    if (!ball.color.isValid()) {
-        ball.color = QColor(255, 0, 0);
+    if (ball.colorIndex == Palette::Empty) {
+        ball.colorIndex = palette.indexOf(QColor(255, 0, 0));
     }
 
     return ball;
 }
+
+QJsonArray GameSave::paletteToJson(const Palette &palette)
+{
+    QJsonArray array;
+    for (const QColor &color : palette.colors()) {
+        array.append(color.name());
+    }
+    return array;
+}
+
+Palette GameSave::jsonToPalette(const QJsonArray &json)
+{
+    QVector<QColor> colors;
+    for (const QJsonValue &value : json) {
+        QColor color(value.toString());
+        colors.append(color.isValid() ? color : QColor(255, 0, 0));
+    }
+    return colors.isEmpty() ? Palette() : Palette(colors);
+}
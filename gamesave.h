@@ -11,6 +11,13 @@
 #include <QFile>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QImage>
+#include "palette.h"
+
+#include <memory>
+
+class SaveIndex;
+struct Puzzle;
 
 class GameSave : public QObject
 {
@@ -18,43 +25,112 @@ class GameSave : public QObject
 
 public:
     explicit GameSave(QObject *parent = nullptr);
+    ~GameSave();
 
     // Ball data structure for serialization
     struct BallData {
         int id;
         int row;
         int col;
-        QColor color;
+        quint8 colorIndex;      // chỉ số trong GameState::palette
         int bounceOffset;
 
-        BallData() : id(-1), row(0), col(0), bounceOffset(0) {}
-        BallData(int id, int row, int col, const QColor &color, int bounceOffset)
-            : id(id), row(row), col(col), color(color), bounceOffset(bounceOffset) {}
+        BallData() : id(-1), row(0), col(0), colorIndex(Palette::Empty), bounceOffset(0) {}
+        BallData(int id, int row, int col, quint8 colorIndex, int bounceOffset)
+            : id(id), row(row), col(col), colorIndex(colorIndex), bounceOffset(bounceOffset) {}
+    };
+
+    // Một nước đi (puzzle): bóng ở (fromRow, fromCol) tới (toRow, toCol)
+    struct MoveData {
+        int fromRow = 0;
+        int fromCol = 0;
+        int toRow = 0;
+        int toCol = 0;
     };
 
     // Game state structure
     struct GameState {
         QVector<BallData> balls;
+        Palette palette;        // lưu 1 lần cho cả file
         int nextBallId;
         int selectedBallIndex;
         int movingBallIndex;
+        int rows;               // kích thước bàn (file cũ: theo bàn đang chơi)
+        int cols;
+        int puzzleMoves = 0;            // > 0: puzzle "dọn hết bóng trong K nước", không sinh bóng mới
+        QVector<MoveData> puzzleSolution;
+
+        GameState() : nextBallId(0), selectedBallIndex(-1), movingBallIndex(-1), rows(10), cols(10) {}
+    };
 
-        GameState() : nextBallId(0), selectedBallIndex(-1), movingBallIndex(-1) {}
+    // Thông tin xem trước của một save, đọc được mà không giải nén cả file
+    struct SaveInfo {
+        int ballCount = 0;
+        int rows = 10;
+        int cols = 10;
+        QString saveTime;       // ISO, như "saveTime" trong JSON
+        QImage thumbnail;       // tối đa ThumbnailSide px, null nếu không có
     };
+    static constexpr int ThumbnailSide = 64;
 
-    // Save game to file
+    // Save game to a named slot in SaveIndex::defaultDirectory()
     bool saveGame(const GameState &gameState, QWidget *parent = nullptr);
 
-    // Load game from file
-    bool loadGame(GameState &gameState, QWidget *parent = nullptr);
+    // Load game: chọn slot (SaveBrowser) hoặc file bất kỳ; file không có
+    // header kích thước được kiểm tra theo bàn rows x cols
+    bool loadGame(GameState &gameState, QWidget *parent = nullptr, int rows = 10, int cols = 10);
+    // Thời gian ghi / đọc file của saveGame / loadGame gần nhất, không tính hộp thoại
+    qint64 lastIoNs() const { return m_lastIoNs; }
+
+    // Số liệu của một lần readFile
+    struct ReadStats {
+        qint64 bytes = 0;               // byte của file
+        qint64 jsonBytes = 0;           // JSON sau giải nén (bằng bytes nếu file không nén)
+        double seconds = 0;
+        qint64 peakRssBytes = 0;        // RSS cao nhất của cả process tới lúc đọc xong
+        double megabytesPerSecond() const { return seconds > 0 ? bytes / 1e6 / seconds : 0; }
+    };
+
+    // Không hộp thoại (headless, script): false + *error (tiếng Việt) nếu lỗi.
+    //
+    // File .json: JSON thụt dòng như cũ. Các tên khác (.bgsave): file nén
+    //   "BGSZ" | u32 len | header JSON (số bóng, kích thước, saveTime)
+    //          | u32 len | thumbnail PNG
+    //          | (u32 len | qCompress(tối đa 1 MB JSON))... | u32 0
+    // Header và thumbnail đọc được ngay (readInfo), không cần giải nén.
+    //
+    // readFile nhận cả hai dạng, đọc dạng stream (SaveStreamReader), bộ nhớ
+    // ngoài kết quả cố định; kiểm tra vị trí bóng theo kích thước trong header
+    // hoặc "rows"/"cols" của JSON. File không ghi kích thước (save cũ) thì theo
+    // bàn rows x cols; rows/cols <= 0: suy ra từ bóng xa nhất.
+    static bool writeFile(const QString &filename, const GameState &gameState, QString *error = nullptr);
+    static bool readFile(const QString &filename, GameState &gameState, QString *error = nullptr,
+                         int rows = 10, int cols = 10, ReadStats *stats = nullptr);
+
+    static bool readInfo(const QString &filename, SaveInfo &info, QString *error = nullptr);
+    // Bàn lớn nhất một header được khai báo
+    static constexpr int MaxSide = 4096;
+    // Không biết trước kích thước bàn (batch, index): file không có header thì
+    // bàn là hình nhỏ nhất (tối thiểu 10x10) chứa mọi bóng
+    static bool readFileAnySize(const QString &filename, GameState &gameState, QString *error = nullptr);
+    // Ảnh bàn tối đa maxSide px, vẽ như BoardView (ThumbnailRenderer)
+    static QImage thumbnail(const GameState &gameState, int maxSide = ThumbnailSide);
+
+    // Bàn + lời giải của một puzzle đã sinh (PuzzleGenerator), palette chuẩn
+    static GameState fromPuzzle(const Puzzle &puzzle);
 
     // Convert between BallData and JSON
     static QJsonObject ballToJson(const BallData &ball);
-    static BallData jsonToBall(const QJsonObject &json);
+    // Palette may grow when an old (v1.0) save names a colour not in it yet
+    static BallData jsonToBall(const QJsonObject &json, Palette &palette);
+    static QJsonArray paletteToJson(const Palette &palette);
+    static Palette jsonToPalette(const QJsonArray &json);
+
+    SaveIndex &saveIndex();
 
 private:
-    QString getSaveFileFilter() const { return "Ball Game Save Files (*.bgsave);;JSON Files (*.json);;All Files (*)"; }
-    QString getLoadFileFilter() const { return "Ball Game Save Files (*.bgsave *.json);;All Files (*)"; }
+    std::unique_ptr<SaveIndex> m_index;     // tạo khi cần
+    qint64 m_lastIoNs = 0;
 };
 
 #endif // GAMESAVE_H
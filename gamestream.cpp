@@ -0,0 +1,240 @@
+#include "gamestream.h"
+
+#include <algorithm>
+
+namespace GameStream {
+
+namespace {
+
+constexpr size_t HeaderBytes = 5;       // u32 length + u8 type
+constexpr int MaxSide = 4096;
+
+void putVarint(std::string &out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out += static_cast<char>(v | 0x80);
+        v >>= 7;
+    }
+    out += static_cast<char>(v);
+}
+
+void putU32(std::string &out, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) out += static_cast<char>(v >> (8 * i));
+}
+
+uint32_t getU32(const uint8_t *p)
+{
+    return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+}
+
+bool getVarint(const uint8_t *&p, const uint8_t *end, uint64_t &v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uint8_t byte = *p++;
+        v |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Mở frame: chỗ cho độ dài, điền lại ở closeFrame
+size_t openFrame(std::string &out, FrameType type)
+{
+    const size_t start = out.size();
+    putU32(out, 0);
+    out += static_cast<char>(type);
+    return start;
+}
+
+void closeFrame(std::string &out, size_t start)
+{
+    const uint32_t length = static_cast<uint32_t>(out.size() - start - HeaderBytes);
+    for (int i = 0; i < 4; ++i) out[start + i] = static_cast<char>(length >> (8 * i));
+}
+
+} // namespace
+
+void appendSnapshot(std::string &out, uint64_t seq, int rows, int cols, const uint8_t *cells,
+                    const std::vector<uint32_t> &palette)
+{
+    const size_t start = openFrame(out, FrameType::Snapshot);
+    out += static_cast<char>(Version);
+    putVarint(out, seq);
+    putVarint(out, static_cast<uint64_t>(rows));
+    putVarint(out, static_cast<uint64_t>(cols));
+    putVarint(out, palette.size());
+    for (uint32_t rgba : palette) putU32(out, rgba);
+
+    // RLE: bàn thưa / nhiều ô trống liền nhau chỉ tốn vài byte
+    const size_t n = static_cast<size_t>(rows) * cols;
+    for (size_t i = 0; i < n;) {
+        size_t run = 1;
+        while (i + run < n && cells[i + run] == cells[i]) ++run;
+        putVarint(out, run);
+        out += static_cast<char>(cells[i]);
+        i += run;
+    }
+    closeFrame(out, start);
+}
+
+void appendTurn(std::string &out, uint64_t seq, const TurnHistory::Turn &turn)
+{
+    const size_t start = openFrame(out, FrameType::Turn);
+    putVarint(out, seq);
+    putVarint(out, static_cast<uint64_t>(turn.from));
+    putVarint(out, static_cast<uint64_t>(turn.to));
+    putVarint(out, static_cast<uint64_t>(turn.spawnedCount()));
+    for (int i = 0; i < turn.spawnedCount(); ++i) {
+        const TurnHistory::CellColor spawned = turn.spawned(i);
+        putVarint(out, static_cast<uint64_t>(spawned.cell));
+        out += static_cast<char>(spawned.color);
+    }
+
+    // ô bị xóa tăng dần, ghi khoảng cách: một hàng 5 ô tốn ~6 byte
+    thread_local std::vector<int> removed;
+    removed.resize(turn.removedCount());
+    for (int i = 0; i < turn.removedCount(); ++i) removed[i] = turn.removed(i).cell;
+    std::sort(removed.begin(), removed.end());
+    putVarint(out, removed.size());
+    int previous = 0;
+    for (int cell : removed) {
+        putVarint(out, static_cast<uint64_t>(cell - previous));
+        previous = cell;
+    }
+    closeFrame(out, start);
+}
+
+bool Reader::fail(const char *message)
+{
+    if (m_error.empty()) m_error = message;
+    return false;
+}
+
+bool Reader::feed(const char *data, size_t size)
+{
+    if (!m_error.empty()) return false;
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(data);
+    const uint8_t *end = p + size;
+
+    // Frame dở từ lần trước: chỉ nối đúng phần còn thiếu
+    while (!m_pending.empty() && p < end) {
+        const uint8_t *pending = reinterpret_cast<const uint8_t *>(m_pending.data());
+        const size_t need = m_pending.size() < HeaderBytes ? HeaderBytes : HeaderBytes + getU32(pending);
+        const size_t take = std::min(need - m_pending.size(), static_cast<size_t>(end - p));
+        m_pending.append(reinterpret_cast<const char *>(p), take);
+        p += take;
+        if (m_pending.size() < HeaderBytes) continue;
+
+        pending = reinterpret_cast<const uint8_t *>(m_pending.data());
+        const uint32_t length = getU32(pending);
+        if (length > MaxFrameBytes) return fail("frame too large");
+        if (m_pending.size() < HeaderBytes + length) continue;
+        if (!frame(static_cast<FrameType>(pending[4]), pending + HeaderBytes, pending + HeaderBytes + length))
+            return false;
+        m_pending.clear();
+    }
+
+    // Các frame trọn vẹn đọc thẳng từ data, không chép
+    while (static_cast<size_t>(end - p) >= HeaderBytes) {
+        const uint32_t length = getU32(p);
+        if (length > MaxFrameBytes) return fail("frame too large");
+        if (static_cast<size_t>(end - p) < HeaderBytes + length) break;
+        if (!frame(static_cast<FrameType>(p[4]), p + HeaderBytes, p + HeaderBytes + length)) return false;
+        p += HeaderBytes + length;
+    }
+    if (p < end) m_pending.append(reinterpret_cast<const char *>(p), static_cast<size_t>(end - p));
+    return true;
+}
+
+bool Reader::frame(FrameType type, const uint8_t *p, const uint8_t *end)
+{
+    bool ok;
+    switch (type) {
+    case FrameType::Snapshot: ok = snapshot(p, end); break;
+    case FrameType::Turn: ok = turn(p, end); break;
+    default: return fail("unknown frame type");
+    }
+    if (!ok) return false;
+    m_lastType = type;
+    ++m_frames;
+    return true;
+}
+
+bool Reader::snapshot(const uint8_t *p, const uint8_t *end)
+{
+    if (p == end || *p++ != Version) return fail("unsupported stream version");
+    uint64_t seq, rows, cols, colors;
+    if (!getVarint(p, end, seq) || !getVarint(p, end, rows) || !getVarint(p, end, cols) || !getVarint(p, end, colors))
+        return fail("truncated snapshot");
+    if (rows < 1 || cols < 1 || rows > MaxSide || cols > MaxSide) return fail("bad board size");
+    if (colors > 255 || static_cast<uint64_t>(end - p) < colors * 4) return fail("bad palette");
+
+    m_palette.resize(colors);
+    for (uint32_t &rgba : m_palette) {
+        rgba = getU32(p);
+        p += 4;
+    }
+    const size_t n = rows * cols;
+    m_cells.resize(n);
+    size_t filled = 0;
+    int balls = 0;
+    while (filled < n) {
+        uint64_t run;
+        if (!getVarint(p, end, run) || p == end || run == 0 || run > n - filled) return fail("bad snapshot cells");
+        const uint8_t color = *p++;
+        std::fill_n(m_cells.begin() + filled, run, color);
+        if (color != 0) balls += static_cast<int>(run);
+        filled += run;
+    }
+    if (p != end) return fail("trailing bytes in snapshot");
+
+    m_rows = static_cast<int>(rows);
+    m_cols = static_cast<int>(cols);
+    m_seq = seq;
+    m_balls = balls;
+    m_lastSpawned = m_lastRemoved = 0;
+    return true;
+}
+
+// Áp dụng theo thứ tự của TurnHistory: đi, thêm, xóa
+bool Reader::turn(const uint8_t *p, const uint8_t *end)
+{
+    if (!hasSnapshot()) return fail("turn before snapshot");
+    const uint64_t n = m_cells.size();
+    uint64_t seq, from, to, count;
+    if (!getVarint(p, end, seq) || !getVarint(p, end, from) || !getVarint(p, end, to)) return fail("truncated turn");
+    if (seq != m_seq + 1) return fail("turn out of sequence");
+    if (from >= n || to >= n || m_cells[from] == 0 || m_cells[to] != 0) return fail("illegal move in turn");
+    m_cells[to] = m_cells[from];
+    m_cells[from] = 0;
+
+    if (!getVarint(p, end, count) || count > n) return fail("truncated turn");
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t cell;
+        if (!getVarint(p, end, cell) || p == end) return fail("truncated turn");
+        const uint8_t color = *p++;
+        if (cell >= n || m_cells[cell] != 0 || color == 0) return fail("bad spawn in turn");
+        m_cells[cell] = color;
+    }
+    m_lastSpawned = static_cast<int>(count);
+
+    if (!getVarint(p, end, count) || count > n) return fail("truncated turn");
+    uint64_t cell = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t delta;
+        if (!getVarint(p, end, delta)) return fail("truncated turn");
+        cell += delta;
+        if (cell >= n || (i > 0 && delta == 0) || m_cells[cell] == 0) return fail("bad removal in turn");
+        m_cells[cell] = 0;
+    }
+    if (p != end) return fail("trailing bytes in turn");
+
+    m_lastRemoved = static_cast<int>(count);
+    m_balls += m_lastSpawned - m_lastRemoved;
+    m_seq = seq;
+    return true;
+}
+
+} // namespace GameStream
@@ -0,0 +1,82 @@
+#ifndef GAMESTREAM_H
+#define GAMESTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "turnhistory.h"
+
+// Binary live-game stream for spectators (dashboards, recorders, bots in
+// other languages), Qt-free. A client gets one Snapshot, then one Turn frame
+// per turn; anything that is not a plain turn (undo, load, new game) or a
+// client that fell behind gets a fresh Snapshot instead.
+//
+// Frame:    u32 LE payload length | u8 type | payload
+// Snapshot: u8 version | varint seq | varint rows | varint cols
+//           | varint n | n x u32 LE palette colour (0xAARRGGBB, index i + 1)
+//           | (varint run | u8 colour)... covering rows * cols cells, row major
+// Turn:     varint seq | varint from | varint to
+//           | varint n | n x (varint cell | u8 colour)      spawned
+//           | varint n | n x varint (cell - previous cell)  removed, ascending
+// Varints are LEB128. A turn applies as: move from -> to, set spawned,
+// clear removed (the TurnHistory order). seq grows by one per frame, so a
+// gap before a Snapshot means frames were skipped, never lost mid-turn.
+namespace GameStream {
+
+constexpr uint8_t Version = 1;
+constexpr uint32_t MaxFrameBytes = 32u << 20;   // snapshot 2048x2048 xấu nhất ~8 MB
+
+enum class FrameType : uint8_t { Snapshot = 1, Turn = 2 };
+
+void appendSnapshot(std::string &out, uint64_t seq, int rows, int cols, const uint8_t *cells,
+                    const std::vector<uint32_t> &palette);
+void appendTurn(std::string &out, uint64_t seq, const TurnHistory::Turn &turn);
+
+// Incremental frame parser that keeps the board the frames describe. Used by
+// clients, and by the server itself to build snapshots for late joiners.
+class Reader
+{
+public:
+    // false on a malformed frame or a turn that does not fit the board; see error()
+    bool feed(const char *data, size_t size);
+    const std::string &error() const { return m_error; }
+
+    bool hasSnapshot() const { return m_rows > 0; }
+    int rows() const { return m_rows; }
+    int cols() const { return m_cols; }
+    const std::vector<uint8_t> &cells() const { return m_cells; }
+    const std::vector<uint32_t> &palette() const { return m_palette; }
+    uint64_t seq() const { return m_seq; }
+    int ballCount() const { return m_balls; }
+
+    // Frame cuối cùng đã áp dụng
+    FrameType lastType() const { return m_lastType; }
+    int lastSpawned() const { return m_lastSpawned; }
+    int lastRemoved() const { return m_lastRemoved; }
+    uint64_t frames() const { return m_frames; }
+
+private:
+    bool frame(FrameType type, const uint8_t *p, const uint8_t *end);
+    bool snapshot(const uint8_t *p, const uint8_t *end);
+    bool turn(const uint8_t *p, const uint8_t *end);
+    bool fail(const char *message);
+
+    std::string m_pending;          // frame chưa trọn
+    std::string m_error;
+    int m_rows = 0;
+    int m_cols = 0;
+    std::vector<uint8_t> m_cells;
+    std::vector<uint32_t> m_palette;
+    uint64_t m_seq = 0;
+    int m_balls = 0;
+    FrameType m_lastType = FrameType::Snapshot;
+    int m_lastSpawned = 0;
+    int m_lastRemoved = 0;
+    uint64_t m_frames = 0;
+};
+
+} // namespace GameStream
+
+#endif // GAMESTREAM_H
@@ -0,0 +1,86 @@
+#include "gymbatch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Seed của ván thứ `episode` trong môi trường `env`
+uint64_t episodeSeed(uint64_t seed, int env, uint64_t episode)
+{
+    Rng mix(seed ^ (static_cast<uint64_t>(env) << 32) ^ (episode * 0x9E3779B97F4A7C15ull));
+    return mix.next();
+}
+
+} // namespace
+
+bool GymBatch::fitsActions(int rows, int cols)
+{
+    if (rows <= 0 || cols <= 0 || rows > GameRules::MaxSide || cols > GameRules::MaxSide) return false;
+    return static_cast<int64_t>(rows) * cols <= MaxCellCount;
+}
+
+GymBatch::GymBatch(int envCount, const GameRules &rules, uint64_t seed, int threads)
+    : m_rules(rules),
+    m_seed(seed),
+    m_pool(threads)
+{
+    m_envs.reserve(envCount);
+    for (int i = 0; i < envCount; ++i) {
+        m_envs.push_back(std::make_unique<GameEngine>(rules));
+        m_actionRng.emplace_back(episodeSeed(~seed, i, 0));
+    }
+    m_episode.assign(envCount, 0);
+}
+
+void GymBatch::run(int begin, int end)
+{
+    const int cells = cellCount();
+    for (int i = begin; i < end; ++i) {
+        GameEngine &env = *m_envs[i];
+        switch (m_job) {
+        case Job::Reset:
+            env.reset(episodeSeed(m_seed, i, m_episode[i] = 0));
+            break;
+        case Job::Step: {
+            const int32_t action = m_actions[i];
+            const GameEngine::StepResult result = env.step(action / cells, action % cells);
+            m_rewards[i] = result.legal ? static_cast<float>(result.cleared) : IllegalReward;
+            m_dones[i] = result.done;
+            if (result.done) env.reset(episodeSeed(m_seed, i, ++m_episode[i]));
+            break;
+        }
+        case Job::Sample: {
+            int from = 0, to = 0;
+            m_sampled[i] = env.randomMove(m_actionRng[i], from, to) ? from * cells + to : 0;
+            break;
+        }
+        }
+        if (m_observations) std::memcpy(m_observations + static_cast<size_t>(i) * cells, env.board().data(), cells);
+    }
+}
+
+void GymBatch::reset(uint8_t *observations)
+{
+    m_job = Job::Reset;
+    m_observations = observations;
+    m_pool.parallelFor(envCount(), 64, [this](int begin, int end) { run(begin, end); });
+}
+
+void GymBatch::step(const int32_t *actions, uint8_t *observations, float *rewards, uint8_t *dones)
+{
+    m_job = Job::Step;
+    m_actions = actions;
+    m_observations = observations;
+    m_rewards = rewards;
+    m_dones = dones;
+    m_pool.parallelFor(envCount(), 64, [this](int begin, int end) { run(begin, end); });
+}
+
+void GymBatch::sampleActions(int32_t *actions)
+{
+    m_job = Job::Sample;
+    m_sampled = actions;
+    m_observations = nullptr;
+    m_pool.parallelFor(envCount(), 64, [this](int begin, int end) { run(begin, end); });
+}
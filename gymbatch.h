@@ -0,0 +1,64 @@
+#ifndef GYMBATCH_H
+#define GYMBATCH_H
+
+#include "gameengine.h"
+#include "workerpool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// A batch of independent GameEngines stepped together, for training move
+// policies. One step() call applies one action per environment on the
+// worker pool and writes packed results into caller-owned arrays:
+//   observations  envCount * cellCount bytes, palette index per cell
+//   rewards       envCount floats: balls cleared, IllegalReward for an
+//                 illegal action (board unchanged)
+//   dones         envCount bytes: 1 if that game ended; the environment is
+//                 reset right away and its observation is the new board
+// Actions are from * cellCount + to, so cellCount is capped at MaxCellCount
+// for every action to fit an int32.
+class GymBatch
+{
+public:
+    static constexpr float IllegalReward = -1.0f;
+    static constexpr int MaxCellCount = 46340;      // 46340² < 2^31
+
+    // rows/cols trong [1, MaxSide] và rows * cols <= MaxCellCount
+    static bool fitsActions(int rows, int cols);
+
+    // threads: extra worker threads, -1 = one per core; rules must pass fitsActions()
+    GymBatch(int envCount, const GameRules &rules, uint64_t seed, int threads = -1);
+
+    int envCount() const { return static_cast<int>(m_envs.size()); }
+    int cellCount() const { return m_rules.rows * m_rules.cols; }
+    const GameRules &rules() const { return m_rules; }
+    const GameEngine &env(int index) const { return *m_envs[index]; }
+
+    void reset(uint8_t *observations);
+    void step(const int32_t *actions, uint8_t *observations, float *rewards, uint8_t *dones);
+    // Một nước hợp lệ ngẫu nhiên cho mỗi môi trường (baseline / benchmark)
+    void sampleActions(int32_t *actions);
+
+private:
+    void run(int begin, int end);
+
+    enum class Job { Reset, Step, Sample };
+
+    GameRules m_rules;
+    std::vector<std::unique_ptr<GameEngine>> m_envs;
+    std::vector<Rng> m_actionRng;       // riêng cho sampleActions
+    std::vector<uint64_t> m_episode;    // số ván đã chơi, để sinh seed ván mới
+    uint64_t m_seed;
+    WorkerPool m_pool;
+
+    // arguments of the running job (the pool lambda only captures `this`)
+    Job m_job = Job::Reset;
+    const int32_t *m_actions = nullptr;
+    int32_t *m_sampled = nullptr;
+    uint8_t *m_observations = nullptr;
+    float *m_rewards = nullptr;
+    uint8_t *m_dones = nullptr;
+};
+
+#endif // GYMBATCH_H
@@ -0,0 +1,319 @@
+#include "headless.h"
+#include "gamesave.h"
+#include "thumbnailrenderer.h"
+#include "workerpool.h"
+
+#include <chrono>
+#include <sstream>
+
+namespace {
+
+const char *const CommandNames[] = { "seed", "select", "move", "spawn", "play", "load", "save", "dump", "strip" };
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+char cellChar(uint8_t color)
+{
+    if (color == GameBoard::Empty) return '.';
+    if (color <= 9) return static_cast<char>('0' + color);
+    if (color <= 35) return static_cast<char>('a' + color - 10);
+    return '#';
+}
+
+} // namespace
+
+HeadlessRunner::HeadlessRunner(const GameRules &rules, uint64_t seed)
+    : m_engine(rules), m_hints(WorkerPool::shared())
+{
+    m_hints.setRules(rules);
+    m_engine.reset(seed);
+    m_botRng.setState(seed ^ 0x9e3779b97f4a7c15ull);
+}
+
+int HeadlessRunner::run(std::FILE *in)
+{
+    int errors = 0;
+    std::string line;
+    char buffer[4096];
+    while (std::fgets(buffer, sizeof buffer, in)) {
+        line += buffer;
+        if (line.back() != '\n' && !std::feof(in)) continue;   // dòng dài hơn buffer
+        ++m_line;
+        errors += !execute(line);
+        line.clear();
+    }
+    if (!line.empty()) {
+        ++m_line;
+        errors += !execute(line);
+    }
+    return errors == 0 ? 0 : 1;
+}
+
+bool HeadlessRunner::execute(const std::string &line)
+{
+    std::istringstream in(line.substr(0, line.find('#')));
+    std::string name;
+    if (!(in >> name)) return true;   // dòng trống / chú thích
+
+    int command = 0;
+    while (command < CommandCount && name != CommandNames[command]) ++command;
+    if (command == CommandCount) {
+        std::fprintf(stderr, "line %d: unknown command '%s'\n", m_line, name.c_str());
+        return false;
+    }
+
+    auto syntax = [&](const char *usage) {
+        std::fprintf(stderr, "line %d: usage: %s\n", m_line, usage);
+        return false;
+    };
+
+    const int64_t start = nowNs();
+    bool ok = true;
+    switch (command) {
+    case Seed: {
+        uint64_t seed;
+        if (!(in >> seed)) return syntax("seed N");
+        m_engine.reset(seed);
+        m_selected = -1;
+        break;
+    }
+    case Select: {
+        int r, c, cell;
+        if (!(in >> r >> c)) return syntax("select R C");
+        if (!cellFrom(r, c, cell)) return false;
+        if (m_engine.board().data()[cell] == GameBoard::Empty) {
+            std::printf("select %d %d: empty\n", r, c);
+            m_selected = -1;
+        } else {
+            m_selected = cell;
+        }
+        break;
+    }
+    case Move: {
+        int a[4], n = 0;
+        while (n < 4 && in >> a[n]) ++n;
+        int from = m_selected, to;
+        if (n == 4) {
+            if (!cellFrom(a[0], a[1], from) || !cellFrom(a[2], a[3], to)) return false;
+        } else if (n == 2) {
+            if (!cellFrom(a[0], a[1], to)) return false;
+        } else {
+            return syntax("move R C | move R1 C1 R2 C2");
+        }
+        ok = move(from, to);
+        break;
+    }
+    case Spawn: {
+        int count;
+        if (!(in >> count) || count < 0) return syntax("spawn N");
+        int cleared = 0;
+        const int spawned = m_engine.spawnBalls(count, &cleared);
+        std::printf("spawn %d: added %d cleared %d\n", count, spawned, cleared);
+        break;
+    }
+    case Play: {
+        int count;
+        std::string policy = "random";
+        if (!(in >> count) || count < 0) return syntax("play N [random|hint]");
+        if (!(in >> policy)) policy = "random";
+        if (policy != "random" && policy != "hint") return syntax("play N [random|hint]");
+        ok = play(count, policy == "hint");
+        break;
+    }
+    case Load:
+    case Save: {
+        std::string path;
+        std::getline(in >> std::ws, path);
+        while (!path.empty() && (path.back() == '\r' || path.back() == ' ')) path.pop_back();
+        if (path.empty()) return syntax(command == Load ? "load FILE" : "save FILE");
+        ok = command == Load ? load(path) : save(path);
+        break;
+    }
+    case Dump:
+        dump();
+        break;
+    case Strip: {
+        int count;
+        std::string policy, path;
+        if (!(in >> count >> policy) || count < 0 || (policy != "random" && policy != "hint"))
+            return syntax("strip N random|hint FILE");
+        std::getline(in >> std::ws, path);
+        while (!path.empty() && (path.back() == '\r' || path.back() == ' ')) path.pop_back();
+        if (path.empty()) return syntax("strip N random|hint FILE");
+        ok = strip(count, policy == "hint", path);
+        break;
+    }
+    }
+
+    m_timings[command].count += 1;
+    m_timings[command].totalNs += nowNs() - start;
+    return ok;
+}
+
+bool HeadlessRunner::cellFrom(int row, int col, int &cell) const
+{
+    const GameBoard &board = m_engine.board();
+    if (!board.inBounds(row, col)) {
+        std::fprintf(stderr, "line %d: cell (%d, %d) outside %dx%d board\n", m_line, row, col, board.rows(),
+                     board.cols());
+        return false;
+    }
+    cell = row * board.cols() + col;
+    return true;
+}
+
+// Nước đi không hợp lệ không phải lỗi của script: in ra và chạy tiếp
+bool HeadlessRunner::move(int from, int to)
+{
+    const int cols = m_engine.board().cols();
+    if (from < 0) {
+        std::printf("move: no ball selected\n");
+        return true;
+    }
+    const GameEngine::StepResult result = m_engine.step(from, to);
+    std::printf("move %d %d -> %d %d: ", from / cols, from % cols, to / cols, to % cols);
+    if (!result.legal) {
+        std::printf("illegal\n");
+        return true;
+    }
+    // như finishMove: bóng vừa đi vẫn được chọn (nếu chưa bị xóa)
+    m_selected = m_engine.board().data()[to] != GameBoard::Empty ? to : -1;
+    std::printf("cleared %d score %d%s\n", result.cleared, m_engine.score(), result.done ? " game over" : "");
+    return true;
+}
+
+bool HeadlessRunner::botMove(bool hint, int &from, int &to)
+{
+    if (m_engine.isOver()) return false;
+    if (hint) {
+        const std::vector<HintMove> &best = m_hints.bestMoves(m_engine.board(), m_engine.regions(), 1);
+        if (best.empty()) return false;
+        from = best.front().from;
+        to = best.front().to;
+        return true;
+    }
+    return m_engine.randomMove(m_botRng, from, to);
+}
+
+bool HeadlessRunner::play(int count, bool hint)
+{
+    int played = 0, cleared = 0;
+    for (int from, to; played < count && botMove(hint, from, to); ++played) cleared += m_engine.step(from, to).cleared;
+    m_selected = -1;
+    std::printf("play %d %s: played %d cleared %d score %d%s\n", count, hint ? "hint" : "random", played, cleared,
+                m_engine.score(), m_engine.isOver() ? " game over" : "");
+    return true;
+}
+
+// Như play, chụp bàn trước nước đầu và sau mỗi nước thành dải PNG (replay)
+bool HeadlessRunner::strip(int count, bool hint, const std::string &path)
+{
+    if (count + 1 > ThumbnailRenderer::MaxStripFrames) {
+        std::fprintf(stderr, "line %d: strip: at most %d moves\n", m_line, ThumbnailRenderer::MaxStripFrames - 1);
+        return false;
+    }
+    QVector<GameBoard> frames;
+    frames.reserve(count + 1);
+    frames.append(m_engine.board());
+    int played = 0;
+    for (int from, to; played < count && botMove(hint, from, to); ++played) {
+        m_engine.step(from, to);
+        frames.append(m_engine.board());
+    }
+    m_selected = -1;
+
+    const QImage image = ThumbnailRenderer::renderStrip(frames, m_palette, StripFrameSide);
+    if (!image.save(QString::fromLocal8Bit(path.c_str()), "PNG")) {
+        std::fprintf(stderr, "line %d: strip: cannot write %s\n", m_line, path.c_str());
+        return false;
+    }
+    std::printf("strip %d %s: %d frames score %d%s\n", count, hint ? "hint" : "random", int(frames.size()),
+                m_engine.score(), m_engine.isOver() ? " game over" : "");
+    return true;
+}
+
+bool HeadlessRunner::load(const std::string &path)
+{
+    const GameBoard &board = m_engine.board();
+    GameSave::GameState state;
+    QString error;
+    GameSave::ReadStats stats;
+    if (!GameSave::readFile(QString::fromLocal8Bit(path.c_str()), state, &error, board.rows(), board.cols(), &stats)) {
+        std::fprintf(stderr, "line %d: load %s: %s\n", m_line, path.c_str(), error.toLocal8Bit().constData());
+        return false;
+    }
+
+    if (state.rows != board.rows() || state.cols != board.cols()) {
+        std::fprintf(stderr, "line %d: load %s: board is %dx%d, not %dx%d (use --board)\n", m_line, path.c_str(),
+                     state.rows, state.cols, board.rows(), board.cols());
+        return false;
+    }
+
+    std::vector<uint8_t> cells(static_cast<size_t>(board.cellCount()), GameBoard::Empty);
+    for (const GameSave::BallData &ball : state.balls) cells[static_cast<size_t>(ball.row) * board.cols() + ball.col] = ball.colorIndex;
+    m_engine.load(cells.data(), m_engine.rng().state());
+    m_palette = state.palette;
+
+    m_selected = -1;
+    if (state.selectedBallIndex >= 0 && state.selectedBallIndex < state.balls.size()) {
+        const GameSave::BallData &ball = state.balls[state.selectedBallIndex];
+        m_selected = ball.row * board.cols() + ball.col;
+    }
+    std::printf("load %s: %d balls\n", path.c_str(), int(state.balls.size()));
+    // số liệu đọc file thay đổi theo máy -> stderr, stdout vẫn so sánh được
+    std::fprintf(stderr, "load %s: %.1f MB in %.3f s, %.1f MB/s, peak RSS %.1f MB\n", path.c_str(), stats.bytes / 1e6,
+                 stats.seconds, stats.megabytesPerSecond(), stats.peakRssBytes / 1e6);
+    return true;
+}
+
+// Bóng theo thứ tự hàng-cột, id đánh lại từ 0
+bool HeadlessRunner::save(const std::string &path)
+{
+    const GameBoard &board = m_engine.board();
+    GameSave::GameState state;
+    state.palette = m_palette;
+    state.rows = board.rows();
+    state.cols = board.cols();
+    for (int cell = 0; cell < board.cellCount(); ++cell) {
+        const uint8_t color = board.data()[cell];
+        if (color == GameBoard::Empty) continue;
+        if (cell == m_selected) state.selectedBallIndex = int(state.balls.size());
+        state.balls.append(GameSave::BallData(state.nextBallId++, cell / board.cols(), cell % board.cols(), color, 0));
+    }
+
+    QString error;
+    if (!GameSave::writeFile(QString::fromLocal8Bit(path.c_str()), state, &error)) {
+        std::fprintf(stderr, "line %d: save %s: %s\n", m_line, path.c_str(), error.toLocal8Bit().constData());
+        return false;
+    }
+    std::printf("save %s: %d balls\n", path.c_str(), int(state.balls.size()));
+    return true;
+}
+
+void HeadlessRunner::dump() const
+{
+    const GameBoard &board = m_engine.board();
+    std::printf("board %dx%d turns %d score %d%s\n", board.rows(), board.cols(), m_engine.turns(), m_engine.score(),
+                m_engine.isOver() ? " game over" : "");
+    std::string row(static_cast<size_t>(board.cols()) + 1, '\n');
+    for (int r = 0; r < board.rows(); ++r) {
+        for (int c = 0; c < board.cols(); ++c) row[c] = cellChar(board.at(r, c));
+        std::fputs(row.c_str(), stdout);
+    }
+}
+
+void HeadlessRunner::printTimings(std::FILE *out) const
+{
+    std::fprintf(out, "%-8s %10s %12s %12s\n", "command", "count", "total ms", "mean us");
+    for (int i = 0; i < CommandCount; ++i) {
+        const Timing &t = m_timings[i];
+        if (t.count == 0) continue;
+        std::fprintf(out, "%-8s %10lld %12.3f %12.3f\n", CommandNames[i], static_cast<long long>(t.count),
+                     t.totalNs / 1e6, t.totalNs / 1e3 / t.count);
+    }
+}
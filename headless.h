@@ -0,0 +1,70 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gameengine.h"
+#include "hintengine.h"
+#include "palette.h"
+
+// --headless: chạy lệnh từ stdin hoặc file script trên GameEngine, không cửa
+// sổ, không event loop, không timer. Dùng để kiểm tra hồi quy khi đổi luật
+// và chạy perf trên chuỗi nước đi thật.
+//
+// Mỗi dòng một lệnh (ô là "hàng cột", đếm từ 0; '#' là chú thích):
+//   seed N              ván mới như initializeBalls với seed N
+//   select R C          chọn bóng
+//   move R C            bóng đang chọn đi tới (R, C): cả lượt (đi, thêm, xóa)
+//   move R1 C1 R2 C2    như trên, không cần select
+//   spawn N             thêm N bóng ngẫu nhiên rồi xóa hàng
+//   play N [random|hint]  N nước của bot
+//   load FILE / save FILE  định dạng .bgsave của GameSave
+//   dump                in bàn: '.' ô trống, 1-9 a-z chỉ số màu
+//   strip N random|hint FILE  như play, ghi dải replay PNG (bàn sau từng nước)
+//
+// Kết quả in ra stdout (ổn định, so sánh được giữa các lần chạy); thời gian
+// từng loại lệnh in ra stderr khi kết thúc.
+class HeadlessRunner
+{
+public:
+    HeadlessRunner(const GameRules &rules, uint64_t seed);
+
+    // 0 nếu mọi lệnh hợp lệ, 1 nếu có lệnh sai cú pháp / lỗi file
+    int run(std::FILE *in);
+    // Một dòng lệnh; false nếu lỗi (đã in ra stderr)
+    bool execute(const std::string &line);
+    void printTimings(std::FILE *out) const;
+
+    const GameEngine &engine() const { return m_engine; }
+
+private:
+    enum Command { Seed, Select, Move, Spawn, Play, Load, Save, Dump, Strip, CommandCount };
+    static constexpr int StripFrameSide = 96;
+
+    bool cellFrom(int row, int col, int &cell) const;
+    bool move(int from, int to);
+    bool botMove(bool hint, int &from, int &to);
+    bool play(int count, bool hint);
+    bool strip(int count, bool hint, const std::string &path);
+    bool load(const std::string &path);
+    bool save(const std::string &path);
+    void dump() const;
+
+    GameEngine m_engine;
+    HintEngine m_hints;
+    Palette m_palette;
+    Rng m_botRng;
+    int m_selected = -1;            // ô đang chọn, -1 nếu không có
+    int m_line = 0;                 // dòng đang chạy (thông báo lỗi)
+
+    struct Timing {
+        int64_t count = 0;
+        int64_t totalNs = 0;
+    };
+    Timing m_timings[CommandCount];
+};
+
+#endif // HEADLESS_H
@@ -0,0 +1,205 @@
+#include "hintengine.h"
+#include "board.h"
+#include "emptyregions.h"
+#include "gameboard.h"
+#include "workerpool.h"
+
+#include <algorithm>
+
+namespace {
+
+constexpr int ClearWeight = 100;
+constexpr int NearWeight = 4;
+
+// Giá trị các hàng đi qua `cell` (màu `color`) chưa đủ lineLength nhưng còn
+// chỗ trống để kéo dài tới đủ: sum(run^2) cho run >= 2.
+int nearLineValue(const uint8_t *cells, int rows, int cols, int cell, uint8_t color, int lineLength, unsigned dirs)
+{
+    const int r = cell / cols, c = cell % cols;
+    auto at = [&](int rr, int cc) -> int {
+        if (rr < 0 || rr >= rows || cc < 0 || cc >= cols) return -1;
+        return cells[rr * cols + cc];
+    };
+
+    int value = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (!(dirs >> d & 1u)) continue;
+        const int dr = BoardDirections::LineRow[d], dc = BoardDirections::LineCol[d];
+        int back = 0, fwd = 0;
+        while (back < lineLength && at(r - (back + 1) * dr, c - (back + 1) * dc) == color) ++back;
+        while (fwd < lineLength && at(r + (fwd + 1) * dr, c + (fwd + 1) * dc) == color) ++fwd;
+        const int run = back + 1 + fwd;
+        if (run < 2 || run >= lineLength) continue;
+
+        // run có thể kéo dài qua các ô trống hai đầu không?
+        int room = run;
+        for (int i = back + 1; room < lineLength && at(r - i * dr, c - i * dc) == 0; ++i) ++room;
+        for (int i = fwd + 1; room < lineLength && at(r + i * dr, c + i * dc) == 0; ++i) ++room;
+        if (room >= lineLength) value += run * run;
+    }
+    return value;
+}
+
+int emptyNeighbours(const uint8_t *cells, int rows, int cols, int cell)
+{
+    const int r = cell / cols, c = cell % cols;
+    return (r > 0 && cells[cell - cols] == 0) + (r + 1 < rows && cells[cell + cols] == 0)
+           + (c > 0 && cells[cell - 1] == 0) + (c + 1 < cols && cells[cell + 1] == 0);
+}
+
+bool better(const HintMove &a, const HintMove &b)
+{
+    if (a.score != b.score) return a.score > b.score;
+    if (a.from != b.from) return a.from < b.from;
+    return a.to < b.to;
+}
+
+} // namespace
+
+HintEngine::HintEngine(WorkerPool &pool)
+    : m_pool(pool)
+{
+}
+
+// Gom các ô trống theo vùng (counting sort theo id của EmptyRegions)
+void HintEngine::bucketRegions(const GameBoard &board, const EmptyRegions &regions)
+{
+    const int n = board.cellCount();
+    const int ids = regions.idCapacity();
+    m_componentStart.assign(ids + 1, 0);
+    for (int cell = 0; cell < n; ++cell) {
+        const int id = regions.regionOf(cell);
+        if (id >= 0) ++m_componentStart[id + 1];
+    }
+    for (int id = 0; id < ids; ++id) m_componentStart[id + 1] += m_componentStart[id];
+    m_componentCells.resize(m_componentStart[ids]);
+    m_cursor.assign(m_componentStart.begin(), m_componentStart.end() - 1);
+    for (int cell = 0; cell < n; ++cell) {
+        const int id = regions.regionOf(cell);
+        if (id >= 0) m_componentCells[m_cursor[id]++] = cell;
+    }
+}
+
+// Mỗi bóng đi được tới mọi ô của các vùng trống kề nó (Jump: mọi ô trống)
+void HintEngine::collectMoves(const GameBoard &board, const EmptyRegions &regions)
+{
+    const int n = board.cellCount();
+    const int cols = board.cols(), rows = board.rows();
+    const uint8_t *cells = board.data();
+    m_moves.clear();
+
+    if (m_jump) {
+        for (int from = 0; from < n; ++from) {
+            if (cells[from] == GameBoard::Empty) continue;
+            for (int to : m_componentCells) {
+                if (m_moveLimit > 0 && static_cast<int>(m_moves.size()) >= m_moveLimit) return;
+                HintMove move;
+                move.from = from;
+                move.to = to;
+                m_moves.push_back(move);
+            }
+        }
+        return;
+    }
+
+    for (int from = 0; from < n; ++from) {
+        if (cells[from] == GameBoard::Empty) continue;
+        const int r = from / cols, c = from % cols;
+        int ids[4];
+        int count = 0;
+        auto addComponent = [&](int next) {
+            const int id = regions.regionOf(next);
+            if (id < 0 || std::find(ids, ids + count, id) != ids + count) return;
+            ids[count++] = id;
+        };
+        if (r > 0) addComponent(from - cols);
+        if (r + 1 < rows) addComponent(from + cols);
+        if (c > 0) addComponent(from - 1);
+        if (c + 1 < cols) addComponent(from + 1);
+
+        for (int i = 0; i < count; ++i) {
+            for (int k = m_componentStart[ids[i]]; k < m_componentStart[ids[i] + 1]; ++k) {
+                if (m_moveLimit > 0 && static_cast<int>(m_moves.size()) >= m_moveLimit) return;
+                HintMove move;
+                move.from = from;
+                move.to = m_componentCells[k];
+                m_moves.push_back(move);
+            }
+        }
+    }
+}
+
+template <class Geometry>
+void HintEngine::scoreMoves(const Geometry &geo, const GameBoard &board)
+{
+    const int rows = board.rows(), cols = board.cols(), n = board.cellCount();
+    const uint8_t *cells = board.data();
+    const int lineLength = m_lineLength;
+    const unsigned dirs = m_lineDirections;
+    HintMove *moves = m_moves.data();
+
+    // giá trị hàng gần đủ của mỗi bóng tại chỗ cũ (mất đi khi bóng rời đi)
+    m_nearBefore.assign(n, 0);
+    for (int cell = 0; cell < n; ++cell) {
+        if (cells[cell] != GameBoard::Empty)
+            m_nearBefore[cell] = nearLineValue(cells, rows, cols, cell, cells[cell], lineLength, dirs);
+    }
+    const int *nearBefore = m_nearBefore.data();
+
+    m_pool.parallelFor(static_cast<int>(m_moves.size()), 256, [&](int begin, int end) {
+        // bản sao board riêng cho mỗi luồng, sửa from/to rồi trả lại
+        thread_local std::vector<uint8_t> scratch;
+        thread_local std::vector<uint8_t> mask;
+        scratch.assign(cells, cells + n);
+        mask.assign(n, 0);
+
+        for (int i = begin; i < end; ++i) {
+            HintMove &move = moves[i];
+            const uint8_t color = cells[move.from];
+
+            scratch[move.from] = GameBoard::Empty;
+            scratch[move.to] = color;
+
+            move.cleared = geo.markLinesThrough(scratch.data(), move.to, mask.data());
+            if (move.cleared > 0) std::fill(mask.begin(), mask.end(), 0);
+            move.nearLines = move.cleared > 0
+                                 ? 0
+                                 : nearLineValue(scratch.data(), rows, cols, move.to, color, lineLength, dirs)
+                                       - nearBefore[move.from];
+
+            // ô vừa trống nối lại được bao nhiêu ô; ô trống nào quanh `to` bị bít kín
+            int trapped = 0;
+            const int r = move.to / cols, c = move.to % cols;
+            auto checkTrapped = [&](int next) {
+                if (scratch[next] == GameBoard::Empty && emptyNeighbours(scratch.data(), rows, cols, next) == 0) ++trapped;
+            };
+            if (r > 0) checkTrapped(move.to - cols);
+            if (r + 1 < rows) checkTrapped(move.to + cols);
+            if (c > 0) checkTrapped(move.to - 1);
+            if (c + 1 < cols) checkTrapped(move.to + 1);
+            move.mobility = emptyNeighbours(scratch.data(), rows, cols, move.from) - 2 * trapped;
+
+            move.score = move.cleared * ClearWeight + move.nearLines * NearWeight + move.mobility;
+
+            scratch[move.to] = GameBoard::Empty;
+            scratch[move.from] = color;
+        }
+    });
+}
+
+const std::vector<HintMove> &HintEngine::bestMoves(const GameBoard &board, const EmptyRegions &regions, int k)
+{
+    m_best.clear();
+    bucketRegions(board, regions);
+    collectMoves(board, regions);
+    if (m_moves.empty() || k <= 0) return m_best;
+
+    withBoardGeometry(board.rows(), board.cols(), m_lineLength, m_lineDirections, [&](const auto &geo) {
+        scoreMoves(geo, board);
+    });
+
+    const size_t keep = std::min(m_moves.size(), static_cast<size_t>(k));
+    std::partial_sort(m_moves.begin(), m_moves.begin() + keep, m_moves.end(), better);
+    m_best.assign(m_moves.begin(), m_moves.begin() + keep);
+    return m_best;
+}
@@ -0,0 +1,70 @@
+#ifndef HINTENGINE_H
+#define HINTENGINE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "gamerules.h"
+
+class EmptyRegions;
+class GameBoard;
+class WorkerPool;
+
+// Một nước đi gợi ý: bóng ở ô `from` đi tới ô trống `to`
+struct HintMove {
+    int from = -1;
+    int to = -1;
+    int score = 0;
+    int cleared = 0;        // số bóng bị xóa ngay sau nước đi
+    int nearLines = 0;      // thay đổi giá trị các hàng gần đủ (sau - trước)
+    int mobility = 0;       // ô trống mở ra ở `from` trừ ô trống bị kẹt quanh `to`
+};
+
+// Scores every legal (ball, reachable empty cell) move of a board and keeps
+// the best k. Reachability comes from the board's EmptyRegions, so "is
+// there a path" is a region-id compare. Scoring runs in
+// chunks on a WorkerPool; results are ordered by score, then (from, to),
+// so the same board always gives the same hint.
+class HintEngine
+{
+public:
+    explicit HintEngine(WorkerPool &pool);
+
+    void setLineLength(int lineLength) { m_lineLength = lineLength; }
+    // Độ dài hàng, hướng hàng, kiểu di chuyển (Jump: mọi ô trống đều tới được)
+    void setRules(const GameRules &rules)
+    {
+        m_lineLength = rules.lineLength;
+        m_lineDirections = rules.lineDirections;
+        m_jump = rules.movement == GameRules::Movement::Jump;
+    }
+    // Giới hạn số nước được chấm (bàn rất lớn); 0 = không giới hạn
+    void setMoveLimit(int limit) { m_moveLimit = limit; }
+
+    // Best k moves, best first. Empty when no ball can move.
+    // `regions` must be up to date with `board`.
+    const std::vector<HintMove> &bestMoves(const GameBoard &board, const EmptyRegions &regions, int k);
+
+    int lastMoveCount() const { return static_cast<int>(m_moves.size()); }
+
+private:
+    void bucketRegions(const GameBoard &board, const EmptyRegions &regions);
+    void collectMoves(const GameBoard &board, const EmptyRegions &regions);
+    template <class Geometry>
+    void scoreMoves(const Geometry &geo, const GameBoard &board);
+
+    WorkerPool &m_pool;
+    int m_lineLength = 5;
+    unsigned m_lineDirections = BoardDirections::AllLines;
+    bool m_jump = false;
+    int m_moveLimit = 0;
+
+    std::vector<int> m_componentStart;  // cells of region i: m_componentCells[start[i] .. start[i+1])
+    std::vector<int> m_componentCells;
+    std::vector<int> m_cursor;
+    std::vector<int> m_nearBefore;      // per ball cell
+    std::vector<HintMove> m_moves;
+    std::vector<HintMove> m_best;
+};
+
+#endif // HINTENGINE_H
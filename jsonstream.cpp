@@ -0,0 +1,306 @@
+#include "jsonstream.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool isNumberChar(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+// Ngữ pháp số JSON: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+// from_chars còn nhận "007", "1.", ".5", "+1" nên kiểm tra trước
+bool isJsonNumber(const char *p, const char *end)
+{
+    auto digits = [&] {
+        const char *start = p;
+        while (p < end && *p >= '0' && *p <= '9') ++p;
+        return p > start;
+    };
+    if (p < end && *p == '-') ++p;
+    if (p < end && *p == '0') ++p;
+    else if (!digits()) return false;
+    if (p < end && *p == '.') {
+        ++p;
+        if (!digits()) return false;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p < end && (*p == '+' || *p == '-')) ++p;
+        if (!digits()) return false;
+    }
+    return p == end;
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 4 chữ số hex sau "\u"; -1 nếu sai
+int parseHex4(const char *p)
+{
+    int value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int h = hexValue(p[i]);
+        if (h < 0) return -1;
+        value = value << 4 | h;
+    }
+    return value;
+}
+
+void appendUtf8(std::string &out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xc0 | cp >> 6);
+        out += static_cast<char>(0x80 | (cp & 0x3f));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xe0 | cp >> 12);
+        out += static_cast<char>(0x80 | (cp >> 6 & 0x3f));
+        out += static_cast<char>(0x80 | (cp & 0x3f));
+    } else {
+        out += static_cast<char>(0xf0 | cp >> 18);
+        out += static_cast<char>(0x80 | (cp >> 12 & 0x3f));
+        out += static_cast<char>(0x80 | (cp >> 6 & 0x3f));
+        out += static_cast<char>(0x80 | (cp & 0x3f));
+    }
+}
+
+} // namespace
+
+bool JsonStream::fail(const char *message)
+{
+    if (m_error.empty()) m_error = std::string(message) + " at byte " + std::to_string(m_offset);
+    return false;
+}
+
+size_t JsonStream::tokenError(const char *message)
+{
+    fail(message);
+    return 0;
+}
+
+bool JsonStream::feed(const char *data, size_t size)
+{
+    if (failed()) return false;
+
+    // Token dở từ chunk trước: nối thêm từng khúc (gấp đôi dần) tới khi trọn
+    while (!m_pending.empty() && size > 0) {
+        const size_t before = m_pending.size();
+        const size_t take = std::min(size, std::max<size_t>(64, before));
+        m_pending.append(data, take);
+        const size_t used = parse(m_pending.data(), m_pending.data() + m_pending.size(), false);
+        if (failed()) return false;
+        if (used == 0) {
+            if (m_pending.size() > MaxTokenBytes) return fail("token too long");
+            data += take;
+            size -= take;
+            continue;
+        }
+        // token kết thúc trong khúc vừa nối; phần còn lại đọc thẳng từ data
+        const size_t fromChunk = used - before;
+        m_offset += used;
+        m_pending.clear();
+        data += fromChunk;
+        size -= fromChunk;
+    }
+
+    const char *p = data;
+    const char *end = data + size;
+    while (p < end) {
+        if (isSpace(*p)) {
+            ++p;
+            ++m_offset;
+            continue;
+        }
+        const size_t used = parse(p, end, false);
+        if (failed()) return false;
+        if (used == 0) {
+            if (static_cast<size_t>(end - p) > MaxTokenBytes) return fail("token too long");
+            m_pending.assign(p, end);
+            return true;
+        }
+        p += used;
+        m_offset += used;
+    }
+    return true;
+}
+
+bool JsonStream::finish()
+{
+    if (failed()) return false;
+    if (!m_pending.empty()) {
+        const size_t used = parse(m_pending.data(), m_pending.data() + m_pending.size(), true);
+        if (failed()) return false;
+        if (used != m_pending.size()) return fail("unexpected end of input");
+        m_offset += used;
+        m_pending.clear();
+    }
+    if (m_expect != Expect::Done) return fail("unexpected end of input");
+    return true;
+}
+
+bool JsonStream::valueDone()
+{
+    m_expect = m_stack.empty() ? Expect::Done : Expect::CommaOrEnd;
+    return true;
+}
+
+size_t JsonStream::parse(const char *p, const char *end, bool last)
+{
+    const bool wantValue = m_expect == Expect::Value || m_expect == Expect::ArrayFirst;
+    const char c = *p;
+    switch (c) {
+    case '{':
+    case '[':
+        if (!wantValue) return tokenError("unexpected bracket");
+        if (static_cast<int>(m_stack.size()) >= MaxDepth) return tokenError("nesting too deep");
+        m_stack.push_back(c);
+        m_expect = c == '{' ? Expect::ObjectFirst : Expect::ArrayFirst;
+        if (!(c == '{' ? m_handler.startObject() : m_handler.startArray())) return tokenError("aborted");
+        return 1;
+    case '}':
+    case ']': {
+        const char open = c == '}' ? '{' : '[';
+        const bool empty = m_expect == (c == '}' ? Expect::ObjectFirst : Expect::ArrayFirst);
+        if (m_stack.empty() || m_stack.back() != open || !(empty || m_expect == Expect::CommaOrEnd))
+            return tokenError("unexpected closing bracket");
+        m_stack.pop_back();
+        if (!(c == '}' ? m_handler.endObject() : m_handler.endArray())) return tokenError("aborted");
+        valueDone();
+        return 1;
+    }
+    case ':':
+        if (m_expect != Expect::Colon) return tokenError("unexpected ':'");
+        m_expect = Expect::Value;
+        return 1;
+    case ',':
+        if (m_expect != Expect::CommaOrEnd) return tokenError("unexpected ','");
+        m_expect = m_stack.back() == '{' ? Expect::Key : Expect::Value;
+        return 1;
+    case '"':
+        if (m_expect == Expect::ObjectFirst || m_expect == Expect::Key) return parseString(p, end, true);
+        if (!wantValue) return tokenError("unexpected string");
+        return parseString(p, end, false);
+    case 't':
+        if (!wantValue) return tokenError("unexpected literal");
+        return parseLiteral(p, end, "true");
+    case 'f':
+        if (!wantValue) return tokenError("unexpected literal");
+        return parseLiteral(p, end, "false");
+    case 'n':
+        if (!wantValue) return tokenError("unexpected literal");
+        return parseLiteral(p, end, "null");
+    default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            if (!wantValue) return tokenError("unexpected number");
+            return parseNumber(p, end, last);
+        }
+        return tokenError("unexpected character");
+    }
+}
+
+size_t JsonStream::parseString(const char *p, const char *end, bool isKey)
+{
+    auto emit = [&](std::string_view value, size_t used) -> size_t {
+        const bool ok = isKey ? m_handler.key(value) : m_handler.string(value);
+        if (!ok) return tokenError("aborted");
+        if (isKey) m_expect = Expect::Colon;
+        else valueDone();
+        return used;
+    };
+
+    // đường nhanh: không có escape, trỏ thẳng vào input
+    const char *q = p + 1;
+    while (q < end && *q != '"' && *q != '\\') {
+        if (static_cast<unsigned char>(*q) < 0x20) return tokenError("control character in string");
+        ++q;
+    }
+    if (q == end) return 0;
+    if (*q == '"') return emit(std::string_view(p + 1, q - p - 1), q + 1 - p);
+
+    m_unescaped.assign(p + 1, q);
+    while (q < end) {
+        const char ch = *q;
+        if (ch == '"') return emit(m_unescaped, q + 1 - p);
+        if (static_cast<unsigned char>(ch) < 0x20) return tokenError("control character in string");
+        if (ch != '\\') {
+            m_unescaped += ch;
+            ++q;
+            continue;
+        }
+        if (end - q < 2) return 0;
+        switch (q[1]) {
+        case '"': m_unescaped += '"'; break;
+        case '\\': m_unescaped += '\\'; break;
+        case '/': m_unescaped += '/'; break;
+        case 'b': m_unescaped += '\b'; break;
+        case 'f': m_unescaped += '\f'; break;
+        case 'n': m_unescaped += '\n'; break;
+        case 'r': m_unescaped += '\r'; break;
+        case 't': m_unescaped += '\t'; break;
+        case 'u': {
+            if (end - q < 6) return 0;
+            int cp = parseHex4(q + 2);
+            if (cp < 0) return tokenError("bad \\u escape");
+            if (cp >= 0xd800 && cp <= 0xdbff) {
+                // cặp surrogate: cần "\uDC00".."\uDFFF" ngay sau
+                if (end - q < 12) return 0;
+                const int low = q[6] == '\\' && q[7] == 'u' ? parseHex4(q + 8) : -1;
+                if (low < 0xdc00 || low > 0xdfff) return tokenError("bad surrogate pair");
+                cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                q += 6;
+            }
+            appendUtf8(m_unescaped, static_cast<uint32_t>(cp));
+            q += 6;
+            continue;
+        }
+        default:
+            return tokenError("bad escape");
+        }
+        q += 2;
+    }
+    return 0;
+}
+
+size_t JsonStream::parseNumber(const char *p, const char *end, bool last)
+{
+    const char *q = p;
+    while (q < end && isNumberChar(*q)) ++q;
+    if (q == end && !last) return 0;   // số có thể còn tiếp ở chunk sau
+
+    double value = 0;
+    if (!isJsonNumber(p, q)) return tokenError("bad number");
+    const std::from_chars_result r = std::from_chars(p, q, value);
+    if (r.ec != std::errc() || r.ptr != q) return tokenError("bad number");
+    if (!m_handler.number(value)) return tokenError("aborted");
+    valueDone();
+    return q - p;
+}
+
+size_t JsonStream::parseLiteral(const char *p, const char *end, std::string_view word)
+{
+    const size_t have = std::min(static_cast<size_t>(end - p), word.size());
+    if (std::memcmp(p, word.data(), have) != 0) return tokenError("bad literal");
+    if (have < word.size()) return 0;
+
+    bool ok;
+    if (word == "null") ok = m_handler.null();
+    else ok = m_handler.boolean(word == "true");
+    if (!ok) return tokenError("aborted");
+    valueDone();
+    return word.size();
+}
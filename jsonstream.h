@@ -0,0 +1,78 @@
+#ifndef JSONSTREAM_H
+#define JSONSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Incremental SAX-style JSON tokenizer, Qt-free.
+//
+// feed() takes the input in chunks of any size and calls the Handler for
+// every token as soon as it is complete; nothing but the current unfinished
+// token and the container stack is kept, so memory stays bounded no matter
+// how large the document is. Strings handed to the handler are only valid
+// during the call. A handler returning false stops parsing.
+class JsonStream
+{
+public:
+    static constexpr size_t MaxTokenBytes = 64 * 1024;   // chuỗi / số dài hơn -> lỗi
+    static constexpr int MaxDepth = 64;
+
+    class Handler
+    {
+    public:
+        virtual ~Handler() = default;
+        virtual bool startObject() = 0;
+        virtual bool endObject() = 0;
+        virtual bool startArray() = 0;
+        virtual bool endArray() = 0;
+        virtual bool key(std::string_view name) = 0;
+        virtual bool string(std::string_view value) = 0;
+        virtual bool number(double value) = 0;
+        virtual bool boolean(bool value) = 0;
+        virtual bool null() = 0;
+    };
+
+    explicit JsonStream(Handler &handler) : m_handler(handler) {}
+
+    // False on a syntax error or when the handler stopped; see error()
+    bool feed(const char *data, size_t size);
+    // Hết input: false nếu tài liệu chưa trọn
+    bool finish();
+
+    bool failed() const { return !m_error.empty(); }
+    const std::string &error() const { return m_error; }
+    uint64_t bytesConsumed() const { return m_offset; }
+
+private:
+    enum class Expect : uint8_t {
+        Value,          // đầu tài liệu, sau ':' hoặc ',' trong mảng
+        ArrayFirst,     // sau '[': giá trị hoặc ']'
+        ObjectFirst,    // sau '{': key hoặc '}'
+        Key,            // sau ',' trong object
+        Colon,
+        CommaOrEnd,     // sau một giá trị trong container
+        Done,
+    };
+
+    // Một token bắt đầu tại p; trả về số byte đã dùng, 0 nếu token chưa trọn
+    size_t parse(const char *p, const char *end, bool last);
+    size_t parseString(const char *p, const char *end, bool isKey);
+    size_t parseNumber(const char *p, const char *end, bool last);
+    size_t parseLiteral(const char *p, const char *end, std::string_view word);
+    bool valueDone();
+    bool fail(const char *message);
+    size_t tokenError(const char *message);     // fail() cho parse*: trả về 0
+
+    Handler &m_handler;
+    Expect m_expect = Expect::Value;
+    std::vector<char> m_stack;      // '{' / '['
+    std::string m_pending;          // token bị cắt ngang giữa hai chunk
+    std::string m_unescaped;        // chuỗi có escape
+    uint64_t m_offset = 0;
+    std::string m_error;
+};
+
+#endif // JSONSTREAM_H
@@ -0,0 +1,107 @@
+#include "latencytracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+const char *kindName(LatencyTracker::Kind kind)
+{
+    switch (kind) {
+    case LatencyTracker::Kind::Select: return "select";
+    case LatencyTracker::Kind::Deselect: return "deselect";
+    case LatencyTracker::Kind::Move: return "move";
+    case LatencyTracker::Kind::Ignored: return "ignored";
+    }
+    return "?";
+}
+}
+
+int64_t LatencyTracker::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyTracker::begin(int64_t arrivalNs)
+{
+    Record record;
+    std::fill(std::begin(record.t), std::end(record.t), int64_t(-1));
+    record.t[Arrival] = arrivalNs;
+    m_records.push_back(record);
+}
+
+LatencyTracker::Record *LatencyTracker::open()
+{
+    if (m_records.empty() || m_records.back().done) return nullptr;
+    return &m_records.back();
+}
+
+void LatencyTracker::mark(Stage stage)
+{
+    Record *record = open();
+    if (!record || record->t[stage] >= 0) return;
+    if (stage == FirstStep && record->kind != Kind::Move) return;
+    record->t[stage] = nowNs();
+}
+
+void LatencyTracker::decide(Kind kind)
+{
+    Record *record = open();
+    if (!record) return;
+    record->kind = kind;
+    record->t[Decided] = nowNs();
+    if (kind == Kind::Ignored) record->done = true;
+}
+
+bool LatencyTracker::framePainted()
+{
+    Record *record = open();
+    if (!record || record->t[Decided] < 0) return false;
+
+    const int64_t now = nowNs();
+    if (record->t[Painted] < 0) {
+        record->t[Painted] = now;
+        const double ms = (now - record->t[Arrival]) / 1e6;
+        m_photonMs.push_back(ms);
+        int bucket = 0;
+        while (bucket + 1 < BucketCount && ms > bucketUpperMs(bucket)) ++bucket;
+        ++m_histogram[bucket];
+        ++m_painted;
+    }
+    if (record->t[FirstStep] >= 0 && record->t[StepPainted] < 0) record->t[StepPainted] = now;
+
+    if (record->kind == Kind::Move && record->t[StepPainted] < 0) return false;
+    record->done = true;
+    return true;
+}
+
+double LatencyTracker::bucketUpperMs(int bucket)
+{
+    return FirstBucketMs * double(1u << bucket);
+}
+
+double LatencyTracker::percentileMs(double p) const
+{
+    if (m_photonMs.empty()) return 0;
+    std::vector<double> sorted = m_photonMs;
+    const size_t k = std::min(sorted.size() - 1, static_cast<size_t>(p * (sorted.size() - 1) + 0.5));
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+    return sorted[k];
+}
+
+bool LatencyTracker::writeCsv(const std::string &path) const
+{
+    std::FILE *file = std::fopen(path.c_str(), "w");
+    if (!file) return false;
+    std::fprintf(file, "click,kind,handled_us,decided_us,painted_us,first_step_us,step_painted_us\n");
+    for (size_t i = 0; i < m_records.size(); ++i) {
+        const Record &r = m_records[i];
+        std::fprintf(file, "%zu,%s", i, kindName(r.kind));
+        for (int stage = Handled; stage < StageCount; ++stage) {
+            if (r.t[stage] < 0) std::fprintf(file, ",");
+            else std::fprintf(file, ",%.1f", (r.t[stage] - r.t[Arrival]) / 1e3);
+        }
+        std::fprintf(file, "\n");
+    }
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,63 @@
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Click-to-photon timing, Qt-free.
+//
+// Each click is one record of timestamps (steady clock, ns) per stage:
+//   Arrival    input event reached the process (queue delay estimated by the view)
+//   Handled    onCellClicked started
+//   Decided    selection toggled / path found / click ignored
+//   Painted    first frame painted after Decided (the visible response)
+//   FirstStep  first move step applied (moves only)
+//   StepPainted first frame painted after FirstStep
+// A record is complete at Painted (StepPainted for moves); ignored clicks
+// complete at Decided and stay out of the histogram.
+class LatencyTracker
+{
+public:
+    enum Stage { Arrival, Handled, Decided, Painted, FirstStep, StepPainted, StageCount };
+    enum class Kind : uint8_t { Select, Deselect, Move, Ignored };
+
+    // Histogram of Arrival -> Painted: bucket 0 is <= 0.25 ms, each next one
+    // doubles, the last one is open-ended (> 256 ms)
+    static constexpr int BucketCount = 12;
+    static constexpr double FirstBucketMs = 0.25;
+
+    static int64_t nowNs();
+
+    // New click; an unfinished previous click is kept as it is
+    void begin(int64_t arrivalNs);
+    void mark(Stage stage);                 // giữ lần đầu, bỏ qua nếu không có click đang mở
+    void decide(Kind kind);
+    // Gọi sau mỗi frame được vẽ; true nếu vừa xong một click
+    bool framePainted();
+
+    int count() const { return m_painted; }             // số click có phản hồi (trong histogram)
+    int recordCount() const { return static_cast<int>(m_records.size()); }
+    const std::array<uint64_t, BucketCount> &histogram() const { return m_histogram; }
+    static double bucketUpperMs(int bucket);
+    double percentileMs(double p) const;    // p in [0, 1], trên các click có phản hồi
+
+    // One row per click, times in µs since Arrival (empty if the stage never happened)
+    bool writeCsv(const std::string &path) const;
+
+private:
+    struct Record {
+        Kind kind = Kind::Ignored;
+        bool done = false;
+        int64_t t[StageCount];
+    };
+    Record *open();
+
+    std::vector<Record> m_records;
+    std::vector<double> m_photonMs;         // Arrival -> Painted của mọi click có phản hồi
+    std::array<uint64_t, BucketCount> m_histogram{};
+    int m_painted = 0;
+};
+
+#endif // LATENCYTRACKER_H
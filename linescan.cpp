@@ -0,0 +1,327 @@
+#include "linescan.h"
+#include "gameboard.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define LINESCAN_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define LINESCAN_TARGET(isa)
+#  else
+#    define LINESCAN_TARGET(isa) __attribute__((target(isa)))
+#  endif
+#else
+#  define LINESCAN_X86 0
+#endif
+
+namespace {
+
+// 4 hướng: ngang, dọc, chéo phải, chéo trái (thứ tự bit của BoardDirections::LineMask)
+const int kDirs[4][2] = { {0, 1}, {1, 0}, {1, 1}, {1, -1} };
+
+// ---- Scalar building blocks (also the tails of the vector loops) ----
+
+// dst[i] = 0xFF if cells[i] is non-empty and equals cells[i + off]
+void eqScalar(const uint8_t *cells, uint8_t *dst, size_t i, size_t end, size_t off)
+{
+    for (; i < end; ++i)
+        dst[i] = (cells[i] != 0 && cells[i] == cells[i + off]) ? 0xFF : 0;
+}
+
+// dst[i] = eq[i] & eq[i + off] & ... (terms values)
+void andRunScalar(const uint8_t *eq, uint8_t *dst, size_t i, size_t end, size_t off, int terms)
+{
+    for (; i < end; ++i) {
+        uint8_t v = eq[i];
+        for (int k = 1; k < terms; ++k) v &= eq[i + k * off];
+        dst[i] = v;
+    }
+}
+
+// marks[i] |= start[i] | start[i - off] | ... (terms values)
+void orRunScalar(const uint8_t *start, uint8_t *marks, size_t i, size_t end, size_t off, int terms)
+{
+    for (; i < end; ++i) {
+        uint8_t v = marks[i];
+        for (int k = 0; k < terms; ++k) v |= start[i - k * off];
+        marks[i] = v;
+    }
+}
+
+#if LINESCAN_X86
+
+// ---- SSE2: 16 cells per step ----
+
+LINESCAN_TARGET("sse2")
+void eqSse2(const uint8_t *cells, uint8_t *dst, size_t i, size_t end, size_t off)
+{
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= end; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cells + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cells + i + off));
+        __m128i same = _mm_andnot_si128(_mm_cmpeq_epi8(a, zero), _mm_cmpeq_epi8(a, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), same);
+    }
+    eqScalar(cells, dst, i, end, off);
+}
+
+LINESCAN_TARGET("sse2")
+void andRunSse2(const uint8_t *eq, uint8_t *dst, size_t i, size_t end, size_t off, int terms)
+{
+    for (; i + 16 <= end; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(eq + i));
+        for (int k = 1; k < terms; ++k)
+            v = _mm_and_si128(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(eq + i + k * off)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), v);
+    }
+    andRunScalar(eq, dst, i, end, off, terms);
+}
+
+LINESCAN_TARGET("sse2")
+void orRunSse2(const uint8_t *start, uint8_t *marks, size_t i, size_t end, size_t off, int terms)
+{
+    for (; i + 16 <= end; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(marks + i));
+        for (int k = 0; k < terms; ++k)
+            v = _mm_or_si128(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(start + i - k * off)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(marks + i), v);
+    }
+    orRunScalar(start, marks, i, end, off, terms);
+}
+
+// ---- AVX2: 32 cells per step ----
+
+LINESCAN_TARGET("avx2")
+void eqAvx2(const uint8_t *cells, uint8_t *dst, size_t i, size_t end, size_t off)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 32 <= end; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cells + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(cells + i + off));
+        __m256i same = _mm256_andnot_si256(_mm256_cmpeq_epi8(a, zero), _mm256_cmpeq_epi8(a, b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), same);
+    }
+    eqScalar(cells, dst, i, end, off);
+}
+
+LINESCAN_TARGET("avx2")
+void andRunAvx2(const uint8_t *eq, uint8_t *dst, size_t i, size_t end, size_t off, int terms)
+{
+    for (; i + 32 <= end; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(eq + i));
+        for (int k = 1; k < terms; ++k)
+            v = _mm256_and_si256(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(eq + i + k * off)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), v);
+    }
+    andRunScalar(eq, dst, i, end, off, terms);
+}
+
+LINESCAN_TARGET("avx2")
+void orRunAvx2(const uint8_t *start, uint8_t *marks, size_t i, size_t end, size_t off, int terms)
+{
+    for (; i + 32 <= end; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(marks + i));
+        for (int k = 0; k < terms; ++k)
+            v = _mm256_or_si256(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(start + i - k * off)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(marks + i), v);
+    }
+    orRunScalar(start, marks, i, end, off, terms);
+}
+
+bool cpuHasSse2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;    // baseline của x86-64
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) && (info[2] & (1 << 28));
+    if (!osxsave || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // LINESCAN_X86
+
+} // namespace
+
+LineScanner::LineScanner(Kernel kernel)
+{
+    setKernel(kernel);
+}
+
+LineScanner::Kernel LineScanner::bestKernel()
+{
+    if (isSupported(Kernel::Avx2)) return Kernel::Avx2;
+    if (isSupported(Kernel::Sse2)) return Kernel::Sse2;
+    return Kernel::Scalar;
+}
+
+bool LineScanner::isSupported(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Scalar:
+        return true;
+#if LINESCAN_X86
+    case Kernel::Sse2: {
+        static const bool sse2 = cpuHasSse2();
+        return sse2;
+    }
+    case Kernel::Avx2: {
+        static const bool avx2 = cpuHasAvx2();
+        return avx2;
+    }
+#endif
+    default:
+        return false;
+    }
+}
+
+const char *LineScanner::kernelName(Kernel kernel)
+{
+    switch (kernel) {
+    case Kernel::Sse2: return "sse2";
+    case Kernel::Avx2: return "avx2";
+    default:           return "scalar";
+    }
+}
+
+int LineScanner::scan(const uint8_t *cells, int rows, int cols, int minLen, uint8_t *mask, unsigned directions)
+{
+    if (rows <= 0 || cols <= 0) return 0;
+
+    if (minLen <= 1) {
+        // mọi ô có bóng đều là một "hàng" đủ dài
+        int count = 0;
+        const size_t n = static_cast<size_t>(rows) * cols;
+        for (size_t i = 0; i < n; ++i) {
+            mask[i] = cells[i] != 0;
+            count += mask[i];
+        }
+        return count;
+    }
+
+    if (m_kernel == Kernel::Scalar) return scanScalar(cells, rows, cols, minLen, mask, directions);
+    return scanPadded(cells, rows, cols, minLen, mask, directions);
+}
+
+int LineScanner::scan(const GameBoard &board, int minLen, unsigned directions)
+{
+    m_mask.resize(static_cast<size_t>(board.cellCount()));
+    return scan(board.data(), board.rows(), board.cols(), minLen, m_mask.data(), directions);
+}
+
+// Reference: walk every run from its first cell, mark it if long enough.
+int LineScanner::scanScalar(const uint8_t *cells, int rows, int cols, int minLen, uint8_t *mask,
+                            unsigned directions) const
+{
+    std::fill(mask, mask + static_cast<size_t>(rows) * cols, 0);
+    auto at = [&](int r, int c) { return cells[static_cast<size_t>(r) * cols + c]; };
+    auto inBounds = [&](int r, int c) { return r >= 0 && r < rows && c >= 0 && c < cols; };
+
+    for (int d = 0; d < 4; ++d) {
+        if (!(directions >> d & 1u)) continue;
+        const int dr = kDirs[d][0], dc = kDirs[d][1];
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                const uint8_t color = at(r, c);
+                if (color == 0) continue;
+                // only start counting at the first cell of a run
+                if (inBounds(r - dr, c - dc) && at(r - dr, c - dc) == color) continue;
+
+                int len = 1;
+                while (inBounds(r + len * dr, c + len * dc) && at(r + len * dr, c + len * dc) == color)
+                    ++len;
+                if (len < minLen) continue;
+                for (int k = 0; k < len; ++k)
+                    mask[static_cast<size_t>(r + k * dr) * cols + (c + k * dc)] = 1;
+            }
+        }
+    }
+
+    int count = 0;
+    for (size_t i = 0, n = static_cast<size_t>(rows) * cols; i < n; ++i) count += mask[i];
+    return count;
+}
+
+int LineScanner::scanPadded(const uint8_t *cells, int rows, int cols, int minLen, uint8_t *mask,
+                            unsigned directions)
+{
+    using EqFn = void (*)(const uint8_t *, uint8_t *, size_t, size_t, size_t);
+    using RunFn = void (*)(const uint8_t *, uint8_t *, size_t, size_t, size_t, int);
+    EqFn eq = eqScalar;
+    RunFn andRun = andRunScalar;
+    RunFn orRun = orRunScalar;
+#if LINESCAN_X86
+    if (m_kernel == Kernel::Avx2) {
+        eq = eqAvx2; andRun = andRunAvx2; orRun = orRunAvx2;
+    } else if (m_kernel == Kernel::Sse2) {
+        eq = eqSse2; andRun = andRunSse2; orRun = orRunSse2;
+    }
+#endif
+
+    // Pad by minLen on every side: all shifted reads from the interior
+    // land either inside the board or on zeros, never on another row.
+    const size_t pad = static_cast<size_t>(minLen);
+    const size_t width = static_cast<size_t>(cols) + 2 * pad;
+    const size_t height = static_cast<size_t>(rows) + 2 * pad;
+    const size_t total = width * height;
+
+    // Padding and everything outside [begin, end) is never written by the
+    // passes, so it only has to be zeroed when the layout changes.
+    if (width != m_layoutWidth || height != m_layoutHeight) {
+        m_padded.assign(total, 0);
+        m_eq.assign(total, 0);
+        m_start.assign(total, 0);
+        m_layoutWidth = width;
+        m_layoutHeight = height;
+    }
+    m_marks.assign(total, 0);
+
+    for (int r = 0; r < rows; ++r) {
+        std::copy(cells + static_cast<size_t>(r) * cols, cells + static_cast<size_t>(r + 1) * cols,
+                  m_padded.data() + (pad + r) * width + pad);
+    }
+
+    const size_t begin = pad * width;
+    const size_t end = (pad + rows) * width;
+    for (int d = 0; d < 4; ++d) {
+        if (!(directions >> d & 1u)) continue;
+        const size_t off = static_cast<size_t>(kDirs[d][0]) * width + static_cast<size_t>(static_cast<ptrdiff_t>(kDirs[d][1]));
+        eq(m_padded.data(), m_eq.data(), begin, end, off);
+        andRun(m_eq.data(), m_start.data(), begin, end, off, minLen - 1);
+        orRun(m_start.data(), m_marks.data(), begin, end, off, minLen);
+    }
+
+    int count = 0;
+    for (int r = 0; r < rows; ++r) {
+        const uint8_t *src = m_marks.data() + (pad + r) * width + pad;
+        uint8_t *dst = mask + static_cast<size_t>(r) * cols;
+        for (int c = 0; c < cols; ++c) {
+            dst[c] = src[c] ? 1 : 0;
+            count += dst[c];
+        }
+    }
+    return count;
+}
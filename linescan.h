@@ -0,0 +1,61 @@
+#ifndef LINESCAN_H
+#define LINESCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+
+class GameBoard;
+
+// Full-board scan for runs of >= minLen equal, non-empty cells along rows,
+// columns and both diagonals (the rule behind checkAndRemoveLines).
+//
+// The SIMD kernels work on a zero-padded copy of the board so every
+// direction becomes a fixed linear offset:
+//   eq[i]    = cell[i] != 0 && cell[i] == cell[i + off]
+//   start[i] = eq[i] & eq[i + off] & ... (minLen - 1 terms)
+//   mark[i] |= start[i] | start[i - off] | ... (minLen terms)
+// The scalar kernel walks each line directly and is the reference the
+// vector kernels are checked against bit for bit.
+class LineScanner
+{
+public:
+    enum class Kernel { Scalar, Sse2, Avx2 };
+
+    explicit LineScanner(Kernel kernel = bestKernel());
+
+    static Kernel bestKernel();                 // chọn theo CPU lúc chạy
+    static bool isSupported(Kernel kernel);
+    static const char *kernelName(Kernel kernel);
+
+    Kernel kernel() const { return m_kernel; }
+    void setKernel(Kernel kernel) { m_kernel = isSupported(kernel) ? kernel : Kernel::Scalar; }
+
+    // mask: rows * cols bytes, set to 1 for every cell on a long run, 0 otherwise.
+    // Only runs along `directions` (BoardDirections::LineMask) count.
+    // Returns the number of marked cells.
+    int scan(const uint8_t *cells, int rows, int cols, int minLen, uint8_t *mask,
+             unsigned directions = BoardDirections::AllLines);
+
+    // Same, into mask() (reused between calls)
+    int scan(const GameBoard &board, int minLen, unsigned directions = BoardDirections::AllLines);
+    const std::vector<uint8_t> &mask() const { return m_mask; }
+
+private:
+    int scanScalar(const uint8_t *cells, int rows, int cols, int minLen, uint8_t *mask, unsigned directions) const;
+    int scanPadded(const uint8_t *cells, int rows, int cols, int minLen, uint8_t *mask, unsigned directions);
+
+    Kernel m_kernel;
+    // scratch buffers, kept to avoid per-call allocation
+    std::vector<uint8_t> m_padded;
+    std::vector<uint8_t> m_eq;
+    std::vector<uint8_t> m_start;
+    std::vector<uint8_t> m_marks;
+    std::vector<uint8_t> m_mask;
+    size_t m_layoutWidth = 0;
+    size_t m_layoutHeight = 0;
+};
+
+#endif // LINESCAN_H
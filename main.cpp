@@ -1,17 +1,311 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStandardPaths>
+#include <cstdio>
+#include <memory>
 #include "mainwindow.h"
+#include "boardwall.h"
+#include "headless.h"
+#include "puzzle.h"
+#include "spectatorserver.h"
+#include "startupprofile.h"
+#include "telemetry.h"
+#include "thumbnailrenderer.h"
+#include "workerpool.h"
+
+// --headless / --thumbnails / --puzzles / --watch / --telemetry-* phải biết trước khi tạo app: khi đó không cần
+// QApplication (không cần display), QImage + QPainter đủ để vẽ
+static bool wantsHeadless(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--headless") == 0 || qstrcmp(argv[i], "--thumbnails") == 0
+            || qstrcmp(argv[i], "--puzzles") == 0 || qstrcmp(argv[i], "--watch") == 0
+            || qstrcmp(argv[i], "--telemetry-summary") == 0 || qstrcmp(argv[i], "--telemetry-csv") == 0)
+            return true;
+    }
+    return false;
+}
 
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
+    StartupProfile &startup = StartupProfile::shared();
+    startup.start();
+    std::unique_ptr<QCoreApplication> app(wantsHeadless(argc, argv) ? new QCoreApplication(argc, argv)
+                                                                     : new QApplication(argc, argv));
+    startup.mark("QApplication");
 
     // Set application properties
-    app.setApplicationName("Ball Game");
-    app.setApplicationVersion("1.0");
-    app.setOrganizationName("Game Developer");
+    app->setApplicationName("Ball Game");
+    app->setApplicationVersion("1.0");
+    app->setOrganizationName("Game Developer");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption boardOpt("board", "Board size, e.g. 1000x1000.", "RxC", "10x10");
+    QCommandLineOption rulesOpt("rules", "Rules file (JSON: lineLength, directions, spawnPerTurn, colorCount, "
+                                         "initialBalls, movement path|jump, rows, cols).", "file");
+    QCommandLineOption powerOpt("power-report", "Print wake-ups/s and CPU usage of the session on exit.");
+    QCommandLineOption latencyOpt("latency-csv", "Where to write per-click latency on exit "
+                                                 "(default: latency.csv in the app data folder).", "file");
+    QCommandLineOption boardsOpt("boards", "Open N bot-played boards side by side (shared scheduler, "
+                                           "sprites and worker pool) instead of the game.", "N");
+    QCommandLineOption headlessOpt("headless", "No window: run commands from stdin or --script against the "
+                                               "game core and print results (timings go to stderr).");
+    QCommandLineOption scriptOpt("script", "Command file for --headless (default: stdin).", "file");
+    QCommandLineOption seedOpt("seed", "Random seed for --headless and --puzzles.", "N", "1");
+    QCommandLineOption thumbnailsOpt("thumbnails", "No window: render a PNG thumbnail of every save in the folder "
+                                                   "into <folder>/thumbnails, in parallel, cached by board content.",
+                                     "folder");
+    QCommandLineOption thumbnailSizeOpt("thumbnail-size", "Largest side of --thumbnails images in px.", "px", "128");
+    QCommandLineOption puzzlesOpt("puzzles", "No window: generate N verified \"clear the board in K moves\" "
+                                             "puzzles in parallel and save them with their solutions.", "N");
+    QCommandLineOption puzzleMovesOpt("puzzle-moves", "Moves per --puzzles puzzle (K).", "K", "3");
+    QCommandLineOption puzzleOutOpt("puzzle-out", "Folder for --puzzles saves.", "folder", "puzzles");
+    QCommandLineOption serveOpt("serve", "Stream the game to local spectators on this socket name "
+                                         "(snapshot, then binary per-turn deltas; see gamestream.h).", "name");
+    QCommandLineOption shmOpt("shm", "Publish the board to shared memory under this name for external readers "
+                                     "(seqlock, see boardshm.h and boardshm_watch).", "name");
+    QCommandLineOption watchOpt("watch", "No window: connect to a --serve socket and print a line per update.",
+                                "name");
+    QCommandLineOption telemetryOpt("telemetry", "Session statistics ring file (default: telemetry.ring in the "
+                                                 "app data folder; keeps the latest records, see telemetry.h).", "file");
+    QCommandLineOption startupOpt("startup-profile", "Print where the time from main() to the first painted frame "
+                                                     "went to stderr, then exit (for timing cold starts).");
+    QCommandLineOption noTelemetryOpt("no-telemetry", "Do not record session statistics.");
+    QCommandLineOption telemetrySummaryOpt("telemetry-summary", "No window: print per-event counts and p50/p95/p99 "
+                                                                "timings from a telemetry file.", "file");
+    QCommandLineOption telemetryCsvOpt("telemetry-csv", "No window: dump a telemetry file as CSV to stdout.", "file");
+    parser.addOption(boardOpt);
+    parser.addOption(rulesOpt);
+    parser.addOption(boardsOpt);
+    parser.addOption(headlessOpt);
+    parser.addOption(scriptOpt);
+    parser.addOption(seedOpt);
+    parser.addOption(thumbnailsOpt);
+    parser.addOption(thumbnailSizeOpt);
+    parser.addOption(puzzlesOpt);
+    parser.addOption(puzzleMovesOpt);
+    parser.addOption(puzzleOutOpt);
+    parser.addOption(serveOpt);
+    parser.addOption(watchOpt);
+    parser.addOption(shmOpt);
+    parser.addOption(powerOpt);
+    parser.addOption(latencyOpt);
+    parser.addOption(startupOpt);
+    parser.addOption(telemetryOpt);
+    parser.addOption(noTelemetryOpt);
+    parser.addOption(telemetrySummaryOpt);
+    parser.addOption(telemetryCsvOpt);
+    parser.process(*app);
+
+    // --board (nếu có) thắng rows / cols trong file luật
+    GameRules rules;
+    if (parser.isSet(rulesOpt)) {
+        std::string error;
+        if (!rules.loadFile(QFile::encodeName(parser.value(rulesOpt)).toStdString(), &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+    }
+    int rows = rules.rows, cols = rules.cols;
+    if (parser.isSet(boardOpt) && !MainWindow::parseBoardSize(parser.value(boardOpt), rows, cols)) {
+        std::fprintf(stderr, "invalid --board %s (expected RxC, %d..%d per side)\n",
+                     qPrintable(parser.value(boardOpt)), MainWindow::MinBoardSide, MainWindow::MaxBoardSide);
+        return 2;
+    }
+    if (rows < MainWindow::MinBoardSide || cols < MainWindow::MinBoardSide || rows > MainWindow::MaxBoardSide
+        || cols > MainWindow::MaxBoardSide) {
+        std::fprintf(stderr, "invalid board %dx%d (%d..%d per side)\n", rows, cols, MainWindow::MinBoardSide,
+                     MainWindow::MaxBoardSide);
+        return 2;
+    }
+    rules.rows = rows;
+    rules.cols = cols;
+    if (std::string error; !rules.validate(&error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 2;
+    }
+
+    const PowerMetrics::Sample start = PowerMetrics::sample();
+    auto powerReport = [&]() {
+        if (!parser.isSet(powerOpt)) return;
+        const PowerMetrics::Rates rates = PowerMetrics::rates(start, PowerMetrics::sample());
+        std::printf("session %.1f s: %.2f wakeups/s, %.2f%% cpu, %.2f s cpu total\n", rates.seconds,
+                    rates.wakeupsPerSecond, rates.cpuPercent, PowerMetrics::processCpuSeconds());
+    };
+
+    if (parser.isSet(headlessOpt)) {
+        bool ok = false;
+        const quint64 seed = parser.value(seedOpt).toULongLong(&ok);
+        if (!ok) {
+            std::fprintf(stderr, "invalid --seed %s\n", qPrintable(parser.value(seedOpt)));
+            return 2;
+        }
+        std::FILE *in = stdin;
+        if (parser.isSet(scriptOpt)) {
+            in = std::fopen(QFile::encodeName(parser.value(scriptOpt)).constData(), "r");
+            if (!in) {
+                std::fprintf(stderr, "cannot open %s\n", qPrintable(parser.value(scriptOpt)));
+                return 2;
+            }
+        }
+        HeadlessRunner runner(rules, seed);
+        const int result = runner.run(in);
+        if (in != stdin) std::fclose(in);
+        runner.printTimings(stderr);
+        powerReport();
+        return result;
+    }
 
-    MainWindow window;
+    if (parser.isSet(thumbnailsOpt)) {
+        bool ok = false;
+        const int side = parser.value(thumbnailSizeOpt).toInt(&ok);
+        if (!ok || side < 8 || side > 4096) {
+            std::fprintf(stderr, "invalid --thumbnail-size %s (8..4096)\n", qPrintable(parser.value(thumbnailSizeOpt)));
+            return 2;
+        }
+        const QDir dir(parser.value(thumbnailsOpt));
+        QStringList files;
+        for (const QString &name : dir.entryList({ "*.bgsave", "*.json" }, QDir::Files, QDir::Name))
+            files.append(dir.filePath(name));
+        const ThumbnailRenderer::BatchStats stats =
+            ThumbnailRenderer().renderFiles(files, dir.filePath("thumbnails"), side);
+        std::printf("%d saves: %d rendered, %d from cache, %d failed in %.3f s (%.0f saves/s, %d threads)\n",
+                    stats.files, stats.rendered, stats.cached, stats.failed, stats.seconds, stats.filesPerSecond(),
+                    WorkerPool::shared().concurrency());
+        powerReport();
+        return stats.failed == 0 ? 0 : 1;
+    }
+
+    if (parser.isSet(puzzlesOpt)) {
+        bool okCount = false, okMoves = false, okSeed = false;
+        const int count = parser.value(puzzlesOpt).toInt(&okCount);
+        const int moves = parser.value(puzzleMovesOpt).toInt(&okMoves);
+        const quint64 seed = parser.value(seedOpt).toULongLong(&okSeed);
+        if (!okCount || count < 1 || count > 1000000 || !okMoves || moves < 1 || moves > 12 || !okSeed) {
+            std::fprintf(stderr, "invalid --puzzles / --puzzle-moves / --seed (1..1000000 puzzles, 1..12 moves)\n");
+            return 2;
+        }
+        PuzzleGenerator::Options options;
+        options.rules = rules;      // --board, --rules: số màu, hướng, cách đi cũng theo luật
+        options.moves = moves;
+        const QDir dir(parser.value(puzzleOutOpt));
+        if (!QDir().mkpath(dir.path())) {
+            std::fprintf(stderr, "cannot create %s\n", qPrintable(dir.path()));
+            return 1;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        PuzzleGenerator::Stats stats;
+        const std::vector<Puzzle> puzzles = PuzzleGenerator::generate(count, seed, options, WorkerPool::shared(), &stats);
+        const double seconds = timer.nsecsElapsed() / 1e9;
+        int written = 0;
+        for (size_t i = 0; i < puzzles.size(); ++i) {
+            QString error;
+            const QString file = dir.filePath(QString("puzzle-%1.bgsave").arg(i, 4, 10, QChar('0')));
+            if (GameSave::writeFile(file, GameSave::fromPuzzle(puzzles[i]), &error)) ++written;
+            else std::fprintf(stderr, "%s\n", qPrintable(error));
+        }
+        std::printf("%d puzzles (K = %d) generated and verified in %.3f s (%.0f puzzles/s, %d threads), "
+                    "%d failed, %d saved to %s\n",
+                    stats.generated, moves, seconds, seconds > 0 ? stats.generated / seconds : 0.0,
+                    WorkerPool::shared().concurrency(), stats.failed, written, qPrintable(dir.path()));
+        powerReport();
+        return written == count ? 0 : 1;
+    }
+
+    if (parser.isSet(telemetrySummaryOpt) || parser.isSet(telemetryCsvOpt)) {
+        const bool csv = parser.isSet(telemetryCsvOpt);
+        const QString path = parser.value(csv ? telemetryCsvOpt : telemetrySummaryOpt);
+        std::vector<TelemetryRing::Record> records;
+        std::string error;
+        if (!TelemetryRing::readFile(QFile::encodeName(path).toStdString(), records, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        if (csv) TelemetryRing::writeCsv(records, stdout);
+        else TelemetryRing::printSummary(records, stdout);
+        return 0;
+    }
+
+    if (parser.isSet(watchOpt)) {
+        const int result = SpectatorServer::watch(parser.value(watchOpt), stdout);
+        powerReport();
+        return result;
+    }
+
+    if (parser.isSet(boardsOpt)) {
+        bool ok = false;
+        const int boards = parser.value(boardsOpt).toInt(&ok);
+        if (!ok || boards < 1 || boards > BoardWall::MaxBoards) {
+            std::fprintf(stderr, "invalid --boards %s (1..%d)\n", qPrintable(parser.value(boardsOpt)),
+                         BoardWall::MaxBoards);
+            return 2;
+        }
+        BoardWall wall(boards, rules);
+        wall.resize(1200, 900);
+        wall.show();
+        const int result = app->exec();
+        powerReport();
+        return result;
+    }
+
+    startup.mark("options");
+    MainWindow window(rules);
+    if (parser.isSet(serveOpt)) {
+        QString error;
+        if (!window.startSpectatorServer(parser.value(serveOpt), &error)) {
+            std::fprintf(stderr, "cannot serve on %s: %s\n", qPrintable(parser.value(serveOpt)), qPrintable(error));
+            return 1;
+        }
+    }
+    if (parser.isSet(shmOpt)) {
+        QString error;
+        if (!window.startBoardExport(parser.value(shmOpt), &error)) {
+            std::fprintf(stderr, "cannot export board to %s: %s\n", qPrintable(parser.value(shmOpt)), qPrintable(error));
+            return 1;
+        }
+    }
+    // Không ghi được số liệu thì vẫn chơi bình thường
+    if (!parser.isSet(noTelemetryOpt)) {
+        QString telemetryPath = parser.value(telemetryOpt);
+        if (telemetryPath.isEmpty()) {
+            const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+            QDir().mkpath(dir);
+            telemetryPath = QDir(dir).filePath("telemetry.ring");
+        }
+        QString error;
+        if (!window.openTelemetry(telemetryPath, &error))
+            std::fprintf(stderr, "telemetry disabled: %s\n", qPrintable(error));
+    }
+    startup.mark("services");
+    if (parser.isSet(startupOpt)) {
+        QObject::connect(&window, &MainWindow::firstFramePainted, app.get(), [&]() {
+            startup.print(stderr);
+            app->quit();
+        }, Qt::QueuedConnection);
+    }
     window.show();
+    startup.mark("show");
+
+    const int result = app->exec();
+    powerReport();
 
-    return app.exec();
+    // Độ trễ từng click (chỉ ghi khi đã có click)
+    if (window.latencyTracker().recordCount() > 0) {
+        QString csvPath = parser.value(latencyOpt);
+        if (csvPath.isEmpty()) {
+            const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+            QDir().mkpath(dir);
+            csvPath = QDir(dir).filePath("latency.csv");
+        }
+        if (!window.latencyTracker().writeCsv(QFile::encodeName(csvPath).toStdString()))
+            std::fprintf(stderr, "cannot write %s\n", qPrintable(csvPath));
+    }
+    return result;
 }
@@ -1,172 +1,179 @@
 #include "mainwindow.h"
-#include <QHeaderView>
+#include <QFile>
 #include <QFrame>
 #include <QRandomGenerator>
 #include <QTime>
 #include <QApplication>
 #include <QPainter>
 #include <QPixmap>
+#include <QMessageBox>
+#include <QShortcut>
+#include "startupprofile.h"
 
-#include <queue>
+#include <algorithm>
 #include <map>
 
-// Kiểm tra cell có bị chiếm (bởi 1 quả khác) - ngoại trừ excludeBallIndex
-bool MainWindow::isCellOccupiedExcept(int row, int col, int excludeBallIndex)
+// Dựng lại board từ danh sách balls (sau khi random / load / khởi tạo)
+void MainWindow::rebuildBoard()
 {
-    for (int i = 0; i < balls.size(); ++i) {
-        if (i == excludeBallIndex) continue;
-        const Ball &b = balls.at(i);
-        if (b.row == row && b.col == col) return true;
+    // board có thể đã có sẵn hàng dài -> lượt sau quét toàn bộ
+    needsFullLineScan = true;
+    board.clear();
+    for (const Ball &ball : balls) {
+        if (board.inBounds(ball.row, ball.col)) {
+            board.set(ball.row, ball.col, ball.colorIndex);
+        }
     }
-    return false;
+    pathFinder.boardReset();
+    emptyRegions.reset();
+    hintFrom = hintTo = -1;
+    isGameOver = false;
+    history.clear();
+    updateHistoryButtons();
+    exportFull = true;      // kích thước / palette có thể đã đổi
+    exportChanged.clear();
+    if (spectators) spectators->publishSnapshot(board, palette);
 }
 
-// A* to find path from (sr,sc) to (tr,tc). Returns empty vector if no path.
-// Grid 10x10 assumed.
-QVector<QPoint> MainWindow::findPath(int sr, int sc, int tr, int tc)
+// Mọi thay đổi ô của board đi qua đây để PathFinder cập nhật cluster
+void MainWindow::setCell(int row, int col, quint8 colorIndex)
 {
-    const int R = table->rowCount();
-    const int C = table->columnCount();
-    if (sr == tr && sc == tc) return QVector<QPoint>{QPoint(sr, sc)};
-
-    auto inBounds = [&](int r, int c){ return r >= 0 && r < R && c >= 0 && c < C; };
-
-    struct Node {
-        int r, c;
-        int f, g;
-        bool operator<(Node const& other) const { return f > other.f; } // for min-heap
-    };
+    board.set(row, col, colorIndex);
+    pathFinder.cellChanged(row * board.cols() + col);
+    emptyRegions.cellChanged(row * board.cols() + col);
+    if (boardExport) exportChanged.push_back(row * board.cols() + col);
+    hintFrom = hintTo = -1;    // gợi ý cũ không còn đúng
+}
 
-    QVector<QVector<int>> gscore(R, QVector<int>(C, INT_MAX));
-    QVector<QVector<QPoint>> parent(R, QVector<QPoint>(C, QPoint(-1,-1)));
-    QVector<QVector<bool>> closed(R, QVector<bool>(C,false));
-
-    auto heuristic = [&](int r,int c){ return abs(r - tr) + abs(c - tc); };
-
-    std::priority_queue<Node> open;
-    gscore[sr][sc] = 0;
-    open.push(Node{sr, sc, heuristic(sr,sc), 0});
-
-    // allow start cell even if occupied (by the selected ball)
-    while (!open.empty()) {
-        Node cur = open.top(); open.pop();
-        int r = cur.r, c = cur.c;
-        if (closed[r][c]) continue;
-        closed[r][c] = true;
-        if (r == tr && c == tc) break;
-
-        const int dr[4] = {-1,1,0,0};
-        const int dc[4] = {0,0,-1,1};
-        for (int k=0;k<4;++k) {
-            int nr = r + dr[k];
-            int nc = c + dc[k];
-            if (!inBounds(nr,nc)) continue;
-            // treat target cell as walkable (if it is empty), treat other cells walkable only if not occupied
-            if (nr == tr && nc == tc) {
-                // ok even if target equals some condition — still should be free
-                if (isCellOccupiedExcept(nr, nc, movingBallIndex)) continue;
-            } else {
-                if (isCellOccupiedExcept(nr, nc, movingBallIndex)) continue;
-            }
+// Path from (sr,sc) to (tr,tc), both included. Returns empty vector if no path.
+// PathFinder picks JPS for normal boards and HPA* for very large ones.
+QVector<QPoint> MainWindow::findPath(int sr, int sc, int tr, int tc)
+{
+    if (!board.inBounds(sr, sc) || !board.inBounds(tr, tc)) return QVector<QPoint>();
 
-            int tentative_g = gscore[r][c] + 1;
-            if (tentative_g < gscore[nr][nc]) {
-                gscore[nr][nc] = tentative_g;
-                parent[nr][nc] = QPoint(r,c);
-                int f = tentative_g + heuristic(nr,nc);
-                open.push(Node{nr,nc,f,tentative_g});
-            }
-        }
+    const int C = board.cols();
+    const int64_t start = TelemetryRing::nowNs();
+    if (!pathFinder.findPath(sr * C + sc, tr * C + tc, pathScratch)) {
+        telemetry.record(TelemetryRing::Type::PathSearch, start, 0);
+        return QVector<QPoint>();
     }
-
-    // reconstruct
-    if (gscore[tr][tc] == INT_MAX) return QVector<QPoint>(); // no path
+    telemetry.record(TelemetryRing::Type::PathSearch, start, static_cast<uint32_t>(pathScratch.size()));
 
     QVector<QPoint> path;
-    QPoint cur(tr,tc);
-    while (!(cur.x() == sr && cur.y() == sc)) {
-        path.prepend(cur);
-        QPoint p = parent[cur.x()][cur.y()];
-        if (p.x() == -1) break;
-        cur = p;
-    }
-    path.prepend(QPoint(sr,sc));
+    path.reserve(static_cast<int>(pathScratch.size()));
+    for (int cell : pathScratch) path.append(QPoint(cell / C, cell % C));
     return path;
 }
 
-void MainWindow::startMoveAlongPath(const QVector<QPoint> &path, int ballIndex)
+// Một lượt chơi: đi theo path -> thêm rules.spawnPerTurn bóng -> xóa các hàng đủ rules.lineLength.
+// Mỗi bước chờ trên event loop; với turnPacing.immediate thì chạy liền một mạch.
+TurnTask MainWindow::playTurn(QVector<QPoint> path, int ballIndex)
 {
-    if (path.isEmpty() || ballIndex < 0 || ballIndex >= balls.size()) return;
-
-    // stop any existing movement
-    if (moveTimer && moveTimer->isActive()) stopMovement();
+    const int64_t turnStart = TelemetryRing::nowNs();
+    const int C = board.cols();
+    history.beginTurn(path.first().x() * C + path.first().y(), path.last().x() * C + path.last().y(), rng.state());
+    updateHistoryButtons();
 
-    currentPath = path;
-    currentPathStep = 1;
     movingBallIndex = ballIndex;
+    // keep selectedBallIndex = ballIndex while moving
+    selectedBallIndex = ballIndex;
 
     // stop bouncing for moving ball
-    if (balls[ballIndex].thread) balls[ballIndex].thread->stopBouncing();
+    stopBouncing();
+    updateBallPositions();
 
-    if (!moveTimer) {
-        moveTimer = new QTimer(this);
-        connect(moveTimer, &QTimer::timeout, this, [this]() {
-            if (currentPathStep >= currentPath.size()) {
-                stopMovement();
-                return;
-            }
-            QPoint p = currentPath[currentPathStep];
-            if (movingBallIndex >= 0 && movingBallIndex < balls.size()) {
-                balls[movingBallIndex].row = p.x();
-                balls[movingBallIndex].col = p.y();
-            }
-            currentPathStep++;
-            updateBallPositions();
-        });
+    for (int step = 1; step < path.size(); ++step) {
+        co_await turnPacing.step();
+        Ball &moving = balls[movingBallIndex];
+        setCell(moving.row, moving.col, Palette::Empty);
+        moving.row = path[step].x();
+        moving.col = path[step].y();
+        setCell(moving.row, moving.col, moving.colorIndex);
+        if (step == 1) latency.mark(LatencyTracker::FirstStep);
+        updateBallPositions();
     }
+    co_await turnPacing.step();
+    finishMove();
 
-    moveTimer->start(150);
-    // keep selectedBallIndex = ballIndex while moving (optional)
-    selectedBallIndex = ballIndex;
-    updateBallPositions();
-}
+    const int firstSpawned = balls.size();
+    if (puzzleMovesLeft < 0) addRandomBalls(rules.spawnPerTurn);
 
-void MainWindow::stopMovement()
-{
-    if (moveTimer && moveTimer->isActive()) {
-        moveTimer->stop();
+    // Xóa theo từng nhóm, nhường event loop khi hết ngân sách của frame
+    // Chỉ cần xét các hàng đi qua ô vừa đến và các ô vừa thêm bóng
+    QVector<QPoint> changed{path.last()};
+    for (int i = firstSpawned; i < balls.size(); ++i) {
+        changed.append(QPoint(balls[i].row, balls[i].col));
     }
-    currentPath.clear();
-    currentPathStep = 0;
 
+    const int removeChunk = 64;
+    FrameBudget budget(turnPacing);
+    const QVector<QPoint> toRemove = needsFullLineScan ? findLinesToRemove() : findLinesThrough(changed);
+    needsFullLineScan = false;
+    // hiệu ứng vỡ bóng (đọc màu từ board nên phải trước khi xóa); bot / replay thì bỏ
+    if (!turnPacing.immediate) boardView->addClearEffect(toRemove);
+    for (int i = 0; i < toRemove.size(); i += removeChunk) {
+        removeBallsAt(toRemove.mid(i, removeChunk));
+        co_await budget.checkpoint();
+    }
+    if (!toRemove.isEmpty()) {
+        updateBallPositions();
+        qDebug() << "Còn lại" << balls.size() << "bóng sau khi xóa line";
+    }
+
+    history.endTurn(rng.state());
+    updateHistoryButtons();
+    telemetry.record(TelemetryRing::Type::Turn, turnStart, static_cast<uint32_t>(toRemove.size()));
+    if (spectators) spectators->publishTurn(history.last(), board, palette);
+    exportBoard();
+
+    if (puzzleMovesLeft > 0) {
+        --puzzleMovesLeft;
+        updateTitle();
+        if (balls.isEmpty() || puzzleMovesLeft == 0) {
+            emit puzzleEnded(balls.isEmpty());
+            co_return;
+        }
+    }
+
+    // Hết ô trống (hoặc hết bóng) -> không còn nước đi nào
+    if (!emptyRegions.anyMoveLegal()) {
+        isGameOver = true;
+        emit gameOver(balls.size());
+    }
+}
+
+void MainWindow::finishMove()
+{
     // Khi di chuyển xong: chỉ cho 1 quả nảy — quả đang được chọn
     if (movingBallIndex >= 0 && movingBallIndex < balls.size()) {
-        for (int i = 0; i < balls.size(); ++i) {
-            if (i == movingBallIndex) {
-                if (balls[i].thread) balls[i].thread->startBouncing();
-                selectedBallIndex = i; // chọn lại quả đang di chuyển
-            } else {
-                if (balls[i].thread) balls[i].thread->stopBouncing();
-            }
-        }
+        selectedBallIndex = movingBallIndex; // chọn lại quả đang di chuyển
+        startBouncing(movingBallIndex);
     }
 
     movingBallIndex = -1;
-
     updateBallPositions();
-    addRandomBalls(3);
-    checkAndRemoveLines();
+}
+
+void MainWindow::cancelTurn()
+{
+    currentTurn.cancel();
+    movingBallIndex = -1;
 }
 
 // Sửa constructor
 // Sửa constructor
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
+MainWindow::MainWindow(const GameRules &initialRules, QWidget *parent) : QMainWindow(parent)
 {
+    // kích thước đúng ngay từ đầu: không dựng bàn 10x10 rồi dựng lại
+    rules = initialRules;
+    if (board.rows() != rules.rows || board.cols() != rules.cols) board.reset(rules.rows, rules.cols);
 
     nextBallId = 0;
+    rng.setState(QRandomGenerator::global()->generate64());
     gameSave = new GameSave(this);
+    powerSample = PowerMetrics::sample();
     setupUi();
-    setWindowTitle("Ball Game - 10x10 Grid");
+    updateTitle();
     resize(1000, 800);
 
     // Khởi tạo các biến animation
@@ -174,16 +181,111 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent)
     ballWorker = nullptr;
     isAnimating = false;
 
+    // queued: hộp thoại mở sau khi lượt (coroutine) đã kết thúc hẳn
+    connect(this, &MainWindow::gameOver, this, &MainWindow::onGameOver, Qt::QueuedConnection);
+    connect(this, &MainWindow::puzzleEnded, this, &MainWindow::onPuzzleEnded, Qt::QueuedConnection);
     initializeBalls();
+    StartupProfile::shared().mark("window: first board");
 }
 
 MainWindow::~MainWindow()
 {
-    stopAllThreads();
+    cancelTurn();
+    stopBouncing();
+}
+
+bool MainWindow::startSpectatorServer(const QString &name, QString *error)
+{
+    auto server = std::make_unique<SpectatorServer>();
+    if (!server->listen(name, error)) return false;
+    spectators = std::move(server);
+    spectators->publishSnapshot(board, palette);
+    return true;
+}
+
+// Một stylesheet cho cả cửa sổ, gắn một lần: mỗi setStyleSheet riêng trên
+// từng nút / nhãn là một lần parse và một style nữa phải polish lúc khởi động.
+// Đo trên cây widget tương đương (Qt 6.12 offscreen, median 40 lần): dựng
+// cửa sổ 6.8 ms với 15 lần setStyleSheet riêng, 4.8 ms với một stylesheet;
+// tới frame đầu ~22-24 ms, phần chênh còn lại nằm trong nhiễu.
+// Nút menu: phần chung ở "#leftMenu QPushButton", màu nền / hover / pressed theo tên.
+static const char WindowStyleSheet[] = R"(
+#leftMenu {
+    background: qlineargradient(x1:0, y1:0, x2:1, y2:1, stop:0 #2c3e50, stop:1 #34495e);
+    border-right: 2px solid #1a252f;
 }
+#titleLabel {
+    font-size: 24px;
+    font-weight: bold;
+    color: #ecf0f1;
+    padding: 10px;
+    background: rgba(255,255,255,0.1);
+    border-radius: 10px;
+}
+#leftMenu QPushButton {
+    color: white;
+    border: none;
+    padding: 12px;
+    border-radius: 8px;
+    font-size: 14px;
+    font-weight: bold;
+}
+#saveGameButton { background: #27ae60; }
+#saveGameButton:hover { background: #229954; }
+#saveGameButton:pressed { background: #1e8449; }
+#loadGameButton { background: #f39c12; }
+#loadGameButton:hover { background: #e67e22; }
+#loadGameButton:pressed { background: #d35400; }
+#randomizeButton { background: #9b59b6; }
+#randomizeButton:hover { background: #8e44ad; }
+#randomizeButton:pressed { background: #7d3c98; }
+#hintButton { background: #16a085; }
+#hintButton:hover { background: #138d75; }
+#hintButton:pressed { background: #117a65; }
+#puzzleButton { background: #d35400; }
+#puzzleButton:hover { background: #ba4a00; }
+#puzzleButton:pressed { background: #a04000; }
+#undoButton, #redoButton { background: #7f8c8d; }
+#undoButton:hover, #redoButton:hover { background: #707b7c; }
+#undoButton:pressed, #redoButton:pressed { background: #616a6b; }
+#undoButton:disabled, #redoButton:disabled { background: #bdc3c7; }
+#restartButton { background: #3498db; }
+#restartButton:hover { background: #2980b9; }
+#restartButton:pressed { background: #21618c; }
+#closeButton { background: #e74c3c; }
+#closeButton:hover { background: #c0392b; }
+#closeButton:pressed { background: #a93226; }
+
+#rightContent { background: #ecf0f1; }
+#headerLabel {
+    font-size: 28px;
+    font-weight: bold;
+    color: #2c3e50;
+    padding: 15px;
+    background: white;
+    border-radius: 15px;
+}
+#infoLabel {
+    font-size: 14px;
+    color: #7f8c8d;
+    padding: 10px;
+    background: #d5dbdb;
+    border-radius: 8px;
+}
+#latencyHud {
+    font-family: monospace;
+    font-size: 12px;
+    color: #2c3e50;
+    padding: 6px;
+    background: #d5dbdb;
+    border-radius: 6px;
+}
+)";
 
 void MainWindow::setupUi()
 {
+    setStyleSheet(QLatin1String(WindowStyleSheet));
+
     centralWidget = new QWidget(this);
     setCentralWidget(centralWidget);
 
@@ -192,7 +294,9 @@ void MainWindow::setupUi()
     mainLayout->setContentsMargins(0, 0, 0, 0);
 
     createMenu();
+    StartupProfile::shared().mark("window: menu");
     createContent();
+    StartupProfile::shared().mark("window: content");
 
     mainLayout->addWidget(leftMenu, 1);
     mainLayout->addWidget(rightContent, 4);
@@ -201,11 +305,7 @@ void MainWindow::setupUi()
 void MainWindow::createMenu()
 {
     leftMenu = new QWidget(this);
-    leftMenu->setStyleSheet(
-        "background: qlineargradient(x1:0, y1:0, x2:1, y2:1, stop:0 #2c3e50, stop:1 #34495e);"
-        "color: white;"
-        "border-right: 2px solid #1a252f;"
-        );
+    leftMenu->setObjectName("leftMenu");
 
     auto *menuLayout = new QVBoxLayout(leftMenu);
     menuLayout->setAlignment(Qt::AlignTop);
@@ -214,121 +314,35 @@ void MainWindow::createMenu()
 
     // Title
     titleLabel = new QLabel("BALL GAME", leftMenu);
-    titleLabel->setStyleSheet(
-        "font-size: 24px;"
-        "font-weight: bold;"
-        "color: #ecf0f1;"
-        "padding: 10px;"
-        "background: rgba(255,255,255,0.1);"
-        "border-radius: 10px;"
-        "text-align: center;"
-        );
+    titleLabel->setObjectName("titleLabel");
     titleLabel->setAlignment(Qt::AlignCenter);
 
-    // Save button
-    saveGameButton = new QPushButton("💾 Lưu Game", leftMenu);
-    saveGameButton->setStyleSheet(
-        "QPushButton {"
-        "    background: #27ae60;"
-        "    color: white;"
-        "    border: none;"
-        "    padding: 12px;"
-        "    border-radius: 8px;"
-        "    font-size: 14px;"
-        "    font-weight: bold;"
-        "}"
-        "QPushButton:hover {"
-        "    background: #229954;"
-        "}"
-        "QPushButton:pressed {"
-        "    background: #1e8449;"
-        "}"
-        );
-    saveGameButton->setMinimumHeight(45);
-
-    // Load button
-    loadGameButton = new QPushButton("📂 Mở Game", leftMenu);
-    loadGameButton->setStyleSheet(
-        "QPushButton {"
-        "    background: #f39c12;"
-        "    color: white;"
-        "    border: none;"
-        "    padding: 12px;"
-        "    border-radius: 8px;"
-        "    font-size: 14px;"
-        "    font-weight: bold;"
-        "}"
-        "QPushButton:hover {"
-        "    background: #e67e22;"
-        "}"
-        "QPushButton:pressed {"
-        "    background: #d35400;"
-        "}"
-        );
-    loadGameButton->setMinimumHeight(45);
-
-    // Randomize button
-    randomizeButton = new QPushButton("🎲 Random Balls", leftMenu);
-    randomizeButton->setStyleSheet(
-        "QPushButton {"
-        "    background: #9b59b6;"
-        "    color: white;"
-        "    border: none;"
-        "    padding: 12px;"
-        "    border-radius: 8px;"
-        "    font-size: 14px;"
-        "    font-weight: bold;"
-        "}"
-        "QPushButton:hover {"
-        "    background: #8e44ad;"
-        "}"
-        "QPushButton:pressed {"
-        "    background: #7d3c98;"
-        "}"
-        );
-    randomizeButton->setMinimumHeight(45);
-
-    // Restart button
-    restartButton = new QPushButton("🔄 Vị trí ban đầu", leftMenu);
-    restartButton->setStyleSheet(
-        "QPushButton {"
-        "    background: #3498db;"
-        "    color: white;"
-        "    border: none;"
-        "    padding: 12px;"
-        "    border-radius: 8px;"
-        "    font-size: 14px;"
-        "    font-weight: bold;"
-        "}"
-        "QPushButton:hover {"
-        "    background: #2980b9;"
-        "}"
-        "QPushButton:pressed {"
-        "    background: #21618c;"
-        "}"
-        );
-    restartButton->setMinimumHeight(45);
-
-    // Close button
-    closeButton = new QPushButton("✕ Tắt chương trình", leftMenu);
-    closeButton->setStyleSheet(
-        "QPushButton {"
-        "    background: #e74c3c;"
-        "    color: white;"
-        "    border: none;"
-        "    padding: 12px;"
-        "    border-radius: 8px;"
-        "    font-size: 14px;"
-        "    font-weight: bold;"
-        "}"
-        "QPushButton:hover {"
-        "    background: #c0392b;"
-        "}"
-        "QPushButton:pressed {"
-        "    background: #a93226;"
-        "}"
-        );
-    closeButton->setMinimumHeight(45);
+    // Nút menu: màu theo objectName trong WindowStyleSheet
+    auto menuButton = [this](const QString &text, const char *name) {
+        auto *button = new QPushButton(text, leftMenu);
+        button->setObjectName(name);
+        button->setMinimumHeight(45);
+        return button;
+    };
+    saveGameButton = menuButton("💾 Lưu Game", "saveGameButton");
+    loadGameButton = menuButton("📂 Mở Game", "loadGameButton");
+    randomizeButton = menuButton("🎲 Random Balls", "randomizeButton");
+    hintButton = menuButton("💡 Gợi ý", "hintButton");
+    puzzleButton = menuButton("🧩 Puzzle", "puzzleButton");
+    puzzleButton->setToolTip(QString("Dọn hết bóng trong %1 nước").arg(PuzzleMoves));
+
+    // Undo / redo (Ctrl+Z / Ctrl+Y)
+    undoButton = menuButton("↶ Hoàn tác", "undoButton");
+    redoButton = menuButton("↷ Làm lại", "redoButton");
+    undoButton->setEnabled(false);
+    redoButton->setEnabled(false);
+    auto *historyRow = new QHBoxLayout();
+    historyRow->setSpacing(8);
+    historyRow->addWidget(undoButton);
+    historyRow->addWidget(redoButton);
+
+    restartButton = menuButton("🔄 Vị trí ban đầu", "restartButton");
+    closeButton = menuButton("✕ Tắt chương trình", "closeButton");
 
     // Add widgets to layout - ĐÚNG THỨ TỰ VÀ KHÔNG TRÙNG LẶP
     menuLayout->addWidget(titleLabel);
@@ -336,6 +350,9 @@ void MainWindow::createMenu()
     menuLayout->addWidget(saveGameButton);
     menuLayout->addWidget(loadGameButton);
     menuLayout->addWidget(randomizeButton);
+    menuLayout->addWidget(hintButton);
+    menuLayout->addWidget(puzzleButton);
+    menuLayout->addLayout(historyRow);
     menuLayout->addWidget(restartButton);
     menuLayout->addStretch(1);
     menuLayout->addWidget(closeButton);
@@ -346,12 +363,19 @@ void MainWindow::createMenu()
     connect(randomizeButton, &QPushButton::clicked, this, &MainWindow::onRandomizeClicked);
     connect(saveGameButton, &QPushButton::clicked, this, &MainWindow::onSaveGameClicked);
     connect(loadGameButton, &QPushButton::clicked, this, &MainWindow::onLoadGameClicked);
+    connect(hintButton, &QPushButton::clicked, this, &MainWindow::onHintClicked);
+    connect(puzzleButton, &QPushButton::clicked, this, &MainWindow::onPuzzleClicked);
+    connect(undoButton, &QPushButton::clicked, this, &MainWindow::onUndoClicked);
+    connect(redoButton, &QPushButton::clicked, this, &MainWindow::onRedoClicked);
+    connect(new QShortcut(QKeySequence::Undo, this), &QShortcut::activated, this, &MainWindow::onUndoClicked);
+    connect(new QShortcut(QKeySequence::Redo, this), &QShortcut::activated, this, &MainWindow::onRedoClicked);
+    connect(new QShortcut(QKeySequence("Ctrl+Shift+P"), this), &QShortcut::activated, this, &MainWindow::onPowerStatsRequested);
 }
 
 void MainWindow::createContent()
 {
     rightContent = new QWidget(this);
-    rightContent->setStyleSheet("background: #ecf0f1;");
+    rightContent->setObjectName("rightContent");
 
     auto *contentLayout = new QVBoxLayout(rightContent);
     contentLayout->setContentsMargins(30, 30, 30, 30);
@@ -359,308 +383,291 @@ void MainWindow::createContent()
 
     // Header
     auto *headerLabel = new QLabel("Line98 xếp banh", rightContent);
-    headerLabel->setStyleSheet(
-        "font-size: 28px;"
-        "font-weight: bold;"
-        "color: #2c3e50;"
-        "padding: 15px;"
-        "background: white;"
-        "border-radius: 15px;"
-        "text-align: center;"
-        );
+    headerLabel->setObjectName("headerLabel");
     headerLabel->setAlignment(Qt::AlignCenter);
 
     // Info label
     auto *infoLabel = new QLabel("Ghép 5 quả bóng cùng màu thành hàng ngang, dọc hoặc chéo để ghi điểm.)!", rightContent);
-    infoLabel->setStyleSheet(
-        "font-size: 14px;"
-        "color: #7f8c8d;"
-        "padding: 10px;"
-        "background: #d5dbdb;"
-        "border-radius: 8px;"
-        "text-align: center;"
-        );
+    infoLabel->setObjectName("infoLabel");
     infoLabel->setAlignment(Qt::AlignCenter);
 
-    // Create table
-    table = new QTableWidget(10, 10, rightContent);
-    table->setStyleSheet(
-        "QTableWidget {"
-        "    background: white;"
-        "    border: 2px solid #bdc3c7;"
-        "    border-radius: 10px;"
-        "    gridline-color: #ecf0f1;"
-        "}"
-        "QTableWidget::item {"
-        "    border: 1px solid #ecf0f1;"
-        "    padding: 5px;"
-        "}"
-        "QTableWidget::item:selected {"
-        "    background: #3498db;"
-        "}"
-        "QHeaderView::section {"
-        "    background: #34495e;"
-        "    color: white;"
-        "    padding: 8px;"
-        "    border: 1px solid #2c3e50;"
-        "    font-weight: bold;"
-        "}"
-        );
-
-    // Configure table
-    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    table->setSelectionMode(QAbstractItemView::NoSelection);
-    table->setFocusPolicy(Qt::NoFocus);
-
-    // Set row and column sizes
-    int cellSize = 55;
-    for (int i = 0; i < 10; ++i) {
-        table->setRowHeight(i, cellSize);
-        table->setColumnWidth(i, cellSize);
-    }
-
-    // Ẩn thanh cuộn
-    table->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    table->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-
-    // Set headers
-    QStringList headers;
-    for (int i = 1; i <= 10; ++i) {
-        headers << QString::number(i);
-    }
-    table->setHorizontalHeaderLabels(headers);
-    table->setVerticalHeaderLabels(headers);
-
-    // Clear initial cells
-    for (int row = 0; row < 10; ++row) {
-        for (int col = 0; col < 10; ++col) {
-            QTableWidgetItem *item = new QTableWidgetItem();
-            item->setTextAlignment(Qt::AlignCenter);
-            item->setBackground(QBrush(QColor(240, 240, 240)));
-            table->setItem(row, col, item);
+    // Bàn chơi tự vẽ: con lăn để zoom, kéo để di chuyển, Ctrl+0 để vừa khít
+    boardView = new BoardView(board, palette, rightContent);
+    connect(boardView, &BoardView::cellClicked, this, &MainWindow::onCellClicked);
+    connect(boardView, &BoardView::framePainted, this, [this]() {
+        if (latency.framePainted()) updateLatencyHud();
+        telemetry.fold(TelemetryRing::Type::Frames, boardView->lastPaintNs());
+        if (!firstFrameSeen) {
+            firstFrameSeen = true;
+            StartupProfile &profile = StartupProfile::shared();
+            profile.finish("first frame");
+            if (profile.totalNs() > 0) {
+                telemetry.recordDuration(TelemetryRing::Type::Startup, profile.totalNs(),
+                                         static_cast<uint32_t>(board.cellCount()));
+            }
+            emit firstFramePainted();
         }
-    }
-
-    connect(table, &QTableWidget::cellClicked, this, &MainWindow::onCellClicked);
+    });
+    connect(new QShortcut(QKeySequence("Ctrl+0"), this), &QShortcut::activated, boardView, &BoardView::fitToView);
 
+    // HUD độ trễ click -> hình: tạo ở click đầu tiên (updateLatencyHud)
     contentLayout->addWidget(headerLabel);
     contentLayout->addWidget(infoLabel);
-    contentLayout->addWidget(table, 1);
+    contentLayout->addWidget(boardView, 1);
 }
 
 int MainWindow::getRandomInt(int min, int max)
 {
-    return QRandomGenerator::global()->bounded(min, max + 1);
+    return rng.range(min, max);
 }
 
 bool MainWindow::isBallAt(int row, int col)
 {
-    for (const Ball &ball : balls) {
-        if (ball.row == row && ball.col == col) {
-            return true;
-        }
-    }
-    return false;
+    return board.inBounds(row, col) && !board.isEmpty(row, col);
 }
 
 // -------------------------
-// An toàn dừng và xóa thread
+// Nảy: chỉ một bóng nảy mỗi lúc, tick qua AnimationScheduler dùng chung
+// (không còn thread riêng cho từng bóng)
 // -------------------------
-void MainWindow::stopAllThreads()
+void MainWindow::startBouncing(int ballIndex)
 {
-    qDebug() << "Dừng tất cả threads, số lượng bóng:" << balls.size();
-    for (Ball &ball : balls) {
-        if (ball.thread) {
-            qDebug() << "Dừng thread cho bóng ID:" << ball.id;
-            ball.thread->stopAndWait();
-            disconnect(ball.thread, nullptr, this, nullptr);
-            delete ball.thread;
-            ball.thread = nullptr;
-        }
+    if (ballIndex < 0 || ballIndex >= balls.size()) return;
+    if (bouncingBallId == balls[ballIndex].id && AnimationScheduler::shared().contains(bounceAnimation)) return;
+
+    stopBouncing();
+    bouncingBallId = balls[ballIndex].id;
+    bounceStep = 0;
+    bounceDir = 1;
+    bounceElapsed = 0;
+    bounceAnimation = AnimationScheduler::shared().add(this, [this](float dt) { return bounceTick(dt); });
+}
+
+void MainWindow::stopBouncing()
+{
+    AnimationScheduler::shared().remove(bounceAnimation);
+    bounceAnimation = 0;
+    if (bouncingBallId < 0) return;
+    const int ballId = bouncingBallId;
+    bouncingBallId = -1;
+    onBounceUpdated(ballId, 0);   // về giữa ô
+}
+
+// Mỗi 30 ms lệch 1 px, đổi chiều ngoài -5..5 (nhịp của BallThread cũ)
+bool MainWindow::bounceTick(float dt)
+{
+    if (bouncingBallId < 0) return false;
+    bounceElapsed += dt;
+    bool moved = false;
+    while (bounceElapsed >= BounceStepSeconds) {
+        bounceElapsed -= BounceStepSeconds;
+        bounceStep += bounceDir;
+        if (bounceStep > 5 || bounceStep < -5) bounceDir = -bounceDir;
+        moved = true;
     }
-    qDebug() << "Đã dừng tất cả threads";
+    if (moved) onBounceUpdated(bouncingBallId, bounceStep);
+    return true;
 }
 
-void MainWindow::initializeBalls()
+void MainWindow::setRules(const GameRules &newRules)
 {
-    stopAllThreads();
-    balls.clear();
+    rules = newRules;
+    if (board.rows() != rules.rows || board.cols() != rules.cols) board.reset(rules.rows, rules.cols);
+    initializeBalls();
+}
 
-    // ====> THÊM VÀO ĐÂY <====
-    // Thiết lập bộ màu gốc mặc định khi bắt đầu game mới
-    baseColors.clear();
-    baseColors << QColor(255, 0, 0)   // Red
-               << QColor(0, 255, 0)   // Green
-               << QColor(0, 0, 255);  // Blue
-    // ====> KẾT THÚC <====
+void MainWindow::setBoardSize(int rows, int cols)
+{
+    board.reset(rows, cols);
+    rules.rows = rows;
+    rules.cols = cols;
+    initializeBalls();
+}
 
-    QVector<QPoint> initialPositions = { QPoint(2, 2), QPoint(5, 5), QPoint(8, 8) };
+bool MainWindow::parseBoardSize(const QString &text, int &rows, int &cols)
+{
+    const QStringList parts = text.toLower().split('x');
+    if (parts.size() != 2) return false;
+    bool okRows = false, okCols = false;
+    const int r = parts[0].trimmed().toInt(&okRows);
+    const int c = parts[1].trimmed().toInt(&okCols);
+    if (!okRows || !okCols) return false;
+    if (r < MinBoardSide || c < MinBoardSide || r > MaxBoardSide || c > MaxBoardSide) return false;
+    rows = r;
+    cols = c;
+    return true;
+}
 
-    for (int i = 0; i < 3; ++i) {
+void MainWindow::initializeBalls()
+{
+    cancelTurn();
+    stopBouncing();
+    balls.clear();
+    puzzleMovesLeft = -1;
+    puzzleSolution.clear();
+
+    // Thiết lập bộ màu gốc mặc định khi bắt đầu game mới: rules.colorCount
+    // màu đầu của palette (1 Red, 2 Green, 3 Blue, ...)
+    palette = Palette();
+    resetBaseColors();
+
+    // (2,2), (5,5), (8,8) trên bàn 10x10, co giãn theo kích thước; luật có
+    // nhiều bóng ban đầu hơn thì phần còn lại ở ô ngẫu nhiên.
+    // board làm bảng ô đã chiếm (rebuildBoard dựng lại ở cuối)
+    board.clear();
+    for (int i = 0; i < rules.initialBalls && balls.size() < board.cellCount(); ++i) {
         Ball ball;
+        if (i < 3) {
+            const int k = 2 + 3 * i;
+            ball.row = k * board.rows() / 10;
+            ball.col = k * board.cols() / 10;
+            if (!board.isEmpty(ball.row, ball.col)) continue;
+        } else {
+            do {
+                ball.row = getRandomInt(0, board.rows() - 1);
+                ball.col = getRandomInt(0, board.cols() - 1);
+            } while (!board.isEmpty(ball.row, ball.col));
+        }
+        ball.colorIndex = i < 3 ? baseColors[i % baseColors.size()] : baseColors[getRandomInt(0, baseColors.size() - 1)];
         ball.id = nextBallId++;
-        ball.row = initialPositions[i].x();
-        ball.col = initialPositions[i].y();
-        ball.color = baseColors[i]; // Lấy màu từ baseColors vừa thiết lập
-        // ... (phần còn lại giữ nguyên)
         ball.bounceOffset = 0;
-        ball.thread = new BallThread(ball.id, this);
-        connect(ball.thread, &BallThread::bounceUpdated, this, &MainWindow::onBounceUpdated);
+        board.set(ball.row, ball.col, ball.colorIndex);
         balls.append(ball);
     }
 
+    rebuildBoard();
+    updateTitle();
     updateBallPositions();
-}QColor MainWindow::getRandomColor()
-{
-    static const QVector<QColor> colors = {
-        QColor(255, 0, 0),     // Red
-        QColor(0, 255, 0),     // Green
-        QColor(0, 0, 255),     // Blue
-        QColor(255, 255, 0),   // Yellow
-        QColor(255, 0, 255),   // Magenta
-        QColor(0, 255, 255),   // Cyan
-        QColor(255, 165, 0),   // Orange
-        QColor(128, 0, 128),   // Purple
-        QColor(255, 192, 203), // Pink
-        QColor(0, 128, 0),     // Dark Green
-        QColor(139, 69, 19),   // Brown
-        QColor(0, 0, 128)      // Navy
-    };
+}
+
+// Màu gốc cho bóng mới: rules.colorCount màu đầu mà palette hiện tại có
+// (save cũ có thể mang palette ít màu hơn)
+void MainWindow::resetBaseColors()
+{
+    baseColors.clear();
+    const int count = qMin(rules.colorCount, palette.size());
+    for (int color = 1; color <= count; ++color) baseColors << static_cast<quint8>(color);
+}
+
+void MainWindow::updateTitle()
+{
+    QString title = QString("Ball Game - %1x%2 Grid").arg(board.rows()).arg(board.cols());
+    if (puzzleMovesLeft >= 0 && balls.isEmpty()) title += " - Puzzle: đã giải";
+    else if (puzzleMovesLeft > 0) title += QString(" - Puzzle: còn %1/%2 nước").arg(puzzleMovesLeft).arg(puzzleMoveLimit);
+    else if (puzzleMovesLeft == 0) title += QString(" - Puzzle: hết %1 nước (hoàn tác để thử lại)").arg(puzzleMoveLimit);
+    setWindowTitle(title);
+}
 
-    return colors[getRandomInt(0, colors.size() - 1)];
+// Một trong 12 màu chuẩn (chỉ số 1..12 của Palette)
+quint8 MainWindow::getRandomColor()
+{
+    const int count = qMin<int>(Palette::StandardCount, palette.size());
+    return static_cast<quint8>(getRandomInt(1, count));
 }
 
 // -------------------------
-// Cập nhật hiển thị bóng (vẽ circle bằng QPixmap + QLabel trong cell)
+// Cập nhật hiển thị bóng: BoardView vẽ thẳng từ board, ở đây chỉ báo
+// ô đang chọn (kèm độ nảy) và ô gợi ý rồi yêu cầu vẽ lại
 // -------------------------
 void MainWindow::updateBallPositions()
 {
-    // Clear old widgets safely
-    for (int row = 0; row < table->rowCount(); ++row) {
-        for (int col = 0; col < table->columnCount(); ++col) {
-            QWidget *old = table->cellWidget(row, col);
-            if (old) {
-                table->removeCellWidget(row, col);
-                delete old;
-            }
-            QTableWidgetItem *item = table->item(row, col);
-            if (!item) {
-                item = new QTableWidgetItem();
-                table->setItem(row, col, item);
-            }
-            item->setText("");
-            item->setBackground(QBrush(QColor(240, 240, 240)));
-            item->setToolTip(QString()); // clear tooltip
-        }
+    const int64_t start = TelemetryRing::nowNs();
+    const int cell = selectedCell();
+    const int bounce = cell >= 0 ? qBound(-5, balls[selectedBallIndex].bounceOffset, 5) : 0;
+    boardView->setSelectedCell(cell, bounce);
+    boardView->setHintCells(hintFrom, hintTo);
+    boardView->update();
+    exportBoard();
+    telemetry.fold(TelemetryRing::Type::Layout, TelemetryRing::nowNs() - start);
+}
+
+// Ô của bóng đang chọn (chỉ số phẳng), -1 nếu không có
+int MainWindow::selectedCell() const
+{
+    if (selectedBallIndex < 0 || selectedBallIndex >= balls.size()) return -1;
+    const Ball &sb = balls[selectedBallIndex];
+    return board.inBounds(sb.row, sb.col) ? sb.row * board.cols() + sb.col : -1;
+}
+
+// Ghi các ô đổi từ lần trước vào shared memory (--shm). Gọi ở cùng chỗ vẽ
+// lại sau khi balls đổi, nên tool ngoài thấy đúng trạng thái đã hiển thị.
+void MainWindow::exportBoard()
+{
+    if (!boardExport) return;
+    BoardShm::Status status;
+    status.selectedCell = selectedCell();
+    status.turn = static_cast<uint64_t>(history.cursor());
+    status.ballCount = balls.size();
+    if (exportFull) {
+        std::vector<uint32_t> colors;
+        colors.reserve(palette.size());
+        for (const QColor &color : palette.colors()) colors.push_back(color.rgba());
+        boardExport->publish(board, colors, status);
+        exportFull = false;
+    } else if (!exportChanged.empty() || status != exportStatus) {
+        boardExport->update(board, exportChanged.data(), exportChanged.size(), status);
     }
+    exportChanged.clear();
+    exportStatus = status;
+}
 
-    // Draw balls
-    for (const Ball &ball : balls) {
-        if (ball.row < 0 || ball.row >= table->rowCount() ||
-            ball.col < 0 || ball.col >= table->columnCount()) continue;
-
-        int cellH = table->rowHeight(ball.row);
-        int cellW = table->columnWidth(ball.col);
-        int diameter = qMax(8, static_cast<int>(qMin(cellH, cellW) * 0.6)); // 60% ô
-
-        QPixmap pixmap(diameter, diameter);
-        pixmap.fill(Qt::transparent);
-
-        QPainter painter(&pixmap);
-        painter.setRenderHint(QPainter::Antialiasing);
-        painter.setBrush(ball.color);
-        painter.setPen(Qt::NoPen);
-        painter.drawEllipse(0, 0, diameter - 1, diameter - 1);
-        painter.end();
-
-        QLabel *ballLabel = new QLabel();
-        ballLabel->setAttribute(Qt::WA_TranslucentBackground);
-        ballLabel->setStyleSheet("background: transparent;");
-        ballLabel->setPixmap(pixmap);
-        ballLabel->setFixedSize(diameter, diameter);
-        ballLabel->setScaledContents(false);
-        ballLabel->setAlignment(Qt::AlignCenter);
-
-        // Make both container and label ignore mouse events so table receives clicks
-        QWidget *container = new QWidget();
-        container->setAttribute(Qt::WA_TranslucentBackground);
-        container->setStyleSheet("background: transparent;");
-
-        // IMPORTANT: ignore mouse events so clicks fall through to the table (cellClicked will fire)
-        container->setAttribute(Qt::WA_TransparentForMouseEvents, true);
-        ballLabel->setAttribute(Qt::WA_TransparentForMouseEvents, true);
-
-        QVBoxLayout *lay = new QVBoxLayout(container);
-        lay->setContentsMargins(0, 0, 0, 0);
-        lay->setSpacing(0);
-
-        int bounce = qBound(-5, ball.bounceOffset, 5);
-        int topSpacer = 5 - bounce;
-        int bottomSpacer = 5 + bounce;
-        lay->addSpacerItem(new QSpacerItem(10, topSpacer, QSizePolicy::Minimum, QSizePolicy::Fixed));
-        lay->addWidget(ballLabel, 0, Qt::AlignHCenter);
-        lay->addSpacerItem(new QSpacerItem(10, bottomSpacer, QSizePolicy::Minimum, QSizePolicy::Fixed));
-
-        table->setCellWidget(ball.row, ball.col, container);
-
-        // Put tooltip on the item (not on container) so it still shows.
-        QTableWidgetItem *item = table->item(ball.row, ball.col);
-        if (item) {
-            item->setToolTip(QString("Ball %1\nPos: (%2,%3)").arg(ball.id).arg(ball.row+1).arg(ball.col+1));
-        }
+bool MainWindow::startBoardExport(const QString &name, QString *error)
+{
+    auto writer = std::make_unique<BoardShm::Writer>();
+    std::string message;
+    if (!writer->open(QFile::encodeName(name).toStdString(), size_t(MaxBoardSide) * MaxBoardSide, &message)) {
+        if (error) *error = QString::fromStdString(message);
+        return false;
     }
+    boardExport = std::move(writer);
+    exportFull = true;
+    exportBoard();
+    return true;
+}
 
-    // Optionally, highlight selected cell (visual cue)
-    // First clear selection background on all items (we already set background). Then mark selectedBallIndex
-    if (selectedBallIndex >= 0 && selectedBallIndex < balls.size()) {
-        const Ball &sb = balls[selectedBallIndex];
-        QTableWidgetItem *it = table->item(sb.row, sb.col);
-        if (it) {
-            it->setBackground(QBrush(QColor(220, 240, 255))); // nhẹ highlight
-        }
+bool MainWindow::openTelemetry(const QString &path, QString *error)
+{
+    std::string message;
+    if (!telemetry.open(QFile::encodeName(path).toStdString(), TelemetryRing::DefaultCapacity, &message)) {
+        if (error) *error = QString::fromStdString(message);
+        return false;
     }
+    return true;
 }
 
 void MainWindow::onRandomizeClicked()
 {
-    // Dừng và đợi tất cả thread hiện tại
-    for (Ball &ball : balls) {
-        if (ball.thread) {
-            ball.thread->stopBouncing();
-            ball.thread->wait(100);
-        }
-    }
+    cancelTurn();
 
-    QVector<QColor> usedColors;
+    stopBouncing();
+
+    QVector<quint8> usedColors;
+    const int colorCount = qMin<int>(Palette::StandardCount, palette.size());
 
     // ====> BẮT ĐẦU THAY ĐỔI <====
     // Xóa danh sách màu gốc hiện tại để chuẩn bị cập nhật mới
     baseColors.clear();
     // ====> KẾT THÚC THAY ĐỔI <====
 
+    // board làm bảng ô đã chiếm (rebuildBoard dựng lại ở cuối)
+    board.clear();
     for (Ball &ball : balls) {
-        // (Giữ nguyên logic tìm vị trí mới...)
-        bool positionExists;
         do {
-            positionExists = false;
-            ball.row = getRandomInt(0, 9);
-            ball.col = getRandomInt(0, 9);
-            for (const Ball &otherBall : balls) {
-                if (&ball != &otherBall && ball.row == otherBall.row && ball.col == otherBall.col) {
-                    positionExists = true;
-                    break;
-                }
-            }
-        } while (positionExists);
+            ball.row = getRandomInt(0, board.rows() - 1);
+            ball.col = getRandomInt(0, board.cols() - 1);
+        } while (!board.isEmpty(ball.row, ball.col));
+        board.set(ball.row, ball.col, 1);   // chiếm chỗ, màu thật gán bên dưới
 
         // (Giữ nguyên logic random màu không trùng từ danh sách lớn...)
-        QColor color;
+        // hết màu chưa dùng (nhiều hơn 12 bóng) thì cho phép trùng
+        if (usedColors.size() >= colorCount) usedColors.clear();
+        quint8 color;
         do {
             color = getRandomColor();
         } while (usedColors.contains(color));
 
         usedColors.append(color);
-        ball.color = color;
+        ball.colorIndex = color;
 
         // ====> BẮT ĐẦU THAY ĐỔI <====
         // Thêm màu vừa được chọn vào danh sách baseColors mới của game
@@ -668,27 +675,34 @@ void MainWindow::onRandomizeClicked()
         // ====> KẾT THÚC THAY ĐỔI <====
 
         ball.bounceOffset = 0;
-
-        // (Giữ nguyên logic còn lại...)
-        if (ball.thread) {
-            ball.thread->stopBouncing();
-        } else {
-            ball.thread = new BallThread(ball.id, this);
-            connect(ball.thread, &BallThread::bounceUpdated, this, &MainWindow::onBounceUpdated);
-        }
     }
 
     selectedBallIndex = -1;
     movingBallIndex = -1;
+    // xáo bóng -> không còn là puzzle
+    puzzleMovesLeft = -1;
+    puzzleSolution.clear();
+    rebuildBoard();
+    updateTitle();
     updateBallPositions();
 }
 void MainWindow::onCellClicked(int row, int column)
 {
+    const qint64 arrival = boardView->lastClickArrivalNs();
+    latency.begin(arrival > 0 ? arrival : LatencyTracker::nowNs());
+    latency.mark(LatencyTracker::Handled);
     qDebug() << "Cell clicked:" << row << column;
 
-    // If currently moving a ball, ignore clicks (avoid conflicts).
-    if (movingBallIndex != -1) {
-        qDebug() << "Ignored click while a ball is moving";
+    // If a turn is still running (moving / clearing), ignore clicks (avoid conflicts).
+    if (currentTurn.isRunning()) {
+        qDebug() << "Ignored click while a turn is running";
+        latency.decide(LatencyTracker::Kind::Ignored);
+        return;
+    }
+    // Puzzle hết nước mà chưa dọn xong: không đi tiếp (sẽ không còn sinh bóng);
+    // hoàn tác để thử lại, hoặc ván / puzzle mới
+    if (isGameOver || puzzleMovesLeft == 0) {
+        latency.decide(LatencyTracker::Kind::Ignored);
         return;
     }
 
@@ -703,21 +717,17 @@ void MainWindow::onCellClicked(int row, int column)
 
     // Clicked on a ball -> toggle selection
     if (clickedIndex != -1) {
-        // if selecting a different ball, stop old one's bouncing
-        if (selectedBallIndex != -1 && selectedBallIndex != clickedIndex) {
-            Ball &old = balls[selectedBallIndex];
-            if (old.thread) old.thread->stopBouncing();
-        }
-
-        Ball &b = balls[clickedIndex];
+        // startBouncing dừng bóng đang nảy trước (chỉ một bóng nảy)
         if (selectedBallIndex == clickedIndex) {
             // toggle off
-            if (b.thread) b.thread->stopBouncing();
+            stopBouncing();
             selectedBallIndex = -1;
+            latency.decide(LatencyTracker::Kind::Deselect);
         } else {
             // select this ball
             selectedBallIndex = clickedIndex;
-            if (b.thread) b.thread->startBouncing();
+            startBouncing(clickedIndex);
+            latency.decide(LatencyTracker::Kind::Select);
         }
 
         updateBallPositions();
@@ -727,40 +737,256 @@ void MainWindow::onCellClicked(int row, int column)
     // Clicked empty cell
     if (selectedBallIndex == -1) {
         qDebug() << "Clicked empty cell with no selection - ignore";
+        latency.decide(LatencyTracker::Kind::Ignored);
         return;
     }
 
     // compute path and start moving
     Ball &sel = balls[selectedBallIndex];
 
-    // Let pathfinder treat the selected ball as the moving one (exclude from occupancy)
-    movingBallIndex = selectedBallIndex;
-    QVector<QPoint> path = findPath(sel.row, sel.col, row, column);
+    // Luật nhảy tự do: bóng đi thẳng tới ô đích, không cần đường
+    const bool jump = rules.movement == GameRules::Movement::Jump;
+
+    // O(1): ô đích không cùng vùng trống với bóng -> khỏi tìm đường
+    if (!jump && !emptyRegions.canReach(sel.row * board.cols() + sel.col, row * board.cols() + column)) {
+        qDebug() << "No path found";
+        latency.decide(LatencyTracker::Kind::Ignored);
+        return;
+    }
+
+    // The pathfinder treats the selected ball's own cell as walkable
+    QVector<QPoint> path = jump ? QVector<QPoint>{ QPoint(sel.row, sel.col), QPoint(row, column) }
+                                : findPath(sel.row, sel.col, row, column);
 
     if (path.isEmpty()) {
         qDebug() << "No path found";
-        movingBallIndex = -1;
+        latency.decide(LatencyTracker::Kind::Ignored);
         return;
     }
+    latency.decide(LatencyTracker::Kind::Move);
 
-    // start movement (this will stop bouncing of that ball)
-    startMoveAlongPath(path, selectedBallIndex);
+    // start the turn (this will stop bouncing of that ball)
+    currentTurn = playTurn(path, selectedBallIndex);
 }
 
-void MainWindow::onBounceUpdated(int ballId, int bounceOffset)
+// Chấm mọi nước đi hợp lệ, tô ô nguồn / ô đích của nước tốt nhất
+void MainWindow::onHintClicked()
 {
-    for (Ball &ball : balls) {
-        if (ball.id == ballId) {
-            ball.bounceOffset = bounceOffset;
-            break;
+    if (currentTurn.isRunning() || isGameOver) return;
+
+    if (!hintEngine) hintEngine = std::make_unique<HintEngine>(WorkerPool::shared());
+    hintEngine->setRules(rules);
+    const std::vector<HintMove> &moves = hintEngine->bestMoves(board, emptyRegions, 3);
+    if (moves.empty()) {
+        qDebug() << "Hint: no legal move";
+        hintFrom = hintTo = -1;
+    } else {
+        const HintMove &best = moves.front();
+        hintFrom = best.from;
+        hintTo = best.to;
+    }
+    updateBallPositions();
+}
+
+// Hoàn tác / làm lại một lượt từ TurnHistory (không chụp lại cả bàn)
+void MainWindow::applyHistoryTurn(const TurnHistory::Turn &turn, bool forward)
+{
+    const int C = board.cols();
+    auto moveBallAt = [&](int fromCell, int toCell) {
+        for (Ball &ball : balls) {
+            if (ball.row * C + ball.col != fromCell) continue;
+            setCell(ball.row, ball.col, Palette::Empty);
+            ball.row = toCell / C;
+            ball.col = toCell % C;
+            setCell(ball.row, ball.col, ball.colorIndex);
+            return;
         }
+    };
+
+    if (forward) {
+        moveBallAt(turn.from, turn.to);
+        for (int i = 0; i < turn.spawnedCount(); ++i) {
+            const TurnHistory::CellColor spawned = turn.spawned(i);
+            addBallAt(spawned.cell / C, spawned.cell % C, spawned.color);
+        }
+        QVector<QPoint> removed;
+        for (int i = 0; i < turn.removedCount(); ++i) removed.append(QPoint(turn.removed(i).cell / C, turn.removed(i).cell % C));
+        removeBallsAt(removed);
+        rng.setState(turn.rngAfter);
+    } else {
+        for (int i = 0; i < turn.removedCount(); ++i) {
+            const TurnHistory::CellColor removed = turn.removed(i);
+            addBallAt(removed.cell / C, removed.cell % C, removed.color);
+        }
+        QVector<QPoint> spawned;
+        for (int i = 0; i < turn.spawnedCount(); ++i) spawned.append(QPoint(turn.spawned(i).cell / C, turn.spawned(i).cell % C));
+        removeBallsAt(spawned);
+        moveBallAt(turn.to, turn.from);
+        rng.setState(turn.rngBefore);
+    }
+
+    // bỏ chọn, bàn cũ có thể còn hàng dài -> lượt sau quét toàn bộ
+    stopBouncing();
+    selectedBallIndex = -1;
+    needsFullLineScan = true;
+    isGameOver = !emptyRegions.anyMoveLegal();
+    if (puzzleMovesLeft >= 0) {
+        puzzleMovesLeft += forward ? -1 : 1;
+        updateTitle();
     }
+    updateHistoryButtons();
     updateBallPositions();
+
+    // redo là đúng một lượt; undo đi ngược thứ tự của frame lượt nên gửi cả bàn
+    if (spectators) {
+        if (forward) spectators->publishTurn(turn, board, palette);
+        else spectators->publishSnapshot(board, palette);
+    }
+}
+
+void MainWindow::onUndoClicked()
+{
+    if (currentTurn.isRunning() || !history.canUndo()) return;
+    applyHistoryTurn(history.undo(), false);
+}
+
+void MainWindow::onRedoClicked()
+{
+    if (currentTurn.isRunning() || !history.canRedo()) return;
+    applyHistoryTurn(history.redo(), true);
+}
+
+void MainWindow::updateHistoryButtons()
+{
+    const bool idle = !currentTurn.isRunning() && !history.isRecording();
+    undoButton->setEnabled(idle && history.canUndo());
+    redoButton->setEnabled(idle && history.canRedo());
+}
+
+// p50/p95/p99 và histogram (mỗi ký tự là một bucket, cao theo số click)
+void MainWindow::updateLatencyHud()
+{
+    if (latency.count() == 0) return;
+    if (!latencyHud) {
+        latencyHud = new QLabel(rightContent);
+        latencyHud->setObjectName("latencyHud");
+        rightContent->layout()->addWidget(latencyHud);
+    }
+
+    static const QString levels = QStringLiteral(" ▁▂▃▄▅▆▇█");
+    const auto &histogram = latency.histogram();
+    const quint64 peak = *std::max_element(histogram.begin(), histogram.end());
+    QString bars;
+    QString table;
+    for (int b = 0; b < LatencyTracker::BucketCount; ++b) {
+        const int level = histogram[b] == 0 ? 0 : 1 + static_cast<int>((levels.size() - 2) * histogram[b] / peak);
+        bars += levels[level];
+        const QString label = b + 1 < LatencyTracker::BucketCount
+            ? QString("≤ %1 ms").arg(LatencyTracker::bucketUpperMs(b))
+            : QString("> %1 ms").arg(LatencyTracker::bucketUpperMs(b - 1));
+        table += QString("%1: %2\n").arg(label).arg(histogram[b]);
+    }
+    latencyHud->setText(QString("Độ trễ click → hình (%1 click): p50 %2 ms · p95 %3 ms · p99 %4 ms   [%5] %6…%7 ms")
+                            .arg(latency.count())
+                            .arg(latency.percentileMs(0.50), 0, 'f', 1)
+                            .arg(latency.percentileMs(0.95), 0, 'f', 1)
+                            .arg(latency.percentileMs(0.99), 0, 'f', 1)
+                            .arg(bars)
+                            .arg(LatencyTracker::FirstBucketMs)
+                            .arg(LatencyTracker::bucketUpperMs(LatencyTracker::BucketCount - 2)));
+    latencyHud->setToolTip(table.trimmed());
+}
+
+// Ctrl+Shift+P: số lần thức / giây và CPU của cả process từ lần xem trước
+void MainWindow::onPowerStatsRequested()
+{
+    const PowerMetrics::Sample now = PowerMetrics::sample();
+    const PowerMetrics::Rates rates = PowerMetrics::rates(powerSample, now);
+    powerSample = now;
+
+    QMessageBox::information(this, "Điện năng",
+                             QString("Trong %1 s vừa qua:\n"
+                                     "  Số lần thức: %2 / s\n"
+                                     "  CPU: %3 % của một core\n"
+                                     "Tổng CPU của process: %4 s\n"
+                                     "Animation đang chạy: %5 (bóng nảy: %6)")
+                                 .arg(rates.seconds, 0, 'f', 1)
+                                 .arg(rates.wakeupsPerSecond, 0, 'f', 2)
+                                 .arg(rates.cpuPercent, 0, 'f', 2)
+                                 .arg(now.cpuSeconds, 0, 'f', 2)
+                                 .arg(AnimationScheduler::shared().activeCount())
+                                 .arg(bouncingBallId >= 0 ? 1 : 0));
+}
+
+void MainWindow::onGameOver(int ballCount)
+{
+    qDebug() << "Game over with" << ballCount << "balls";
+    QMessageBox::information(this, "Hết nước đi",
+                             QString("Không còn nước đi nào — trò chơi kết thúc!\nSố bóng trên bàn: %1").arg(ballCount));
+}
+
+// Puzzle mới K nước trên bàn 10x10; chỉ nhận bàn đã có lời giải kiểm chứng
+void MainWindow::onPuzzleClicked()
+{
+    // cùng luật đang chơi (hướng, số màu, cách đi), chỉ kích thước cố định
+    PuzzleGenerator::Options options;
+    options.rules = rules;
+    options.rules.rows = options.rules.cols = 10;
+    options.moves = PuzzleMoves;
+    PuzzleSolver solver(PuzzleGenerator::rulesFor(options));
+    Puzzle puzzle;
+    if (!PuzzleGenerator::generateOne(rng.next(), options, solver, puzzle)) {
+        QMessageBox::warning(this, "Puzzle", "Không tạo được puzzle, hãy thử lại!");
+        return;
+    }
+    const GameSave::GameState state = GameSave::fromPuzzle(puzzle);
+    if (board.rows() != state.rows || board.cols() != state.cols) setBoardSize(state.rows, state.cols);
+    applyGameState(state);
+}
+
+void MainWindow::onPuzzleEnded(bool solved)
+{
+    if (solved) {
+        QMessageBox::information(this, "Puzzle", QString("Đã dọn sạch bàn trong %1 nước!")
+                                                     .arg(puzzleMoveLimit - puzzleMovesLeft));
+        return;
+    }
+    // chỉ cách giải từ thế ban đầu: hoàn tác để thử lại
+    QString solution;
+    for (const GameSave::MoveData &move : puzzleSolution) {
+        solution += QString("\n(%1,%2) → (%3,%4)").arg(move.fromRow).arg(move.fromCol).arg(move.toRow).arg(move.toCol);
+    }
+    QMessageBox::information(this, "Puzzle",
+                             QString("Hết nước, bàn còn %1 bóng.\nHoàn tác để thử lại, hoặc bắt đầu ván / puzzle mới. Lời giải:%2")
+                                 .arg(balls.size()).arg(solution));
+}
+
+void MainWindow::onBounceUpdated(int ballId, int bounceOffset)
+{
+    // gần như luôn là bóng đang chọn -> khỏi duyệt cả danh sách mỗi tick
+    int index = selectedBallIndex;
+    if (index < 0 || index >= balls.size() || balls[index].id != ballId) {
+        index = -1;
+        for (int i = 0; i < balls.size(); ++i) {
+            if (balls[i].id == ballId) {
+                index = i;
+                break;
+            }
+        }
+    }
+    if (index < 0) return;
+
+    Ball &ball = balls[index];
+    ball.bounceOffset = bounceOffset;
+    // chỉ bóng đang chọn được vẽ nảy -> chỉ vẽ lại ô của nó
+    if (index == selectedBallIndex && board.inBounds(ball.row, ball.col)) {
+        boardView->setSelectedCell(ball.row * board.cols() + ball.col, qBound(-5, bounceOffset, 5));
+    }
 }
 
 void MainWindow::onCloseClicked()
 {
-    stopAllThreads();
+    stopBouncing();
     QApplication::quit();
 }
 
@@ -814,173 +1040,225 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event) {
 void MainWindow::addRandomBalls(int count)
 {
     for (int i = 0; i < count; ++i) {
-        QVector<QPoint> emptyCells;
-        for (int r = 0; r < 10; ++r) {
-            for (int c = 0; c < 10; ++c) {
-                if (!isBallAt(r, c))
-                    emptyCells.append(QPoint(r, c));
-            }
-        }
-        if (emptyCells.isEmpty()) return;
+        if (emptyRegions.emptyCount() == 0) return;   // bàn đầy, playTurn sẽ báo gameOver
 
-        QPoint pos = emptyCells[getRandomInt(0, emptyCells.size() - 1)];
+        // ô trống ngẫu nhiên lấy thẳng từ danh sách của EmptyRegions, không quét bàn
+        const int cell = emptyRegions.emptyCell(getRandomInt(0, emptyRegions.emptyCount() - 1));
+        const int row = cell / board.cols(), col = cell % board.cols();
+        if (baseColors.isEmpty()) resetBaseColors();    // Random Balls trên bàn trống
+        if (baseColors.isEmpty()) return;               // palette rỗng
 
         // ====> LOGIC ĐÚNG KHI THÊM BÓNG MỚI <====
         // Lấy màu ngẫu nhiên từ danh sách 3 MÀU GỐC
-        QColor color = baseColors[getRandomInt(0, baseColors.size() - 1)];
+        quint8 color = baseColors[getRandomInt(0, baseColors.size() - 1)];
 
-        Ball newBall;
-        // ... (phần còn lại của hàm giữ nguyên)
-        newBall.id = nextBallId++;
-        newBall.row = pos.x();
-        newBall.col = pos.y();
-        newBall.color = color;
-        newBall.bounceOffset = 0;
-        newBall.thread = new BallThread(newBall.id, this);
-
-        connect(newBall.thread, &BallThread::bounceUpdated, this, &MainWindow::onBounceUpdated);
-        balls.append(newBall);
+        addBallAt(row, col, color);
+        history.recordSpawn(cell, color);
     }
     updateBallPositions();
 }
+
+void MainWindow::addBallAt(int row, int col, quint8 colorIndex)
+{
+    Ball newBall;
+    newBall.id = nextBallId++;
+    newBall.row = row;
+    newBall.col = col;
+    newBall.colorIndex = colorIndex;
+    newBall.bounceOffset = 0;
+    balls.append(newBall);
+    setCell(newBall.row, newBall.col, newBall.colorIndex);
+}
 void MainWindow::checkAndRemoveLines()
 {
-    const int R = table->rowCount();
-    const int C = table->columnCount();
-    QVector<QPoint> toRemove;
-
-    auto colorAt = [&](int r, int c) -> QColor {
-        for (const Ball &b : balls)
-            if (b.row == r && b.col == c)
-                return b.color;
-        return QColor();
-    };
+    const QVector<QPoint> toRemove = findLinesToRemove();
+    if (toRemove.isEmpty()) return;
 
-    auto checkDir = [&](int r, int c, int dr, int dc) {
-        QColor col = colorAt(r, c);
-        if (!col.isValid()) return QVector<QPoint>();
-        QVector<QPoint> line;
-        line.append(QPoint(r, c));
-        int nr = r + dr, nc = c + dc;
-        while (nr >= 0 && nr < R && nc >= 0 && nc < C && colorAt(nr, nc) == col) {
-            line.append(QPoint(nr, nc));
-            nr += dr;
-            nc += dc;
-        }
-        return line;
-    };
-
-    // kiểm tra ngang, dọc, chéo
-    for (int r = 0; r < R; ++r) {
-        for (int c = 0; c < C; ++c) {
-            QVector<QVector<QPoint>> dirs = {
-                checkDir(r, c, 0, 1),   // ngang
-                checkDir(r, c, 1, 0),   // dọc
-                checkDir(r, c, 1, 1),   // chéo phải
-                checkDir(r, c, 1, -1)   // chéo trái
-            };
-            for (auto &line : dirs) {
-                if (line.size() >= 5) {
-                    toRemove += line;
-                    qDebug() << "Tìm thấy line dài" << line.size() << "tại (" << r << "," << c << ")";
-                }
-            }
-        }
-    }
-
-    // xóa các quả trùng nhau (nếu có)
-    std::sort(toRemove.begin(), toRemove.end(), [](const QPoint &a, const QPoint &b){
-        if (a.x() == b.x()) return a.y() < b.y();
-        return a.x() < b.x();
-    });
-    toRemove.erase(std::unique(toRemove.begin(), toRemove.end()), toRemove.end());
+    boardView->addClearEffect(toRemove);
+    removeBallsAt(toRemove);
+    updateBallPositions();
+    qDebug() << "Còn lại" << balls.size() << "bóng sau khi xóa line";
+}
 
-    if (toRemove.isEmpty()) {
+// Tìm tất cả các ô nằm trên hàng >= rules.lineLength bóng cùng màu theo các hướng của luật.
+// Quét cả bàn bằng LineScanner (SIMD khi CPU hỗ trợ), kết quả theo thứ tự hàng/cột.
+QVector<QPoint> MainWindow::findLinesToRemove()
+{
+    QVector<QPoint> toRemove;
+    const int64_t start = TelemetryRing::nowNs();
+    const int count = lineScanner.scan(board, rules.lineLength, rules.lineDirections);
+    telemetry.record(TelemetryRing::Type::LineScan, start, static_cast<uint32_t>(count));
+    if (count == 0) {
         qDebug() << "Không tìm thấy line nào để xóa";
-        return;
+        return toRemove;
     }
 
+    toRemove = maskToCells(lineScanner.mask().data(), count);
     qDebug() << "Sẽ xóa" << toRemove.size() << "bóng";
+    return toRemove;
+}
 
-    // xóa banh trong danh sách chính - SỬA CÁCH XÓA ĐỂ TRÁNH CRASH
-    for (const QPoint &p : toRemove) {
-        for (int i = balls.size() - 1; i >= 0; --i) {  // duyệt ngược để tránh lỗi index
-            if (balls[i].row == p.x() && balls[i].col == p.y()) {
-                qDebug() << "Xóa bóng ID:" << balls[i].id << "tại (" << p.x() << "," << p.y() << ")";
-                if (balls[i].thread) {
-                    balls[i].thread->stopBouncing();
-                    balls[i].thread->wait(100);
-                    delete balls[i].thread;
-                    balls[i].thread = nullptr;
-                }
-                balls.removeAt(i);
-                break;  // chỉ xóa 1 bóng tại vị trí này
+// Chỉ xét các hàng đi qua những ô vừa thay đổi (bảng tĩnh của Board<> với các
+// bộ luật hay gặp). Đúng khi trên bàn không còn hàng dài nào từ trước.
+QVector<QPoint> MainWindow::findLinesThrough(const QVector<QPoint> &cells)
+{
+    const int64_t start = TelemetryRing::nowNs();
+    lineMask.assign(static_cast<size_t>(board.cellCount()), 0);
+    const int count = withBoardGeometry(board.rows(), board.cols(), rules.lineLength, rules.lineDirections, [&](const auto &geo) {
+        int marked = 0;
+        for (const QPoint &p : cells) {
+            if (board.inBounds(p.x(), p.y())) {
+                marked += geo.markLinesThrough(board.data(), p.x() * board.cols() + p.y(), lineMask.data());
             }
         }
+        return marked;
+    });
+    telemetry.record(TelemetryRing::Type::LineScan, start, static_cast<uint32_t>(count));
+    if (count == 0) return QVector<QPoint>();
+
+    qDebug() << "Sẽ xóa" << count << "bóng";
+    return maskToCells(lineMask.data(), count);
+}
+
+QVector<QPoint> MainWindow::maskToCells(const uint8_t *mask, int count) const
+{
+    QVector<QPoint> result;
+    result.reserve(count);
+    for (int r = 0; r < board.rows(); ++r) {
+        for (int c = 0; c < board.cols(); ++c) {
+            if (mask[static_cast<size_t>(r) * board.cols() + c]) result.append(QPoint(r, c));
+        }
     }
+    return result;
+}
 
-    // Cập nhật selectedBallIndex nếu bóng được chọn bị xóa
-    if (selectedBallIndex >= balls.size()) {
-        selectedBallIndex = -1;
+// Đánh dấu các ô rồi lọc balls một lượt: O(bóng + ô) thay vì O(bóng * ô)
+void MainWindow::removeBallsAt(const QVector<QPoint> &cells)
+{
+    if (cells.isEmpty()) return;
+
+    const int C = board.cols();
+    removeMask.assign(static_cast<size_t>(board.cellCount()), 0);
+    for (const QPoint &p : cells) {
+        if (!board.inBounds(p.x(), p.y()) || board.isEmpty(p.x(), p.y())) continue;
+        history.recordRemove(p.x() * C + p.y(), board.at(p.x(), p.y()));
+        removeMask[static_cast<size_t>(p.x()) * C + p.y()] = 1;
+        setCell(p.x(), p.y(), Palette::Empty);
     }
 
-    updateBallPositions();
-    qDebug() << "Còn lại" << balls.size() << "bóng sau khi xóa line";
+    int kept = 0;
+    int newSelected = -1, newMoving = -1;
+    bool removedBouncing = false;
+    for (int i = 0; i < balls.size(); ++i) {
+        Ball &ball = balls[i];
+        if (board.inBounds(ball.row, ball.col) && removeMask[static_cast<size_t>(ball.row) * C + ball.col]) {
+            qDebug() << "Xóa bóng ID:" << ball.id << "tại (" << ball.row << "," << ball.col << ")";
+            removeMask[static_cast<size_t>(ball.row) * C + ball.col] = 0;   // chỉ xóa 1 bóng tại vị trí này
+            removedBouncing = removedBouncing || ball.id == bouncingBallId;
+            continue;
+        }
+        if (i == selectedBallIndex) newSelected = kept;
+        if (i == movingBallIndex) newMoving = kept;
+        if (kept != i) balls[kept] = ball;
+        ++kept;
+    }
+    balls.resize(kept);
+
+    // bóng được chọn bị xóa -> bỏ chọn
+    selectedBallIndex = newSelected;
+    movingBallIndex = newMoving;
+    if (removedBouncing) stopBouncing();
 }
 
 // Thêm implementations:
 void MainWindow::onSaveGameClicked()
 {
-    // Chuẩn bị game state
+    // Gọi save
+    const GameSave::GameState state = currentGameState();
+    if (gameSave->saveGame(state, this)) {
+        telemetry.recordDuration(TelemetryRing::Type::Save, gameSave->lastIoNs(), static_cast<uint32_t>(state.balls.size()));
+    }
+}
+
+void MainWindow::onLoadGameClicked()
+{
+    GameSave::GameState gameState;
+
+    if (gameSave->loadGame(gameState, this, board.rows(), board.cols())) {
+        telemetry.recordDuration(TelemetryRing::Type::Load, gameSave->lastIoNs(), static_cast<uint32_t>(gameState.balls.size()));
+        // save có kích thước khác (header / "rows", "cols") -> đổi bàn trước
+        if (gameState.rows != board.rows() || gameState.cols != board.cols()) {
+            if (gameState.rows < MinBoardSide || gameState.cols < MinBoardSide
+                || gameState.rows > MaxBoardSide || gameState.cols > MaxBoardSide) {
+                QMessageBox::warning(this, "Lỗi Mở Game",
+                                     QString("Kích thước bàn %1x%2 không được hỗ trợ!").arg(gameState.rows).arg(gameState.cols));
+                return;
+            }
+            setBoardSize(gameState.rows, gameState.cols);
+        }
+        applyGameState(gameState);
+    }
+}
+
+// Chụp trạng thái hiện tại (để lưu)
+GameSave::GameState MainWindow::currentGameState() const
+{
     GameSave::GameState gameState;
 
     for (const Ball &ball : balls) {
-        GameSave::BallData ballData(ball.id, ball.row, ball.col, ball.color, ball.bounceOffset);
+        GameSave::BallData ballData(ball.id, ball.row, ball.col, ball.colorIndex, ball.bounceOffset);
         gameState.balls.append(ballData);
     }
+    gameState.palette = palette;
 
     gameState.nextBallId = nextBallId;
     gameState.selectedBallIndex = selectedBallIndex;
     gameState.movingBallIndex = movingBallIndex;
-
-    // Gọi save
-    gameSave->saveGame(gameState, this);
+    gameState.rows = board.rows();
+    gameState.cols = board.cols();
+    if (puzzleMovesLeft > 0) {
+        gameState.puzzleMoves = puzzleMovesLeft;
+        // lời giải chỉ đúng khi chưa đi nước nào
+        if (puzzleMovesLeft == puzzleMoveLimit) gameState.puzzleSolution = puzzleSolution;
+    }
+    return gameState;
 }
 
-void MainWindow::onLoadGameClicked()
+// Thay toàn bộ bàn bằng một trạng thái đã lưu
+void MainWindow::applyGameState(const GameSave::GameState &gameState)
 {
-    GameSave::GameState gameState;
-
-    if (gameSave->loadGame(gameState, this)) {
-        // Stop all current threads
-        stopAllThreads();
-        balls.clear();
-
-        // Load balls from saved state
-        for (const GameSave::BallData &ballData : gameState.balls) {
-            Ball ball;
-            ball.id = ballData.id;
-            ball.row = ballData.row;
-            ball.col = ballData.col;
-            ball.color = ballData.color;
-            ball.bounceOffset = ballData.bounceOffset;
-            ball.thread = new BallThread(ball.id, this);
-            ball.ballLabel = nullptr;
-
-            connect(ball.thread, &BallThread::bounceUpdated, this, &MainWindow::onBounceUpdated);
-            balls.append(ball);
-        }
-
-        // Restore game state
-        nextBallId = gameState.nextBallId;
-        selectedBallIndex = gameState.selectedBallIndex;
-        movingBallIndex = gameState.movingBallIndex;
+    // Stop the running turn and the bounce animation
+    cancelTurn();
+    stopBouncing();
+    balls.clear();
 
-        // Restart bouncing for selected ball
-        if (selectedBallIndex >= 0 && selectedBallIndex < balls.size()) {
-            balls[selectedBallIndex].thread->startBouncing();
-        }
+    // Load balls from saved state
+    for (const GameSave::BallData &ballData : gameState.balls) {
+        Ball ball;
+        ball.id = ballData.id;
+        ball.row = ballData.row;
+        ball.col = ballData.col;
+        ball.colorIndex = ballData.colorIndex;
+        ball.bounceOffset = ballData.bounceOffset;
+        balls.append(ball);
+    }
 
-        updateBallPositions();
+    // Restore game state
+    palette = gameState.palette;
+    resetBaseColors();      // chỉ số cũ có thể vượt palette vừa tải
+    rebuildBoard();
+    nextBallId = gameState.nextBallId;
+    selectedBallIndex = gameState.selectedBallIndex;
+    movingBallIndex = gameState.movingBallIndex;
+    puzzleMovesLeft = gameState.puzzleMoves > 0 ? gameState.puzzleMoves : -1;
+    puzzleMoveLimit = qMax(0, gameState.puzzleMoves);
+    puzzleSolution = gameState.puzzleSolution;
+    updateTitle();
+
+    // Restart bouncing for selected ball
+    if (selectedBallIndex >= 0 && selectedBallIndex < balls.size()) {
+        startBouncing(selectedBallIndex);
     }
+
+    updateBallPositions();
 }
@@ -2,7 +2,6 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QTableWidget>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -11,8 +10,28 @@
 #include <QTimer>
 #include <QColor>
 #include <QThread>
-#include "ballthread.h"  // Thêm include này
+#include "animationscheduler.h"
+#include "boardview.h"
 #include "gamesave.h"
+#include "turntask.h"
+#include "palette.h"
+#include "gameboard.h"
+#include "linescan.h"
+#include "board.h"
+#include "pathfinder.h"
+#include "hintengine.h"
+#include "gamerules.h"
+#include "emptyregions.h"
+#include "turnhistory.h"
+#include "rng.h"
+#include "workerpool.h"
+#include "powermetrics.h"
+#include "latencytracker.h"
+#include "puzzle.h"
+#include "spectatorserver.h"
+#include "boardshm.h"
+#include "telemetry.h"
+#include <memory>
 class BallWorker : public QObject {
     Q_OBJECT
 public:
@@ -33,11 +52,47 @@ private:
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
+    friend class RenderBench;   // bench/renderbench.cpp dựng frame trực tiếp
 
 public:
-    explicit MainWindow(QWidget *parent = nullptr);
+    // Bàn và ván đầu tiên dựng theo luật (kích thước --board / --rules) ngay từ đầu
+    explicit MainWindow(const GameRules &rules = GameRules(), QWidget *parent = nullptr);
     ~MainWindow();
 
+    // Chạy lượt chơi không có độ trễ (bot / replay)
+    void setInstantTurns(bool instant) { turnPacing.immediate = instant; }
+
+    // Đổi kích thước bàn (--board RxC) và bắt đầu ván mới
+    void setBoardSize(int rows, int cols);
+    // Luật chơi (--rules file.json): kích thước bàn, hàng, số bóng / màu, kiểu di chuyển.
+    // Bắt đầu ván mới.
+    void setRules(const GameRules &rules);
+    const GameRules &gameRules() const { return rules; }
+    static constexpr int MinBoardSide = 5;      // đủ chỗ cho một hàng 5 (luật chuẩn)
+    static constexpr int MaxBoardSide = 2048;
+    // "RxC", ví dụ "1000x1000"; false nếu sai cú pháp / ngoài [MinBoardSide, MaxBoardSide]
+    static bool parseBoardSize(const QString &text, int &rows, int &cols);
+
+    const LatencyTracker &latencyTracker() const { return latency; }
+
+    // Phát ván cho client local (--serve NAME); false + *error nếu không mở được socket
+    bool startSpectatorServer(const QString &name, QString *error = nullptr);
+    // Bàn trong shared memory cho tool / bot ngoài (--shm NAME, xem boardshm.h)
+    bool startBoardExport(const QString &name, QString *error = nullptr);
+    // Ghi số liệu phiên chơi vào file vòng (--telemetry FILE, xem telemetry.h)
+    bool openTelemetry(const QString &path, QString *error = nullptr);
+
+    GameSave::GameState currentGameState() const;
+    void applyGameState(const GameSave::GameState &gameState);
+
+signals:
+    // Không còn nước đi hợp lệ (bàn đầy) sau một lượt
+    void gameOver(int ballCount);
+    // Puzzle: dọn hết bóng (solved) hoặc hết nước
+    void puzzleEnded(bool solved);
+    // Frame đầu tiên của bàn đã vẽ xong (StartupProfile đã finish)
+    void firstFramePainted();
+
 private slots:
     void onCloseClicked();
     void onRestartClicked();
@@ -51,26 +106,37 @@ private slots:
     void checkAndRemoveLines();
     void onSaveGameClicked();
     void onLoadGameClicked();
+    void onHintClicked();
+    void onGameOver(int ballCount);
+    void onPuzzleClicked();
+    void onPuzzleEnded(bool solved);
+    void onPowerStatsRequested();
+    void onUndoClicked();
+    void onRedoClicked();
 private:
     void setupUi();
     void createMenu();
     void createContent();
     void initializeBalls();
+    void resetBaseColors();
     void updateBallPositions();
     void startBallAnimation();
     void stopBallAnimation();
-    void stopAllThreads();  // Thêm hàm này
+    // chỉ một bóng nảy mỗi lúc; tick trong AnimationScheduler::shared()
+    void startBouncing(int ballIndex);
+    void stopBouncing();
+    bool bounceTick(float dt);
     bool isBallAt(int row, int col);  // Thêm hàm này
-    QColor getRandomColor();
+    quint8 getRandomColor();
     int getRandomInt(int min, int max);
     bool eventFilter(QObject *obj, QEvent *event) override;
-    QVector<QColor> baseColors; // <<< THÊM DÒNG NÀY
+    QVector<quint8> baseColors; // chỉ số màu gốc trong palette
 
     // UI Components
     QWidget *centralWidget;
     QWidget *leftMenu;
     QWidget *rightContent;
-    QTableWidget *table;
+    BoardView *boardView;
     QPushButton *closeButton;
     QPushButton *restartButton;
     QPushButton *randomizeButton;
@@ -80,34 +146,85 @@ private:
     GameSave *gameSave;
     QPushButton *saveGameButton;   // Thêm dòng này
     QPushButton *loadGameButton;   // Thêm dòng này
+    QPushButton *hintButton;
+    QPushButton *puzzleButton;
+    QPushButton *undoButton;
+    QPushButton *redoButton;
     // Ball data
     struct Ball {
         int id;  // Thêm id
         int row;
         int col;
-        QColor color;
+        quint8 colorIndex;  // chỉ số trong palette
         int bounceOffset;  // Đổi từ currentOffsetY
-        BallThread *thread;  // Thêm thread
-        QLabel *ballLabel;
     };
 
     QVector<Ball> balls;
     int nextBallId;  // Thêm biến này
+    Palette palette;
+    GameBoard board;   // 1 byte/ô, đồng bộ với balls
+    PathFinder pathFinder{board};          // khai báo sau board
+    EmptyRegions emptyRegions{board};      // vùng ô trống liên thông, cập nhật theo setCell
+    bool isGameOver = false;
+    Rng rng;                               // mọi số ngẫu nhiên của game; trạng thái lưu trong history
+    TurnHistory history;                   // undo/redo theo delta từng lượt
+    PowerMetrics::Sample powerSample;      // mốc của lần xem thông số điện năng trước
+    LatencyTracker latency;                // click -> hình, từng giai đoạn
+    std::unique_ptr<SpectatorServer> spectators;   // null nếu không --serve
+    std::unique_ptr<BoardShm::Writer> boardExport; // null nếu không --shm
+    std::vector<int> exportChanged;        // ô đổi từ lần ghi shared memory trước
+    bool exportFull = true;                // ghi cả bàn + palette lần tới
+    BoardShm::Status exportStatus;
+    TelemetryRing telemetry;               // chưa open thì mọi lần ghi là no-op
+    int selectedCell() const;
+    void exportBoard();
+    QLabel *latencyHud = nullptr;          // tạo khi có click đầu tiên
+    bool firstFrameSeen = false;
+    void updateLatencyHud();
+    void addBallAt(int row, int col, quint8 colorIndex);
+    void applyHistoryTurn(const TurnHistory::Turn &turn, bool forward);
+    void updateHistoryButtons();
+    void updateTitle();
+    // Puzzle "dọn hết bóng trong K nước": không sinh bóng sau mỗi nước
+    static constexpr int PuzzleMoves = 3;
+    int puzzleMovesLeft = -1;              // -1: ván thường
+    int puzzleMoveLimit = 0;               // K lúc bắt đầu
+    QVector<GameSave::MoveData> puzzleSolution;   // từ thế ban đầu
+    std::vector<int> pathScratch;
+    std::unique_ptr<HintEngine> hintEngine;   // tạo ở lần gợi ý đầu (WorkerPool::shared() mở thread, ~65 µs với 7 thread)
+    int hintFrom = -1;                     // ô gợi ý (chỉ số phẳng), -1 nếu không có
+    int hintTo = -1;
+    LineScanner lineScanner;
+    std::vector<uint8_t> lineMask;
+    std::vector<uint8_t> removeMask;       // removeBallsAt: ô cần xóa
+    bool needsFullLineScan = true;
+    GameRules rules;                       // độ dài hàng, hướng, số bóng sinh ra, kiểu di chuyển
+    void rebuildBoard();
+    void setCell(int row, int col, quint8 colorIndex);
 
     // Animation
     QThread *animationThread;
     BallWorker *ballWorker;
     bool isAnimating;
+    static constexpr float BounceStepSeconds = 0.03f;
+    int bouncingBallId = -1;               // bóng đang nảy, -1 nếu không có
+    int bounceAnimation = 0;               // id trong AnimationScheduler
+    int bounceStep = 0;                    // độ lệch hiện tại -5..5 px
+    int bounceDir = 1;
+    float bounceElapsed = 0;
     // trong class MainWindow (private phần)
     int selectedBallIndex = -1;            // index trong QVector<Ball>, -1 nếu không chọn
-    QTimer *moveTimer = nullptr;
-    QVector<QPoint> currentPath;           // đường đi (list ô) cho movement
-    int currentPathStep = 0;               // bước hiện tại trên path
     int movingBallIndex = -1;              // ball đang di chuyển, -1 nếu không
-    void startMoveAlongPath(const QVector<QPoint> &path, int ballIndex);
-    void stopMovement();
+    TurnTask currentTurn;                  // lượt đang chạy (move -> spawn -> clear)
+    TurnPacing turnPacing;
+    TurnTask playTurn(QVector<QPoint> path, int ballIndex);
+    void finishMove();
+    void cancelTurn();
+    QVector<QPoint> findLinesToRemove();
+    QVector<QPoint> findLinesThrough(const QVector<QPoint> &cells);
+    QVector<QPoint> maskToCells(const uint8_t *mask, int count) const;
+    void removeBallsAt(const QVector<QPoint> &cells);
     QVector<QPoint> findPath(int sr, int sc, int tr, int tc);
-    bool isCellOccupiedExcept(int row, int col, int excludeBallIndex);
 
 };
 
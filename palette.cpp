@@ -0,0 +1,51 @@
+#include "palette.h"
+
+Palette::Palette()
+{
+    m_colors = {
+        QColor(255, 0, 0),     // 1  Red
+        QColor(0, 255, 0),     // 2  Green
+        QColor(0, 0, 255),     // 3  Blue
+        QColor(255, 255, 0),   // 4  Yellow
+        QColor(255, 0, 255),   // 5  Magenta
+        QColor(0, 255, 255),   // 6  Cyan
+        QColor(255, 165, 0),   // 7  Orange
+        QColor(128, 0, 128),   // 8  Purple
+        QColor(255, 192, 203), // 9  Pink
+        QColor(0, 128, 0),     // 10 Dark Green
+        QColor(139, 69, 19),   // 11 Brown
+        QColor(0, 0, 128)      // 12 Navy
+    };
+}
+
+Palette::Palette(const QVector<QColor> &colors)
+    : m_colors(colors.mid(0, MaxColors))
+{
+}
+
+QColor Palette::color(quint8 index) const
+{
+    if (!isValidIndex(index)) return QColor();
+    return m_colors[index - 1];
+}
+
+quint8 Palette::find(const QColor &color) const
+{
+    const QRgb rgb = color.rgb();
+    for (int i = 0; i < m_colors.size(); ++i) {
+        if (m_colors[i].rgb() == rgb) return static_cast<quint8>(i + 1);
+    }
+    return Empty;
+}
+
+quint8 Palette::indexOf(const QColor &color)
+{
+    quint8 index = find(color);
+    if (index != Empty) return index;
+
+    // Bảng đầy: dùng lại màu đầu tiên thay vì tràn chỉ số
+    if (m_colors.size() >= MaxColors) return 1;
+
+    m_colors.append(color);
+    return static_cast<quint8>(m_colors.size());
+}
@@ -0,0 +1,31 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <QColor>
+#include <QVector>
+
+// Bảng màu của game. Bóng chỉ lưu chỉ số 1 byte vào bảng này,
+// chỉ số 0 dành cho ô trống.
+class Palette
+{
+public:
+    static constexpr quint8 Empty = 0;
+    static constexpr int StandardCount = 12;    // số màu của getRandomColor
+    static constexpr int MaxColors = 255;
+
+    Palette();                                  // 12 màu chuẩn (chỉ số 1..12)
+    explicit Palette(const QVector<QColor> &colors);
+
+    int size() const { return m_colors.size(); }            // số màu (không tính Empty)
+    bool isValidIndex(int index) const { return index > 0 && index <= m_colors.size(); }
+    QColor color(quint8 index) const;
+    const QVector<QColor> &colors() const { return m_colors; } // colors()[i] là màu của chỉ số i + 1
+
+    quint8 find(const QColor &color) const;     // Empty nếu chưa có
+    quint8 indexOf(const QColor &color);        // thêm vào bảng nếu chưa có
+
+private:
+    QVector<QColor> m_colors;
+};
+
+#endif // PALETTE_H
@@ -0,0 +1,94 @@
+#include "particlesystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr float Gravity = 6.0f;         // ô / s^2
+constexpr float Drag = 2.5f;            // 1 / s
+constexpr float GhostSize = 0.6f;       // như bóng vẽ (60% ô)
+constexpr float GhostLife = 0.25f;
+constexpr float TwoPi = 6.28318530718f;
+}
+
+ParticleSystem::ParticleSystem(int capacity)
+{
+    const size_t n = static_cast<size_t>(std::max(capacity, 0));
+    m_x.resize(n);
+    m_y.resize(n);
+    m_vx.resize(n);
+    m_vy.resize(n);
+    m_life.resize(n);
+    m_maxLife.resize(n);
+    m_size.resize(n);
+    m_color.resize(n);
+}
+
+void ParticleSystem::spawn(float x, float y, float vx, float vy, float size, float life, uint8_t color)
+{
+    const int i = m_count++;
+    m_x[i] = x;
+    m_y[i] = y;
+    m_vx[i] = vx;
+    m_vy[i] = vy;
+    m_size[i] = size;
+    m_life[i] = m_maxLife[i] = life;
+    m_color[i] = color;
+}
+
+int ParticleSystem::burst(float x, float y, uint8_t color, int count)
+{
+    count = std::min(count, freeSlots());
+    if (count <= 0) return 0;
+
+    spawn(x, y, 0, 0, GhostSize, GhostLife, color);
+    for (int k = 1; k < count; ++k) {
+        const float angle = TwoPi * unit();
+        const float speed = 1.5f + 2.0f * unit();
+        spawn(x, y, speed * std::cos(angle), speed * std::sin(angle) - 1.0f,
+              0.12f + 0.1f * unit(), 0.35f + 0.25f * unit(), color);
+    }
+    return count;
+}
+
+void ParticleSystem::update(float dt)
+{
+    const float damping = std::max(0.0f, 1.0f - Drag * dt);
+    int i = 0;
+    while (i < m_count) {
+        m_life[i] -= dt;
+        if (m_life[i] <= 0) {
+            // swap-remove: hạt cuối lấp chỗ, xét lại chỉ số i
+            const int last = --m_count;
+            m_x[i] = m_x[last];
+            m_y[i] = m_y[last];
+            m_vx[i] = m_vx[last];
+            m_vy[i] = m_vy[last];
+            m_life[i] = m_life[last];
+            m_maxLife[i] = m_maxLife[last];
+            m_size[i] = m_size[last];
+            m_color[i] = m_color[last];
+            continue;
+        }
+        m_vx[i] *= damping;
+        m_vy[i] = m_vy[i] * damping + Gravity * dt;
+        m_x[i] += m_vx[i] * dt;
+        m_y[i] += m_vy[i] * dt;
+        ++i;
+    }
+}
+
+bool ParticleSystem::bounds(float &x0, float &y0, float &x1, float &y1) const
+{
+    if (m_count == 0) return false;
+    x0 = y0 = 1e30f;
+    x1 = y1 = -1e30f;
+    for (int i = 0; i < m_count; ++i) {
+        const float r = m_size[i] * 0.5f;
+        x0 = std::min(x0, m_x[i] - r);
+        y0 = std::min(y0, m_y[i] - r);
+        x1 = std::max(x1, m_x[i] + r);
+        y1 = std::max(y1, m_y[i] + r);
+    }
+    return true;
+}
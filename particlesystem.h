@@ -0,0 +1,61 @@
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include <cstdint>
+#include <vector>
+
+#include "rng.h"
+
+// Fixed-capacity particle pool for line-clear effects, Qt-free.
+//
+// Struct-of-arrays storage sized once in the constructor. Dead particles are
+// swap-removed, so the live ones are always [0, size()). Emitting never
+// allocates, and it stops at the capacity. That caps the update and draw
+// cost of a frame however many balls a chain clear removes.
+//
+// Positions and sizes are in board cells (cell (r, c) spans [c, c+1) x [r, r+1)),
+// so the view can zoom without touching the particles. The effect has its
+// own Rng and never draws from the game's.
+class ParticleSystem
+{
+public:
+    static constexpr int DefaultCapacity = 4096;
+    static constexpr int FragmentsPerBurst = 10;
+
+    explicit ParticleSystem(int capacity = DefaultCapacity);
+
+    int capacity() const { return static_cast<int>(m_x.size()); }
+    int size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    int freeSlots() const { return capacity() - m_count; }
+    void clear() { m_count = 0; }
+
+    // Quả bóng vỡ tại tâm (x, y): 1 hạt "bóng mờ" co lại tại chỗ + tối đa
+    // count - 1 mảnh bắn ra. Trả về số hạt thực sự thêm (cắt theo capacity).
+    int burst(float x, float y, uint8_t color, int count = FragmentsPerBurst + 1);
+
+    void update(float dt);
+
+    // Bounding box of all particles including their size; false if empty
+    bool bounds(float &x0, float &y0, float &x1, float &y1) const;
+
+    float x(int i) const { return m_x[i]; }
+    float y(int i) const { return m_y[i]; }
+    uint8_t color(int i) const { return m_color[i]; }
+    float alpha(int i) const { return m_life[i] / m_maxLife[i]; }          // 1 -> 0
+    float size(int i) const { return m_size[i] * alpha(i); }               // đường kính, co dần
+
+private:
+    float unit() { return static_cast<float>(m_rng.next() >> 40) * (1.0f / 16777216.0f); }   // [0, 1)
+    void spawn(float x, float y, float vx, float vy, float size, float life, uint8_t color);
+
+    std::vector<float> m_x, m_y;
+    std::vector<float> m_vx, m_vy;
+    std::vector<float> m_life, m_maxLife;
+    std::vector<float> m_size;
+    std::vector<uint8_t> m_color;
+    int m_count = 0;
+    Rng m_rng{0x9A271C1E5ull};
+};
+
+#endif // PARTICLESYSTEM_H
@@ -0,0 +1,665 @@
+#include "pathfinder.h"
+#include "board.h"
+#include "gameboard.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+
+namespace {
+
+// min f first; on equal f prefer the deeper node (larger g)
+bool heapAfter(const SearchBuffers::Node &a, const SearchBuffers::Node &b)
+{
+    return a.f > b.f || (a.f == b.f && a.g < b.g);
+}
+
+int sign(int v) { return (v > 0) - (v < 0); }
+
+} // namespace
+
+// -------------------------
+// SearchBuffers
+// -------------------------
+void SearchBuffers::prepare(int cellCount)
+{
+    if (static_cast<int>(m_seen.size()) < cellCount) {
+        m_seen.resize(cellCount, 0);
+        m_closed.resize(cellCount, 0);
+        m_g.resize(cellCount);
+        m_parent.resize(cellCount);
+    }
+    if (++m_generation == 0) {
+        // generation wrapped around: old stamps could match again
+        std::fill(m_seen.begin(), m_seen.end(), 0);
+        std::fill(m_closed.begin(), m_closed.end(), 0);
+        m_generation = 1;
+    }
+    m_heap.clear();
+}
+
+void SearchBuffers::push(int cell, int g, int f)
+{
+    m_heap.push_back(Node{f, g, cell});
+    std::push_heap(m_heap.begin(), m_heap.end(), heapAfter);
+}
+
+SearchBuffers::Node SearchBuffers::pop()
+{
+    std::pop_heap(m_heap.begin(), m_heap.end(), heapAfter);
+    Node node = m_heap.back();
+    m_heap.pop_back();
+    return node;
+}
+
+// -------------------------
+// PathFinder
+// -------------------------
+PathFinder::PathFinder(const GameBoard &board, int clusterSize)
+    : m_board(board),
+    m_algorithm(defaultAlgorithm(board.rows(), board.cols())),
+    m_clusterSize(std::max(4, clusterSize))
+{
+}
+
+PathFinder::Algorithm PathFinder::defaultAlgorithm(int rows, int cols)
+{
+    // HPA* only pays off once a full search would touch a huge area
+    if (static_cast<long long>(rows) * cols >= 512LL * 512LL) return Algorithm::Hierarchical;
+    return Algorithm::JumpPoint;
+}
+
+const char *PathFinder::algorithmName(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::AStar:        return "astar";
+    case Algorithm::JumpPoint:    return "jps";
+    case Algorithm::Hierarchical: return "hpa";
+    }
+    return "?";
+}
+
+bool PathFinder::walkable(int cell) const
+{
+    return m_board.data()[cell] == GameBoard::Empty || cell == m_start;
+}
+
+int PathFinder::manhattan(int a, int b) const
+{
+    const int cols = m_board.cols();
+    return std::abs(a / cols - b / cols) + std::abs(a % cols - b % cols);
+}
+
+bool PathFinder::findPath(int start, int target, std::vector<int> &path)
+{
+    return findPath(start, target, path, m_algorithm);
+}
+
+bool PathFinder::findPath(int start, int target, std::vector<int> &path, Algorithm algorithm)
+{
+    path.clear();
+    const int n = m_board.cellCount();
+    if (start < 0 || start >= n || target < 0 || target >= n) return false;
+    if (start == target) {
+        path.push_back(start);
+        return true;
+    }
+    if (m_board.data()[target] != GameBoard::Empty) return false;
+
+    m_start = start;
+    bool found = false;
+    switch (algorithm) {
+    case Algorithm::AStar:        found = aStar(start, target, path); break;
+    case Algorithm::JumpPoint:    found = jumpPoint(start, target, path); break;
+    case Algorithm::Hierarchical: found = hierarchical(start, target, path); break;
+    }
+    m_start = -1;
+    if (!found) path.clear();
+    return found;
+}
+
+// -------------------------
+// A*
+// -------------------------
+bool PathFinder::aStar(int start, int target, std::vector<int> &path)
+{
+    // neighbour tables do not depend on the line length
+    if (m_board.rows() == 10 && m_board.cols() == 10) return aStarOn(StandardBoard(), start, target, path);
+    return aStarOn(DynamicBoard(m_board.rows(), m_board.cols(), 5), start, target, path);
+}
+
+template <class Geometry>
+bool PathFinder::aStarOn(const Geometry &geo, int start, int target, std::vector<int> &path)
+{
+    m_buffers.prepare(geo.cellCount());
+    m_buffers.setG(start, 0, -1);
+    m_buffers.push(start, 0, manhattan(start, target));
+
+    while (!m_buffers.empty()) {
+        const SearchBuffers::Node node = m_buffers.pop();
+        if (m_buffers.closed(node.cell)) continue;
+        m_buffers.close(node.cell);
+        if (node.cell == target) break;
+
+        geo.forEachNeighbour(node.cell, [&](int next) {
+            if (!walkable(next) || m_buffers.closed(next)) return;
+            const int g = node.g + 1;
+            if (g < m_buffers.g(next)) {
+                m_buffers.setG(next, g, node.cell);
+                m_buffers.push(next, g, g + manhattan(next, target));
+            }
+        });
+    }
+
+    if (!m_buffers.seen(target)) return false;
+    for (int cell = target; cell != -1; cell = m_buffers.parent(cell)) path.push_back(cell);
+    std::reverse(path.begin(), path.end());
+    return true;
+}
+
+// -------------------------
+// Jump Point Search (4-connected)
+//
+// Canonical paths turn from vertical to horizontal only at a forced
+// neighbour, while horizontal runs may branch vertically anywhere. So a
+// horizontal jump stops where a vertical jump from it finds something, and
+// a vertical jump stops at the target or where a side cell opens up right
+// after being blocked one row back.
+// -------------------------
+int PathFinder::jumpVertical(int r, int c, int dr, int target) const
+{
+    const int rows = m_board.rows(), cols = m_board.cols();
+    for (;;) {
+        r += dr;
+        if (r < 0 || r >= rows) return -1;
+        const int cell = r * cols + c;
+        if (!walkable(cell)) return -1;
+        if (cell == target) return cell;
+
+        const int behind = cell - dr * cols;
+        if (c > 0 && walkable(cell - 1) && !walkable(behind - 1)) return cell;
+        if (c + 1 < cols && walkable(cell + 1) && !walkable(behind + 1)) return cell;
+    }
+}
+
+int PathFinder::jumpHorizontal(int r, int c, int dc, int target) const
+{
+    const int cols = m_board.cols();
+    for (;;) {
+        c += dc;
+        if (c < 0 || c >= cols) return -1;
+        const int cell = r * cols + c;
+        if (!walkable(cell)) return -1;
+        if (cell == target) return cell;
+        if (jumpVertical(r, c, -1, target) != -1 || jumpVertical(r, c, 1, target) != -1) return cell;
+    }
+}
+
+bool PathFinder::jumpPoint(int start, int target, std::vector<int> &path)
+{
+    const int cols = m_board.cols();
+    m_buffers.prepare(m_board.cellCount());
+    m_buffers.setG(start, 0, -1);
+    m_buffers.push(start, 0, manhattan(start, target));
+
+    int successors[4];
+    while (!m_buffers.empty()) {
+        const SearchBuffers::Node node = m_buffers.pop();
+        if (m_buffers.closed(node.cell)) continue;
+        m_buffers.close(node.cell);
+        if (node.cell == target) break;
+
+        const int r = node.cell / cols, c = node.cell % cols;
+        const int parent = m_buffers.parent(node.cell);
+        int count = 0;
+        if (parent == -1) {
+            successors[count++] = jumpHorizontal(r, c, -1, target);
+            successors[count++] = jumpHorizontal(r, c, 1, target);
+            successors[count++] = jumpVertical(r, c, -1, target);
+            successors[count++] = jumpVertical(r, c, 1, target);
+        } else if (parent / cols == r) {
+            // arrived horizontally: keep going, or turn up/down
+            successors[count++] = jumpHorizontal(r, c, sign(c - parent % cols), target);
+            successors[count++] = jumpVertical(r, c, -1, target);
+            successors[count++] = jumpVertical(r, c, 1, target);
+        } else {
+            // arrived vertically: keep going, turn only towards forced sides
+            const int dr = sign(r - parent / cols);
+            const int behind = node.cell - dr * cols;
+            successors[count++] = jumpVertical(r, c, dr, target);
+            if (c > 0 && walkable(node.cell - 1) && !walkable(behind - 1))
+                successors[count++] = jumpHorizontal(r, c, -1, target);
+            if (c + 1 < cols && walkable(node.cell + 1) && !walkable(behind + 1))
+                successors[count++] = jumpHorizontal(r, c, 1, target);
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const int next = successors[i];
+            if (next < 0 || m_buffers.closed(next)) continue;
+            const int g = node.g + manhattan(node.cell, next);
+            if (g < m_buffers.g(next)) {
+                m_buffers.setG(next, g, node.cell);
+                m_buffers.push(next, g, g + manhattan(next, target));
+            }
+        }
+    }
+
+    if (!m_buffers.seen(target)) return false;
+
+    // expand the straight segments between jump points
+    for (int cell = target; cell != -1; cell = m_buffers.parent(cell)) path.push_back(cell);
+    std::reverse(path.begin(), path.end());
+    std::vector<int> jumps;
+    jumps.swap(path);
+    path.push_back(jumps.front());
+    for (size_t i = 1; i < jumps.size(); ++i) {
+        const int from = jumps[i - 1], to = jumps[i];
+        const int step = (from / cols == to / cols) ? sign(to - from) : sign(to - from) * cols;
+        for (int cell = from + step; cell != to; cell += step) path.push_back(cell);
+        path.push_back(to);
+    }
+    return true;
+}
+
+// -------------------------
+// Hierarchical (HPA*)
+// -------------------------
+int PathFinder::clusterOf(int cell) const
+{
+    const int cols = m_board.cols();
+    return (cell / cols / m_clusterSize) * m_clusterCols + (cell % cols) / m_clusterSize;
+}
+
+void PathFinder::clusterBounds(int cluster, int &r0, int &c0, int &r1, int &c1) const
+{
+    r0 = (cluster / m_clusterCols) * m_clusterSize;
+    c0 = (cluster % m_clusterCols) * m_clusterSize;
+    r1 = std::min(m_board.rows(), r0 + m_clusterSize) - 1;
+    c1 = std::min(m_board.cols(), c0 + m_clusterSize) - 1;
+}
+
+int PathFinder::horizontalBorder(int clusterRow, int clusterCol) const
+{
+    return clusterRow * (m_clusterCols - 1) + clusterCol;
+}
+
+int PathFinder::verticalBorder(int clusterRow, int clusterCol) const
+{
+    return m_clusterRows * (m_clusterCols - 1) + clusterRow * m_clusterCols + clusterCol;
+}
+
+int PathFinder::entranceIndex(int cluster, int cell) const
+{
+    const std::vector<int> &entrances = m_clusters[cluster].entrances;
+    for (size_t i = 0; i < entrances.size(); ++i) {
+        if (entrances[i] == cell) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void PathFinder::boardReset()
+{
+    if (!m_fixedAlgorithm) m_algorithm = defaultAlgorithm(m_board.rows(), m_board.cols());
+    m_layoutRows = -1;
+    m_layoutCols = -1;
+}
+
+void PathFinder::cellChanged(int cell)
+{
+    // layout not built yet (or reset): ensureClusters() rebuilds everything
+    if (m_layoutRows != m_board.rows() || m_layoutCols != m_board.cols()) return;
+
+    const int k = clusterOf(cell);
+    if (!m_clusters[k].dirty) {
+        m_clusters[k].dirty = true;
+        m_dirtyClusters.push_back(k);
+    }
+
+    // a cell on the cluster edge can open or close an entrance
+    int r0, c0, r1, c1;
+    clusterBounds(k, r0, c0, r1, c1);
+    const int r = cell / m_board.cols(), c = cell % m_board.cols();
+    const int cr = k / m_clusterCols, cc = k % m_clusterCols;
+    auto markBorder = [&](int border) {
+        if (!m_borders[border].dirty) {
+            m_borders[border].dirty = true;
+            m_dirtyBorders.push_back(border);
+        }
+    };
+    if (c == c0 && cc > 0) markBorder(horizontalBorder(cr, cc - 1));
+    if (c == c1 && cc + 1 < m_clusterCols) markBorder(horizontalBorder(cr, cc));
+    if (r == r0 && cr > 0) markBorder(verticalBorder(cr - 1, cc));
+    if (r == r1 && cr + 1 < m_clusterRows) markBorder(verticalBorder(cr, cc));
+}
+
+void PathFinder::ensureClusters()
+{
+    if (m_layoutRows != m_board.rows() || m_layoutCols != m_board.cols()) {
+        m_layoutRows = m_board.rows();
+        m_layoutCols = m_board.cols();
+        m_clusterRows = (m_layoutRows + m_clusterSize - 1) / m_clusterSize;
+        m_clusterCols = (m_layoutCols + m_clusterSize - 1) / m_clusterSize;
+
+        m_clusters.assign(static_cast<size_t>(m_clusterRows) * m_clusterCols, Cluster());
+        m_borders.assign(static_cast<size_t>(m_clusterRows) * (m_clusterCols - 1)
+                             + static_cast<size_t>(m_clusterRows - 1) * m_clusterCols, Border());
+        m_dirtyClusters.clear();
+        m_dirtyBorders.clear();
+        for (size_t i = 0; i < m_clusters.size(); ++i) m_dirtyClusters.push_back(static_cast<int>(i));
+        for (size_t i = 0; i < m_borders.size(); ++i) m_dirtyBorders.push_back(static_cast<int>(i));
+
+        const size_t local = static_cast<size_t>(m_clusterSize) * m_clusterSize;
+        m_localSeen.assign(local, 0);
+        m_localDist.assign(local, 0);
+        m_localParent.assign(local, -1);
+        m_localGeneration = 0;
+    }
+
+    for (int border : m_dirtyBorders) {
+        if (m_borders[border].dirty) rebuildBorder(border);
+    }
+    m_dirtyBorders.clear();
+
+    for (int cluster : m_dirtyClusters) {
+        if (m_clusters[cluster].dirty) rebuildCluster(cluster);
+    }
+    m_dirtyClusters.clear();
+}
+
+void PathFinder::rebuildBorder(int border)
+{
+    const int cols = m_board.cols();
+    const uint8_t *cells = m_board.data();
+    Border &b = m_borders[border];
+    b.pairs.clear();
+    b.dirty = false;
+
+    const int horizontalCount = m_clusterRows * (m_clusterCols - 1);
+    int clusterA, clusterB;
+    int first, last, stepAlong, across;     // cellA of the first pair, ...
+    if (border < horizontalCount) {
+        const int cr = border / (m_clusterCols - 1), cc = border % (m_clusterCols - 1);
+        clusterA = cr * m_clusterCols + cc;
+        clusterB = clusterA + 1;
+        const int colA = (cc + 1) * m_clusterSize - 1;
+        const int rowEnd = std::min(m_board.rows(), (cr + 1) * m_clusterSize) - 1;
+        first = cr * m_clusterSize * cols + colA;
+        last = rowEnd * cols + colA;
+        stepAlong = cols;
+        across = 1;
+    } else {
+        const int index = border - horizontalCount;
+        const int cr = index / m_clusterCols, cc = index % m_clusterCols;
+        clusterA = cr * m_clusterCols + cc;
+        clusterB = clusterA + m_clusterCols;
+        const int rowA = (cr + 1) * m_clusterSize - 1;
+        const int colEnd = std::min(cols, (cc + 1) * m_clusterSize) - 1;
+        first = rowA * cols + cc * m_clusterSize;
+        last = rowA * cols + colEnd;
+        stepAlong = 1;
+        across = cols;
+    }
+
+    // one transition in the middle of every open segment of the border
+    int segmentStart = -1;
+    for (int cell = first;; cell += stepAlong) {
+        const bool inside = cell <= last;
+        const bool open = inside && cells[cell] == GameBoard::Empty && cells[cell + across] == GameBoard::Empty;
+        if (open && segmentStart < 0) segmentStart = cell;
+        if (!open && segmentStart >= 0) {
+            const int count = (cell - segmentStart) / stepAlong;
+            const int mid = segmentStart + (count / 2) * stepAlong;
+            b.pairs.push_back(mid);
+            b.pairs.push_back(mid + across);
+            segmentStart = -1;
+        }
+        if (!inside) break;
+    }
+
+    for (int k : { clusterA, clusterB }) {
+        if (!m_clusters[k].dirty) {
+            m_clusters[k].dirty = true;
+            m_dirtyClusters.push_back(k);
+        }
+    }
+}
+
+void PathFinder::rebuildCluster(int cluster)
+{
+    Cluster &cl = m_clusters[cluster];
+    cl.entrances.clear();
+    cl.partners.clear();
+    cl.intra.clear();
+    cl.dirty = false;
+
+    auto addEntrance = [&](int cell, int partner) {
+        int index = entranceIndex(cluster, cell);
+        if (index < 0) {
+            index = static_cast<int>(cl.entrances.size());
+            cl.entrances.push_back(cell);
+            cl.partners.emplace_back();
+        }
+        cl.partners[index].push_back(partner);
+    };
+
+    const int cr = cluster / m_clusterCols, cc = cluster % m_clusterCols;
+    int borders[4];
+    int count = 0;
+    if (cc > 0) borders[count++] = horizontalBorder(cr, cc - 1);
+    if (cc + 1 < m_clusterCols) borders[count++] = horizontalBorder(cr, cc);
+    if (cr > 0) borders[count++] = verticalBorder(cr - 1, cc);
+    if (cr + 1 < m_clusterRows) borders[count++] = verticalBorder(cr, cc);
+
+    for (int i = 0; i < count; ++i) {
+        const std::vector<int> &pairs = m_borders[borders[i]].pairs;
+        for (size_t p = 0; p + 1 < pairs.size(); p += 2) {
+            if (clusterOf(pairs[p]) == cluster) addEntrance(pairs[p], pairs[p + 1]);
+            else addEntrance(pairs[p + 1], pairs[p]);
+        }
+    }
+
+    cl.intra.resize(cl.entrances.size());
+    for (size_t i = 0; i < cl.entrances.size(); ++i) {
+        clusterBfs(cluster, cl.entrances[i], -1);
+        for (size_t j = 0; j < cl.entrances.size(); ++j) {
+            if (i == j) continue;
+            const int d = localDist(cluster, cl.entrances[j]);
+            if (d >= 0) cl.intra[i].push_back(Edge{cl.entrances[j], d});
+        }
+    }
+}
+
+void PathFinder::clusterBfs(int cluster, int from, int allowCell)
+{
+    if (++m_localGeneration == 0) {
+        std::fill(m_localSeen.begin(), m_localSeen.end(), 0);
+        m_localGeneration = 1;
+    }
+
+    int r0, c0, r1, c1;
+    clusterBounds(cluster, r0, c0, r1, c1);
+    const int cols = m_board.cols();
+    const uint8_t *cells = m_board.data();
+    auto localIndex = [&](int cell) { return (cell / cols - r0) * m_clusterSize + (cell % cols - c0); };
+
+    m_queue.clear();
+    m_queue.push_back(from);
+    const int start = localIndex(from);
+    m_localSeen[start] = m_localGeneration;
+    m_localDist[start] = 0;
+    m_localParent[start] = -1;
+
+    for (size_t head = 0; head < m_queue.size(); ++head) {
+        const int cell = m_queue[head];
+        const int r = cell / cols, c = cell % cols;
+        const int dist = m_localDist[localIndex(cell)];
+        for (int k = 0; k < 4; ++k) {
+            const int nr = r + BoardDirections::StepRow[k];
+            const int nc = c + BoardDirections::StepCol[k];
+            if (nr < r0 || nr > r1 || nc < c0 || nc > c1) continue;
+            const int next = nr * cols + nc;
+            if (cells[next] != GameBoard::Empty && next != allowCell) continue;
+            const int local = localIndex(next);
+            if (m_localSeen[local] == m_localGeneration) continue;
+            m_localSeen[local] = m_localGeneration;
+            m_localDist[local] = dist + 1;
+            m_localParent[local] = cell;
+            m_queue.push_back(next);
+        }
+    }
+}
+
+int PathFinder::localDist(int cluster, int cell) const
+{
+    int r0, c0, r1, c1;
+    clusterBounds(cluster, r0, c0, r1, c1);
+    const int cols = m_board.cols();
+    const int r = cell / cols, c = cell % cols;
+    if (r < r0 || r > r1 || c < c0 || c > c1) return -1;
+    const int local = (r - r0) * m_clusterSize + (c - c0);
+    return m_localSeen[local] == m_localGeneration ? m_localDist[local] : -1;
+}
+
+bool PathFinder::appendClusterPath(int cluster, int from, int to, int allowCell, std::vector<int> &path)
+{
+    if (from == to) return true;
+    clusterBfs(cluster, from, allowCell);
+    if (localDist(cluster, to) < 0) return false;
+
+    int r0, c0, r1, c1;
+    clusterBounds(cluster, r0, c0, r1, c1);
+    const int cols = m_board.cols();
+    const size_t mark = path.size();
+    for (int cell = to; cell != from;) {
+        path.push_back(cell);
+        cell = m_localParent[(cell / cols - r0) * m_clusterSize + (cell % cols - c0)];
+    }
+    std::reverse(path.begin() + static_cast<std::ptrdiff_t>(mark), path.end());
+    return true;
+}
+
+bool PathFinder::hierarchical(int start, int target, std::vector<int> &path)
+{
+    ensureClusters();
+
+    const int cols = m_board.cols();
+    const uint8_t *cells = m_board.data();
+    const int startCluster = clusterOf(start);
+    const int targetCluster = clusterOf(target);
+
+    // ---- temporary edges out of start ----
+    m_startEdges.clear();
+    std::vector<int> &startVia = m_startVia;
+    startVia.clear();
+    auto addStartEdge = [&](int cell, int cost, int via) {
+        for (size_t i = 0; i < m_startEdges.size(); ++i) {
+            if (m_startEdges[i].cell != cell) continue;
+            if (cost < m_startEdges[i].cost) {
+                m_startEdges[i].cost = cost;
+                startVia[i] = via;
+            }
+            return;
+        }
+        m_startEdges.push_back(Edge{cell, cost});
+        startVia.push_back(via);
+    };
+    auto connectFrom = [&](int cluster, int from, int baseCost, int via) {
+        clusterBfs(cluster, from, start);
+        for (int entrance : m_clusters[cluster].entrances) {
+            const int d = localDist(cluster, entrance);
+            if (d >= 0) addStartEdge(entrance, baseCost + d, via);
+        }
+        if (cluster == targetCluster) {
+            const int d = localDist(cluster, target);
+            if (d >= 0) addStartEdge(target, baseCost + d, via);
+        }
+    };
+
+    connectFrom(startCluster, start, 0, -1);
+    // the ball's own cell is never an entrance (it is occupied), so also
+    // step straight across a cluster edge from it
+    const int sr = start / cols, sc = start % cols;
+    for (int k = 0; k < 4; ++k) {
+        const int nr = sr + BoardDirections::StepRow[k];
+        const int nc = sc + BoardDirections::StepCol[k];
+        if (!m_board.inBounds(nr, nc)) continue;
+        const int next = nr * cols + nc;
+        if (cells[next] != GameBoard::Empty || clusterOf(next) == startCluster) continue;
+        connectFrom(clusterOf(next), next, 1, next);
+    }
+
+    // ---- temporary edges into target ----
+    m_targetEdges.clear();
+    clusterBfs(targetCluster, target, -1);
+    for (int entrance : m_clusters[targetCluster].entrances) {
+        const int d = localDist(targetCluster, entrance);
+        if (d >= 0) m_targetEdges.push_back(Edge{entrance, d});
+    }
+
+    // ---- A* over entrances ----
+    m_buffers.prepare(m_board.cellCount());
+    m_buffers.setG(start, 0, -1);
+    m_buffers.push(start, 0, manhattan(start, target));
+    auto relax = [&](int from, int fromG, int next, int cost) {
+        if (m_buffers.closed(next)) return;
+        const int g = fromG + cost;
+        if (g < m_buffers.g(next)) {
+            m_buffers.setG(next, g, from);
+            m_buffers.push(next, g, g + manhattan(next, target));
+        }
+    };
+
+    while (!m_buffers.empty()) {
+        const SearchBuffers::Node node = m_buffers.pop();
+        if (m_buffers.closed(node.cell)) continue;
+        m_buffers.close(node.cell);
+        if (node.cell == target) break;
+
+        if (node.cell == start) {
+            for (const Edge &edge : m_startEdges) relax(node.cell, node.g, edge.cell, edge.cost);
+            continue;
+        }
+        const int cluster = clusterOf(node.cell);
+        const int index = entranceIndex(cluster, node.cell);
+        if (index < 0) continue;
+        const Cluster &cl = m_clusters[cluster];
+        for (const Edge &edge : cl.intra[index]) relax(node.cell, node.g, edge.cell, edge.cost);
+        for (int partner : cl.partners[index]) relax(node.cell, node.g, partner, 1);
+        if (cluster == targetCluster) {
+            for (const Edge &edge : m_targetEdges) {
+                if (edge.cell == node.cell) relax(node.cell, node.g, target, edge.cost);
+            }
+        }
+    }
+    if (!m_buffers.seen(target)) return false;
+
+    // ---- refine abstract hops into cells ----
+    std::vector<int> hops;
+    for (int cell = target; cell != -1; cell = m_buffers.parent(cell)) hops.push_back(cell);
+    std::reverse(hops.begin(), hops.end());
+
+    path.push_back(start);
+    for (size_t i = 1; i < hops.size(); ++i) {
+        const int from = hops[i - 1], to = hops[i];
+        bool ok;
+        if (from == start) {
+            int via = -1;
+            for (size_t e = 0; e < m_startEdges.size(); ++e) {
+                if (m_startEdges[e].cell == to) via = startVia[e];
+            }
+            if (via < 0) {
+                ok = appendClusterPath(startCluster, start, to, start, path);
+            } else {
+                path.push_back(via);
+                ok = appendClusterPath(clusterOf(via), via, to, -1, path);
+            }
+        } else if (manhattan(from, to) == 1 && clusterOf(from) != clusterOf(to)) {
+            path.push_back(to);
+            ok = true;
+        } else {
+            ok = appendClusterPath(clusterOf(from), from, to, -1, path);
+        }
+        if (!ok) return false;      // cluster data out of date: should not happen
+    }
+    return true;
+}
@@ -0,0 +1,157 @@
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+#include <cstdint>
+#include <vector>
+
+class GameBoard;
+
+// Generation-stamped scratch space for grid searches. prepare() invalidates
+// everything in O(1) by bumping the generation, so searches never clear or
+// allocate per call once the buffers have grown to the board size.
+class SearchBuffers
+{
+public:
+    void prepare(int cellCount);
+
+    bool seen(int cell) const { return m_seen[cell] == m_generation; }
+    bool closed(int cell) const { return m_closed[cell] == m_generation; }
+    int g(int cell) const { return seen(cell) ? m_g[cell] : INT32_MAX; }
+    int parent(int cell) const { return m_parent[cell]; }
+
+    void setG(int cell, int g, int parent)
+    {
+        m_seen[cell] = m_generation;
+        m_g[cell] = g;
+        m_parent[cell] = parent;
+    }
+    void close(int cell) { m_closed[cell] = m_generation; }
+
+    // open list: binary min-heap on f, ties broken towards larger g
+    struct Node {
+        int f;
+        int g;
+        int cell;
+    };
+    void push(int cell, int g, int f);
+    Node pop();
+    bool empty() const { return m_heap.empty(); }
+
+private:
+    uint32_t m_generation = 0;
+    std::vector<uint32_t> m_seen;
+    std::vector<uint32_t> m_closed;
+    std::vector<int> m_g;
+    std::vector<int> m_parent;
+    std::vector<Node> m_heap;
+};
+
+// Pathfinding on a GameBoard: a ball moves up/down/left/right through empty
+// cells. Three interchangeable searches share the same buffers:
+//  - AStar:        plain A*, neighbours from Board<>/DynamicBoard
+//  - JumpPoint:    Jump Point Search for 4-connected uniform grids;
+//                  same optimal length as A*, far fewer heap operations
+//  - Hierarchical: HPA* over clusters of clusterSize x clusterSize cells.
+//                  Entrances and intra-cluster distances are rebuilt lazily
+//                  for the clusters touched by cellChanged(). Near-optimal,
+//                  meant for very large boards.
+class PathFinder
+{
+public:
+    enum class Algorithm { AStar, JumpPoint, Hierarchical };
+
+    explicit PathFinder(const GameBoard &board, int clusterSize = 16);
+
+    static Algorithm defaultAlgorithm(int rows, int cols);
+    static const char *algorithmName(Algorithm algorithm);
+
+    Algorithm algorithm() const { return m_algorithm; }
+    // Chọn cố định; không gọi thì boardReset() chọn lại theo kích thước bàn
+    void setAlgorithm(Algorithm algorithm)
+    {
+        m_algorithm = algorithm;
+        m_fixedAlgorithm = true;
+    }
+
+    // Báo ô vừa đổi giữa trống <-> có bóng (giữ cluster của HPA* đúng)
+    void cellChanged(int cell);
+    // Cả bàn vừa thay đổi (load, random, đổi kích thước); chọn lại thuật toán
+    void boardReset();
+
+    // Path from start (the moving ball's own cell, treated as walkable) to
+    // target, both included, as flat cell indices. False if unreachable.
+    bool findPath(int start, int target, std::vector<int> &path);
+    bool findPath(int start, int target, std::vector<int> &path, Algorithm algorithm);
+
+private:
+    bool walkable(int cell) const;
+    int manhattan(int a, int b) const;
+
+    bool aStar(int start, int target, std::vector<int> &path);
+    template <class Geometry>
+    bool aStarOn(const Geometry &geo, int start, int target, std::vector<int> &path);
+
+    bool jumpPoint(int start, int target, std::vector<int> &path);
+    int jumpHorizontal(int r, int c, int dc, int target) const;
+    int jumpVertical(int r, int c, int dr, int target) const;
+
+    // ---- HPA* ----
+    struct Edge {
+        int cell;
+        int cost;
+    };
+    struct Cluster {
+        std::vector<int> entrances;             // entrance cells inside this cluster
+        std::vector<std::vector<Edge>> intra;   // distances between entrances (within cluster)
+        std::vector<std::vector<int>> partners; // neighbouring entrance across a border
+        bool dirty = true;
+    };
+    struct Border {
+        std::vector<int> pairs;                 // cellA, cellB, cellA, cellB ...
+        bool dirty = true;
+    };
+
+    bool hierarchical(int start, int target, std::vector<int> &path);
+    void ensureClusters();
+    void rebuildBorder(int border);
+    void rebuildCluster(int cluster);
+    int clusterOf(int cell) const;
+    int entranceIndex(int cluster, int cell) const;
+    void clusterBounds(int cluster, int &r0, int &c0, int &r1, int &c1) const;
+    // BFS inside one cluster from `from`; fills m_local dist/parent
+    void clusterBfs(int cluster, int from, int allowCell);
+    int localDist(int cluster, int cell) const;
+    bool appendClusterPath(int cluster, int from, int to, int allowCell, std::vector<int> &path);
+    int horizontalBorder(int clusterRow, int clusterCol) const;  // giữa (i,j) và (i,j+1)
+    int verticalBorder(int clusterRow, int clusterCol) const;    // giữa (i,j) và (i+1,j)
+
+    const GameBoard &m_board;
+    Algorithm m_algorithm;
+    bool m_fixedAlgorithm = false;  // setAlgorithm đã chọn
+    int m_start = -1;           // ô của bóng đang tìm đường (coi như trống)
+    SearchBuffers m_buffers;
+
+    int m_clusterSize;
+    int m_clusterRows = 0;
+    int m_clusterCols = 0;
+    int m_layoutRows = -1;
+    int m_layoutCols = -1;
+    std::vector<Cluster> m_clusters;
+    std::vector<Border> m_borders;
+    std::vector<int> m_dirtyClusters;
+    std::vector<int> m_dirtyBorders;
+
+    // cluster-local BFS scratch (generation stamped)
+    uint32_t m_localGeneration = 0;
+    std::vector<uint32_t> m_localSeen;
+    std::vector<int> m_localDist;
+    std::vector<int> m_localParent;
+    std::vector<int> m_queue;
+
+    // HPA* query: edges from start / into target
+    std::vector<Edge> m_startEdges;
+    std::vector<Edge> m_targetEdges;
+    std::vector<int> m_startVia;         // via cell per start edge (-1: inside start cluster)
+};
+
+#endif // PATHFINDER_H
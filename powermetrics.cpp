@@ -0,0 +1,65 @@
+#include "powermetrics.h"
+
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+std::atomic<uint64_t> PowerMetrics::s_wakeups{0};
+
+double PowerMetrics::processCpuSeconds()
+{
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0;
+    auto seconds = [](const FILETIME &t) {
+        return ((static_cast<uint64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime) * 1e-7;   // đơn vị 100 ns
+    };
+    return seconds(kernel) + seconds(user);
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    auto seconds = [](const timeval &t) { return t.tv_sec + t.tv_usec * 1e-6; };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+#endif
+}
+
+uint64_t PowerMetrics::peakRssBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof counters)) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);          // byte
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;   // KB
+#endif
+#endif
+}
+
+PowerMetrics::Sample PowerMetrics::sample()
+{
+    Sample s;
+    s.wakeups = wakeups();
+    s.cpuSeconds = processCpuSeconds();
+    s.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return s;
+}
+
+PowerMetrics::Rates PowerMetrics::rates(const Sample &from, const Sample &to)
+{
+    Rates r;
+    r.seconds = to.wallSeconds - from.wallSeconds;
+    if (r.seconds <= 0) return r;
+    r.wakeupsPerSecond = (to.wakeups - from.wakeups) / r.seconds;
+    r.cpuPercent = 100.0 * (to.cpuSeconds - from.cpuSeconds) / r.seconds;
+    return r;
+}
@@ -0,0 +1,40 @@
+#ifndef POWERMETRICS_H
+#define POWERMETRICS_H
+
+#include <atomic>
+#include <cstdint>
+
+// Process-wide idle-cost counters, Qt-free.
+//
+// Every place that wakes up on its own (AnimationScheduler ticks, TurnDelay timers)
+// calls recordWakeup(). Two samples give wake-ups per second and the share
+// of one core the whole process used in between; an idle window should
+// show 0 wake-ups/s and ~0% CPU.
+class PowerMetrics
+{
+public:
+    struct Sample {
+        uint64_t wakeups = 0;
+        double cpuSeconds = 0;      // user + system, mọi thread của process
+        double wallSeconds = 0;     // đồng hồ đơn điệu
+    };
+    struct Rates {
+        double wakeupsPerSecond = 0;
+        double cpuPercent = 0;      // 100 = một core chạy liên tục
+        double seconds = 0;
+    };
+
+    static void recordWakeup() { s_wakeups.fetch_add(1, std::memory_order_relaxed); }
+    static uint64_t wakeups() { return s_wakeups.load(std::memory_order_relaxed); }
+
+    static double processCpuSeconds();
+    // Bộ nhớ thường trú cao nhất của process từ lúc chạy (0 nếu không đọc được)
+    static uint64_t peakRssBytes();
+    static Sample sample();
+    static Rates rates(const Sample &from, const Sample &to);
+
+private:
+    static std::atomic<uint64_t> s_wakeups;
+};
+
+#endif // POWERMETRICS_H
@@ -0,0 +1,355 @@
+#include "puzzle.h"
+#include "board.h"
+#include "linescan.h"
+#include "workerpool.h"
+
+#include <algorithm>
+
+namespace {
+
+// Seed của puzzle thứ i (như episodeSeed của GymBatch)
+uint64_t puzzleSeed(uint64_t seed, int index)
+{
+    Rng mix(seed ^ (static_cast<uint64_t>(index) * 0x9E3779B97F4A7C15ull));
+    return mix.next();
+}
+
+GameRules withoutSpawns(GameRules rules)
+{
+    rules.spawnPerTurn = 0;
+    return rules;
+}
+
+} // namespace
+
+bool Puzzle::verify() const
+{
+    if (cells.size() != static_cast<size_t>(rules.rows) * rules.cols) return false;
+    if (static_cast<int>(solution.size()) > moveLimit) return false;
+
+    GameEngine engine(withoutSpawns(rules));
+    engine.load(cells.data(), seed);
+    for (const PuzzleMove &move : solution) {
+        if (!engine.step(move.from, move.to).legal) return false;
+    }
+    return engine.regions().ballCount() == 0;
+}
+
+PuzzleSolver::PuzzleSolver(const GameRules &rules)
+    : m_rules(withoutSpawns(rules)),
+    m_engine(m_rules)
+{
+    m_engine.setHistoryEnabled(true);   // undo để quay lui
+}
+
+bool PuzzleSolver::solve(const uint8_t *cells, int maxMoves, std::vector<PuzzleMove> &solution, int64_t nodeBudget)
+{
+    m_engine.load(cells, 0);
+    m_dead.clear();
+    m_path.clear();
+    if (static_cast<int>(m_moves.size()) < maxMoves + 1) m_moves.resize(maxMoves + 1);
+    m_budget = nodeBudget;
+    m_nodes = 0;
+    m_aborted = false;
+
+    const bool found = search(maxMoves);
+    m_totalNodes += m_nodes;
+    if (found) solution = m_path;
+    return found;
+}
+
+uint64_t PuzzleSolver::stateKey(int movesLeft) const
+{
+    // FNV-1a 64 trên các ô, trộn thêm số nước còn lại
+    uint64_t hash = 14695981039346656037ull ^ static_cast<uint64_t>(movesLeft);
+    const GameBoard &board = m_engine.board();
+    const uint8_t *cells = board.data();
+    for (int i = 0; i < board.cellCount(); ++i) hash = (hash ^ cells[i]) * 1099511628211ull;
+    return hash;
+}
+
+// Không thêm bóng: một màu còn 1..L-1 bóng thì không xóa hết được nữa.
+// Mỗi nước xóa tối đa 4 hàng qua một ô.
+bool PuzzleSolver::hopeless() const
+{
+    const GameBoard &board = m_engine.board();
+    int counts[256] = {};
+    const uint8_t *cells = board.data();
+    for (int i = 0; i < board.cellCount(); ++i) ++counts[cells[i]];
+    for (int color = 1; color < 256; ++color) {
+        if (counts[color] > 0 && counts[color] < m_rules.lineLength) return true;
+    }
+    return false;
+}
+
+void PuzzleSolver::clearingMoves(std::vector<PuzzleMove> &moves)
+{
+    moves.clear();
+    const GameBoard &board = m_engine.board();
+    const int rows = board.rows(), cols = board.cols(), L = m_rules.lineLength;
+    const unsigned dirs = m_rules.lineDirections;
+    const uint8_t *cells = board.data();
+
+    // số bóng cùng màu liền kề ô theo hướng d, chiều sign
+    auto run = [&](int r, int c, int d, int sign, uint8_t color) {
+        int count = 0;
+        for (int k = 1; k < L; ++k) {
+            const int rr = r + sign * k * BoardDirections::LineRow[d], cc = c + sign * k * BoardDirections::LineCol[d];
+            if (rr < 0 || rr >= rows || cc < 0 || cc >= cols || cells[rr * cols + cc] != color) break;
+            ++count;
+        }
+        return count;
+    };
+    // bóng càng ít hàng xóm cùng màu càng nên đi trước (không phá hàng khác)
+    auto neighbours = [&](int cell) {
+        const int r = cell / cols, c = cell % cols;
+        int count = 0;
+        for (int d = 0; d < 4; ++d) count += run(r, c, d, 1, cells[cell]) + run(r, c, d, -1, cells[cell]);
+        return count;
+    };
+
+    for (std::vector<int> &balls : m_ballsOf) balls.clear();
+    for (int cell = 0; cell < board.cellCount(); ++cell) {
+        if (cells[cell] != GameBoard::Empty) m_ballsOf[cells[cell]].push_back(cell);
+    }
+
+    std::vector<Scored> &scored = m_scored;
+    scored.clear();
+    for (int target = 0; target < board.cellCount(); ++target) {
+        if (cells[target] != GameBoard::Empty) continue;
+        const int r = target / cols, c = target % cols;
+
+        // màu nào thêm vào ô này thì thành hàng
+        uint8_t colors[8];
+        int colorCount = 0;
+        for (int d = 0; d < 4; ++d) {
+            if (!(dirs >> d & 1u)) continue;
+            for (int sign = -1; sign <= 1; sign += 2) {
+                const int rr = r + sign * BoardDirections::LineRow[d], cc = c + sign * BoardDirections::LineCol[d];
+                if (rr < 0 || rr >= rows || cc < 0 || cc >= cols) continue;
+                const uint8_t color = cells[rr * cols + cc];
+                if (color == GameBoard::Empty || std::find(colors, colors + colorCount, color) != colors + colorCount)
+                    continue;
+                if (1 + run(r, c, d, 1, color) + run(r, c, d, -1, color) >= L) colors[colorCount++] = color;
+            }
+        }
+        if (colorCount == 0) continue;
+
+        for (int i = 0; i < colorCount; ++i) {
+            for (int from : m_ballsOf[colors[i]]) {
+                if (m_engine.canMove(from, target)) scored.push_back(Scored{ neighbours(from), PuzzleMove{ from, target } });
+            }
+        }
+    }
+    std::stable_sort(scored.begin(), scored.end(), [](const Scored &a, const Scored &b) { return a.score < b.score; });
+    for (const Scored &s : scored) moves.push_back(s.move);
+}
+
+bool PuzzleSolver::search(int movesLeft)
+{
+    const int balls = m_engine.regions().ballCount();
+    if (balls == 0) return true;
+    const int maxClear = 4 * (m_rules.lineLength - 1) + 1;
+    if (movesLeft == 0 || balls > movesLeft * maxClear || hopeless()) return false;
+
+    const uint64_t key = stateKey(movesLeft);
+    if (m_dead.count(key)) {
+        ++m_memoHits;
+        return false;
+    }
+    if (++m_nodes > m_budget) {
+        m_aborted = true;
+        return false;
+    }
+
+    // danh sách riêng cho từng độ sâu: lời gọi đệ quy không ghi đè
+    std::vector<PuzzleMove> &moves = m_moves[movesLeft];
+    clearingMoves(moves);
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const PuzzleMove move = moves[i];
+        const GameEngine::StepResult result = m_engine.step(move.from, move.to);
+        if (!result.legal) continue;
+        if (result.cleared > 0) {
+            m_path.push_back(move);
+            if (search(movesLeft - 1)) return true;
+            m_path.pop_back();
+        }
+        m_engine.undo();
+        if (m_aborted) return false;
+    }
+    m_dead.insert(key);
+    return false;
+}
+
+int PuzzleSolver::deadEnds(const uint8_t *cells, int maxMoves, int64_t nodeBudget, int enough)
+{
+    if (maxMoves < 2) return 0;
+    m_engine.load(cells, 0);
+    std::vector<PuzzleMove> moves;
+    clearingMoves(moves);
+
+    const int n = m_engine.board().cellCount();
+    std::vector<uint8_t> after(n);
+    std::vector<PuzzleMove> solution;
+    int dead = 0;
+    // clearingMoves xếp bóng lẻ lên trước; bóng lấy từ hàng khác (hay là bẫy) ở cuối
+    for (size_t i = moves.size(); i-- > 0 && dead < enough;) {
+        const PuzzleMove &move = moves[i];
+        // solve() nạp lại engine: dựng lại bàn đầu cho từng nước
+        m_engine.load(cells, 0);
+        const GameEngine::StepResult result = m_engine.step(move.from, move.to);
+        if (!result.legal || result.cleared == 0) continue;
+        std::copy(m_engine.board().data(), m_engine.board().data() + n, after.begin());
+        if (!solve(after.data(), maxMoves - 1, solution, nodeBudget) && !m_aborted) ++dead;
+    }
+    return dead;
+}
+
+GameRules PuzzleGenerator::rulesFor(const Options &options)
+{
+    return withoutSpawns(options.rules);
+}
+
+bool PuzzleGenerator::generateOne(uint64_t seed, const Options &options, PuzzleSolver &solver, Puzzle &puzzle,
+                                  Stats *stats)
+{
+    const GameRules &rules = options.rules;
+    const int rows = rules.rows, cols = rules.cols, L = rules.lineLength, n = rows * cols;
+    const int minDeadEnds = options.moves > 1 ? options.minDeadEnds : 0;
+    Rng rng(seed);
+    LineScanner scanner;
+    std::vector<uint8_t> cells(n), reserved(n), mask(n);
+    std::vector<int> lineBalls;             // bóng của các hàng đã dựng (ô cắt được)
+    std::vector<PuzzleMove> solution;
+    const int64_t nodesBefore = solver.nodes(), memoBefore = solver.memoHits();
+    bool found = false;
+
+    int directions[4];
+    int directionCount = 0;
+    for (int d = 0; d < 4; ++d) {
+        if (rules.lineDirections >> d & 1u) directions[directionCount++] = d;
+    }
+    if (directionCount == 0) return false;
+
+    // ô trống chưa dành cho hàng / bóng nào
+    auto isFree = [&](int cell) { return cells[cell] == GameBoard::Empty && !reserved[cell]; };
+
+    for (int attempt = 0; attempt < options.maxAttempts && !found; ++attempt) {
+        if (stats) ++stats->attempts;
+        std::fill(cells.begin(), cells.end(), GameBoard::Empty);
+        std::fill(reserved.begin(), reserved.end(), 0);
+        lineBalls.clear();
+        int ordered = 0;
+
+        bool built = true;
+        for (int line = 0; line < options.moves && built; ++line) {
+            // nửa số hàng (trừ hàng đầu) thiếu đúng một ô đang có bóng của hàng trước
+            const bool cross = !lineBalls.empty() && rules.colorCount > 1 && rng.below(2) == 0;
+            uint8_t lineColor = GameBoard::Empty;
+            built = false;
+            for (int tries = 0; tries < 64 && !built; ++tries) {
+                const int d = directions[rng.below(directionCount)];
+                const int dr = BoardDirections::LineRow[d], dc = BoardDirections::LineCol[d];
+                int r, c, gap, crossCell = -1;
+                if (cross) {
+                    crossCell = lineBalls[rng.below(static_cast<uint32_t>(lineBalls.size()))];
+                    gap = static_cast<int>(rng.below(L));
+                    r = crossCell / cols - gap * dr;
+                    c = crossCell % cols - gap * dc;
+                } else {
+                    r = static_cast<int>(rng.below(rows));
+                    c = static_cast<int>(rng.below(cols));
+                    gap = static_cast<int>(rng.below(L));
+                }
+                const int rEnd = r + (L - 1) * dr, cEnd = c + (L - 1) * dc;
+                if (r < 0 || r >= rows || c < 0 || c >= cols || rEnd < 0 || rEnd >= rows || cEnd < 0 || cEnd >= cols)
+                    continue;
+                bool free = true;
+                for (int k = 0; k < L && free; ++k) free = (cross && k == gap) || isFree((r + k * dr) * cols + c + k * dc);
+                if (!free) continue;
+
+                // màu khác bóng ở ô cắt, không thì hàng đã đủ ngay từ đầu
+                uint8_t color = static_cast<uint8_t>(rng.range(1, rules.colorCount));
+                if (cross) {
+                    while (color == cells[crossCell]) color = static_cast<uint8_t>(rng.range(1, rules.colorCount));
+                }
+
+                // L-1 bóng trên hàng; ô thiếu vẫn được giữ (trống, hoặc bóng của hàng bị cắt)
+                for (int k = 0; k < L; ++k) {
+                    const int cell = (r + k * dr) * cols + c + k * dc;
+                    reserved[cell] = 1;
+                    if (k == gap) continue;
+                    cells[cell] = color;
+                    lineBalls.push_back(cell);
+                }
+                lineColor = color;
+                ordered += cross;
+                built = true;
+            }
+            if (!built) break;
+
+            // bóng còn thiếu ở chỗ khác trên bàn
+            built = false;
+            for (int tries = 0; tries < 64 && !built; ++tries) {
+                const int cell = static_cast<int>(rng.below(n));
+                if (!isFree(cell)) continue;
+                cells[cell] = lineColor;
+                reserved[cell] = 1;
+                built = true;
+            }
+        }
+        if (!built) continue;
+        // bàn ban đầu không được có sẵn hàng (game xóa ngay khi load)
+        if (scanner.scan(cells.data(), rows, cols, L, mask.data(), rules.lineDirections) > 0) continue;
+        if (!solver.solve(cells.data(), options.moves, solution, options.nodeBudget)) continue;
+        const int deadEnds = minDeadEnds > 0 ? solver.deadEnds(cells.data(), options.moves, options.nodeBudget, minDeadEnds) : 0;
+        if (deadEnds < minDeadEnds) continue;
+
+        puzzle.rules = rulesFor(options);
+        puzzle.cells = cells;
+        puzzle.moveLimit = options.moves;
+        puzzle.solution = solution;
+        puzzle.seed = seed;
+        found = puzzle.verify();
+        if (found && stats) {
+            stats->deadEnds += deadEnds;
+            stats->ordered += ordered;
+        }
+    }
+
+    if (stats) {
+        stats->nodes += solver.nodes() - nodesBefore;
+        stats->memoHits += solver.memoHits() - memoBefore;
+    }
+    return found;
+}
+
+std::vector<Puzzle> PuzzleGenerator::generate(int count, uint64_t seed, const Options &options, WorkerPool &pool,
+                                              Stats *stats)
+{
+    std::vector<Puzzle> slots(count);
+    std::vector<uint8_t> ok(count, 0);
+    std::vector<Stats> slotStats(count);
+    const GameRules rules = rulesFor(options);
+
+    // mỗi chunk một solver (GameEngine + bảng nhớ riêng)
+    pool.parallelFor(count, 8, [&](int begin, int end) {
+        PuzzleSolver solver(rules);
+        for (int i = begin; i < end; ++i) ok[i] = generateOne(puzzleSeed(seed, i), options, solver, slots[i], &slotStats[i]);
+    });
+
+    std::vector<Puzzle> puzzles;
+    puzzles.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (ok[i]) puzzles.push_back(std::move(slots[i]));
+        if (!stats) continue;
+        stats->generated += ok[i];
+        stats->failed += !ok[i];
+        stats->attempts += slotStats[i].attempts;
+        stats->nodes += slotStats[i].nodes;
+        stats->memoHits += slotStats[i].memoHits;
+        stats->deadEnds += slotStats[i].deadEnds;
+        stats->ordered += slotStats[i].ordered;
+    }
+    return puzzles;
+}
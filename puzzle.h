@@ -0,0 +1,121 @@
+#ifndef PUZZLE_H
+#define PUZZLE_H
+
+#include "gameengine.h"
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+class WorkerPool;
+
+// Chế độ puzzle: "xóa hết bóng trong K nước". Không thêm bóng sau mỗi nước
+// (spawnPerTurn = 0), còn lại đúng luật của game: bóng đi tới ô trống nối
+// được (findPath / EmptyRegions), hàng >= lineLength qua ô vừa đến bị xóa
+// (checkAndRemoveLines / GameEngine).
+struct PuzzleMove {
+    int from = -1;
+    int to = -1;
+};
+
+struct Puzzle {
+    GameRules rules;                    // spawnPerTurn = 0
+    std::vector<uint8_t> cells;         // rows * cols, chỉ số màu (0 = trống)
+    int moveLimit = 0;                  // K
+    std::vector<PuzzleMove> solution;   // đã kiểm tra, <= moveLimit nước
+    uint64_t seed = 0;
+
+    // Chạy lời giải trên GameEngine mới: mọi nước hợp lệ, bàn trống ở cuối
+    bool verify() const;
+};
+
+// Tìm lời giải <= K nước bằng DFS trên GameEngine (step / undo, không chép
+// bàn). Chỉ thử nước xóa được ít nhất một hàng: ô trống mà thêm màu c vào
+// thì thành hàng, với mọi bóng màu c tới được ô đó. Trạng thái đã chứng minh
+// vô nghiệm (hash bàn + số nước còn lại) được nhớ lại. Màu nào còn 1..L-1
+// bóng thì không bao giờ xóa hết được -> cắt nhánh.
+class PuzzleSolver
+{
+public:
+    static constexpr int64_t DefaultNodeBudget = 1000;
+
+    explicit PuzzleSolver(const GameRules &rules);
+
+    // false nếu vô nghiệm trong maxMoves nước hoặc vượt nodeBudget (aborted())
+    bool solve(const uint8_t *cells, int maxMoves, std::vector<PuzzleMove> &solution,
+               int64_t nodeBudget = DefaultNodeBudget);
+    bool aborted() const { return m_aborted; }
+
+    // Số nước xóa được ở bàn đầu mà sau đó không còn lời giải trong
+    // maxMoves - 1 nước (bẫy), dừng đếm khi đủ `enough`. Nước mà lời giải con
+    // vượt nodeBudget không tính.
+    int deadEnds(const uint8_t *cells, int maxMoves, int64_t nodeBudget = DefaultNodeBudget, int enough = INT32_MAX);
+
+    // Cộng dồn qua các lần solve
+    int64_t nodes() const { return m_totalNodes; }
+    int64_t memoHits() const { return m_memoHits; }
+
+private:
+    bool search(int movesLeft);
+    void clearingMoves(std::vector<PuzzleMove> &moves);
+    bool hopeless() const;
+    uint64_t stateKey(int movesLeft) const;
+
+    GameRules m_rules;
+    GameEngine m_engine;
+    std::unordered_set<uint64_t> m_dead;    // trạng thái vô nghiệm
+    std::vector<std::vector<PuzzleMove>> m_moves;   // theo số nước còn lại
+    std::vector<PuzzleMove> m_path;
+    // scratch của clearingMoves
+    struct Scored {
+        int score;
+        PuzzleMove move;
+    };
+    std::vector<int> m_ballsOf[256];        // ô có bóng theo màu
+    std::vector<Scored> m_scored;
+    int64_t m_budget = 0;
+    int64_t m_nodes = 0;
+    bool m_aborted = false;
+    int64_t m_totalNodes = 0;
+    int64_t m_memoHits = 0;
+};
+
+// Sinh puzzle ngược từ lời giải: K hàng lineLength ô theo các hướng luật cho
+// phép, mỗi hàng thiếu một ô, bóng còn thiếu đặt ngẫu nhiên ở chỗ khác trên
+// bàn. Khoảng nửa số hàng cắt qua một bóng của hàng dựng trước và thiếu đúng
+// ô đó: hàng này chỉ xóa được sau khi hàng kia đã xóa, nên thứ tự nước đi có
+// nghĩa. Bàn chỉ được nhận khi PuzzleSolver tìm ra lời giải (có thể khác cách
+// dựng) và có ít nhất minDeadEnds nước xóa được nhưng dẫn vào ngõ cụt (vd. lấy
+// bóng của một hàng khác để lấp hàng này); lời giải đó đi kèm puzzle.
+class PuzzleGenerator
+{
+public:
+    struct Options {
+        GameRules rules;                // kích thước, lineLength, số màu, hướng, cách đi; spawnPerTurn bỏ qua
+        int moves = 3;                  // K
+        int minDeadEnds = 1;            // bẫy tối thiểu ở bàn đầu (K >= 2)
+        int maxAttempts = 64;           // bàn thử cho mỗi puzzle
+        int64_t nodeBudget = PuzzleSolver::DefaultNodeBudget;
+    };
+
+    struct Stats {
+        int generated = 0;
+        int failed = 0;                 // hết maxAttempts
+        int64_t attempts = 0;
+        int64_t nodes = 0;
+        int64_t memoHits = 0;
+        int64_t deadEnds = 0;           // bẫy ở bàn đầu, cộng qua các puzzle đã nhận
+        int64_t ordered = 0;            // hàng phải đợi hàng khác xóa trước
+    };
+
+    // Puzzle i dùng seed riêng suy từ (seed, i): kết quả không phụ thuộc số
+    // luồng. Song song trên pool; puzzle hỏng (hết lượt thử) bị bỏ qua.
+    static std::vector<Puzzle> generate(int count, uint64_t seed, const Options &options, WorkerPool &pool,
+                                        Stats *stats = nullptr);
+    static bool generateOne(uint64_t seed, const Options &options, PuzzleSolver &solver, Puzzle &puzzle,
+                            Stats *stats = nullptr);
+
+    static GameRules rulesFor(const Options &options);
+};
+
+#endif // PUZZLE_H
@@ -0,0 +1,34 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+// splitmix64: one 64-bit word of state, so a game's RNG can be seeded per
+// environment, copied, saved and restored exactly (replays, undo).
+class Rng
+{
+public:
+    explicit Rng(uint64_t seed = 0) : m_state(seed) {}
+
+    uint64_t next()
+    {
+        uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, n) (multiply-shift, no division)
+    uint32_t below(uint32_t n) { return static_cast<uint32_t>((static_cast<uint64_t>(next() >> 32) * n) >> 32); }
+
+    // Uniform in [lo, hi], như getRandomInt của MainWindow
+    int range(int lo, int hi) { return lo + static_cast<int>(below(static_cast<uint32_t>(hi - lo + 1))); }
+
+    uint64_t state() const { return m_state; }
+    void setState(uint64_t state) { m_state = state; }
+
+private:
+    uint64_t m_state;
+};
+
+#endif // RNG_H
@@ -0,0 +1,118 @@
+#include "savebrowser.h"
+#include "saveindex.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QListWidget>
+#include <QMessageBox>
+#include <QPixmap>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+SaveBrowser::SaveBrowser(SaveIndex &index, QWidget *parent) : QDialog(parent), m_index(index)
+{
+    setWindowTitle("Mở Game");
+    resize(460, 520);
+
+    m_list = new QListWidget(this);
+    m_list->setIconSize(QSize(GameSave::ThumbnailSide, GameSave::ThumbnailSide));
+    m_list->setUniformItemSizes(true);      // nghìn slot: không đo từng dòng
+    m_list->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_status = new QLabel(this);
+
+    m_openButton = new QPushButton("Mở", this);
+    m_deleteButton = new QPushButton("Xóa", this);
+    QPushButton *otherButton = new QPushButton("File khác...", this);
+    QPushButton *cancelButton = new QPushButton("Hủy", this);
+    m_openButton->setDefault(true);
+
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addWidget(otherButton);
+    buttons->addStretch();
+    buttons->addWidget(m_deleteButton);
+    buttons->addWidget(m_openButton);
+    buttons->addWidget(cancelButton);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_list);
+    layout->addWidget(m_status);
+    layout->addLayout(buttons);
+
+    connect(m_openButton, &QPushButton::clicked, this, &SaveBrowser::onOpenClicked);
+    connect(m_deleteButton, &QPushButton::clicked, this, &SaveBrowser::onDeleteClicked);
+    connect(otherButton, &QPushButton::clicked, this, &SaveBrowser::onOtherFileClicked);
+    connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
+    connect(m_list, &QListWidget::itemActivated, this, &SaveBrowser::onOpenClicked);
+    connect(m_list, &QListWidget::currentRowChanged, this, [this](int row) {
+        m_openButton->setEnabled(row >= 0);
+        m_deleteButton->setEnabled(row >= 0);
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    int rescanned = 0;
+    m_index.refresh(&rescanned);
+    populate();
+    m_status->setText(QString("%1 save · %2 file đọc lại · %3 ms")
+                          .arg(m_index.entries().size())
+                          .arg(rescanned)
+                          .arg(timer.elapsed()));
+}
+
+void SaveBrowser::populate()
+{
+    m_list->clear();
+    for (const SaveIndex::Entry &entry : m_index.entries()) {
+        const QDateTime time = QDateTime::fromString(entry.info.saveTime, Qt::ISODate);
+        const QString when = time.isValid() ? time.toString("dd/MM/yyyy HH:mm")
+                                            : QDateTime::fromMSecsSinceEpoch(entry.modifiedMs).toString("dd/MM/yyyy HH:mm");
+        QListWidgetItem *item = new QListWidgetItem(QString("%1\n%2 bóng · %3x%4 · %5")
+                                                        .arg(entry.fileName)
+                                                        .arg(entry.info.ballCount)
+                                                        .arg(entry.info.rows)
+                                                        .arg(entry.info.cols)
+                                                        .arg(when),
+                                                    m_list);
+        if (!entry.info.thumbnail.isNull()) item->setIcon(QPixmap::fromImage(entry.info.thumbnail));
+        item->setData(Qt::UserRole, entry.fileName);
+    }
+    if (m_list->count() > 0) m_list->setCurrentRow(0);
+    m_openButton->setEnabled(m_list->count() > 0);
+    m_deleteButton->setEnabled(m_list->count() > 0);
+}
+
+void SaveBrowser::onOpenClicked()
+{
+    const QListWidgetItem *item = m_list->currentItem();
+    if (!item) return;
+    m_selectedFile = m_index.filePath(item->data(Qt::UserRole).toString());
+    accept();
+}
+
+void SaveBrowser::onDeleteClicked()
+{
+    const QListWidgetItem *item = m_list->currentItem();
+    if (!item) return;
+    const QString fileName = item->data(Qt::UserRole).toString();
+    if (QMessageBox::question(this, "Xóa Save", QString("Xóa save \"%1\"?").arg(fileName)) != QMessageBox::Yes) return;
+
+    if (!QFile::remove(m_index.filePath(fileName))) {
+        QMessageBox::warning(this, "Lỗi", QString("Không thể xóa file:\n%1").arg(fileName));
+        return;
+    }
+    m_index.removeFile(fileName);
+    delete m_list->takeItem(m_list->row(item));
+}
+
+void SaveBrowser::onOtherFileClicked()
+{
+    const QString filename = QFileDialog::getOpenFileName(this, "Mở Game", QDir::homePath(),
+                                                          "Ball Game Save Files (*.bgsave *.json);;All Files (*)");
+    if (filename.isEmpty()) return;
+    m_selectedFile = filename;
+    accept();
+}
@@ -0,0 +1,39 @@
+#ifndef SAVEBROWSER_H
+#define SAVEBROWSER_H
+
+#include <QDialog>
+
+class QLabel;
+class QListWidget;
+class QPushButton;
+class SaveIndex;
+
+// Chọn save-slot để mở: danh sách lấy từ SaveIndex (thumbnail + số bóng,
+// kích thước, thời gian), không mở file save nào khi hiển thị.
+class SaveBrowser : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SaveBrowser(SaveIndex &index, QWidget *parent = nullptr);
+
+    // Đường dẫn đầy đủ file được chọn (slot hoặc "File khác...")
+    QString selectedFile() const { return m_selectedFile; }
+
+private slots:
+    void onOpenClicked();
+    void onDeleteClicked();
+    void onOtherFileClicked();
+
+private:
+    void populate();
+
+    SaveIndex &m_index;
+    QListWidget *m_list;
+    QLabel *m_status;
+    QPushButton *m_openButton;
+    QPushButton *m_deleteButton;
+    QString m_selectedFile;
+};
+
+#endif // SAVEBROWSER_H
@@ -0,0 +1,187 @@
+#include "saveindex.h"
+#include "workerpool.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+namespace {
+
+const char *const IndexFileName = "index.bgidx";
+constexpr quint32 IndexMagic = 0x42474958;      // "BGIX"
+constexpr quint32 IndexVersion = 2;           // 2: thêm danh sách file không hợp lệ
+
+} // namespace
+
+SaveIndex::SaveIndex(const QString &directory) : m_directory(directory)
+{
+}
+
+QString SaveIndex::defaultDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("saves");
+}
+
+QString SaveIndex::filePath(const QString &fileName) const
+{
+    return QDir(m_directory).filePath(fileName);
+}
+
+bool SaveIndex::loadIndex()
+{
+    m_loaded = true;
+    m_entries.clear();
+    m_invalid.clear();
+    QFile file(filePath(IndexFileName));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0, version = 0, count = 0;
+    in >> magic >> version >> count;
+    if (magic != IndexMagic || version < 1 || version > IndexVersion) return false;
+
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        qint32 balls = 0, rows = 0, cols = 0;
+        in >> entry.fileName >> entry.size >> entry.modifiedMs >> balls >> rows >> cols >> entry.info.saveTime
+            >> entry.info.thumbnail;
+        entry.info.ballCount = balls;
+        entry.info.rows = rows;
+        entry.info.cols = cols;
+        m_entries.append(entry);
+    }
+    quint32 invalidCount = 0;
+    if (version >= 2) in >> invalidCount;
+    for (quint32 i = 0; i < invalidCount && in.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        in >> entry.fileName >> entry.size >> entry.modifiedMs;
+        m_invalid.append(entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        m_entries.clear();          // index hỏng: dựng lại từ thư mục
+        m_invalid.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SaveIndex::saveIndex() const
+{
+    QDir().mkpath(m_directory);
+    QSaveFile file(filePath(IndexFileName));
+    if (!file.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << IndexMagic << IndexVersion << quint32(m_entries.size());
+    for (const Entry &entry : m_entries) {
+        out << entry.fileName << entry.size << entry.modifiedMs << qint32(entry.info.ballCount)
+            << qint32(entry.info.rows) << qint32(entry.info.cols) << entry.info.saveTime << entry.info.thumbnail;
+    }
+    out << quint32(m_invalid.size());
+    for (const Entry &entry : m_invalid) out << entry.fileName << entry.size << entry.modifiedMs;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+void SaveIndex::sortEntries()
+{
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) {
+        if (a.modifiedMs != b.modifiedMs) return a.modifiedMs > b.modifiedMs;
+        return a.fileName < b.fileName;
+    });
+}
+
+void SaveIndex::refresh(int *rescanned)
+{
+    bool changed = !loadIndex();
+    // file đã biết: chỉ số trong m_entries, hoặc -1 - i với m_invalid[i]
+    QHash<QString, int> known;
+    for (int i = 0; i < m_entries.size(); ++i) known.insert(m_entries[i].fileName, i);
+    for (int i = 0; i < m_invalid.size(); ++i) known.insert(m_invalid[i].fileName, -1 - i);
+
+    const QFileInfoList files =
+        QDir(m_directory).entryInfoList({ "*.bgsave", "*.json" }, QDir::Files | QDir::Readable, QDir::NoSort);
+    QVector<Entry> fresh;
+    QVector<Entry> invalid;
+    QVector<Entry> stale;               // mới hoặc đã đổi: phải đọc header (file nén) / cả file (.json cũ)
+    fresh.reserve(files.size());
+    for (const QFileInfo &fileInfo : files) {
+        const qint64 modified = fileInfo.lastModified().toMSecsSinceEpoch();
+        const auto it = known.constFind(fileInfo.fileName());
+        if (it != known.constEnd()) {
+            const bool wasValid = it.value() >= 0;
+            const Entry &old = wasValid ? m_entries[it.value()] : m_invalid[-1 - it.value()];
+            if (old.size == fileInfo.size() && old.modifiedMs == modified) {
+                (wasValid ? fresh : invalid).append(old);
+                continue;
+            }
+        }
+        Entry entry;
+        entry.fileName = fileInfo.fileName();
+        entry.size = fileInfo.size();
+        entry.modifiedMs = modified;
+        stale.append(entry);
+    }
+
+    // song song: save cũ không có header phải đọc và vẽ thumbnail cả bàn
+    QVector<char> valid(stale.size(), 0);
+    Entry *staleData = stale.data();    // data() trước: operator[] không const trên nhiều luồng
+    char *validData = valid.data();
+    WorkerPool::shared().parallelFor(int(stale.size()), 1, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+            validData[i] = GameSave::readInfo(filePath(staleData[i].fileName), staleData[i].info);
+    });
+    for (int i = 0; i < stale.size(); ++i) {
+        if (valid[i]) {
+            fresh.append(stale[i]);
+        } else {
+            // không phải save hợp lệ: nhớ lại để không đọc lại tới khi file đổi
+            stale[i].info = GameSave::SaveInfo();
+            invalid.append(stale[i]);
+        }
+    }
+    const int scanned = int(stale.size());
+    changed = changed || scanned > 0;
+    changed = changed || fresh.size() != m_entries.size() || invalid.size() != m_invalid.size();
+
+    m_entries = fresh;
+    m_invalid = invalid;
+    sortEntries();
+    if (changed) saveIndex();
+    if (rescanned) *rescanned = scanned;
+}
+
+void SaveIndex::updateFile(const QString &fileName, const GameSave::SaveInfo &info)
+{
+    const QFileInfo fileInfo(filePath(fileName));
+    Entry entry;
+    entry.fileName = fileName;
+    entry.size = fileInfo.size();
+    entry.modifiedMs = fileInfo.lastModified().toMSecsSinceEpoch();
+    entry.info = info;
+
+    if (!m_loaded) loadIndex();
+    auto sameName = [&](const Entry &e) { return e.fileName == fileName; };
+    m_invalid.erase(std::remove_if(m_invalid.begin(), m_invalid.end(), sameName), m_invalid.end());
+    auto it = std::find_if(m_entries.begin(), m_entries.end(), sameName);
+    if (it != m_entries.end()) *it = entry;
+    else m_entries.append(entry);
+    sortEntries();
+    saveIndex();
+}
+
+void SaveIndex::removeFile(const QString &fileName)
+{
+    if (!m_loaded) loadIndex();
+    auto sameName = [&](const Entry &e) { return e.fileName == fileName; };
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), sameName), m_entries.end());
+    m_invalid.erase(std::remove_if(m_invalid.begin(), m_invalid.end(), sameName), m_invalid.end());
+    saveIndex();
+}
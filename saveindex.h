@@ -0,0 +1,53 @@
+#ifndef SAVEINDEX_H
+#define SAVEINDEX_H
+
+#include <QString>
+#include <QVector>
+
+#include "gamesave.h"
+
+// Thư mục save-slot và file index (index.bgidx) của nó: tên file, kích thước,
+// thời gian sửa và SaveInfo (số bóng, kích thước bàn, saveTime, thumbnail).
+// Liệt kê chỉ cần stat thư mục + đọc index; chỉ file mới / đã đổi (kích
+// thước hoặc mtime khác) mới phải mở để đọc header. File không phải save
+// cũng được ghi nhớ (không có SaveInfo) để lần sau không đọc lại.
+class SaveIndex
+{
+public:
+    struct Entry {
+        QString fileName;               // trong directory()
+        qint64 size = 0;
+        qint64 modifiedMs = 0;
+        GameSave::SaveInfo info;
+    };
+
+    explicit SaveIndex(const QString &directory = defaultDirectory());
+
+    // <AppDataLocation>/saves
+    static QString defaultDirectory();
+    QString directory() const { return m_directory; }
+    QString filePath(const QString &fileName) const;
+
+    // Đọc index rồi đối chiếu với thư mục; ghi lại index nếu có thay đổi.
+    // Số file phải đọc header (mới / đổi) trả về qua *rescanned.
+    void refresh(int *rescanned = nullptr);
+    // Mới nhất trước
+    const QVector<Entry> &entries() const { return m_entries; }
+
+    // Gọi sau khi vừa ghi / xóa một file trong thư mục; đọc index từ đĩa trước
+    // nếu chưa đọc, để không ghi đè index đầy đủ bằng một mục
+    void updateFile(const QString &fileName, const GameSave::SaveInfo &info);
+    void removeFile(const QString &fileName);
+
+private:
+    bool loadIndex();
+    bool saveIndex() const;
+    void sortEntries();
+
+    QString m_directory;
+    QVector<Entry> m_entries;
+    QVector<Entry> m_invalid;           // không phải save hợp lệ: chỉ tên / kích thước / mtime
+    bool m_loaded = false;              // đã loadIndex() ít nhất một lần
+};
+
+#endif // SAVEINDEX_H
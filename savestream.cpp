@@ -0,0 +1,346 @@
+#include "savestream.h"
+
+#include <cmath>
+#include <climits>
+
+namespace {
+
+constexpr uint32_t DefaultRed = 0xffff0000u;   // màu thay cho màu hỏng, như jsonToPalette
+
+// Như QJsonValue::toInt: chỉ nhận số nguyên nằm trong int
+bool toInt(double value, int &out)
+{
+    if (!(value >= INT_MIN && value <= INT_MAX) || std::floor(value) != value) return false;
+    out = static_cast<int>(value);
+    return true;
+}
+
+int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+SaveStreamReader::SaveStreamReader(int rows, int cols, BallSink sink, ColorResolver resolver)
+    : m_rows(rows), m_cols(cols), m_sink(std::move(sink)), m_resolver(std::move(resolver))
+{
+    m_where.reserve(JsonStream::MaxDepth + 1);
+    m_where.push_back(Where::Top);
+    m_occupied.assign((static_cast<size_t>(rows) * cols + 63) / 64, 0);
+}
+
+bool SaveStreamReader::parseHexColor(std::string_view text, uint32_t &rgba)
+{
+    if (text.empty() || text[0] != '#') return false;
+    const size_t n = text.size() - 1;
+    if (n != 3 && n != 6 && n != 8) return false;
+
+    uint32_t value = 0;
+    for (size_t i = 1; i <= n; ++i) {
+        const int h = hexDigit(text[i]);
+        if (h < 0) return false;
+        value = value << 4 | static_cast<uint32_t>(h);
+    }
+    if (n == 3) {
+        // #rgb -> #rrggbb
+        const uint32_t r = value >> 8 & 0xf, g = value >> 4 & 0xf, b = value & 0xf;
+        value = (r * 0x11) << 16 | (g * 0x11) << 8 | b * 0x11;
+    }
+    rgba = n == 8 ? value : 0xff000000u | value;
+    return true;
+}
+
+bool SaveStreamReader::feed(const char *data, size_t size)
+{
+    if (!m_error.empty()) return false;
+    if (m_json.feed(data, size)) return true;
+    return fail("File không hợp lệ hoặc đã bị hỏng!\n" + m_json.error());
+}
+
+bool SaveStreamReader::finish()
+{
+    if (!m_error.empty()) return false;
+    if (!m_json.finish()) return fail("File không hợp lệ hoặc đã bị hỏng!\n" + m_json.error());
+    if (!m_sawBalls) return fail("File không chứa dữ liệu game hợp lệ!");
+    if (m_ballCount == 0) return fail("File không chứa bóng nào!");
+    if (m_maxBallId >= m_nextBallId) m_nextBallId = m_maxBallId + 1;
+    return true;
+}
+
+bool SaveStreamReader::fail(std::string message)
+{
+    if (m_error.empty()) m_error = std::move(message);
+    return false;
+}
+
+bool SaveStreamReader::enter(Where where)
+{
+    m_where.push_back(where);
+    return true;
+}
+
+void SaveStreamReader::leave()
+{
+    m_where.pop_back();
+}
+
+bool SaveStreamReader::startObject()
+{
+    switch (m_where.back()) {
+    case Where::Top:
+        return enter(Where::Root);
+    case Where::Root:
+        if (m_field == Field::Balls) return fail("File không chứa dữ liệu game hợp lệ!");
+        if (m_field == Field::Puzzle) return enter(Where::Puzzle);
+        return enter(Where::Skip);
+    case Where::Balls:
+        m_ball = Ball();
+        return enter(Where::Ball);
+    case Where::Ball:
+        if (m_field != Field::Color) return enter(Where::Skip);
+        m_rgb[0] = m_rgb[1] = m_rgb[2] = 0;
+        return enter(Where::BallColor);
+    case Where::Palette:
+        m_palette.push_back(DefaultRed);
+        return enter(Where::Skip);
+    case Where::SolutionMove:
+        return fail("Lời giải puzzle không hợp lệ!");
+    default:
+        return enter(Where::Skip);
+    }
+}
+
+bool SaveStreamReader::startArray()
+{
+    switch (m_where.back()) {
+    case Where::Top:
+        return fail("File không hợp lệ hoặc đã bị hỏng!");
+    case Where::Root:
+        if (m_field == Field::Balls) {
+            m_sawBalls = true;
+            return enter(Where::Balls);
+        }
+        if (m_field == Field::Palette) {
+            m_hasPalette = true;
+            m_palette.clear();
+            return enter(Where::Palette);
+        }
+        return enter(Where::Skip);
+    case Where::Balls:
+        return fail("File không chứa dữ liệu game hợp lệ!");   // phần tử của balls phải là object
+    case Where::Palette:
+        m_palette.push_back(DefaultRed);
+        return enter(Where::Skip);
+    case Where::Puzzle:
+        if (m_field != Field::Solution) return enter(Where::Skip);
+        m_solution.clear();
+        return enter(Where::Solution);
+    case Where::Solution:
+        if (m_solution.size() >= MaxSolutionMoves) return fail("Lời giải puzzle không hợp lệ!");
+        m_moveValueCount = 0;
+        return enter(Where::SolutionMove);
+    case Where::SolutionMove:
+        return fail("Lời giải puzzle không hợp lệ!");
+    default:
+        return enter(Where::Skip);
+    }
+}
+
+bool SaveStreamReader::endObject()
+{
+    const Where where = m_where.back();
+    leave();
+    if (where == Where::Ball) return finishBall();
+    if (where == Where::BallColor) {
+        // QColor(r, g, b) ngoài 0..255 là màu hỏng
+        const bool valid = m_rgb[0] >= 0 && m_rgb[0] <= 255 && m_rgb[1] >= 0 && m_rgb[1] <= 255
+                           && m_rgb[2] >= 0 && m_rgb[2] <= 255;
+        m_ball.colorKind = valid ? Ball::Rgba : Ball::None;
+        m_ball.rgba = 0xff000000u | uint32_t(m_rgb[0]) << 16 | uint32_t(m_rgb[1]) << 8 | uint32_t(m_rgb[2]);
+    }
+    return true;
+}
+
+bool SaveStreamReader::endArray()
+{
+    const Where where = m_where.back();
+    leave();
+    if (where == Where::SolutionMove) return finishSolutionMove();
+    return true;
+}
+
+bool SaveStreamReader::key(std::string_view name)
+{
+    switch (m_where.back()) {
+    case Where::Root:
+        if (name == "balls") m_field = Field::Balls;
+        else if (name == "palette") m_field = Field::Palette;
+        else if (name == "nextBallId") m_field = Field::NextBallId;
+        else if (name == "selectedBallIndex") m_field = Field::Selected;
+        else if (name == "movingBallIndex") m_field = Field::Moving;
+        else if (name == "puzzle") m_field = Field::Puzzle;
+        else if (name == "rows") m_field = Field::Rows;
+        else if (name == "cols") m_field = Field::Cols;
+        else m_field = Field::Other;
+        break;
+    case Where::Ball:
+        if (name == "id") m_field = Field::Id;
+        else if (name == "row") m_field = Field::Row;
+        else if (name == "col") m_field = Field::Col;
+        else if (name == "color") m_field = Field::Color;
+        else if (name == "bounceOffset") m_field = Field::Bounce;
+        else m_field = Field::Other;
+        break;
+    case Where::BallColor:
+        if (name == "r") m_field = Field::Red;
+        else if (name == "g") m_field = Field::Green;
+        else if (name == "b") m_field = Field::Blue;
+        else m_field = Field::Other;
+        break;
+    case Where::Puzzle:
+        if (name == "moves") m_field = Field::PuzzleMoves;
+        else if (name == "solution") m_field = Field::Solution;
+        else m_field = Field::Other;
+        break;
+    default:
+        m_field = Field::Other;
+        break;
+    }
+    return true;
+}
+
+bool SaveStreamReader::string(std::string_view value)
+{
+    switch (m_where.back()) {
+    case Where::Root:
+    case Where::Balls:
+        return scalar();
+    case Where::Ball:
+        if (m_field == Field::Color) {
+            uint32_t rgba = 0;
+            const bool ok = parseHexColor(value, rgba) || (m_resolver && m_resolver(value, rgba));
+            m_ball.colorKind = ok ? Ball::Rgba : Ball::None;
+            m_ball.rgba = rgba;
+        }
+        return true;
+    case Where::Palette: {
+        uint32_t rgba = 0;
+        const bool ok = parseHexColor(value, rgba) || (m_resolver && m_resolver(value, rgba));
+        m_palette.push_back(ok ? rgba : DefaultRed);
+        return true;
+    }
+    default:
+        return true;
+    }
+}
+
+bool SaveStreamReader::number(double value)
+{
+    int v = 0;
+    const bool integral = toInt(value, v);
+    switch (m_where.back()) {
+    case Where::Root:
+        if (m_field == Field::Balls) return fail("File không chứa dữ liệu game hợp lệ!");
+        if (m_field == Field::NextBallId) m_nextBallId = integral ? v : 0;
+        else if (m_field == Field::Selected) m_selectedBallIndex = integral ? v : -1;
+        else if (m_field == Field::Moving) m_movingBallIndex = integral ? v : -1;
+        else if (m_field == Field::Rows || m_field == Field::Cols) {
+            if (!integral || v <= 0) return fail("File không hợp lệ hoặc đã bị hỏng!");
+            (m_field == Field::Rows ? m_declaredRows : m_declaredCols) = v;
+        }
+        return true;
+    case Where::Balls:
+        return scalar();
+    case Where::Ball:
+        switch (m_field) {
+        case Field::Id: m_ball.id = integral ? v : -1; break;
+        case Field::Row: m_ball.row = integral ? v : 0; break;
+        case Field::Col: m_ball.col = integral ? v : 0; break;
+        case Field::Bounce: m_ball.bounceOffset = integral ? v : 0; break;
+        case Field::Color:
+            // chỉ số palette; kiểm tra với palette ở cuối (palette có thể nằm sau balls)
+            if (integral && v > 0 && v <= 255) {
+                m_ball.colorKind = Ball::Index;
+                m_ball.colorIndex = v;
+            } else {
+                m_ball.colorKind = Ball::None;
+            }
+            break;
+        default:
+            break;
+        }
+        return true;
+    case Where::BallColor:
+        if (m_field == Field::Red) m_rgb[0] = integral ? v : 0;
+        else if (m_field == Field::Green) m_rgb[1] = integral ? v : 0;
+        else if (m_field == Field::Blue) m_rgb[2] = integral ? v : 0;
+        return true;
+    case Where::Palette:
+        m_palette.push_back(DefaultRed);
+        return true;
+    case Where::Puzzle:
+        if (m_field == Field::PuzzleMoves) m_puzzleMoves = integral && v > 0 ? v : 0;
+        return true;
+    case Where::SolutionMove:
+        if (!integral || m_moveValueCount >= 4) return fail("Lời giải puzzle không hợp lệ!");
+        m_moveValues[m_moveValueCount++] = v;
+        return true;
+    default:
+        return true;
+    }
+}
+
+bool SaveStreamReader::scalar()
+{
+    switch (m_where.back()) {
+    case Where::Root:
+        if (m_field == Field::Balls) return fail("File không chứa dữ liệu game hợp lệ!");
+        return true;
+    case Where::Balls:
+        return fail("File không chứa dữ liệu game hợp lệ!");   // số, chuỗi, true/null trong balls
+    case Where::Palette:
+        m_palette.push_back(DefaultRed);
+        return true;
+    case Where::SolutionMove:
+        return fail("Lời giải puzzle không hợp lệ!");
+    default:
+        return true;
+    }
+}
+
+bool SaveStreamReader::finishBall()
+{
+    const Ball &ball = m_ball;
+    if (ball.row < 0 || ball.row >= m_rows || ball.col < 0 || ball.col >= m_cols) {
+        return fail("Bóng có vị trí không hợp lệ:\nBóng ID " + std::to_string(ball.id) + " tại ("
+                    + std::to_string(ball.row) + "," + std::to_string(ball.col) + ")");
+    }
+    const size_t cell = static_cast<size_t>(ball.row) * m_cols + ball.col;
+    uint64_t &word = m_occupied[cell / 64];
+    const uint64_t bit = uint64_t(1) << (cell % 64);
+    if (word & bit) {
+        return fail("Nhiều bóng ở cùng vị trí:\nHàng " + std::to_string(ball.row) + ", Cột "
+                    + std::to_string(ball.col));
+    }
+    word |= bit;
+
+    ++m_ballCount;
+    if (ball.id > m_maxBallId) m_maxBallId = ball.id;
+    if (ball.colorKind == Ball::Index && ball.colorIndex > m_maxColorIndex) m_maxColorIndex = ball.colorIndex;
+    if (m_sink) m_sink(ball);
+    return true;
+}
+
+bool SaveStreamReader::finishSolutionMove()
+{
+    const int *v = m_moveValues;
+    const bool valid = m_moveValueCount == 4 && v[0] >= 0 && v[0] < m_rows && v[1] >= 0 && v[1] < m_cols
+                       && v[2] >= 0 && v[2] < m_rows && v[3] >= 0 && v[3] < m_cols;
+    if (!valid) return fail("Lời giải puzzle không hợp lệ!");
+    m_solution.push_back(SolutionMove{ v[0], v[1], v[2], v[3] });
+    return true;
+}
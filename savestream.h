@@ -0,0 +1,135 @@
+#ifndef SAVESTREAM_H
+#define SAVESTREAM_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "jsonstream.h"
+
+// One-pass reader for the v1 save format (.bgsave JSON), Qt-free.
+//
+// Each ball is validated the moment its object closes: position inside
+// rows x cols, no second ball on an occupied cell (one bit per cell), colour
+// parsed inline. Valid balls go straight to the sink, so the only memory
+// besides the caller's own result is the occupancy bitmap and the
+// tokenizer's current token.
+//
+// Colours: palette index (v1.1), "#rrggbb" / "#rgb" / "#aarrggbb" strings
+// and {r, g, b} objects (v1.0). Colour names ("red") go to the optional
+// resolver; without one they count as missing.
+//
+// Puzzle saves add "puzzle": {"moves": K, "solution": [[r1, c1, r2, c2], ...]};
+// each move is bounds-checked like a ball.
+class SaveStreamReader : private JsonStream::Handler
+{
+public:
+    struct Ball {
+        enum Color : uint8_t { None, Index, Rgba };
+        int id = -1;
+        int row = 0;
+        int col = 0;
+        int bounceOffset = 0;
+        Color colorKind = None;
+        int colorIndex = 0;         // colorKind == Index
+        uint32_t rgba = 0;          // colorKind == Rgba, 0xAARRGGBB
+    };
+    struct SolutionMove {
+        int fromRow = 0;
+        int fromCol = 0;
+        int toRow = 0;
+        int toCol = 0;
+    };
+    static constexpr size_t MaxSolutionMoves = 4096;
+    using BallSink = std::function<void(const Ball &ball)>;
+    using ColorResolver = std::function<bool(std::string_view name, uint32_t &rgba)>;
+
+    SaveStreamReader(int rows, int cols, BallSink sink, ColorResolver resolver = ColorResolver());
+
+    bool feed(const char *data, size_t size);
+    // Hết file: kiểm tra tài liệu trọn vẹn và có ít nhất một bóng
+    bool finish();
+    const std::string &error() const { return m_error; }
+
+    // Kết quả (hợp lệ sau finish())
+    int ballCount() const { return m_ballCount; }
+    int maxBallId() const { return m_maxBallId; }
+    int maxColorIndex() const { return m_maxColorIndex; }
+    bool hasPalette() const { return m_hasPalette; }
+    const std::vector<uint32_t> &palette() const { return m_palette; }   // 0xAARRGGBB
+    int nextBallId() const { return m_nextBallId; }
+    int selectedBallIndex() const { return m_selectedBallIndex; }
+    int movingBallIndex() const { return m_movingBallIndex; }
+    uint64_t bytesRead() const { return m_json.bytesConsumed(); }
+    int puzzleMoves() const { return m_puzzleMoves; }          // 0: không phải puzzle
+    // "rows"/"cols" ở gốc (v1.2+), 0 nếu file không ghi. Trong file chúng nằm
+    // sau balls (khóa xếp theo ABC), nên bóng vẫn được kiểm tra theo rows x cols
+    // của constructor; người gọi kiểm tra lại nếu kích thước khai báo nhỏ hơn.
+    int declaredRows() const { return m_declaredRows; }
+    int declaredCols() const { return m_declaredCols; }
+    const std::vector<SolutionMove> &puzzleSolution() const { return m_solution; }
+
+    // "#rgb", "#rrggbb", "#aarrggbb" -> 0xAARRGGBB
+    static bool parseHexColor(std::string_view text, uint32_t &rgba);
+
+private:
+    enum class Field : uint8_t {
+        None, Balls, Palette, NextBallId, Selected, Moving, Puzzle,     // gốc
+        Rows, Cols,
+        Id, Row, Col, Color, Bounce,                                    // trong bóng
+        Red, Green, Blue,                                               // trong {r, g, b}
+        PuzzleMoves, Solution,                                          // trong puzzle
+        Other,
+    };
+    enum class Where : uint8_t { Top, Root, Balls, Ball, BallColor, Palette, Puzzle, Solution, SolutionMove, Skip };
+
+    bool startObject() override;
+    bool endObject() override;
+    bool startArray() override;
+    bool endArray() override;
+    bool key(std::string_view name) override;
+    bool string(std::string_view value) override;
+    bool number(double value) override;
+    bool boolean(bool) override { return scalar(); }
+    bool null() override { return scalar(); }
+
+    bool scalar();                  // giá trị không dùng tới
+    bool enter(Where where);
+    void leave();
+    bool finishBall();
+    bool finishSolutionMove();
+    bool fail(std::string message);
+
+    JsonStream m_json{*this};
+    int m_rows;
+    int m_cols;
+    BallSink m_sink;
+    ColorResolver m_resolver;
+
+    std::vector<Where> m_where;     // ngữ cảnh theo độ sâu, tối đa JsonStream::MaxDepth
+    Field m_field = Field::None;
+    bool m_sawBalls = false;
+    Ball m_ball;
+    int m_rgb[3] = { 0, 0, 0 };
+
+    std::vector<uint64_t> m_occupied;   // 1 bit / ô
+    int m_ballCount = 0;
+    int m_maxBallId = 0;
+    int m_maxColorIndex = 0;
+    bool m_hasPalette = false;
+    std::vector<uint32_t> m_palette;
+    int m_nextBallId = 0;
+    int m_selectedBallIndex = -1;
+    int m_movingBallIndex = -1;
+    int m_puzzleMoves = 0;
+    int m_declaredRows = 0;
+    int m_declaredCols = 0;
+    std::vector<SolutionMove> m_solution;
+    int m_moveValues[4] = { 0, 0, 0, 0 };
+    int m_moveValueCount = 0;           // số phần tử của nước đang đọc
+    std::string m_error;
+};
+
+#endif // SAVESTREAM_H
@@ -0,0 +1,241 @@
+#include "spectatorserver.h"
+#include "gamestream.h"
+
+#include <QByteArray>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QVector>
+
+#include <vector>
+
+// Phần chạy trên luồng mạng. Giữ một GameStream::Reader làm bản sao của bàn
+// để dựng snapshot cho client vào giữa ván hoặc bị tụt lại.
+class SpectatorHub : public QObject
+{
+public:
+    bool listen(const QString &name, QString *error)
+    {
+        m_server = new QLocalServer(this);
+        m_server->setSocketOptions(QLocalServer::UserAccessOption);
+        m_server->setMaxPendingConnections(SpectatorServer::MaxClients);
+        // socket cũ còn sót lại sau khi crash
+        QLocalServer::removeServer(name);
+        if (!m_server->listen(name)) {
+            if (error) *error = m_server->errorString();
+            delete m_server;
+            m_server = nullptr;
+            return false;
+        }
+        connect(m_server, &QLocalServer::newConnection, this, [this]() { acceptClients(); });
+        return true;
+    }
+
+    void shutdown()
+    {
+        for (const Client &client : m_clients) delete client.socket;
+        m_clients.clear();
+        delete m_server;
+        m_server = nullptr;
+    }
+
+    void broadcast(const QByteArray &frame)
+    {
+        if (!m_mirror.feed(frame.constData(), size_t(frame.size()))) {
+            qWarning("spectator stream: %s", m_mirror.error().c_str());
+            m_mirror = GameStream::Reader();    // đợi snapshot kế tiếp
+            return;
+        }
+        m_snapshotDirty = true;
+        const bool isSnapshot = frame.size() > 4 && quint8(frame[4]) == quint8(GameStream::FrameType::Snapshot);
+        for (Client &client : m_clients) {
+            if (client.resync) continue;
+            // Hàng đợi trống thì luôn ghi: frame lớn hơn giới hạn (snapshot bàn
+            // 2048x2048) vẫn phải đi, và chỉ khi còn dữ liệu đang gửi thì
+            // bytesWritten -> drained() mới chạy. Snapshot đang gửi không tính
+            // vào giới hạn, để các lượt sau nó không lại gây resync.
+            const qint64 queued = client.socket->bytesToWrite();
+            if (queued > 0 && queued + frame.size() > SpectatorServer::MaxQueuedBytes + client.snapshotBytes) {
+                // không đọc kịp: bỏ các lượt, gửi snapshot khi hàng đợi vơi
+                client.resync = true;
+                continue;
+            }
+            client.socket->write(frame);
+            if (isSnapshot) client.snapshotBytes = frame.size();
+        }
+    }
+
+private:
+    struct Client {
+        QLocalSocket *socket;
+        bool resync;
+        qint64 snapshotBytes;           // snapshot gửi gần nhất
+    };
+
+    void acceptClients()
+    {
+        while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+            if (m_clients.size() >= SpectatorServer::MaxClients) {
+                socket->abort();
+                socket->deleteLater();
+                continue;
+            }
+            m_clients.append(Client{ socket, false, 0 });
+            // client chỉ xem: dữ liệu gửi lên bị bỏ qua
+            connect(socket, &QLocalSocket::readyRead, socket, [socket]() { socket->readAll(); });
+            connect(socket, &QLocalSocket::bytesWritten, this, [this, socket]() { drained(socket); });
+            connect(socket, &QLocalSocket::disconnected, this, [this, socket]() { removeClient(socket); });
+            if (m_mirror.hasSnapshot()) sendSnapshot(m_clients.last());
+        }
+    }
+
+    void drained(QLocalSocket *socket)
+    {
+        for (Client &client : m_clients) {
+            if (client.socket != socket) continue;
+            if (client.resync && socket->bytesToWrite() <= SpectatorServer::ResyncBytes) {
+                client.resync = false;
+                sendSnapshot(client);
+            }
+            return;
+        }
+    }
+
+    void sendSnapshot(Client &client)
+    {
+        const QByteArray &frame = snapshot();
+        client.snapshotBytes = frame.size();
+        client.socket->write(frame);
+    }
+
+    void removeClient(QLocalSocket *socket)
+    {
+        for (int i = 0; i < m_clients.size(); ++i) {
+            if (m_clients[i].socket != socket) continue;
+            m_clients.remove(i);
+            socket->deleteLater();
+            return;
+        }
+    }
+
+    // Snapshot của bàn hiện tại; dựng lại tối đa một lần mỗi frame
+    const QByteArray &snapshot()
+    {
+        if (m_snapshotDirty) {
+            m_encoded.clear();
+            GameStream::appendSnapshot(m_encoded, m_mirror.seq(), m_mirror.rows(), m_mirror.cols(),
+                                       m_mirror.cells().data(), m_mirror.palette());
+            m_snapshot = QByteArray(m_encoded.data(), qsizetype(m_encoded.size()));
+            m_snapshotDirty = false;
+        }
+        return m_snapshot;
+    }
+
+    QLocalServer *m_server = nullptr;
+    QVector<Client> m_clients;
+    GameStream::Reader m_mirror;
+    std::string m_encoded;
+    QByteArray m_snapshot;
+    bool m_snapshotDirty = true;
+};
+
+SpectatorServer::SpectatorServer()
+{
+    m_thread.setObjectName("SpectatorServer");
+}
+
+SpectatorServer::~SpectatorServer()
+{
+    if (!m_hub) return;
+    // socket phải bị xóa trên luồng của nó
+    SpectatorHub *hub = m_hub;
+    QMetaObject::invokeMethod(hub, [hub]() { hub->shutdown(); }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+    delete m_hub;
+}
+
+bool SpectatorServer::listen(const QString &name, QString *error)
+{
+    if (m_hub) {
+        if (error) *error = "already listening";
+        return false;
+    }
+    SpectatorHub *hub = new SpectatorHub;
+    hub->moveToThread(&m_thread);
+    m_thread.start();
+
+    bool ok = false;
+    QMetaObject::invokeMethod(hub, [&]() { ok = hub->listen(name, error); }, Qt::BlockingQueuedConnection);
+    if (!ok) {
+        m_thread.quit();
+        m_thread.wait();
+        delete hub;
+        return false;
+    }
+    m_hub = hub;
+    return true;
+}
+
+void SpectatorServer::publishSnapshot(const GameBoard &board, const Palette &palette)
+{
+    if (!m_hub) return;
+    std::vector<uint32_t> colors;
+    colors.reserve(size_t(palette.size()));
+    for (const QColor &color : palette.colors()) colors.push_back(color.rgba());
+    m_frame.clear();
+    GameStream::appendSnapshot(m_frame, ++m_seq, board.rows(), board.cols(), board.data(), colors);
+    m_paletteSize = palette.size();
+    post();
+}
+
+void SpectatorServer::publishTurn(const TurnHistory::Turn &turn, const GameBoard &board, const Palette &palette)
+{
+    if (!m_hub) return;
+    if (palette.size() != m_paletteSize) {
+        // lượt dùng màu client chưa biết
+        publishSnapshot(board, palette);
+        return;
+    }
+    m_frame.clear();
+    GameStream::appendTurn(m_frame, ++m_seq, turn);
+    post();
+}
+
+void SpectatorServer::post()
+{
+    SpectatorHub *hub = m_hub;
+    const QByteArray frame(m_frame.data(), qsizetype(m_frame.size()));
+    QMetaObject::invokeMethod(hub, [hub, frame]() { hub->broadcast(frame); }, Qt::QueuedConnection);
+}
+
+int SpectatorServer::watch(const QString &name, std::FILE *out)
+{
+    QLocalSocket socket;
+    socket.connectToServer(name, QIODevice::ReadOnly);
+    if (!socket.waitForConnected(3000)) {
+        std::fprintf(stderr, "cannot connect to %s: %s\n", qPrintable(name), qPrintable(socket.errorString()));
+        return 1;
+    }
+    GameStream::Reader reader;
+    quint64 bytes = 0;
+    while (socket.state() == QLocalSocket::ConnectedState || socket.bytesAvailable() > 0) {
+        if (socket.bytesAvailable() == 0 && !socket.waitForReadyRead(-1)) continue;
+        const QByteArray data = socket.readAll();
+        bytes += quint64(data.size());
+        const quint64 framesBefore = reader.frames();
+        if (!reader.feed(data.constData(), size_t(data.size()))) {
+            std::fprintf(stderr, "bad stream: %s\n", reader.error().c_str());
+            return 1;
+        }
+        if (reader.frames() == framesBefore) continue;
+        if (reader.lastType() == GameStream::FrameType::Snapshot)
+            std::fprintf(out, "seq %llu snapshot %dx%d, %d balls", (unsigned long long)reader.seq(), reader.rows(),
+                         reader.cols(), reader.ballCount());
+        else
+            std::fprintf(out, "seq %llu turn +%d -%d, %d balls", (unsigned long long)reader.seq(),
+                         reader.lastSpawned(), reader.lastRemoved(), reader.ballCount());
+        std::fprintf(out, " (%llu frames, %llu bytes)\n", (unsigned long long)reader.frames(), (unsigned long long)bytes);
+        std::fflush(out);
+    }
+    return 0;
+}
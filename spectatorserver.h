@@ -0,0 +1,58 @@
+#ifndef SPECTATORSERVER_H
+#define SPECTATORSERVER_H
+
+#include <QString>
+#include <QThread>
+
+#include <cstdio>
+#include <string>
+
+#include "gameboard.h"
+#include "palette.h"
+#include "turnhistory.h"
+
+class SpectatorHub;
+
+// Phát ván đang chơi cho các tiến trình khác trên máy (dashboard, recorder,
+// bot viết bằng ngôn ngữ khác) qua QLocalServer (Unix domain socket /
+// named pipe), theo định dạng của gamestream.h.
+//
+// Luồng GUI chỉ mã hóa frame (~100 ns một lượt) rồi gửi sang luồng mạng;
+// accept, ghi socket và backpressure đều nằm ở luồng đó. Client chậm không
+// bao giờ chặn ván: khi hàng đợi của nó vượt MaxQueuedBytes (cộng snapshot
+// vừa gửi) thì bỏ các lượt, đợi nó đọc bớt rồi gửi một snapshot mới. Frame
+// gặp hàng đợi trống luôn được ghi, kể cả khi lớn hơn giới hạn.
+class SpectatorServer
+{
+public:
+    static constexpr int MaxClients = 64;
+    static constexpr qint64 MaxQueuedBytes = 256 * 1024;   // mỗi client
+    static constexpr qint64 ResyncBytes = 16 * 1024;       // đọc xuống dưới mức này thì gửi snapshot
+
+    SpectatorServer();
+    ~SpectatorServer();
+
+    // Tên socket (ví dụ "ballgame" -> /tmp/ballgame trên Linux). false + *error nếu không listen được.
+    bool listen(const QString &name, QString *error = nullptr);
+    bool isListening() const { return m_hub != nullptr; }
+
+    // Cả bàn: ván mới, load, undo, đổi luật
+    void publishSnapshot(const GameBoard &board, const Palette &palette);
+    // Một lượt vừa xong (hoặc redo); bàn là trạng thái sau lượt
+    void publishTurn(const TurnHistory::Turn &turn, const GameBoard &board, const Palette &palette);
+
+    // Client mẫu (--watch NAME): một dòng tóm tắt mỗi lần nhận dữ liệu, tới khi server đóng.
+    // 0 khi server đóng bình thường, 1 nếu không kết nối được / luồng hỏng.
+    static int watch(const QString &name, std::FILE *out);
+
+private:
+    void post();
+
+    QThread m_thread;
+    SpectatorHub *m_hub = nullptr;  // sống trên m_thread
+    std::string m_frame;            // dùng lại giữa các lượt
+    quint64 m_seq = 0;
+    int m_paletteSize = -1;         // palette đã gửi; màu mới -> snapshot
+};
+
+#endif // SPECTATORSERVER_H
@@ -0,0 +1,48 @@
+#include "spritecache.h"
+
+#include <QCoreApplication>
+#include <QPainter>
+#include <QtMath>
+
+namespace {
+SpriteCache *sharedCache = nullptr;
+}
+
+// Sống cùng app: QPixmap phải được xóa trong lúc hủy QApplication, không
+// phải sau đó như một static cục bộ
+SpriteCache &SpriteCache::shared()
+{
+    if (!sharedCache) {
+        sharedCache = new SpriteCache;
+        qAddPostRoutine([] {
+            delete sharedCache;
+            sharedCache = nullptr;
+        });
+    }
+    return *sharedCache;
+}
+
+QPixmap SpriteCache::ball(const QColor &color, int diameter, qreal devicePixelRatio)
+{
+    const quint64 key = quint64(color.rgba()) | quint64(diameter & 0xffff) << 32
+                        | quint64(qRound(devicePixelRatio * 100) & 0xffff) << 48;
+    auto it = m_sprites.constFind(key);
+    if (it != m_sprites.constEnd()) return it.value();
+
+    if (m_sprites.size() >= MaxEntries) m_sprites.clear();
+
+    const int pixels = qMax(1, qCeil(diameter * devicePixelRatio));
+    QPixmap pixmap(pixels, pixels);
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setBrush(color);
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(QRectF(0, 0, diameter, diameter));
+    painter.end();
+
+    m_sprites.insert(key, pixmap);
+    return pixmap;
+}
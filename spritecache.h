@@ -0,0 +1,28 @@
+#ifndef SPRITECACHE_H
+#define SPRITECACHE_H
+
+#include <QColor>
+#include <QHash>
+#include <QPixmap>
+
+// Pre-rendered antialiased balls, shared by every BoardView in the process.
+// One pixmap per (colour, diameter, device pixel ratio); a board only pays
+// for the lookups. GUI thread only.
+class SpriteCache
+{
+public:
+    static constexpr int MaxEntries = 1024;    // vượt thì xóa hết (zoom liên tục tạo nhiều cỡ)
+
+    static SpriteCache &shared();
+
+    // Bóng đường kính `diameter` px logic (implicitly shared, trả về bản sao rẻ)
+    QPixmap ball(const QColor &color, int diameter, qreal devicePixelRatio = 1.0);
+
+    int size() const { return m_sprites.size(); }
+    void clear() { m_sprites.clear(); }
+
+private:
+    QHash<quint64, QPixmap> m_sprites;
+};
+
+#endif // SPRITECACHE_H
@@ -0,0 +1,96 @@
+#include "startupprofile.h"
+
+#include <chrono>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+#endif
+
+namespace {
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// exec -> bây giờ theo /proc/self/stat (trường 22, tick từ lúc boot); < 0 nếu không đọc được
+double processAgeMs()
+{
+#ifdef __linux__
+    std::FILE *file = std::fopen("/proc/self/stat", "r");
+    if (!file) return -1;
+    char line[1024];
+    const bool ok = std::fgets(line, sizeof line, file) != nullptr;
+    std::fclose(file);
+    // tên tiến trình (trường 2) có thể chứa khoảng trắng: đếm từ dấu ')' cuối
+    const char *p = ok ? std::strrchr(line, ')') : nullptr;
+    if (!p) return -1;
+    for (int field = 2; field < 22 && p; ++field) p = std::strchr(p + 1, ' ');
+    if (!p) return -1;
+    const unsigned long long startTicks = std::strtoull(p + 1, nullptr, 10);
+    timespec boot{};
+    const long hz = sysconf(_SC_CLK_TCK);
+    if (hz <= 0 || clock_gettime(CLOCK_BOOTTIME, &boot) != 0) return -1;
+    const double ageMs = (boot.tv_sec + boot.tv_nsec / 1e9 - double(startTicks) / hz) * 1e3;
+    return ageMs >= 0 ? ageMs : -1;
+#else
+    return -1;
+#endif
+}
+
+} // namespace
+
+StartupProfile &StartupProfile::shared()
+{
+    static StartupProfile profile;
+    return profile;
+}
+
+void StartupProfile::start()
+{
+    m_phases.clear();
+    m_phases.reserve(16);
+    m_finished = false;
+    m_startNs = nowNs();
+    m_preMainMs = processAgeMs();
+}
+
+void StartupProfile::mark(const char *phase)
+{
+    if (!isRunning()) return;
+    m_phases.push_back(Phase{ phase, nowNs() });
+}
+
+void StartupProfile::finish(const char *phase)
+{
+    if (!isRunning()) return;
+    mark(phase);
+    m_finished = true;
+}
+
+int64_t StartupProfile::totalNs() const
+{
+    return m_finished && !m_phases.empty() ? m_phases.back().endNs - m_startNs : 0;
+}
+
+void StartupProfile::print(std::FILE *out) const
+{
+    if (m_phases.empty()) {
+        std::fprintf(out, "startup: no phases recorded\n");
+        return;
+    }
+    const int64_t end = m_phases.back().endNs;
+    std::fprintf(out, "startup: %.1f ms from main() to %s", (end - m_startNs) / 1e6,
+                 m_finished ? m_phases.back().name : "the last mark (not finished)");
+    if (m_preMainMs >= 0) std::fprintf(out, ", plus ~%.0f ms before main()", m_preMainMs);
+    std::fprintf(out, "\n%-26s %10s %10s\n", "phase", "ms", "total ms");
+    int64_t previous = m_startNs;
+    for (const Phase &phase : m_phases) {
+        std::fprintf(out, "%-26s %10.2f %10.2f\n", phase.name, (phase.endNs - previous) / 1e6,
+                     (phase.endNs - m_startNs) / 1e6);
+        previous = phase.endNs;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef STARTUPPROFILE_H
+#define STARTUPPROFILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Cold-start breakdown from main() to the first painted frame, Qt-free.
+//
+// main() calls start() first thing; every phase calls mark() when it ends
+// and the first painted frame calls finish(). print() lists each phase with
+// its own time and the running total. Marks before start() (renderbench,
+// other tools that build a MainWindow) and after finish() are ignored.
+// On Linux the time between exec and main() (loading the Qt libraries,
+// static initialisers) comes from /proc with a 10 ms tick, so it is shown
+// apart and not added to the total.
+class StartupProfile
+{
+public:
+    static StartupProfile &shared();
+
+    void start();
+    void mark(const char *phase);           // phase: chuỗi hằng, không chép
+    void finish(const char *phase);         // mốc cuối
+    bool isRunning() const { return m_startNs != 0 && !m_finished; }
+    bool isFinished() const { return m_finished; }
+    int64_t totalNs() const;                // start -> finish, 0 nếu chưa xong
+    void print(std::FILE *out) const;
+
+private:
+    struct Phase {
+        const char *name;
+        int64_t endNs;
+    };
+    std::vector<Phase> m_phases;
+    int64_t m_startNs = 0;
+    double m_preMainMs = -1;                // < 0: không đo được
+    bool m_finished = false;
+};
+
+#endif // STARTUPPROFILE_H
@@ -0,0 +1,345 @@
+#include "telemetry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char *const TypeNames[] = {
+    "?", "session", "path_search", "turn", "line_scan", "layout", "frames", "slow_frame", "save", "load", "startup",
+};
+static_assert(sizeof(TypeNames) / sizeof(TypeNames[0]) == static_cast<size_t>(TelemetryRing::Type::TypeCount));
+// header.written được nhiều tiến trình cùng fetch_add qua mapping
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free);
+// magic ghi sau cùng khi tạo file: tiến trình khác thấy != 0 là header đã đủ
+static_assert(std::atomic_ref<uint32_t>::is_always_lock_free);
+
+bool isFolded(TelemetryRing::Type type)
+{
+    return type == TelemetryRing::Type::Layout || type == TelemetryRing::Type::Frames;
+}
+
+// "2024-01-31 23:59:59" giờ địa phương
+std::string formatTime(uint64_t us)
+{
+    const std::time_t seconds = static_cast<std::time_t>(us / 1000000);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &seconds);
+#else
+    localtime_r(&seconds, &tm);
+#endif
+    char text[32];
+    std::strftime(text, sizeof text, "%Y-%m-%d %H:%M:%S", &tm);
+    return text;
+}
+
+double percentile(const std::vector<float> &sorted, double p)
+{
+    if (sorted.empty()) return 0;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * (sorted.size() - 1) + 0.5))];
+}
+
+} // namespace
+
+const char *TelemetryRing::typeName(Type type)
+{
+    const size_t i = static_cast<size_t>(type);
+    return i < static_cast<size_t>(Type::TypeCount) ? TypeNames[i] : TypeNames[0];
+}
+
+TelemetryRing::~TelemetryRing()
+{
+    close();
+}
+
+int64_t TelemetryRing::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool TelemetryRing::open(const std::string &path, uint32_t capacity, std::string *error)
+{
+    close();
+    auto fail = [&](const std::string &what) {
+        if (error) *error = path + ": " + what;
+        return false;
+    };
+    if (capacity == 0 || capacity > (1u << 26)) return fail("bad capacity");
+    const size_t bytes = sizeof(Header) + size_t(capacity) * sizeof(Record);
+
+    // File có sẵn không bao giờ bị cắt hay khởi tạo lại (có thể là file của
+    // tiến trình khác đang ghi, hoặc --telemetry trỏ nhầm file): chỉ dùng khi
+    // đúng định dạng và cùng capacity, không thì báo lỗi. File mới được tạo
+    // độc quyền (O_EXCL / CREATE_NEW) và magic ghi sau cùng; tiến trình mở
+    // đúng lúc đó thấy file rỗng hoặc magic = 0 thì đợi một chút rồi xem lại.
+    void *base = nullptr;
+    bool created = false;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE, mapping = nullptr;
+    auto unmap = [&]() {
+        if (base) UnmapViewOfFile(base);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        base = mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+    };
+#else
+    auto unmap = [&]() {
+        if (base) munmap(base, bytes);
+        base = nullptr;
+    };
+#endif
+    for (int attempt = 0; !base; ++attempt) {
+        if (attempt == OpenAttempts) return fail("header still incomplete (a process died while creating it?)");
+        if (attempt > 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#ifdef _WIN32
+        const DWORD share = FILE_SHARE_READ | FILE_SHARE_WRITE;    // nhiều cửa sổ game cùng ghi
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, share, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE && GetLastError() == ERROR_FILE_NOT_FOUND) {
+            file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, share, nullptr, CREATE_NEW,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE && GetLastError() == ERROR_FILE_EXISTS) continue;   // vừa bị tạo trước
+            created = file != INVALID_HANDLE_VALUE;
+        }
+        if (file == INVALID_HANDLE_VALUE) return fail("cannot open (error " + std::to_string(GetLastError()) + ")");
+        LARGE_INTEGER size{};
+        if (created) {
+            size.QuadPart = LONGLONG(bytes);
+            if (!SetFilePointerEx(file, size, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+                unmap();
+                DeleteFileA(path.c_str());      // file của mình, chưa có header
+                return fail("cannot resize");
+            }
+        } else if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            unmap();
+            continue;
+        } else if (size_t(size.QuadPart) != bytes) {
+            unmap();
+            return fail("not a telemetry ring with capacity " + std::to_string(capacity) + ", left untouched");
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+        base = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes) : nullptr;
+        if (!base) {
+            const DWORD err = GetLastError();
+            unmap();
+            if (created) DeleteFileA(path.c_str());
+            return fail("cannot map (error " + std::to_string(err) + ")");
+        }
+#else
+        int fd = ::open(path.c_str(), O_RDWR);
+        if (fd < 0 && errno == ENOENT) {
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+            if (fd < 0 && errno == EEXIST) continue;    // vừa bị tạo trước
+            created = fd >= 0;
+        }
+        if (fd < 0) return fail(std::strerror(errno));
+        struct stat st {};
+        if (created ? ftruncate(fd, off_t(bytes)) != 0 : fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            if (created) ::unlink(path.c_str());    // file của mình, chưa có header
+            return fail(std::strerror(err));
+        }
+        if (!created && st.st_size == 0) {
+            ::close(fd);
+            continue;
+        }
+        if (!created && size_t(st.st_size) != bytes) {
+            ::close(fd);
+            return fail("not a telemetry ring with capacity " + std::to_string(capacity) + ", left untouched");
+        }
+        base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int err = errno;
+        ::close(fd);    // mapping giữ file
+        if (base == MAP_FAILED) {
+            base = nullptr;
+            if (created) ::unlink(path.c_str());
+            return fail(std::strerror(err));
+        }
+#endif
+        if (created) break;
+        Header &existing = *static_cast<Header *>(base);
+        const uint32_t magic = std::atomic_ref<uint32_t>(existing.magic).load(std::memory_order_acquire);
+        if (magic == 0) {
+            unmap();    // đang được tạo
+            continue;
+        }
+        if (magic != Magic || existing.version != Version || existing.recordSize != sizeof(Record)
+            || existing.capacity != capacity) {
+            unmap();
+            return fail("not a telemetry ring with capacity " + std::to_string(capacity) + ", left untouched");
+        }
+    }
+#ifdef _WIN32
+    m_file = file;
+    m_mapping = mapping;
+#endif
+
+    m_bytes = bytes;
+    m_wallBaseUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch()).count();
+    m_steadyBaseNs = nowNs();
+    m_header = static_cast<Header *>(base);     // file mới: toàn 0 sau ftruncate / SetEndOfFile
+    m_records = reinterpret_cast<Record *>(static_cast<char *>(base) + sizeof(Header));
+    if (created) {
+        m_header->version = Version;
+        m_header->recordSize = sizeof(Record);
+        m_header->capacity = capacity;
+        std::atomic_ref<uint32_t>(m_header->magic).store(Magic, std::memory_order_release);
+    }
+#ifdef _WIN32
+    append(Type::Session, m_steadyBaseNs, 0, static_cast<uint32_t>(GetCurrentProcessId()));
+#else
+    append(Type::Session, m_steadyBaseNs, 0, static_cast<uint32_t>(getpid()));
+#endif
+    return true;
+}
+
+void TelemetryRing::close()
+{
+    if (!m_records) return;
+    const int64_t now = nowNs();
+    for (int i = 0; i < static_cast<int>(Type::TypeCount); ++i) {
+        if (m_folds[i].count > 0) flushFold(static_cast<Type>(i), m_folds[i], now);
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m_header);
+    CloseHandle(m_mapping);
+    CloseHandle(m_file);
+    m_mapping = m_file = nullptr;
+#else
+    munmap(m_header, m_bytes);
+#endif
+    m_header = nullptr;
+    m_records = nullptr;
+    m_bytes = 0;
+}
+
+uint64_t TelemetryRing::recordsWritten() const
+{
+    return m_header ? std::atomic_ref<uint64_t>(m_header->written).load(std::memory_order_relaxed) : 0;
+}
+
+void TelemetryRing::append(Type type, int64_t nowNs, float durationUs, uint32_t value)
+{
+    // Nhận ô bằng fetch_add: hai cửa sổ game cùng ghi một file (mặc định cùng
+    // telemetry.ring) không bao giờ ghi đè bản ghi của nhau
+    const uint64_t n = std::atomic_ref<uint64_t>(m_header->written).fetch_add(1, std::memory_order_relaxed);
+    Record &record = m_records[n % m_header->capacity];
+    const uint64_t wallUs = static_cast<uint64_t>(m_wallBaseUs + (nowNs - m_steadyBaseNs) / 1000);
+    record.stamp = wallUs << 8 | static_cast<uint8_t>(type);
+    record.durationUs = durationUs;
+    record.value = value;
+}
+
+void TelemetryRing::fold(Type type, int64_t durationNs)
+{
+    if (!m_records) return;
+    const int64_t now = nowNs();
+    if (type == Type::Frames && durationNs > SlowFrameUs * 1e3) append(Type::SlowFrame, now, float(durationNs / 1e3), 0);
+
+    Fold &fold = m_folds[static_cast<int>(type)];
+    if (fold.count > 0 && now - fold.windowNs >= FoldNs) flushFold(type, fold, now);
+    if (fold.count == 0) fold.windowNs = now;
+    fold.totalNs += durationNs;
+    ++fold.count;
+}
+
+void TelemetryRing::flushFold(Type type, Fold &fold, int64_t nowNs)
+{
+    append(type, nowNs, float(fold.totalNs / 1e3), fold.count);
+    fold = Fold();
+}
+
+bool TelemetryRing::readFile(const std::string &path, std::vector<Record> &records, std::string *error)
+{
+    records.clear();
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        if (error) *error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    Header header;
+    const bool headerOk = std::fread(&header, sizeof header, 1, file) == 1 && header.magic == Magic
+                          && header.version == Version && header.recordSize == sizeof(Record) && header.capacity > 0;
+    std::vector<Record> ring;
+    if (headerOk) {
+        ring.resize(header.capacity);
+        ring.resize(std::fread(ring.data(), sizeof(Record), ring.size(), file));
+    }
+    std::fclose(file);
+    if (!headerOk || ring.size() != header.capacity) {
+        if (error) *error = path + ": not a telemetry file";
+        return false;
+    }
+
+    const uint64_t written = header.written;
+    const uint64_t count = std::min<uint64_t>(written, header.capacity);
+    records.reserve(size_t(count));
+    for (uint64_t i = written - count; i < written; ++i) records.push_back(ring[size_t(i % header.capacity)]);
+    return true;
+}
+
+void TelemetryRing::printSummary(const std::vector<Record> &records, std::FILE *out)
+{
+    if (records.empty()) {
+        std::fprintf(out, "no records\n");
+        return;
+    }
+    std::vector<float> durations[static_cast<int>(Type::TypeCount)];
+    uint64_t values[static_cast<int>(Type::TypeCount)] = {};
+    for (const Record &record : records) {
+        const int type = static_cast<int>(record.type());
+        if (type <= 0 || type >= static_cast<int>(Type::TypeCount)) continue;
+        durations[type].push_back(record.durationUs);
+        values[type] += record.value;
+    }
+    std::fprintf(out, "%zu records, %s .. %s, %zu sessions\n", records.size(),
+                 formatTime(records.front().timeUs()).c_str(), formatTime(records.back().timeUs()).c_str(),
+                 durations[static_cast<int>(Type::Session)].size());
+    std::fprintf(out, "%-12s %9s %12s %10s %10s %10s %10s\n", "event", "count", "value avg", "p50 us", "p95 us",
+                 "p99 us", "max us");
+    for (int type = static_cast<int>(Type::PathSearch); type < static_cast<int>(Type::TypeCount); ++type) {
+        std::vector<float> &d = durations[type];
+        if (d.empty()) continue;
+        const char *name = typeName(static_cast<Type>(type));
+        if (isFolded(static_cast<Type>(type))) {
+            // bản ghi gộp: chỉ có trung bình mỗi lần gọi
+            double total = 0;
+            for (float us : d) total += us;
+            std::fprintf(out, "%-12s %9llu %12s %10.1f %10s %10s %10s   (mean, folded per second)\n", name,
+                         static_cast<unsigned long long>(values[type]), "-", values[type] ? total / values[type] : 0.0,
+                         "-", "-", "-");
+            continue;
+        }
+        std::sort(d.begin(), d.end());
+        std::fprintf(out, "%-12s %9zu %12.2f %10.1f %10.1f %10.1f %10.1f\n", name, d.size(),
+                     double(values[type]) / d.size(), percentile(d, 0.50), percentile(d, 0.95), percentile(d, 0.99),
+                     double(d.back()));
+    }
+}
+
+void TelemetryRing::writeCsv(const std::vector<Record> &records, std::FILE *out)
+{
+    std::fprintf(out, "time_us,event,duration_us,value\n");
+    for (const Record &record : records) {
+        std::fprintf(out, "%llu,%s,%.3f,%u\n", static_cast<unsigned long long>(record.timeUs()),
+                     typeName(record.type()), double(record.durationUs), record.value);
+    }
+}
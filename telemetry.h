@@ -0,0 +1,126 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Session statistics in a fixed-size, memory-mapped ring file, Qt-free.
+//
+// The file keeps the most recent `capacity` records across sessions, so
+// days of play cost a few MB whatever happens. Recording is one steady-clock
+// read (wall time is derived from it) plus a 16-byte store into the mapping;
+// the OS writes pages back on its own. Several processes may record into
+// the same file: each record claims its slot with an atomic fetch_add on
+// the header. A reader can catch a slot that is claimed but not yet filled.
+// That costs at most a few records at the head of the ring.
+// Events that fire every frame (paint, updateBallPositions) are folded into
+// one record per second, with the count in `value`. Frames slower than
+// SlowFrameUs also get their own record.
+//
+// File:   Header (64 bytes) | Record[capacity]
+// Record: u64 (wall-clock µs since epoch << 8 | type) | f32 duration µs | u32 value
+class TelemetryRing
+{
+public:
+    enum class Type : uint8_t {
+        Session = 1,    // value = pid
+        PathSearch,     // findPath; value = số ô của đường (0: không có)
+        Turn,           // cả lượt, kể cả animation; value = số bóng bị xóa
+        LineScan,       // checkAndRemoveLines / quét hàng; value = số ô tìm thấy
+        Layout,         // updateBallPositions, gộp theo giây; value = số lần
+        Frames,         // paintEvent, gộp theo giây; value = số frame
+        SlowFrame,      // một frame > SlowFrameUs
+        Save,           // value = số bóng
+        Load,           // value = số bóng
+        Startup,        // main() -> frame đầu tiên (StartupProfile); value = số ô của bàn
+        TypeCount
+    };
+    static const char *typeName(Type type);
+
+    struct Record {
+        uint64_t stamp;         // µs từ epoch << 8 | type
+        float durationUs;       // tổng thời gian với bản ghi gộp
+        uint32_t value;
+
+        Type type() const { return static_cast<Type>(stamp & 0xff); }
+        uint64_t timeUs() const { return stamp >> 8; }
+    };
+    static_assert(sizeof(Record) == 16, "records are 16 bytes on disk");
+
+    static constexpr uint32_t Magic = 0x4d544742u;  // "BGTM"
+    static constexpr uint32_t Version = 1;
+    static constexpr uint32_t DefaultCapacity = 1u << 18;  // 4 MB
+    static constexpr double SlowFrameUs = 16667;
+    static constexpr int64_t FoldNs = 1000000000;        // gộp bản ghi theo từng giây
+    static constexpr int OpenAttempts = 200;             // ~200 ms đợi tiến trình khác tạo xong header
+
+    TelemetryRing() = default;
+    ~TelemetryRing();
+    TelemetryRing(const TelemetryRing &) = delete;
+    TelemetryRing &operator=(const TelemetryRing &) = delete;
+
+    // Mở (hoặc tạo) file, giữ các bản ghi cũ, ghi thêm bản ghi Session. File có
+    // sẵn mà sai định dạng hay khác capacity thì báo lỗi, không ghi đè
+    bool open(const std::string &path, uint32_t capacity = DefaultCapacity, std::string *error = nullptr);
+    void close();                                   // ghi nốt các bản ghi gộp đang mở
+    bool isOpen() const { return m_records != nullptr; }
+
+    static int64_t nowNs();                         // steady clock, cùng gốc với LatencyTracker
+    // Một lần đo từ startNs (nowNs) tới bây giờ; không làm gì nếu chưa open
+    void record(Type type, int64_t startNs, uint32_t value = 0)
+    {
+        if (!m_records) return;
+        const int64_t now = nowNs();
+        append(type, now, float((now - startNs) / 1e3), value);
+    }
+    // Thời gian đã đo sẵn (ví dụ bằng QElapsedTimer)
+    void recordDuration(Type type, int64_t durationNs, uint32_t value = 0)
+    {
+        if (!m_records) return;
+        append(type, nowNs(), float(durationNs / 1e3), value);
+    }
+    // Sự kiện dày: cộng dồn, mỗi giây ghi một bản ghi
+    void fold(Type type, int64_t durationNs);
+    uint64_t recordsWritten() const;
+
+    // Đọc file (kể cả khi game đang ghi), theo thứ tự thời gian
+    static bool readFile(const std::string &path, std::vector<Record> &records, std::string *error = nullptr);
+    // Theo từng loại: số lần, tổng value, p50 / p95 / p99 / max thời gian
+    static void printSummary(const std::vector<Record> &records, std::FILE *out);
+    static void writeCsv(const std::vector<Record> &records, std::FILE *out);
+
+private:
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t capacity;
+        uint64_t written;                   // tổng số bản ghi đã ghi, bản ghi i ở ô i % capacity (qua atomic_ref)
+        uint8_t reserved[40];
+    };
+    static_assert(sizeof(Header) == 64, "header is 64 bytes on disk");
+
+    struct Fold {
+        int64_t windowNs = 0;               // đầu cửa sổ (nowNs)
+        int64_t totalNs = 0;
+        uint32_t count = 0;
+    };
+
+    void append(Type type, int64_t nowNs, float durationUs, uint32_t value);
+    void flushFold(Type type, Fold &fold, int64_t nowNs);
+
+    Header *m_header = nullptr;
+    Record *m_records = nullptr;
+    size_t m_bytes = 0;
+    int64_t m_wallBaseUs = 0;               // giờ thật lúc open, ứng với m_steadyBaseNs
+    int64_t m_steadyBaseNs = 0;
+    Fold m_folds[static_cast<int>(Type::TypeCount)];
+#ifdef _WIN32
+    void *m_file = nullptr;
+    void *m_mapping = nullptr;
+#endif
+};
+
+#endif // TELEMETRY_H
@@ -0,0 +1,191 @@
+#include "thumbnailrenderer.h"
+#include "workerpool.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QPainter>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <atomic>
+
+namespace {
+
+constexpr quint64 RenderVersion = 1;            // đổi cách vẽ -> tăng để bỏ cache cũ
+const QColor StripBackground(236, 240, 241);    // như nền BoardView
+
+// FNV-1a 64
+struct Hash {
+    quint64 value = 14695981039346656037ull;
+
+    void add(const void *data, size_t size)
+    {
+        const unsigned char *p = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i) value = (value ^ p[i]) * 1099511628211ull;
+    }
+    void add(quint64 v) { add(&v, sizeof v); }
+};
+
+// Mỗi luồng một BoardPainter (sprite QImage riêng, không cần khóa)
+BoardPainter &threadPainter()
+{
+    thread_local BoardPainter painter(BoardPainter::Target::Image);
+    return painter;
+}
+
+QSize fitSize(int rows, int cols, int maxSide)
+{
+    const int side = qMax(1, qMax(rows, cols));
+    return QSize(qMax(1, cols * maxSide / side), qMax(1, rows * maxSide / side));
+}
+
+void paintBoard(QPainter &painter, const GameBoard &board, const Palette &palette, const QRect &rect,
+                const BoardPainter::Marks &marks)
+{
+    const double cellSize = qMin(double(rect.width()) / board.cols(), double(rect.height()) / board.rows());
+    // bàn lớn hơn ảnh: thu nhỏ mịn thay vì bỏ ô
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, cellSize < 1.0);
+    threadPainter().paint(painter, board, palette, rect.topLeft(), cellSize, 0, 0, board.rows(), board.cols(), marks);
+}
+
+QByteArray encodePng(const QImage &image)
+{
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return png;
+}
+
+bool writeBytes(const QString &path, const QByteArray &data)
+{
+    QSaveFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+}
+
+} // namespace
+
+ThumbnailRenderer::ThumbnailRenderer(const QString &cacheDirectory) : m_cacheDirectory(cacheDirectory)
+{
+}
+
+QString ThumbnailRenderer::defaultCacheDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath("thumbnails");
+}
+
+QImage ThumbnailRenderer::render(const GameBoard &board, const Palette &palette, int maxSide,
+                                 const BoardPainter::Marks &marks)
+{
+    if (board.rows() <= 0 || board.cols() <= 0 || maxSide <= 0) return QImage();
+    QImage image(fitSize(board.rows(), board.cols(), maxSide), QImage::Format_RGB32);
+    image.fill(StripBackground);
+    QPainter painter(&image);
+    paintBoard(painter, board, palette, image.rect(), marks);
+    painter.end();
+    return image;
+}
+
+QImage ThumbnailRenderer::render(const GameSave::GameState &gameState, int maxSide)
+{
+    return render(boardFrom(gameState), gameState.palette, maxSide);
+}
+
+QImage ThumbnailRenderer::renderStrip(const QVector<GameBoard> &frames, const Palette &palette, int frameSide)
+{
+    const int count = qMin(int(frames.size()), MaxStripFrames);
+    if (count == 0 || frameSide <= 0) return QImage();
+    const GameBoard &first = frames.front();
+    const QSize frame = fitSize(first.rows(), first.cols(), frameSide);
+
+    QImage image(count * frame.width() + (count - 1) * StripGap, frame.height(), QImage::Format_RGB32);
+    image.fill(StripBackground);
+    QPainter painter(&image);
+    for (int i = 0; i < count; ++i) {
+        if (frames[i].rows() != first.rows() || frames[i].cols() != first.cols()) continue;
+        const QRect rect(i * (frame.width() + StripGap), 0, frame.width(), frame.height());
+        painter.setClipRect(rect);
+        paintBoard(painter, frames[i], palette, rect, BoardPainter::Marks());
+    }
+    painter.end();
+    return image;
+}
+
+GameBoard ThumbnailRenderer::boardFrom(const GameSave::GameState &gameState)
+{
+    GameBoard board(qMax(1, gameState.rows), qMax(1, gameState.cols));
+    for (const GameSave::BallData &ball : gameState.balls) {
+        if (!board.inBounds(ball.row, ball.col) || !gameState.palette.isValidIndex(ball.colorIndex)) continue;
+        board.set(ball.row, ball.col, ball.colorIndex);
+    }
+    return board;
+}
+
+QString ThumbnailRenderer::contentKey(const GameBoard &board, const Palette &palette, int side)
+{
+    Hash hash;
+    hash.add(RenderVersion);
+    hash.add(quint64(board.rows()) << 32 | quint32(board.cols()));
+    hash.add(quint64(side));
+    for (const QColor &color : palette.colors()) hash.add(quint64(color.rgba()));
+    hash.add(board.data(), static_cast<size_t>(board.cellCount()));
+    return QString::number(hash.value, 16).rightJustified(16, '0');
+}
+
+QByteArray ThumbnailRenderer::thumbnailPng(const GameBoard &board, const Palette &palette, int side, bool *cached) const
+{
+    const QString path = QDir(m_cacheDirectory).filePath(contentKey(board, palette, side) + ".png");
+    QFile file(path);
+    if (file.open(QIODevice::ReadOnly)) {
+        const QByteArray png = file.readAll();
+        if (!png.isEmpty()) {
+            if (cached) *cached = true;
+            return png;
+        }
+    }
+    if (cached) *cached = false;
+
+    const QByteArray png = encodePng(render(board, palette, side));
+    // cache chỉ để tăng tốc: ghi lỗi (ổ đầy, không có quyền) không sao
+    if (!png.isEmpty()) writeBytes(path, png);
+    return png;
+}
+
+ThumbnailRenderer::BatchStats ThumbnailRenderer::renderFiles(const QStringList &files, const QString &outDirectory,
+                                                             int side) const
+{
+    BatchStats stats;
+    stats.files = int(files.size());
+    QDir().mkpath(m_cacheDirectory);
+    QDir().mkpath(outDirectory);
+
+    QElapsedTimer timer;
+    timer.start();
+    std::atomic<int> rendered{0}, cached{0}, failed{0};
+    // grain 4: save nhỏ đọc + vẽ ~0.1 ms, chia nhỏ để các luồng cân tải
+    WorkerPool::shared().parallelFor(stats.files, 4, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            GameSave::GameState state;
+            if (!GameSave::readFileAnySize(files[i], state)) {
+                ++failed;
+                continue;
+            }
+            bool hit = false;
+            const QByteArray png = thumbnailPng(boardFrom(state), state.palette, side, &hit);
+            const QString out = QDir(outDirectory).filePath(QFileInfo(files[i]).fileName() + ".png");
+            if (png.isEmpty() || !writeBytes(out, png)) {
+                ++failed;
+                continue;
+            }
+            ++(hit ? cached : rendered);
+        }
+    });
+    stats.rendered = rendered;
+    stats.cached = cached;
+    stats.failed = failed;
+    stats.seconds = timer.nsecsElapsed() / 1e9;
+    return stats;
+}
@@ -0,0 +1,61 @@
+#ifndef THUMBNAILRENDERER_H
+#define THUMBNAILRENDERER_H
+
+#include <QImage>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "boardpainter.h"
+#include "gameboard.h"
+#include "gamesave.h"
+
+// Ảnh bàn (thumbnail PNG) và dải replay, vẽ bằng QImage + QPainter qua
+// BoardPainter nên giống hệt BoardView. Các hàm static chạy được trên mọi
+// luồng (mỗi luồng một BoardPainter riêng); batch chạy song song trên
+// WorkerPool::shared().
+//
+// Cache trên đĩa: <cacheDirectory>/<key>.png, key là hash 64-bit của nội
+// dung bàn (kích thước, ô, palette, cỡ ảnh), nên cùng một bàn chỉ vẽ một
+// lần dù nằm trong nhiều file save.
+class ThumbnailRenderer
+{
+public:
+    static constexpr int MaxStripFrames = 256;
+    static constexpr int StripGap = 2;          // px giữa hai frame của dải replay
+
+    explicit ThumbnailRenderer(const QString &cacheDirectory = defaultCacheDirectory());
+
+    // <CacheLocation>/thumbnails
+    static QString defaultCacheDirectory();
+    QString cacheDirectory() const { return m_cacheDirectory; }
+
+    // Cả bàn trong tối đa maxSide x maxSide px (giữ tỉ lệ)
+    static QImage render(const GameBoard &board, const Palette &palette, int maxSide,
+                         const BoardPainter::Marks &marks = BoardPainter::Marks());
+    static QImage render(const GameSave::GameState &gameState, int maxSide);
+    // Các frame (cùng kích thước bàn) xếp ngang, mỗi frame tối đa frameSide px
+    static QImage renderStrip(const QVector<GameBoard> &frames, const Palette &palette, int frameSide);
+
+    static GameBoard boardFrom(const GameSave::GameState &gameState);
+    static QString contentKey(const GameBoard &board, const Palette &palette, int side);
+
+    // PNG từ cache nếu có, không thì vẽ rồi ghi vào cache. *cached = lấy từ cache.
+    QByteArray thumbnailPng(const GameBoard &board, const Palette &palette, int side, bool *cached = nullptr) const;
+
+    struct BatchStats {
+        int files = 0;
+        int rendered = 0;
+        int cached = 0;
+        int failed = 0;
+        double seconds = 0;
+        double filesPerSecond() const { return seconds > 0 ? files / seconds : 0; }
+    };
+    // Mỗi save trong files -> outDirectory/<tên file>.png, song song
+    BatchStats renderFiles(const QStringList &files, const QString &outDirectory, int side) const;
+
+private:
+    QString m_cacheDirectory;
+};
+
+#endif // THUMBNAILRENDERER_H
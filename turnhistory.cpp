@@ -0,0 +1,77 @@
+#include "turnhistory.h"
+
+void TurnHistory::beginTurn(int from, int to, uint64_t rngBefore)
+{
+    // lượt mới cắt bỏ nhánh redo
+    if (m_cursor < static_cast<int>(m_turns.size())) {
+        m_changes.resize(m_turns[m_cursor].firstChange);
+        m_turns.resize(m_cursor);
+    }
+    Record record{};
+    record.from = from;
+    record.to = to;
+    record.rngBefore = rngBefore;
+    record.firstChange = static_cast<uint32_t>(m_changes.size());
+    m_turns.push_back(record);
+    m_recording = true;
+}
+
+void TurnHistory::recordSpawn(int cell, uint8_t color)
+{
+    if (!m_recording) return;
+    // spawns come before removals in a turn, keep them first in the slice
+    Record &record = m_turns.back();
+    m_changes.insert(m_changes.begin() + record.firstChange + record.spawned, static_cast<uint32_t>(cell) << 8 | color);
+    ++record.spawned;
+}
+
+void TurnHistory::recordRemove(int cell, uint8_t color)
+{
+    if (!m_recording) return;
+    m_changes.push_back(static_cast<uint32_t>(cell) << 8 | color);
+    ++m_turns.back().removed;
+}
+
+void TurnHistory::endTurn(uint64_t rngAfter)
+{
+    if (!m_recording) return;
+    m_turns.back().rngAfter = rngAfter;
+    m_cursor = static_cast<int>(m_turns.size());
+    m_recording = false;
+}
+
+TurnHistory::Turn TurnHistory::view(const Record &record) const
+{
+    Turn turn;
+    turn.from = record.from;
+    turn.to = record.to;
+    turn.rngBefore = record.rngBefore;
+    turn.rngAfter = record.rngAfter;
+    turn.m_changes = m_changes.data() + record.firstChange;
+    turn.m_spawned = record.spawned;
+    turn.m_removed = record.removed;
+    return turn;
+}
+
+TurnHistory::Turn TurnHistory::undo()
+{
+    return view(m_turns[--m_cursor]);
+}
+
+TurnHistory::Turn TurnHistory::redo()
+{
+    return view(m_turns[m_cursor++]);
+}
+
+void TurnHistory::clear()
+{
+    m_turns.clear();
+    m_changes.clear();
+    m_cursor = 0;
+    m_recording = false;
+}
+
+size_t TurnHistory::memoryBytes() const
+{
+    return m_turns.size() * sizeof(Record) + m_changes.size() * sizeof(uint32_t);
+}
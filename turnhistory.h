@@ -0,0 +1,87 @@
+#ifndef TURNHISTORY_H
+#define TURNHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Undo/redo log of turns as compact deltas instead of board snapshots.
+// A turn is: move from -> to, the balls spawned, the balls removed, and the
+// RNG state before and after. Cell changes are packed as (cell << 8 | colour)
+// in one shared array, so a typical turn costs ~40 bytes whatever the
+// board size.
+//
+// The log only records. The owner (GameEngine, MainWindow) applies a turn
+// forwards or backwards:
+//   undo: put `removed` back, clear `spawned`, move to -> from, rng = rngBefore
+//   redo: move from -> to, set `spawned`, clear `removed`, rng = rngAfter
+class TurnHistory
+{
+public:
+    struct CellColor {
+        int cell;
+        uint8_t color;
+    };
+
+    // Xem một lượt đã ghi (chỉ hợp lệ tới lần ghi tiếp theo)
+    class Turn
+    {
+    public:
+        int from = -1;
+        int to = -1;
+        uint64_t rngBefore = 0;
+        uint64_t rngAfter = 0;
+
+        int spawnedCount() const { return m_spawned; }
+        int removedCount() const { return m_removed; }
+        CellColor spawned(int i) const { return unpack(m_changes[i]); }
+        CellColor removed(int i) const { return unpack(m_changes[m_spawned + i]); }
+
+    private:
+        friend class TurnHistory;
+        static CellColor unpack(uint32_t v) { return CellColor{static_cast<int>(v >> 8), static_cast<uint8_t>(v & 0xff)}; }
+        const uint32_t *m_changes = nullptr;
+        int m_spawned = 0;
+        int m_removed = 0;
+    };
+
+    // Ghi lượt mới; xóa các lượt redo phía sau
+    void beginTurn(int from, int to, uint64_t rngBefore);
+    void recordSpawn(int cell, uint8_t color);
+    void recordRemove(int cell, uint8_t color);
+    void endTurn(uint64_t rngAfter);
+    bool isRecording() const { return m_recording; }
+
+    bool canUndo() const { return m_cursor > 0; }
+    bool canRedo() const { return m_cursor < static_cast<int>(m_turns.size()); }
+    // Lượt cần hoàn tác / làm lại; cursor lùi / tiến một bước
+    Turn undo();
+    Turn redo();
+    // Lượt ngay trước cursor (vừa ghi / vừa làm lại); cần canUndo()
+    Turn last() const { return view(m_turns[m_cursor - 1]); }
+
+    void clear();
+    int turnCount() const { return static_cast<int>(m_turns.size()); }
+    int cursor() const { return m_cursor; }
+    size_t memoryBytes() const;     // bytes in use (không tính phần dư capacity)
+
+private:
+    struct Record {
+        int32_t from;
+        int32_t to;
+        uint64_t rngBefore;
+        uint64_t rngAfter;
+        uint32_t firstChange;   // into m_changes
+        uint16_t spawned;
+        uint16_t removed;
+    };
+
+    Turn view(const Record &record) const;
+
+    std::vector<Record> m_turns;
+    std::vector<uint32_t> m_changes;
+    int m_cursor = 0;
+    bool m_recording = false;
+};
+
+#endif // TURNHISTORY_H
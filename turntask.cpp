@@ -0,0 +1,74 @@
+#include "turntask.h"
+#include <QTimer>
+#include "powermetrics.h"
+
+TurnTask &TurnTask::operator=(TurnTask &&other) noexcept
+{
+    if (this != &other) {
+        cancel();
+        m_handle = other.m_handle;
+        other.m_handle = nullptr;
+    }
+    return *this;
+}
+
+void TurnTask::cancel()
+{
+    // Destroying a suspended frame also destroys its pending TurnDelay,
+    // which stops the timer so the handle is never resumed.
+    if (m_handle) {
+        m_handle.destroy();
+        m_handle = nullptr;
+    }
+}
+
+TurnDelay::TurnDelay(TurnDelay &&other) noexcept
+    : m_ms(other.m_ms),
+    m_restartOnResume(other.m_restartOnResume),
+    m_timer(other.m_timer)
+{
+    other.m_timer = nullptr;
+}
+
+TurnDelay::~TurnDelay()
+{
+    if (m_timer) {
+        // may run inside the timer's own timeout() -> deleteLater, not delete
+        m_timer->stop();
+        m_timer->disconnect();
+        m_timer->deleteLater();
+    }
+}
+
+void TurnDelay::await_suspend(std::coroutine_handle<> handle)
+{
+    m_timer = new QTimer();
+    m_timer->setSingleShot(true);
+    QObject::connect(m_timer, &QTimer::timeout, m_timer, [handle]() {
+        PowerMetrics::recordWakeup();
+        handle.resume();
+    });
+    m_timer->start(m_ms);
+}
+
+void TurnDelay::await_resume() noexcept
+{
+    if (m_restartOnResume) {
+        m_restartOnResume->restart();
+    }
+}
+
+FrameBudget::FrameBudget(const TurnPacing &pacing)
+    : m_budgetMs(pacing.frameBudgetMs),
+    m_immediate(pacing.immediate)
+{
+    m_elapsed.start();
+}
+
+TurnDelay FrameBudget::checkpoint()
+{
+    if (m_immediate || m_elapsed.elapsed() < m_budgetMs) {
+        return TurnDelay(-1);
+    }
+    return TurnDelay(0, &m_elapsed);
+}
@@ -0,0 +1,85 @@
+#ifndef TURNTASK_H
+#define TURNTASK_H
+
+#include <QElapsedTimer>
+#include <coroutine>
+#include <exception>
+
+class QTimer;
+
+// Coroutine type for one game turn (move -> spawn -> clear).
+// The body starts running immediately; the owner keeps the frame alive
+// and destroying the task cancels a turn that is still waiting.
+class TurnTask
+{
+public:
+    struct promise_type {
+        TurnTask get_return_object() { return TurnTask(Handle::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    TurnTask() = default;
+    TurnTask(TurnTask &&other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; }
+    TurnTask &operator=(TurnTask &&other) noexcept;
+    TurnTask(const TurnTask &) = delete;
+    TurnTask &operator=(const TurnTask &) = delete;
+    ~TurnTask() { cancel(); }
+
+    bool isRunning() const { return m_handle && !m_handle.done(); }
+    void cancel();              // hủy lượt đang chờ (an toàn nếu đã xong)
+
+private:
+    explicit TurnTask(Handle handle) : m_handle(handle) {}
+    Handle m_handle;
+};
+
+// Awaitable pause on the Qt event loop.
+// ms < 0 means "do not suspend" (zero-delay mode for bots and replays).
+class TurnDelay
+{
+public:
+    explicit TurnDelay(int ms, QElapsedTimer *restartOnResume = nullptr)
+        : m_ms(ms), m_restartOnResume(restartOnResume) {}
+    TurnDelay(TurnDelay &&other) noexcept;
+    TurnDelay(const TurnDelay &) = delete;
+    TurnDelay &operator=(const TurnDelay &) = delete;
+    ~TurnDelay();
+
+    bool await_ready() const noexcept { return m_ms < 0; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() noexcept;
+
+private:
+    int m_ms;
+    QElapsedTimer *m_restartOnResume;
+    QTimer *m_timer = nullptr;
+};
+
+// How a turn is paced: real animation timings or full speed.
+struct TurnPacing {
+    bool immediate = false;
+    int moveStepMs = 150;       // thời gian mỗi bước di chuyển
+    int frameBudgetMs = 8;      // thời gian tối đa cho việc nặng trong 1 frame
+
+    TurnDelay step() const { return TurnDelay(immediate ? -1 : moveStepMs); }
+};
+
+// Lets heavy work yield back to the event loop once a frame's budget is spent.
+class FrameBudget
+{
+public:
+    explicit FrameBudget(const TurnPacing &pacing);
+
+    TurnDelay checkpoint();
+
+private:
+    QElapsedTimer m_elapsed;
+    int m_budgetMs;
+    bool m_immediate;
+};
+
+#endif // TURNTASK_H
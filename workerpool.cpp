@@ -0,0 +1,95 @@
+#include "workerpool.h"
+
+#include <algorithm>
+
+namespace {
+
+// Pool whose job the current thread is running chunks of (worker or caller)
+thread_local const WorkerPool *t_runningPool = nullptr;
+
+} // namespace
+
+WorkerPool::WorkerPool(int threads)
+{
+    if (threads < 0) threads = std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    m_threads.reserve(threads);
+    for (int i = 0; i < threads; ++i) m_threads.emplace_back([this] { workerLoop(); });
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread &t : m_threads) t.join();
+}
+
+WorkerPool &WorkerPool::shared()
+{
+    static WorkerPool pool;
+    return pool;
+}
+
+void WorkerPool::runChunks()
+{
+    for (;;) {
+        const int begin = m_next.fetch_add(m_grain, std::memory_order_relaxed);
+        if (begin >= m_count) return;
+        (*m_fn)(begin, std::min(m_count, begin + m_grain));
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    unsigned seenJob = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_jobId != seenJob; });
+            if (m_stop) return;
+            seenJob = m_jobId;
+        }
+        t_runningPool = this;
+        runChunks();
+        t_runningPool = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busy == 0) m_done.notify_one();
+        }
+    }
+}
+
+void WorkerPool::parallelFor(int count, int grain, const std::function<void(int, int)> &fn)
+{
+    if (count <= 0) return;
+    grain = std::max(1, grain);
+    // parallelFor lồng trong một chunk của chính pool này: m_jobMutex đang bị
+    // giữ và các worker đang bận, nên chạy luôn trên luồng hiện tại
+    if (m_threads.empty() || count <= grain || t_runningPool == this) {
+        fn(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> job(m_jobMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fn = &fn;
+        m_count = count;
+        m_grain = grain;
+        m_next.store(0, std::memory_order_relaxed);
+        m_busy = static_cast<int>(m_threads.size());
+        ++m_jobId;
+    }
+    m_wake.notify_all();
+    const WorkerPool *outer = t_runningPool;
+    t_runningPool = this;
+    runChunks();
+    t_runningPool = outer;
+
+    // workers that wake late find no chunks left and check out immediately
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&] { return m_busy == 0; });
+    m_fn = nullptr;
+}
@@ -0,0 +1,55 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small persistent thread pool for data-parallel loops in the game core.
+// Threads are started once and sleep on a condition variable between jobs,
+// so a parallelFor costs a wake-up, not a thread spawn. The calling thread
+// takes chunks too. One job runs at a time (callers are serialised).
+class WorkerPool
+{
+public:
+    // threads = extra worker threads; -1 = hardware_concurrency() - 1
+    explicit WorkerPool(int threads = -1);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    // Số luồng tham gia một job (kể cả luồng gọi)
+    int concurrency() const { return static_cast<int>(m_threads.size()) + 1; }
+
+    // Calls fn(begin, end) over [0, count) in chunks of at most `grain`
+    // items and returns when every chunk is done. Small loops run inline,
+    // and so does a parallelFor called from inside a chunk of this pool.
+    void parallelFor(int count, int grain, const std::function<void(int, int)> &fn);
+
+    // Pool dùng chung cho cả chương trình
+    static WorkerPool &shared();
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_jobMutex;              // one parallelFor at a time
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    bool m_stop = false;
+    unsigned m_jobId = 0;
+    int m_busy = 0;                     // workers still inside the current job
+
+    const std::function<void(int, int)> *m_fn = nullptr;
+    int m_count = 0;
+    int m_grain = 1;
+    std::atomic<int> m_next{0};
+};
+
+#endif // WORKERPOOL_H